@@ -0,0 +1,1053 @@
+/*! \file Ble112Emulator.cpp
+    \brief Emulator of the BLE112 module connected to a Thunderboard Sense 2, attached to SOCKET0 in the host build
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include "Ble112Emulator.h"
+#include "defines.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define GATT_PRIMARY_SERVICE 0x2800
+#define GATT_CHARACTERISTIC 0x2803
+#define GATT_CCCD 0x2902
+#define GATT_READ 0x02
+#define GATT_WRITE 0x08
+#define GATT_NOTIFY 0x10
+#define GATT_INDICATE 0x20
+#define MS_PER_DAY 86400000.0
+#define DESCRIPTION_LINE_SIZE 256
+
+/*! \var sensorModel
+    \brief Initial value, step of the random walk and size in bytes of each UplinkTypes_t (Thunderboard units)
+ */
+static const struct {
+  int32_t initial;
+  int32_t step;
+  uint8_t size;
+}sensorModel[FIELD_STRENGHT_TYPE + 1] = {
+    {0, 0, 1},/*BLE_DISCONNECT*/
+    {1, 1, 1},/*UV_INDEX*/
+    {1013250, 30, 4},/*PRESSURE: 0.1 Pa*/
+    {2150, 15, 2},/*TEMPERATURE: 0.01 C*/
+    {40000, 800, 4},/*AMBIENT_LIGHT: 0.01 lux*/
+    {4500, 150, 2},/*SOUND_LEVEL: 0.01 dB*/
+    {4500, 40, 2},/*HUMIDITY: 0.01 %*/
+    {100, 1, 1},/*BATTERY_LEVEL: %*/
+    {400, 20, 2},/*ECO2: ppm*/
+    {20, 5, 2},/*TVOC: ppb*/
+    {0, 0, 1},/*HALL_STATE: notified*/
+    {500, 50, 4}/*FIELD_STRENGHT: uT*/
+};
+
+/*! \var sensorName
+    \brief Name of each UplinkTypes_t in the description files
+ */
+static const char *sensorName[FIELD_STRENGHT_TYPE + 1] = {
+    "BLE_DISCONNECT", "UV_INDEX", "PRESSURE", "TEMPERATURE", "AMBIENT_LIGHT", "SOUND_LEVEL",
+    "HUMIDITY", "BATTERY_LEVEL", "ECO2", "TVOC", "HALL_STATE", "FIELD_STRENGHT"
+};
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS                                                          *
+ ******************************************************************************/
+
+/*! \fn static void uuidToAttribute(gattAttribute_t *attribute, const uint8_t *uuid, uint8_t length)
+    \brief Store a UUID given most significant byte first (defines.h) as the attribute type
+*/
+static void uuidToAttribute(gattAttribute_t *attribute, const uint8_t *uuid, uint8_t length){
+    attribute->typeLength = length;
+    for(uint8_t i = 0; i < length; i++){
+        attribute->type[i] = uuid[length - 1 - i];
+    }
+}
+
+/*! \fn static gattAttribute_t newAttribute(uint16_t handle, uint16_t type)
+    \brief An attribute with a 16 bits type and no value
+*/
+static gattAttribute_t newAttribute(uint16_t handle, uint16_t type){
+    gattAttribute_t attribute;
+    attribute.handle = handle;
+    attribute.type[0] = type;
+    attribute.type[1] = type >> 8;
+    attribute.typeLength = 2;
+    attribute.sensor = -1;
+    return attribute;
+}
+
+/*! \fn static uint8_t isType(const gattAttribute_t *attribute, uint16_t type)
+    \brief 1 if the attribute has the 16 bits type
+*/
+static uint8_t isType(const gattAttribute_t *attribute, uint16_t type){
+    return (attribute->typeLength == 2) && (attribute->type[0] == (uint8_t)type) && (attribute->type[1] == (uint8_t)(type >> 8));
+}
+
+/*! \fn void addService16(uint16_t uuid)
+    \brief Append a primary service declaration with a 16 bits UUID
+*/
+void Ble112Emulator::addService16(uint16_t uuid){
+    gattAttribute_t attribute = newAttribute(database.size() + 1, GATT_PRIMARY_SERVICE);
+    attribute.value.push_back(uuid);
+    attribute.value.push_back(uuid >> 8);
+    database.push_back(attribute);
+}
+
+/*! \fn void addService128(const uint8_t *uuid)
+    \brief Append a primary service declaration with a 128 bits UUID (most significant byte first)
+*/
+void Ble112Emulator::addService128(const uint8_t *uuid){
+    gattAttribute_t attribute = newAttribute(database.size() + 1, GATT_PRIMARY_SERVICE);
+    for(uint8_t i = 0; i < 16; i++){
+        attribute.value.push_back(uuid[15 - i]);
+    }
+    database.push_back(attribute);
+}
+
+/*! \fn void addCharacteristic(const uint8_t *uuid, uint8_t uuidLength, uint8_t properties, int8_t sensor)
+    \brief Append the declaration, the value and, if it notifies or indicates, the CCCD of a characteristic
+    \param  uuid        UUID, most significant byte first
+    \param  uuidLength  2 or 16
+    \param  properties  GATT properties
+    \param  sensor      UplinkTypes_t served by the value, -1 for a static value
+*/
+void Ble112Emulator::addCharacteristic(const uint8_t *uuid, uint8_t uuidLength, uint8_t properties, int8_t sensor){
+    uint16_t valueHandle = database.size() + 2;
+    gattAttribute_t declaration = newAttribute(database.size() + 1, GATT_CHARACTERISTIC);
+    gattAttribute_t value = newAttribute(valueHandle, 0);
+    declaration.value.push_back(properties);
+    declaration.value.push_back(valueHandle);
+    declaration.value.push_back(valueHandle >> 8);
+    for(uint8_t i = 0; i < uuidLength; i++){
+        declaration.value.push_back(uuid[uuidLength - 1 - i]);
+    }
+    database.push_back(declaration);
+    uuidToAttribute(&value, uuid, uuidLength);
+    value.sensor = sensor;
+    value.value.push_back(0);
+    database.push_back(value);
+    if(properties & (GATT_NOTIFY | GATT_INDICATE)){
+        gattAttribute_t cccd = newAttribute(database.size() + 1, GATT_CCCD);
+        cccd.value.push_back(0);
+        cccd.value.push_back(0);
+        database.push_back(cccd);
+    }
+}
+
+/*! \fn void addCharacteristic16(uint16_t uuid, uint8_t properties, int8_t sensor)
+    \brief addCharacteristic() with a 16 bits UUID
+*/
+void Ble112Emulator::addCharacteristic16(uint16_t uuid, uint8_t properties, int8_t sensor){
+    uint8_t bytes[2] = {(uint8_t)(uuid >> 8), (uint8_t)uuid};
+    addCharacteristic(bytes, 2, properties, sensor);
+}
+
+/*! \fn void addCharacteristic128(const uint8_t *uuid, uint8_t properties, int8_t sensor)
+    \brief addCharacteristic() with a 128 bits UUID
+*/
+void Ble112Emulator::addCharacteristic128(const uint8_t *uuid, uint8_t properties, int8_t sensor){
+    addCharacteristic(uuid, 16, properties, sensor);
+}
+
+/*! \fn void buildThunderboard()
+    \brief Build the GATT database of the Thunderboard Sense 2 (services 0 to A of defines.h)
+*/
+void Ble112Emulator::buildThunderboard(){
+    database.clear();
+    addService16(0x1800);
+    addCharacteristic16(0x2A00, GATT_READ, -1);
+    addCharacteristic16(0x2A01, GATT_READ, -1);
+    addService16(0x1801);
+    addCharacteristic16(0x2A05, GATT_INDICATE, -1);
+    addService16(0x180A);
+    addCharacteristic16(0x2A29, GATT_READ, -1);
+    addCharacteristic16(0x2A24, GATT_READ, -1);
+    addCharacteristic16(0x2A25, GATT_READ, -1);
+    addCharacteristic16(0x2A27, GATT_READ, -1);
+    addCharacteristic16(0x2A26, GATT_READ, -1);
+    addCharacteristic16(0x2A23, GATT_READ, -1);
+    addService16(0x180F);
+    addCharacteristic16(0x2A19, GATT_READ | GATT_NOTIFY, BATTERY_LEVEL_TYPE);
+    addService16(0x181A);
+    addCharacteristic16(0x2A76, GATT_READ, UV_INDEX_TYPE);
+    addCharacteristic16(0x2A6D, GATT_READ, PRESSURE_TYPE);
+    addCharacteristic16(0x2A6E, GATT_READ, TEMPERATURE_TYPE);
+    addCharacteristic16(0x2A6F, GATT_READ, HUMIDITY_TYPE);
+    addCharacteristic128(Service4_Characrteristic4_Ambient_Light_uuid, GATT_READ, AMBIENT_LIGHT_TYPE);
+    addCharacteristic128(Service4_Characrteristic5_Sound_Level_uuid, GATT_READ, SOUND_LEVEL_TYPE);
+    addCharacteristic128(Service4_Characrteristic6_Control_Point_uuid, GATT_WRITE | GATT_INDICATE, -1);
+    addService128(power_management_service_uuid);
+    addCharacteristic128(Service5_Characrteristic0_Power_Source_uuid, GATT_READ, -1);
+    addService128(iaq_service_uuid);
+    addCharacteristic128(Service6_Characrteristic0_ECO2_uuid, GATT_READ, ECO2_TYPE);
+    addCharacteristic128(Service6_Characrteristic1_TVOC_uuid, GATT_READ, TVOC_TYPE);
+    addCharacteristic128(Service6_Characrteristic2_Control_Point_uuid, GATT_WRITE | GATT_INDICATE, -1);
+    addService128(user_interface_service_uuid);
+    addCharacteristic128(Service7_Characrteristic0_Buttons_uuid, GATT_READ | GATT_NOTIFY, -1);
+    addCharacteristic128(Service7_Characrteristic1_Leds_uuid, GATT_READ | GATT_WRITE, -1);
+    addCharacteristic128(Service7_Characrteristic2_RGB_Leds_uuid, GATT_READ | GATT_WRITE, -1);
+    addCharacteristic128(Service7_Characrteristic3_Control_Point_uuid, GATT_WRITE | GATT_INDICATE, -1);
+    addService16(0x1815);
+    addCharacteristic16(0x2A56, GATT_READ | GATT_WRITE | GATT_NOTIFY, -1);
+    addCharacteristic16(0x2A56, GATT_READ | GATT_WRITE | GATT_NOTIFY, -1);
+    addService128(accleration_orientation_service_uuid);
+    addCharacteristic128(Service9_Characrteristic0_Acceleration_uuid, GATT_NOTIFY, -1);
+    addCharacteristic128(Service9_Characrteristic1_Orientation_uuid, GATT_NOTIFY, -1);
+    addCharacteristic128(Service9_Characrteristic2_Control_Point_uuid, GATT_WRITE | GATT_INDICATE, -1);
+    addService128(hall_effect_service_uuid);
+    addCharacteristic128(ServiceA_Characrteristic0_State_uuid, GATT_READ | GATT_NOTIFY, HALL_STATE_TYPE);
+    addCharacteristic128(ServiceA_Characrteristic1_Field_Strength_uuid, GATT_READ | GATT_NOTIFY, FIELD_STRENGHT_TYPE);
+    addCharacteristic128(ServiceA_Characrteristic2_Control_Point_uuid, GATT_WRITE | GATT_INDICATE, -1);
+}
+
+/*! \fn static uint8_t parseHex(const char *text, std::vector<uint8_t> *bytes)
+    \brief Decode hexadecimal digits, the dashes are ignored
+    \retval 1 if the text is an even number of digits, 0 otherwise
+*/
+static uint8_t parseHex(const char *text, std::vector<uint8_t> *bytes){
+    char digits[3] = {0, 0, 0};
+    uint8_t count = 0;
+    bytes->clear();
+    for(; *text != '\0'; text++){
+        if(*text == '-'){
+            continue;
+        }
+        if(!isxdigit((unsigned char)*text)){
+            return 0;
+        }
+        digits[count++] = *text;
+        if(count == 2){
+            bytes->push_back(strtoul(digits, NULL, 16));
+            count = 0;
+        }
+    }
+    return count == 0;
+}
+
+/*! \fn static uint8_t parseProperties(const char *text)
+    \brief GATT properties of a comma separated list of read, write, notify and indicate, 0 if a name is unknown
+*/
+static uint8_t parseProperties(const char *text){
+    static const char *names[4] = {"read", "write", "notify", "indicate"};
+    static const uint8_t bits[4] = {GATT_READ, GATT_WRITE, GATT_NOTIFY, GATT_INDICATE};
+    uint8_t properties = 0;
+    uint8_t known;
+    size_t length;
+    while(*text != '\0'){
+        length = strcspn(text, ",");
+        known = 0;
+        for(uint8_t i = 0; i < 4; i++){
+            if((strlen(names[i]) == length) && (strncmp(text, names[i], length) == 0)){
+                properties |= bits[i];
+                known = 1;
+            }
+        }
+        if(!known){
+            return 0;
+        }
+        text += length + (text[length] == ',');
+    }
+    return properties;
+}
+
+/*! \fn static int8_t parseSensor(const char *text)
+    \brief UplinkTypes_t given by number or by name, -1 if it is not a sensor characteristic
+*/
+static int8_t parseSensor(const char *text){
+    char *end;
+    long number = strtol(text, &end, 10);
+    if((*end == '\0') && (end != text)){
+        return ((number > BLE_DISCONNECT_TYPE) && (number <= FIELD_STRENGHT_TYPE)) ? number : -1;
+    }
+    for(uint8_t i = UV_INDEX_TYPE; i <= FIELD_STRENGHT_TYPE; i++){
+        if(strcmp(text, sensorName[i]) == 0){
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*! \fn uint8_t parseDirective(char *line)
+    \brief Apply one line of a description file (see Ble112Emulator.h)
+    \param  line The line without the end of line, it is modified
+    \retval 1 if the line is valid, 0 otherwise
+*/
+uint8_t Ble112Emulator::parseDirective(char *line){
+    char *keyword = strtok(line, " \t");
+    char *argument;
+    char *rest;
+    std::vector<uint8_t> uuid;
+    if((keyword == NULL) || (keyword[0] == '#')){
+        return 1;
+    }
+    if((strcmp(keyword, "name") == 0) || (strcmp(keyword, "address") == 0)){
+        rest = strtok(NULL, "");
+        while((rest != NULL) && isspace((unsigned char)*rest)){
+            rest++;
+        }
+        if((rest == NULL) || (*rest == '\0')){
+            return 0;
+        }
+        if(keyword[0] == 'n'){
+            setName(rest);
+            return 1;
+        }
+        if(!parseHex(rest, &uuid) || (uuid.size() != 6)){
+            return 0;
+        }
+        setAddress(rest);
+        return 1;
+    }
+    argument = strtok(NULL, " \t");
+    if(argument == NULL){
+        return 0;
+    }
+    if(strcmp(keyword, "interval") == 0){
+        setConnectionInterval(strtoul(argument, NULL, 10));
+        return 1;
+    }
+    if(strcmp(keyword, "latency") == 0){
+        char *id = strtok(NULL, " \t");
+        char *ms = strtok(NULL, " \t");
+        if(id == NULL){
+            setResponseLatency(strtoul(argument, NULL, 10));
+            return 1;
+        }
+        if(ms == NULL){
+            return 0;
+        }
+        setCommandLatency(strtoul(argument, NULL, 0), strtoul(id, NULL, 0), strtoul(ms, NULL, 10));
+        return 1;
+    }
+    if(!parseHex(argument, &uuid) || ((uuid.size() != 2) && (uuid.size() != 16))){
+        return 0;
+    }
+    if(strcmp(keyword, "service") == 0){
+        if(uuid.size() == 2){
+            addService16(uuid[0] << 8 | uuid[1]);
+        }else{
+            addService128(&uuid[0]);
+        }
+        return 1;
+    }
+    if(strcmp(keyword, "characteristic") == 0){
+        char *properties = strtok(NULL, " \t");
+        char *source = strtok(NULL, " \t");
+        uint16_t valueHandle = database.size() + 2;
+        int8_t sensor = -1;
+        std::vector<uint8_t> value(1, 0);
+        uint8_t propertyBits;
+        if((properties == NULL) || ((propertyBits = parseProperties(properties)) == 0) || database.empty()){
+            return 0;
+        }
+        rest = strtok(NULL, "");
+        while((rest != NULL) && isspace((unsigned char)*rest)){
+            rest++;
+        }
+        if(source != NULL){
+            if(rest == NULL){
+                return 0;
+            }else if(strcmp(source, "sensor") == 0){
+                if((sensor = parseSensor(rest)) < 0){
+                    return 0;
+                }
+            }else if(strcmp(source, "value") == 0){
+                if(!parseHex(rest, &value) || value.empty()){
+                    return 0;
+                }
+            }else if(strcmp(source, "text") == 0){
+                value.assign(rest, rest + strlen(rest));
+            }else{
+                return 0;
+            }
+        }
+        addCharacteristic(&uuid[0], uuid.size(), propertyBits, sensor);
+        database[valueHandle - 1].value = value;
+        return 1;
+    }
+    return 0;
+}
+
+/*! \fn gattAttribute_t* findAttribute(uint16_t handle)
+    \brief The attribute with the handle, NULL if it does not exist
+*/
+gattAttribute_t* Ble112Emulator::findAttribute(uint16_t handle){
+    if((handle == 0) || (handle > database.size())){
+        return NULL;
+    }
+    return &database[handle - 1];
+}
+
+/*! \fn uint16_t groupEnd(size_t index)
+    \brief The end group handle of the service declared at database[index], 0xFFFF for the last one
+*/
+uint16_t Ble112Emulator::groupEnd(size_t index){
+    for(size_t i = index + 1; i < database.size(); i++){
+        if(isType(&database[i], GATT_PRIMARY_SERVICE)){
+            return database[i].handle - 1;
+        }
+    }
+    return 0xFFFF;
+}
+
+/*! \fn std::vector<uint8_t> readValue(gattAttribute_t *attribute)
+    \brief The value of an attribute, the sensor values take a step of their random walk
+*/
+std::vector<uint8_t> Ble112Emulator::readValue(gattAttribute_t *attribute){
+    std::vector<uint8_t> value;
+    int32_t step;
+    if(attribute->sensor < 0){
+        return attribute->value;
+    }
+    if(attribute->sensor == HALL_STATE_TYPE){
+        sensorValue[HALL_STATE_TYPE] = hallState;
+    }else{
+        step = sensorModel[attribute->sensor].step;
+        sensorValue[attribute->sensor] += std::uniform_int_distribution<int32_t>(-step, step)(random);
+        if(sensorValue[attribute->sensor] < 0){
+            sensorValue[attribute->sensor] = 0;
+        }
+    }
+    for(uint8_t i = 0; i < sensorModel[attribute->sensor].size; i++){
+        value.push_back((uint8_t)(sensorValue[attribute->sensor] >> (8 * i)));
+    }
+    return value;
+}
+
+/*! \fn uint64_t schedule(uint64_t delay, uint8_t type, uint8_t classID, uint8_t id, const uint8_t *payload, uint8_t length)
+    \brief Queue a BGAPI packet delay ms after the previous one
+    \param  type 0x00 response, 0x80 event
+    \retval The virtual time of the packet
+*/
+uint64_t Ble112Emulator::schedule(uint64_t delay, uint8_t type, uint8_t classID, uint8_t id, const uint8_t *payload, uint8_t length){
+    std::vector<uint8_t> packet;
+    uint64_t now = hostClock.getTime();
+    lastOutput = ((lastOutput > now) ? lastOutput : now) + delay;
+    packet.push_back(type);
+    packet.push_back(length);
+    packet.push_back(classID);
+    packet.push_back(id);
+    packet.insert(packet.end(), payload, payload + length);
+    output.insert(std::make_pair(lastOutput, packet));
+    return lastOutput;
+}
+
+/*! \fn uint64_t response(uint8_t classID, uint8_t id, const uint8_t *payload, uint8_t length)
+    \brief Queue the response of a command
+*/
+uint64_t Ble112Emulator::response(uint8_t classID, uint8_t id, const uint8_t *payload, uint8_t length){
+    std::map<uint16_t, uint32_t>::iterator latency = commandLatency.find(classID << 8 | id);
+    return schedule((latency != commandLatency.end()) ? latency->second : responseLatency, 0x00, classID, id, payload, length);
+}
+
+/*! \fn uint64_t event(uint64_t delay, uint8_t classID, uint8_t id, const uint8_t *payload, uint8_t length)
+    \brief Queue an event delay ms after the previous packet
+*/
+uint64_t Ble112Emulator::event(uint64_t delay, uint8_t classID, uint8_t id, const uint8_t *payload, uint8_t length){
+    return schedule(delay, 0x80, classID, id, payload, length);
+}
+
+/*! \fn void attclientResponse(uint8_t classID, uint8_t id, uint8_t connection, uint16_t result)
+    \brief Queue a [connection][result] response
+*/
+void Ble112Emulator::attclientResponse(uint8_t classID, uint8_t id, uint8_t connection, uint16_t result){
+    uint8_t payload[3] = {connection, (uint8_t)result, (uint8_t)(result >> 8)};
+    response(classID, id, payload, sizeof(payload));
+}
+
+/*! \fn uint64_t procedureCompleted(uint64_t delay, uint8_t connection, uint16_t result, uint16_t handle)
+    \brief Queue the attclient_procedure_completed event
+*/
+uint64_t Ble112Emulator::procedureCompleted(uint64_t delay, uint8_t connection, uint16_t result, uint16_t handle){
+    uint8_t payload[5] = {connection, (uint8_t)result, (uint8_t)(result >> 8), (uint8_t)handle, (uint8_t)(handle >> 8)};
+    return event(delay, 4, 1, payload, sizeof(payload));
+}
+
+/*! \fn void readByGroupType(const uint8_t *payload)
+    \brief attclient_read_by_group_type: one group_found event per service in the range
+*/
+void Ble112Emulator::readByGroupType(const uint8_t *payload){
+    uint16_t start = payload[1] | ((uint16_t)payload[2] << 8);
+    uint16_t end = payload[3] | ((uint16_t)payload[4] << 8);
+    uint8_t found[32];
+    attclientResponse(4, 1, payload[0], 0);
+    for(size_t i = 0; i < database.size(); i++){
+        if((database[i].handle < start) || (database[i].handle > end) || !isType(&database[i], GATT_PRIMARY_SERVICE)){
+            continue;
+        }
+        uint16_t groupEndHandle = groupEnd(i);
+        found[0] = payload[0];
+        found[1] = database[i].handle;
+        found[2] = database[i].handle >> 8;
+        found[3] = groupEndHandle;
+        found[4] = groupEndHandle >> 8;
+        found[5] = database[i].value.size();
+        memcpy(found + 6, &database[i].value[0], database[i].value.size());
+        event(connectionInterval, 4, 2, found, 6 + database[i].value.size());
+    }
+    procedureCompleted(connectionInterval, payload[0], 0, end);
+}
+
+/*! \fn void readByType(const uint8_t *payload)
+    \brief attclient_read_by_type: one attribute_value event (type 3) per attribute of the type in the range
+*/
+void Ble112Emulator::readByType(const uint8_t *payload){
+    uint16_t start = payload[1] | ((uint16_t)payload[2] << 8);
+    uint16_t end = payload[3] | ((uint16_t)payload[4] << 8);
+    uint8_t found[40];
+    uint8_t any = 0;
+    attclientResponse(4, 2, payload[0], 0);
+    for(size_t i = 0; i < database.size(); i++){
+        if((database[i].handle < start) || (database[i].handle > end) || (database[i].typeLength != payload[5])
+           || (memcmp(database[i].type, payload + 6, payload[5]) != 0)){
+            continue;
+        }
+        found[0] = payload[0];
+        found[1] = database[i].handle;
+        found[2] = database[i].handle >> 8;
+        found[3] = 3;
+        found[4] = database[i].value.size();
+        memcpy(found + 5, &database[i].value[0], database[i].value.size());
+        event(connectionInterval, 4, 5, found, 5 + database[i].value.size());
+        any = 1;
+    }
+    procedureCompleted(connectionInterval, payload[0], any ? 0 : BLE112_ATT_NOT_FOUND, start);
+}
+
+/*! \fn void findInformation(const uint8_t *payload)
+    \brief attclient_find_information: one find_information_found event per attribute in the range
+*/
+void Ble112Emulator::findInformation(const uint8_t *payload){
+    uint16_t start = payload[1] | ((uint16_t)payload[2] << 8);
+    uint16_t end = payload[3] | ((uint16_t)payload[4] << 8);
+    uint8_t found[20];
+    uint8_t any = 0;
+    attclientResponse(4, 3, payload[0], 0);
+    for(size_t i = 0; i < database.size(); i++){
+        if((database[i].handle < start) || (database[i].handle > end)){
+            continue;
+        }
+        found[0] = payload[0];
+        found[1] = database[i].handle;
+        found[2] = database[i].handle >> 8;
+        found[3] = database[i].typeLength;
+        memcpy(found + 4, database[i].type, database[i].typeLength);
+        event(connectionInterval, 4, 4, found, 4 + database[i].typeLength);
+        any = 1;
+    }
+    procedureCompleted(connectionInterval, payload[0], any ? 0 : BLE112_ATT_NOT_FOUND, start);
+}
+
+/*! \fn void readByHandle(const uint8_t *payload)
+    \brief attclient_read_by_handle: attribute_value event (type 0) or procedure_completed with the ATT error
+
+    As the ATT Read Response, the value is truncated to BLE112_ATT_MTU - 1 bytes.
+*/
+void Ble112Emulator::readByHandle(const uint8_t *payload){
+    uint16_t handle = payload[1] | ((uint16_t)payload[2] << 8);
+    gattAttribute_t *attribute = findAttribute(handle);
+    std::vector<uint8_t> value;
+    uint8_t found[40];
+    attclientResponse(4, 4, payload[0], 0);
+    if(attribute == NULL){
+        procedureCompleted(connectionInterval, payload[0], BLE112_ATT_INVALID_HANDLE, handle);
+        return;
+    }
+    value = readValue(attribute);
+    if(value.size() > (BLE112_ATT_MTU - 1)){
+        value.resize(BLE112_ATT_MTU - 1);
+    }
+    found[0] = payload[0];
+    found[1] = handle;
+    found[2] = handle >> 8;
+    found[3] = 0;
+    found[4] = value.size();
+    memcpy(found + 5, &value[0], value.size());
+    event(connectionInterval, 4, 5, found, 5 + value.size());
+}
+
+/*! \fn void readLong(const uint8_t *payload)
+    \brief attclient_read_long: one attribute_value event per chunk (type 0, then type 4) and procedure_completed
+
+    The module sends a Read Request and Read Blob Requests, one per connection interval, until a
+    response is shorter than BLE112_ATT_MTU - 1 bytes: a value that is a multiple of it takes one
+    more request, answered with no data.
+*/
+void Ble112Emulator::readLong(const uint8_t *payload){
+    uint16_t handle = payload[1] | ((uint16_t)payload[2] << 8);
+    gattAttribute_t *attribute = findAttribute(handle);
+    std::vector<uint8_t> value;
+    uint8_t found[5 + BLE112_ATT_MTU - 1];
+    size_t offset = 0;
+    size_t chunk;
+    attclientResponse(4, 8, payload[0], 0);
+    if(attribute == NULL){
+        procedureCompleted(connectionInterval, payload[0], BLE112_ATT_INVALID_HANDLE, handle);
+        return;
+    }
+    value = readValue(attribute);
+    do{
+        chunk = value.size() - offset;
+        if(chunk > (BLE112_ATT_MTU - 1)){
+            chunk = BLE112_ATT_MTU - 1;
+        }
+        found[0] = payload[0];
+        found[1] = handle;
+        found[2] = handle >> 8;
+        found[3] = (offset == 0) ? 0 : 4;
+        found[4] = chunk;
+        memcpy(found + 5, value.data() + offset, chunk);
+        event(connectionInterval, 4, 5, found, 5 + chunk);
+        offset += chunk;
+    }while(offset < value.size());
+    procedureCompleted((chunk == (BLE112_ATT_MTU - 1)) ? connectionInterval : 0, payload[0], 0, handle);
+}
+
+/*! \fn void attributeWrite(const uint8_t *payload)
+    \brief attclient_attribute_write: store the value and complete the procedure
+*/
+void Ble112Emulator::attributeWrite(const uint8_t *payload){
+    uint16_t handle = payload[1] | ((uint16_t)payload[2] << 8);
+    gattAttribute_t *attribute = findAttribute(handle);
+    attclientResponse(4, 5, payload[0], 0);
+    if(attribute == NULL){
+        procedureCompleted(connectionInterval, payload[0], BLE112_ATT_INVALID_HANDLE, handle);
+        return;
+    }
+    attribute->value.assign(payload + 4, payload + 4 + payload[3]);
+    procedureCompleted(connectionInterval, payload[0], 0, handle);
+}
+
+/*! \fn void execute(const uint8_t *packet, uint8_t length)
+    \brief Answer a BGAPI command [0x00][payload length][class][command][payload]
+
+    A command shorter than its payload length is ignored.
+*/
+void Ble112Emulator::execute(const uint8_t *packet, uint8_t length){
+    const uint8_t *payload = packet + 4;
+    uint8_t classID = packet[2];
+    uint8_t id = packet[3];
+    uint8_t result[16];
+    uint64_t now = hostClock.getTime();
+    if(length < packet[1] + 4){
+        return;
+    }
+    commands++;
+    commandCount[classID << 8 | id]++;
+    if((classID == 4) && !connected){
+        attclientResponse(classID, id, payload[0], BLE112_NOT_CONNECTED);
+        return;
+    }
+    if((classID == 4) && (id == 1)){
+        readByGroupType(payload);
+    }else if((classID == 4) && (id == 2)){
+        readByType(payload);
+    }else if((classID == 4) && (id == 3)){
+        findInformation(payload);
+    }else if((classID == 4) && (id == 4)){
+        readByHandle(payload);
+    }else if((classID == 4) && (id == 5)){
+        attributeWrite(payload);
+    }else if((classID == 4) && (id == 8)){
+        readLong(payload);
+    }else if((classID == 6) && (id == 2)){
+        result[0] = 0;
+        result[1] = 0;
+        response(classID, id, result, 2);
+        scanning = 1;
+        nextAdvertising = ((availableTime > now) ? availableTime : now) + BLE112_ADVERTISING_INTERVAL;
+    }else if((classID == 6) && (id == 3)){
+        uint8_t available = (now >= availableTime) && (memcmp(payload, address, 6) == 0);
+        result[0] = 0;
+        result[1] = 0;
+        result[2] = 0;
+        response(classID, id, result, 3);
+        if(available){
+            uint8_t status[16] = {0, 0x05};
+            memcpy(status + 2, address, 6);
+            status[8] = 0;
+            status[9] = payload[7];
+            status[10] = payload[8];
+            status[11] = payload[11];
+            status[12] = payload[12];
+            status[13] = 0;
+            status[14] = 0;
+            status[15] = 0xFF;
+            event(BLE112_CONNECT_LATENCY, 3, 0, status, sizeof(status));
+            connected = 1;
+            nextHall = lastOutput + randomInterval(hallRate);
+            nextDisconnect = lastOutput + randomInterval(disconnectRate);
+        }
+    }else if((classID == 3) && (id == 7)){
+        uint8_t status[16] = {payload[0], (uint8_t)(connected ? 0x05 : 0x00)};
+        memcpy(status + 2, address, 6);
+        result[0] = payload[0];
+        response(classID, id, result, 1);
+        event(responseLatency, 3, 0, status, sizeof(status));
+    }else if((classID == 3) && (id == 0)){
+        uint8_t reason[3] = {payload[0], 0x16, 0x02};
+        result[0] = payload[0];
+        result[1] = connected ? 0 : (uint8_t)BLE112_NOT_CONNECTED;
+        result[2] = connected ? 0 : (uint8_t)(BLE112_NOT_CONNECTED >> 8);
+        response(classID, id, result, 3);
+        if(connected){
+            event(connectionInterval, 3, 4, reason, sizeof(reason));
+            connected = 0;
+        }
+    }else{
+        if((classID == 6) && (id == 4)){
+            scanning = 0;
+        }
+        result[0] = 0;
+        result[1] = 0;
+        response(classID, id, result, 2);
+    }
+}
+
+/*! \fn gattAttribute_t* hallAttribute()
+    \brief The value attribute of the Hall state, NULL if the database has none
+*/
+gattAttribute_t* Ble112Emulator::hallAttribute(){
+    for(size_t i = 0; i < database.size(); i++){
+        if(database[i].sensor == HALL_STATE_TYPE){
+            return &database[i];
+        }
+    }
+    return NULL;
+}
+
+/*! \fn uint8_t hallNotifying()
+    \brief 1 if the central has enabled the notifications of the Hall state (its CCCD follows the value)
+*/
+uint8_t Ble112Emulator::hallNotifying(){
+    gattAttribute_t *state = hallAttribute();
+    gattAttribute_t *cccd = (state != NULL) ? findAttribute(state->handle + 1) : NULL;
+    return (cccd != NULL) && isType(cccd, GATT_CCCD) && !cccd->value.empty() && (cccd->value[0] & 0x01);
+}
+
+/*! \fn uint64_t randomInterval(double rate)
+    \brief Exponential interval of a Poisson process
+    \param  rate Events per ms, 0 for never
+    \retval ms to the next event
+*/
+uint64_t Ble112Emulator::randomInterval(double rate){
+    if(rate <= 0){
+        return HOST_NEVER / 2;
+    }
+    return (uint64_t)std::exponential_distribution<double>(rate)(random) + 1;
+}
+
+/*! \fn void loseLink(uint64_t time)
+    \brief The link is lost at time: connection_disconnected (supervision timeout) and outage of the peripheral
+*/
+void Ble112Emulator::loseLink(uint64_t time){
+    uint8_t reason[3] = {0, 0x08, 0x02};
+    std::vector<uint8_t> packet;
+    packet.push_back(0x80);
+    packet.push_back(sizeof(reason));
+    packet.push_back(3);
+    packet.push_back(4);
+    packet.insert(packet.end(), reason, reason + sizeof(reason));
+    output.insert(std::make_pair(time, packet));
+    connected = 0;
+    availableTime = time + outage;
+    for(size_t i = 0; i < database.size(); i++){
+        if(isType(&database[i], GATT_CCCD)){
+            database[i].value.assign(2, 0);
+        }
+    }
+    disconnects++;
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS                                                           *
+ ******************************************************************************/
+
+/*! class constructor
+  Thunderboard Sense 2 "Thunder Sense #02735" 000b57a90aaf, without Hall events nor link losses,
+  with the default latencies
+  \param seed Seed of the random generator
+  \return void
+*/
+Ble112Emulator::Ble112Emulator(uint32_t seed) : random(seed){
+    lastOutput = 0;
+    connected = 0;
+    scanning = 0;
+    nextAdvertising = HOST_NEVER;
+    availableTime = 0;
+    hallRate = 0;
+    disconnectRate = 0;
+    outage = 0;
+    nextHall = HOST_NEVER;
+    nextDisconnect = HOST_NEVER;
+    hallState = 0;
+    notifications = 0;
+    disconnects = 0;
+    connectionInterval = BLE112_CONNECTION_INTERVAL;
+    responseLatency = BLE112_RESPONSE_LATENCY;
+    commands = 0;
+    bytesReceived = 0;
+    bytesSent = 0;
+    for(uint8_t i = 0; i <= FIELD_STRENGHT_TYPE; i++){
+        sensorValue[i] = sensorModel[i].initial;
+    }
+    setAddress("000b57a90aaf");
+    setName("Thunder Sense #02735");
+    buildThunderboard();
+}
+
+/*! \fn void setAddress(const char *mac)
+    \brief Set the address of the peripheral as 12 hexadecimal digits
+*/
+void Ble112Emulator::setAddress(const char *mac){
+    unsigned int byte;
+    for(uint8_t i = 0; i < 6; i++){
+        if(sscanf(mac + 2 * i, "%2x", &byte) == 1){
+            address[5 - i] = byte;
+        }
+    }
+}
+
+/*! \fn void setName(const char *localName)
+    \brief Set the complete local name advertised
+*/
+void Ble112Emulator::setName(const char *localName){
+    strncpy(name, localName, sizeof(name) - 1);
+    name[sizeof(name) - 1] = '\0';
+}
+
+/*! \fn void setHallEventsPerDay(double events)
+    \brief Set the mean number of Hall state changes per day
+*/
+void Ble112Emulator::setHallEventsPerDay(double events){
+    hallRate = events / MS_PER_DAY;
+}
+
+/*! \fn void setDisconnectsPerDay(double events, uint32_t outageSeconds)
+    \brief Set the mean number of link losses per day and the time the peripheral is not seen after each one
+*/
+void Ble112Emulator::setDisconnectsPerDay(double events, uint32_t outageSeconds){
+    disconnectRate = events / MS_PER_DAY;
+    outage = outageSeconds * 1000ULL;
+}
+
+/*! \fn uint16_t loadDatabase(const char *path)
+    \brief Replace the GATT database, and the settings given, with those of a description file
+    \param  path The description file (see Ble112Emulator.h)
+    \retval 0 if the file has been loaded, the number of the first wrong line otherwise
+             (BLE112_FILE_ERROR if it cannot be opened). The database is not changed if there is an error.
+*/
+uint16_t Ble112Emulator::loadDatabase(const char *path){
+    char line[DESCRIPTION_LINE_SIZE];
+    uint16_t lineNumber = 0;
+    std::vector<gattAttribute_t> previous = database;
+    FILE *file = fopen(path, "r");
+    if(file == NULL){
+        return BLE112_FILE_ERROR;
+    }
+    database.clear();
+    while(fgets(line, sizeof(line), file) != NULL){
+        lineNumber++;
+        line[strcspn(line, "\r\n")] = '\0';
+        for(size_t end = strlen(line); (end > 0) && isspace((unsigned char)line[end - 1]); end--){
+            line[end - 1] = '\0';
+        }
+        if(!parseDirective(line)){
+            fclose(file);
+            database = previous;
+            return lineNumber;
+        }
+    }
+    fclose(file);
+    if(database.empty()){
+        database = previous;
+        return lineNumber + 1;
+    }
+    return 0;
+}
+
+/*! \fn void setConnectionInterval(uint32_t ms)
+    \brief Set the ms between the events of a GATT procedure
+*/
+void Ble112Emulator::setConnectionInterval(uint32_t ms){
+    connectionInterval = ms;
+}
+
+/*! \fn void setResponseLatency(uint32_t ms)
+    \brief Set the ms from a command to its response, for the commands without a latency of their own
+*/
+void Ble112Emulator::setResponseLatency(uint32_t ms){
+    responseLatency = ms;
+}
+
+/*! \fn void setCommandLatency(uint8_t classID, uint8_t id, uint32_t ms)
+    \brief Set the ms from a command to its response
+*/
+void Ble112Emulator::setCommandLatency(uint8_t classID, uint8_t id, uint32_t ms){
+    commandLatency[classID << 8 | id] = ms;
+}
+
+/*! \fn void receive(const uint8_t *data, uint16_t length)
+    \brief Bytes written by the node: packet mode commands [length][0x00][payload length][class][command][payload]
+*/
+void Ble112Emulator::receive(const uint8_t *data, uint16_t length){
+    bytesReceived += length;
+    for(uint16_t i = 0; i < length; i++){
+        input.push_back(data[i]);
+        if((input.size() > 1) && (input.size() == (size_t)input[0] + 1)){
+            if(input.size() >= 5){
+                execute(&input[1], input.size() - 1);
+            }
+            input.clear();
+        }
+    }
+}
+
+/*! \fn void update(uint64_t now)
+    \brief Generate the spontaneous events due and deliver the packets due at now
+*/
+void Ble112Emulator::update(uint64_t now){
+    uint8_t scanResponse[64];
+    uint8_t nameLength = strlen(name);
+    while(scanning && (nextAdvertising <= now)){
+        scanResponse[0] = (uint8_t)(-60 - (int)(random() % 20));
+        scanResponse[1] = 0;
+        memcpy(scanResponse + 2, address, 6);
+        scanResponse[8] = 0;
+        scanResponse[9] = 0xFF;
+        scanResponse[10] = 5 + nameLength;
+        scanResponse[11] = 2;
+        scanResponse[12] = 0x01;
+        scanResponse[13] = 0x06;
+        scanResponse[14] = 1 + nameLength;
+        scanResponse[15] = 0x09;
+        memcpy(scanResponse + 16, name, nameLength);
+        std::vector<uint8_t> packet(4, 0);
+        packet[0] = 0x80;
+        packet[1] = 16 + nameLength;
+        packet[2] = 6;
+        packet[3] = 0;
+        packet.insert(packet.end(), scanResponse, scanResponse + 16 + nameLength);
+        output.insert(std::make_pair(nextAdvertising, packet));
+        nextAdvertising += BLE112_ADVERTISING_INTERVAL;
+    }
+    while(connected && ((nextHall <= now) || (nextDisconnect <= now))){
+        if(nextDisconnect <= nextHall){
+            loseLink(nextDisconnect);
+            nextHall = HOST_NEVER;
+            nextDisconnect = HOST_NEVER;
+        }else{
+            gattAttribute_t *state = hallAttribute();
+            hallState ^= 1;
+            if(hallNotifying()){
+                uint8_t notification[6] = {0, (uint8_t)state->handle, (uint8_t)(state->handle >> 8), 1, 1, hallState};
+                std::vector<uint8_t> packet;
+                packet.push_back(0x80);
+                packet.push_back(sizeof(notification));
+                packet.push_back(4);
+                packet.push_back(5);
+                packet.insert(packet.end(), notification, notification + sizeof(notification));
+                output.insert(std::make_pair(nextHall, packet));
+                notifications++;
+            }
+            nextHall += randomInterval(hallRate);
+        }
+    }
+    while(!output.empty() && (output.begin()->first <= now)){
+        uart->deliver(&output.begin()->second[0], output.begin()->second.size());
+        bytesSent += output.begin()->second.size();
+        output.erase(output.begin());
+    }
+}
+
+/*! \fn uint64_t nextActivity()
+    \brief Virtual time of the next packet: queued, scan response or spontaneous event
+*/
+uint64_t Ble112Emulator::nextActivity(){
+    uint64_t next = output.empty() ? HOST_NEVER : output.begin()->first;
+    if(scanning && (nextAdvertising < next)){
+        next = nextAdvertising;
+    }
+    if(connected && hallNotifying() && (nextHall < next)){
+        next = nextHall;
+    }
+    if(connected && (nextDisconnect < next)){
+        next = nextDisconnect;
+    }
+    return next;
+}
+
+/*! \fn uint8_t isConnected()
+    \brief 1 if the link is up
+*/
+uint8_t Ble112Emulator::isConnected(){
+    return connected;
+}
+
+/*! \fn uint32_t getNotifications()
+    \brief Number of Hall notifications sent
+*/
+uint32_t Ble112Emulator::getNotifications(){
+    return notifications;
+}
+
+/*! \fn uint32_t getDisconnects()
+    \brief Number of link losses injected
+*/
+uint32_t Ble112Emulator::getDisconnects(){
+    return disconnects;
+}
+
+/*! \fn uint16_t getAttributes()
+    \brief Number of attributes of the GATT database
+*/
+uint16_t Ble112Emulator::getAttributes(){
+    return database.size();
+}
+
+/*! \fn uint32_t getCommands()
+    \brief Number of commands received
+*/
+uint32_t Ble112Emulator::getCommands(){
+    return commands;
+}
+
+/*! \fn uint32_t getCommands(uint8_t classID, uint8_t id)
+    \brief Number of commands of a class and ID received
+*/
+uint32_t Ble112Emulator::getCommands(uint8_t classID, uint8_t id){
+    std::map<uint16_t, uint32_t>::iterator count = commandCount.find(classID << 8 | id);
+    return (count != commandCount.end()) ? count->second : 0;
+}
+
+/*! \fn uint64_t getBytesReceived()
+    \brief Number of bytes written by the node
+*/
+uint64_t Ble112Emulator::getBytesReceived(){
+    return bytesReceived;
+}
+
+/*! \fn uint64_t getBytesSent()
+    \brief Number of bytes delivered to the node
+*/
+uint64_t Ble112Emulator::getBytesSent(){
+    return bytesSent;
+}
+
+/*! \fn void resetCounters()
+    \brief Clear the command and byte counters
+*/
+void Ble112Emulator::resetCounters(){
+    commandCount.clear();
+    commands = 0;
+    bytesReceived = 0;
+    bytesSent = 0;
+}
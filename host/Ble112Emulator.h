@@ -0,0 +1,211 @@
+/*! \file Ble112Emulator.h
+    \brief Emulator of the BLE112 module connected to a Thunderboard Sense 2, attached to SOCKET0 in the host build
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    It answers the BGAPI commands sent by WaspBLE and BLECentral (packet mode, length prefix) with
+    BGAPI responses and events, timed on the virtual clock: a response UART latency after the
+    command and one connection interval between the events of a GATT procedure.
+
+    The peripheral serves the Thunderboard Sense 2 GATT database of defines.h, or the database of
+    a description file given to loadDatabase(). The sensor characteristics return a random walk of
+    typical values, the Hall state is notified at random times (Poisson process) and the link can
+    be lost at random times, after which the peripheral does not advertise during an outage.
+
+    Description file, one directive per line, the lines starting with '#' are comments:
+        service <uuid>
+        characteristic <uuid> <read,write,notify,indicate> [sensor <UplinkTypes_t>|value <hex>|text <string>]
+        name <local name>
+        address <12 hexadecimal digits>
+        interval <ms between the events of a GATT procedure>
+        latency [<class> <command>] <ms from the command to its response>
+    The UUIDs are 4 or 32 hexadecimal digits (dashes ignored), most significant first as in
+    defines.h, and the sensors are given by number or by name without _TYPE (TEMPERATURE).
+    The handles are assigned in order, as the BLE112 GATT compiler does.
+
+    The emulator counts the commands received, by class and ID, and the bytes in both directions,
+    so discovery and read strategies can be compared on the same virtual timeline.
+*/
+
+/*! \def _BLE112EMULATOR_H
+    \brief The library flag
+ */
+#ifndef _BLE112EMULATOR_H
+#define _BLE112EMULATOR_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+#include <map>
+#include <random>
+#include <vector>
+#include "HostUart.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define BLE112_RESPONSE_LATENCY 2/*!< Default ms from a command to its response */
+#define BLE112_CONNECTION_INTERVAL 75/*!< Default ms between the events of a GATT procedure (connectDirect() interval 60 * 1.25 ms) */
+#define BLE112_CONNECT_LATENCY 150/*!< ms from gap_connect_direct to the connection_status event */
+#define BLE112_ADVERTISING_INTERVAL 100/*!< ms between the scan responses of the peripheral */
+#define BLE112_ATT_MTU 23/*!< ATT MTU of the links, a read or a read blob returns up to BLE112_ATT_MTU - 1 bytes */
+#define BLE112_ATT_NOT_FOUND 0x040A/*!< ATT error: attribute not found */
+#define BLE112_ATT_INVALID_HANDLE 0x0401/*!< ATT error: invalid handle */
+#define BLE112_NOT_CONNECTED 0x0186/*!< BGAPI error: not connected */
+#define BLE112_FILE_ERROR 0xFFFF/*!< loadDatabase(): the file cannot be opened */
+
+/*! \struct gattAttribute_t
+    \brief  One attribute of the GATT database of the peripheral
+ */
+typedef struct {
+  uint16_t handle;/**< Attribute handle */
+  uint8_t type[16];/**< Attribute type (UUID), least significant byte first */
+  uint8_t typeLength;/**< 2 or 16 */
+  std::vector<uint8_t> value;/**< Value of a static attribute */
+  int8_t sensor;/**< UplinkTypes_t served by the attribute, -1 if the value is static */
+}gattAttribute_t;
+
+/******************************************************************************
+ * Class                                                                      *
+ ******************************************************************************/
+
+//! Ble112Emulator Class
+/*!
+  BLE112 central module and Thunderboard Sense 2 peripheral
+ */
+class Ble112Emulator : public HostDevice{
+
+/// private attributes //////////////
+private:
+
+    std::multimap<uint64_t, std::vector<uint8_t> > output;/*!< BGAPI packets to deliver, by virtual time */
+    std::vector<uint8_t> input;/*!< Bytes of the command being received */
+    std::vector<gattAttribute_t> database;/*!< GATT database of the peripheral */
+    uint64_t lastOutput;/*!< Virtual time of the last packet scheduled, the packets are delivered in order */
+    uint8_t address[6];/*!< bd_addr of the peripheral, least significant byte first */
+    char name[32];/*!< Complete local name advertised */
+    uint8_t connected;/*!< 1 if the link is up */
+    uint8_t scanning;/*!< 1 between gap_discover and gap_end_procedure */
+    uint64_t nextAdvertising;/*!< Virtual time of the next scan response while scanning */
+    uint64_t availableTime;/*!< The peripheral does not advertise before this virtual time (outage) */
+    double hallRate;/*!< Hall state changes per ms */
+    double disconnectRate;/*!< Link losses per ms */
+    uint64_t outage;/*!< ms without advertising after a link loss */
+    uint64_t nextHall;/*!< Virtual time of the next Hall state change */
+    uint64_t nextDisconnect;/*!< Virtual time of the next link loss */
+    uint8_t hallState;/*!< Current Hall state */
+    int32_t sensorValue[12];/*!< Random walk of each UplinkTypes_t */
+    uint32_t notifications;/*!< Notifications sent */
+    uint32_t disconnects;/*!< Link losses */
+    std::mt19937 random;/*!< Random generator of the run */
+    uint32_t connectionInterval;/*!< ms between the events of a GATT procedure */
+    uint32_t responseLatency;/*!< ms from a command to its response, if it is not in commandLatency */
+    std::map<uint16_t, uint32_t> commandLatency;/*!< ms from a command to its response, by class << 8 | command */
+    std::map<uint16_t, uint32_t> commandCount;/*!< Commands received, by class << 8 | command */
+    uint32_t commands;/*!< Commands received */
+    uint64_t bytesReceived;/*!< Bytes written by the node */
+    uint64_t bytesSent;/*!< Bytes delivered to the node */
+
+/// private methods //////////////////////////
+private:
+
+    void addService16(uint16_t uuid);
+
+    void addService128(const uint8_t *uuid);
+
+    void addCharacteristic(const uint8_t *uuid, uint8_t uuidLength, uint8_t properties, int8_t sensor);
+
+    void addCharacteristic16(uint16_t uuid, uint8_t properties, int8_t sensor);
+
+    void addCharacteristic128(const uint8_t *uuid, uint8_t properties, int8_t sensor);
+
+    void buildThunderboard();
+
+    uint8_t parseDirective(char *line);
+
+    gattAttribute_t* findAttribute(uint16_t handle);
+
+    uint16_t groupEnd(size_t index);
+
+    std::vector<uint8_t> readValue(gattAttribute_t *attribute);
+
+    uint64_t schedule(uint64_t delay, uint8_t type, uint8_t classID, uint8_t id, const uint8_t *payload, uint8_t length);
+
+    uint64_t response(uint8_t classID, uint8_t id, const uint8_t *payload, uint8_t length);
+
+    uint64_t event(uint64_t delay, uint8_t classID, uint8_t id, const uint8_t *payload, uint8_t length);
+
+    void attclientResponse(uint8_t classID, uint8_t id, uint8_t connection, uint16_t result);
+
+    uint64_t procedureCompleted(uint64_t delay, uint8_t connection, uint16_t result, uint16_t handle);
+
+    void execute(const uint8_t *packet, uint8_t length);
+
+    void readByGroupType(const uint8_t *payload);
+
+    void readByType(const uint8_t *payload);
+
+    void findInformation(const uint8_t *payload);
+
+    void readByHandle(const uint8_t *payload);
+
+    void readLong(const uint8_t *payload);
+
+    void attributeWrite(const uint8_t *payload);
+
+    gattAttribute_t* hallAttribute();
+
+    uint8_t hallNotifying();
+
+    uint64_t randomInterval(double rate);
+
+    void loseLink(uint64_t time);
+
+/// public methods ////////////
+public:
+
+    Ble112Emulator(uint32_t seed = 1);
+
+    void setAddress(const char *mac);
+
+    void setName(const char *localName);
+
+    void setHallEventsPerDay(double events);
+
+    void setDisconnectsPerDay(double events, uint32_t outageSeconds);
+
+    uint16_t loadDatabase(const char *path);
+
+    void setConnectionInterval(uint32_t ms);
+
+    void setResponseLatency(uint32_t ms);
+
+    void setCommandLatency(uint8_t classID, uint8_t id, uint32_t ms);
+
+    void receive(const uint8_t *data, uint16_t length);
+
+    void update(uint64_t now);
+
+    uint64_t nextActivity();
+
+    uint8_t isConnected();
+
+    uint32_t getNotifications();
+
+    uint32_t getDisconnects();
+
+    uint16_t getAttributes();
+
+    uint32_t getCommands();
+
+    uint32_t getCommands(uint8_t classID, uint8_t id);
+
+    uint64_t getBytesReceived();
+
+    uint64_t getBytesSent();
+
+    void resetCounters();
+};
+
+#endif
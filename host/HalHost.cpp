@@ -0,0 +1,118 @@
+/*! \file HalHost.cpp
+    \brief Hardware abstraction of the node: sleep, wake up interrupts, the tick counter and the memory use (host implementation)
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    halSleep() moves the virtual clock to the first wake up source: the RTC Alarm 1 or, if the
+    PCINT8 interrupt is enabled, the next byte of the device attached to SOCKET0.
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include "WaspClasses.h"
+#include "Hal.h"
+#include "HalHost.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define HOST_MAX_SLEEP 86400000ULL/*!< ms slept when there is no wake up source */
+#define HOST_BLE_UART 0/*!< SOCKET0 */
+
+static thread_local halCallback_t alarmCallback = NULL;/*!< Attached to the RTC alarm */
+static thread_local halCallback_t bleWakeUpCallback = NULL;/*!< Attached to PCINT8 */
+static thread_local uint8_t bleWakeUpEnabled = 0;/*!< PCINT8 enabled */
+static thread_local uint64_t sleepTime = 0;/*!< ms slept since the start of the run */
+static thread_local uint32_t alarmWakeUps = 0;/*!< Wake ups by the RTC alarm */
+static thread_local uint32_t bleWakeUps = 0;/*!< Wake ups by PCINT8 */
+
+/******************************************************************************
+ * FUNCTIONS                                                                  *
+ ******************************************************************************/
+
+void halAttachAlarm(halCallback_t callback){
+    alarmCallback = callback;
+}
+
+void halAttachBleWakeUp(halCallback_t callback){
+    bleWakeUpCallback = callback;
+}
+
+void halEnableBleWakeUp(){
+    bleWakeUpEnabled = 1;
+}
+
+void halDisableBleWakeUp(){
+    bleWakeUpEnabled = 0;
+}
+
+/*! \fn void halSleep()
+    \brief Let the virtual time pass until the first wake up source and call its callback
+*/
+void halSleep(){
+    uint64_t alarm = RTC.getAlarm1Time();
+    uint64_t ble = bleWakeUpEnabled ? hostUart[HOST_BLE_UART].nextActivity() : HOST_NEVER;
+    uint64_t start = hostClock.getTime();
+    uint64_t limit = start + HOST_MAX_SLEEP;
+    if((ble <= alarm) && (ble <= limit)){
+        hostClock.setTime(ble);
+        sleepTime += ble - start;
+        bleWakeUps++;
+        if(bleWakeUpCallback != NULL){
+            bleWakeUpCallback();
+        }
+    }else if(alarm <= limit){
+        hostClock.setTime(alarm);
+        sleepTime += alarm - start;
+        alarmWakeUps++;
+        RTC.clearAlarmFlag();
+        if(alarmCallback != NULL){
+            alarmCallback();
+        }
+    }else{
+        hostClock.setTime(limit);
+        sleepTime += HOST_MAX_SLEEP;
+    }
+}
+
+/*! \fn uint32_t halTicks()
+    \brief The virtual clock in HAL_TICKS_PER_MS ticks
+*/
+uint32_t halTicks(){
+    return (uint32_t)(hostClock.getTime() * HAL_TICKS_PER_MS);
+}
+
+/*! \fn void halPaintStack()
+    \brief Nothing, the RAM of the ATmega1281 is not modelled
+*/
+void halPaintStack(){
+}
+
+/*! \fn void halGetMemory(halMemory_t *memory)
+    \brief All the fields 0, the RAM of the ATmega1281 is not modelled (as freeMemory())
+*/
+void halGetMemory(halMemory_t *memory){
+    memset(memory, 0, sizeof(halMemory_t));
+}
+
+/*! \fn uint64_t halHostGetSleepTime()
+    \retval ms slept in halSleep() since the start of the run
+*/
+uint64_t halHostGetSleepTime(){
+    return sleepTime;
+}
+
+/*! \fn uint32_t halHostGetAlarmWakeUps()
+    \retval Wake ups by the RTC alarm since the start of the run
+*/
+uint32_t halHostGetAlarmWakeUps(){
+    return alarmWakeUps;
+}
+
+/*! \fn uint32_t halHostGetBleWakeUps()
+    \retval Wake ups by PCINT8 since the start of the run
+*/
+uint32_t halHostGetBleWakeUps(){
+    return bleWakeUps;
+}
@@ -0,0 +1,28 @@
+/*! \file HalHost.h
+    \brief Sleep accounting of the host implementation of the hardware abstraction (Hal.h)
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+*/
+
+/*! \def _HALHOST_H
+    \brief The library flag
+ */
+#ifndef _HALHOST_H
+#define _HALHOST_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+uint64_t halHostGetSleepTime();
+
+uint32_t halHostGetAlarmWakeUps();
+
+uint32_t halHostGetBleWakeUps();
+
+#endif
@@ -0,0 +1,52 @@
+/*! \file HostClock.cpp
+    \brief Virtual clock of the host build
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include "HostClock.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+thread_local HostClock hostClock = HostClock();
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS                                                           *
+ ******************************************************************************/
+
+/*! class constructor
+  The clock starts at 0
+  \param void
+  \return void
+*/
+HostClock::HostClock(){
+    now = 0;
+}
+
+/*! \fn uint64_t getTime()
+    \brief Return the virtual time
+    \retval ms since the start of the run
+*/
+uint64_t HostClock::getTime(){
+    return now;
+}
+
+/*! \fn void advance(uint64_t ms)
+    \brief Let ms of virtual time pass
+*/
+void HostClock::advance(uint64_t ms){
+    now += ms;
+}
+
+/*! \fn void setTime(uint64_t ms)
+    \brief Move the clock to ms, the clock never goes back
+*/
+void HostClock::setTime(uint64_t ms){
+    if(ms > now){
+        now = ms;
+    }
+}
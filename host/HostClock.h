@@ -0,0 +1,57 @@
+/*! \file HostClock.h
+    \brief Virtual clock of the host build
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    The host build does not wait: millis(), the RTC epoch and the UART timeouts follow this clock,
+    that only moves forward when the node waits (delay(), polling an empty UART, sleeping).
+    A day of operation runs in a fraction of a second.
+*/
+
+/*! \def _HOSTCLOCK_H
+    \brief The library flag
+ */
+#ifndef _HOSTCLOCK_H
+#define _HOSTCLOCK_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define HOST_EPOCH_START 1792281600UL/*!< RTC epoch at virtual time 0, 18/10/2026 00:00:00 UTC */
+#define HOST_NEVER 0xFFFFFFFFFFFFFFFFULL/*!< Virtual time of an activity that is not going to happen */
+
+/******************************************************************************
+ * Class                                                                      *
+ ******************************************************************************/
+
+//! HostClock Class
+/*!
+  Virtual time in ms since the start of the run
+ */
+class HostClock{
+
+/// private attributes //////////////
+private:
+
+    uint64_t now;/*!< Virtual time in ms */
+
+/// public methods ////////////
+public:
+
+    HostClock();
+
+    uint64_t getTime();
+
+    void advance(uint64_t ms);
+
+    void setTime(uint64_t ms);
+};
+
+extern thread_local HostClock hostClock;
+
+#endif
@@ -0,0 +1,175 @@
+/*! \file HostUart.cpp
+    \brief UARTs of the Waspmote sockets in the host build
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include "HostUart.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+thread_local HostUart hostUart[HOST_UARTS];
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS                                                           *
+ ******************************************************************************/
+
+/*! class constructor
+  The socket is empty and closed
+  \param void
+  \return void
+*/
+HostUart::HostUart(){
+    device = 0;
+    opened = 0;
+    bytesWritten = 0;
+    bytesRead = 0;
+    openedSince = 0;
+    openedTime = 0;
+    trace = 0;
+    socket = 0;
+}
+
+/*! \fn void attach(HostDevice *attachedDevice)
+    \brief Connect a device to the socket
+*/
+void HostUart::attach(HostDevice *attachedDevice){
+    device = attachedDevice;
+    if(device != 0){
+        device->attach(this);
+    }
+}
+
+/*! \fn void capture(UartTrace *captureTrace, uint8_t captureSocket)
+    \brief Record the bytes exchanged while the UART is opened
+    \param captureTrace The opened trace, NULL to stop capturing
+    \param captureSocket The socket of the UART in the records
+*/
+void HostUart::capture(UartTrace *captureTrace, uint8_t captureSocket){
+    trace = captureTrace;
+    socket = captureSocket;
+}
+
+/*! \fn void open()
+    \brief Open the UART, the bytes received while it was closed are lost
+*/
+void HostUart::open(){
+    if(!opened){
+        openedSince = hostClock.getTime();
+    }
+    opened = 1;
+    received.clear();
+}
+
+/*! \fn void close()
+    \brief Close the UART
+*/
+void HostUart::close(){
+    if(opened){
+        openedTime += hostClock.getTime() - openedSince;
+    }
+    opened = 0;
+}
+
+/*! \fn uint8_t isOpened()
+    \retval 1 if the UART is opened
+*/
+uint8_t HostUart::isOpened(){
+    return opened;
+}
+
+/*! \fn void deliver(const uint8_t *data, uint16_t length)
+    \brief Called by the device to send bytes to the node
+*/
+void HostUart::deliver(const uint8_t *data, uint16_t length){
+    if(opened){
+        received.insert(received.end(), data, data + length);
+        if(trace != 0){
+            trace->record(socket, UART_TRACE_TO_NODE, data, length);
+        }
+    }
+}
+
+/*! \fn int available()
+    \brief Bytes ready to be read, after letting the device deliver the bytes due at the current virtual time
+*/
+int HostUart::available(){
+    if(device != 0){
+        device->update(hostClock.getTime());
+    }
+    return (int)received.size();
+}
+
+/*! \fn int read()
+    \retval The next byte, -1 if there is none
+*/
+int HostUart::read(){
+    uint8_t byte;
+    if(available() == 0){
+        return -1;
+    }
+    byte = received.front();
+    received.pop_front();
+    bytesRead++;
+    return byte;
+}
+
+/*! \fn void write(const uint8_t *data, uint16_t length)
+    \brief Send bytes to the device
+*/
+void HostUart::write(const uint8_t *data, uint16_t length){
+    bytesWritten += length;
+    if(opened && (trace != 0)){
+        trace->record(socket, UART_TRACE_TO_MODULE, data, length);
+    }
+    if(opened && (device != 0)){
+        device->receive(data, length);
+    }
+}
+
+/*! \fn void flush()
+    \brief Discard the bytes received
+*/
+void HostUart::flush(){
+    available();
+    received.clear();
+}
+
+/*! \fn uint64_t nextActivity()
+    \brief Virtual time of the next byte to be received
+    \retval The current time if there are bytes to read, HOST_NEVER if nothing is expected
+*/
+uint64_t HostUart::nextActivity(){
+    if(!received.empty()){
+        return hostClock.getTime();
+    }
+    if(device == 0){
+        return HOST_NEVER;
+    }
+    return device->nextActivity();
+}
+
+/*! \fn uint32_t getBytesWritten()
+    \retval Bytes written by the node since the start of the run
+*/
+uint32_t HostUart::getBytesWritten(){
+    return bytesWritten;
+}
+
+/*! \fn uint32_t getBytesRead()
+    \retval Bytes read by the node since the start of the run
+*/
+uint32_t HostUart::getBytesRead(){
+    return bytesRead;
+}
+
+/*! \fn uint64_t getOpenedTime()
+    \retval ms the UART has been opened since the start of the run
+*/
+uint64_t HostUart::getOpenedTime(){
+    return openedTime + (opened ? hostClock.getTime() - openedSince : 0);
+}
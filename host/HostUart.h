@@ -0,0 +1,119 @@
+/*! \file HostUart.h
+    \brief UARTs of the Waspmote sockets in the host build
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    The bytes written by the node are handed to the HostDevice attached to the socket (the module
+    emulator), and the bytes of the device are queued with the virtual time they arrive at. Without
+    a device the writes are discarded and nothing is ever received, as with an empty socket.
+    With capture() the bytes that go through the opened UART are recorded in a UartTrace.
+*/
+
+/*! \def _HOSTUART_H
+    \brief The library flag
+ */
+#ifndef _HOSTUART_H
+#define _HOSTUART_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+#include <deque>
+#include "HostClock.h"
+#include "UartTrace.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define HOST_UARTS 2/*!< SOCKET0 (BLE module) and SOCKET1 (LoRaWAN module) */
+
+class HostUart;
+
+//! HostDevice Class
+/*!
+  A module connected to a socket
+ */
+class HostDevice{
+
+/// protected attributes //////////////
+protected:
+
+    HostUart *uart;/*!< The UART the device is attached to */
+
+/// public methods ////////////
+public:
+
+    HostDevice(){ uart = 0; }
+
+    virtual ~HostDevice(){}
+
+    virtual void attach(HostUart *attachedUart){ uart = attachedUart; }
+
+    virtual void receive(const uint8_t *data, uint16_t length) = 0;/*!< Bytes written by the node */
+
+    virtual void update(uint64_t now){ (void)now; }/*!< Deliver through uart the bytes due at now */
+
+    virtual uint64_t nextActivity(){ return HOST_NEVER; }/*!< Virtual time of the next byte to deliver */
+};
+
+/******************************************************************************
+ * Class                                                                      *
+ ******************************************************************************/
+
+//! HostUart Class
+/*!
+  One socket UART
+ */
+class HostUart{
+
+/// private attributes //////////////
+private:
+
+    HostDevice *device;/*!< The device attached, NULL if the socket is empty */
+    std::deque<uint8_t> received;/*!< Bytes of the device not read yet by the node */
+    uint8_t opened;/*!< 1 between beginSerial() and closeSerial() */
+    uint32_t bytesWritten;/*!< Bytes written by the node */
+    uint32_t bytesRead;/*!< Bytes read by the node */
+    uint64_t openedSince;/*!< Virtual time of the last open() */
+    uint64_t openedTime;/*!< ms opened before the last open(), the time the module has been powered */
+    UartTrace *trace;/*!< Capture of the bytes exchanged, NULL if not capturing */
+    uint8_t socket;/*!< Socket recorded in the trace */
+
+/// public methods ////////////
+public:
+
+    HostUart();
+
+    void attach(HostDevice *attachedDevice);
+
+    void capture(UartTrace *captureTrace, uint8_t captureSocket);
+
+    void open();
+
+    void close();
+
+    uint8_t isOpened();
+
+    void deliver(const uint8_t *data, uint16_t length);
+
+    int available();
+
+    int read();
+
+    void write(const uint8_t *data, uint16_t length);
+
+    void flush();
+
+    uint64_t nextActivity();
+
+    uint32_t getBytesWritten();
+
+    uint32_t getBytesRead();
+
+    uint64_t getOpenedTime();
+};
+
+extern thread_local HostUart hostUart[HOST_UARTS];
+
+#endif
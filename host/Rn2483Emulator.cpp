@@ -0,0 +1,552 @@
+/*! \file Rn2483Emulator.cpp
+    \brief Emulator of the RN2483 LoRaWAN module and of its network, attached to SOCKET1 in the host build
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "Rn2483Emulator.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+
+/*! \var defaultParameters
+    \brief "mac get" key and value of the RN2483 after a factory reset (EU868)
+ */
+static const char *defaultParameters[][2] = {
+    {"adr", "off"}, {"ar", "off"}, {"dr", "5"}, {"pwridx", "1"}, {"retx", "7"},
+    {"devaddr", "00000000"}, {"rxdelay1", "1000"}, {"rxdelay2", "2000"}, {"rx2", "0 869525000"},
+    {"ch freq 0", "868100000"}, {"ch freq 1", "868300000"}, {"ch freq 2", "868500000"}
+};
+
+/*! \var maxPayload
+    \brief Longest application payload of each EU868 data rate
+ */
+static const uint8_t maxPayload[6] = {51, 51, 51, 115, 222, 222};
+
+/*! \var defaultLatency
+    \brief Approximate processing time in ms of the commands of the RN2483 firmware, by command prefix
+ */
+static const struct {
+  const char *prefix;
+  uint32_t ms;
+}defaultLatency[] = {
+    {"sys get ver", 3}, {"mac get", 3}, {"mac set", 4}, {"mac save", 185},
+    {"mac join", 10}, {"mac tx", 12}
+};
+
+/*! \fn static uint32_t serialTime(size_t characters)
+    \brief ms to transfer characters over the UART of the module, rounded up
+*/
+static uint32_t serialTime(size_t characters){
+    return (characters * 10 * 1000 + RN2483_BAUD_RATE - 1) / RN2483_BAUD_RATE;
+}
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS                                                          *
+ ******************************************************************************/
+
+/*! \fn void answer(uint64_t delay, const std::string &line)
+    \brief Queue an answer line delay ms after the previous one
+*/
+void Rn2483Emulator::answer(uint64_t delay, const std::string &line){
+    uint64_t now = hostClock.getTime();
+    lastOutput = ((lastOutput > now) ? lastOutput : now) + delay + serialTime(line.size() + 2);
+    output.insert(std::make_pair(lastOutput, line + "\r\n"));
+}
+
+/*! \fn void reply(const std::string &line)
+    \brief Queue the first answer of the current command
+*/
+void Rn2483Emulator::reply(const std::string &line){
+    answer(latency, line);
+}
+
+/*! \fn uint32_t processingTime(const std::string &line)
+    \brief ms from the first character of a command to its first answer: transfer and processing
+*/
+uint32_t Rn2483Emulator::processingTime(const std::string &line){
+    uint32_t ms = RN2483_COMMAND_LATENCY;
+    size_t longest = 0;
+    for(std::map<std::string, uint32_t>::iterator entry = commandLatency.begin(); entry != commandLatency.end(); entry++){
+        if((entry->first.size() > longest) && (line.compare(0, entry->first.size(), entry->first) == 0)){
+            longest = entry->first.size();
+            ms = entry->second;
+        }
+    }
+    return serialTime(line.size() + 2) + ms;
+}
+
+/*! \fn std::string commandName(const std::string &line)
+    \brief The command without its arguments: three words, four for the channel parameters ("mac set ch freq")
+*/
+std::string Rn2483Emulator::commandName(const std::string &line){
+    uint8_t words = ((line.compare(0, 11, "mac set ch ") == 0) || (line.compare(0, 11, "mac get ch ") == 0)) ? 4 : 3;
+    size_t end = 0;
+    for(uint8_t i = 0; (i < words) && (end != std::string::npos); i++){
+        end = line.find(' ', (i == 0) ? 0 : end + 1);
+    }
+    return line.substr(0, end);
+}
+
+/*! \fn int8_t freeChannel(uint64_t time)
+    \brief A random channel enabled for the data rate and within its duty cycle at time, -1 if there is not
+*/
+int8_t Rn2483Emulator::freeChannel(uint64_t time){
+    int8_t free[RN2483_CHANNELS];
+    uint8_t count = 0;
+    unsigned int minimum;
+    unsigned int maximum;
+    char key[24];
+    for(uint8_t channel = 0; channel < RN2483_CHANNELS; channel++){
+        snprintf(key, sizeof(key), "ch status %u", channel);
+        if((parameter(key) != "on") || (channelFree[channel] > time)){
+            continue;
+        }
+        snprintf(key, sizeof(key), "ch freq %u", channel);
+        if(parameter(key) == "0"){
+            continue;
+        }
+        snprintf(key, sizeof(key), "ch drrange %u", channel);
+        if((sscanf(parameter(key).c_str(), "%u %u", &minimum, &maximum) == 2) && (dataRate() >= minimum) && (dataRate() <= maximum)){
+            free[count++] = channel;
+        }
+    }
+    return (count == 0) ? -1 : free[std::uniform_int_distribution<int>(0, count - 1)(random)];
+}
+
+/*! \fn uint64_t channelAvailable()
+    \brief Virtual time the first enabled channel leaves its duty cycle off time
+*/
+uint64_t Rn2483Emulator::channelAvailable(){
+    uint64_t first = HOST_NEVER;
+    for(uint8_t channel = 0; channel < RN2483_CHANNELS; channel++){
+        if((channelFree[channel] < first) && (freeChannel(channelFree[channel]) >= 0)){
+            first = channelFree[channel];
+        }
+    }
+    return first;
+}
+
+/*! \fn std::string parameter(const std::string &key)
+    \brief The value of a parameter, the default one of the channels not set
+*/
+std::string Rn2483Emulator::parameter(const std::string &key){
+    std::map<std::string, std::string>::iterator found = parameters.find(key);
+    unsigned int channel;
+    if(found != parameters.end()){
+        return found->second;
+    }
+    if(sscanf(key.c_str(), "ch dcycle %u", &channel) == 1){
+        return (channel < 3) ? "302" : "65535";
+    }
+    if(sscanf(key.c_str(), "ch drrange %u", &channel) == 1){
+        return "0 5";
+    }
+    if(sscanf(key.c_str(), "ch status %u", &channel) == 1){
+        return (channel < 3) ? "on" : "off";
+    }
+    if(sscanf(key.c_str(), "ch freq %u", &channel) == 1){
+        return "0";
+    }
+    return "";
+}
+
+/*! \fn void setParameter(const std::string &arguments)
+    \brief "mac set <key> <value>", the value of "ch drrange" and "rx2" has two words
+*/
+void Rn2483Emulator::setParameter(const std::string &arguments){
+    size_t split = arguments.rfind(' ');
+    if((arguments.compare(0, 11, "ch drrange ") == 0) || (arguments.compare(0, 4, "rx2 ") == 0)){
+        split = (split == std::string::npos) ? split : arguments.rfind(' ', split - 1);
+    }
+    if((split == std::string::npos) || (split == 0)){
+        reply("invalid_param");
+        return;
+    }
+    parameters[arguments.substr(0, split)] = arguments.substr(split + 1);
+    reply("ok");
+}
+
+/*! \fn void getParameter(const std::string &key)
+    \brief "mac get <key>", "rx2" takes the band as argument
+*/
+void Rn2483Emulator::getParameter(const std::string &key){
+    char text[16];
+    std::string value;
+    if(key == "upctr"){
+        snprintf(text, sizeof(text), "%lu", (unsigned long)upCounter);
+        value = text;
+    }else if(key == "dnctr"){
+        snprintf(text, sizeof(text), "%lu", (unsigned long)downCounter);
+        value = text;
+    }else if(key == "gwnb"){
+        value = "1";
+    }else if(key.compare(0, 4, "rx2 ") == 0){
+        value = parameter("rx2");
+    }else{
+        value = parameter(key);
+    }
+    reply(value.empty() ? "invalid_param" : value);
+}
+
+/*! \fn uint8_t dataRate()
+    \brief The data rate of the uplinks, DR0 (SF12) to DR5 (SF7)
+*/
+uint8_t Rn2483Emulator::dataRate(){
+    unsigned int dr = 5;
+    sscanf(parameter("dr").c_str(), "%u", &dr);
+    return (dr > 5) ? 5 : dr;
+}
+
+/*! \fn void localUplink(uint8_t confirmed, rn2483Reception_t *reception)
+    \brief Outcome of a transmission without network: loss probability and the local downlink queue
+*/
+void Rn2483Emulator::localUplink(uint8_t confirmed, rn2483Reception_t *reception){
+    reception->received = !std::bernoulli_distribution(lossProbability)(random);
+    reception->hasData = reception->received && !downlinks.empty();
+    reception->window = (reception->received && (confirmed || reception->hasData)) ? 1 : 0;
+    reception->airtime = 0;
+    if(reception->hasData){
+        reception->downlink = downlinks.front();
+        reception->airtime = timeOnAir(dataRate(), reception->downlink.data.size() / 2);
+        downlinks.pop_front();
+    }else if(reception->window != 0){
+        reception->airtime = timeOnAir(dataRate(), 0);
+    }
+}
+
+/*! \fn void transmit(uint8_t confirmed, unsigned int port, const std::string &data)
+    \brief "mac tx": transmissions, RX windows and the final answer
+*/
+void Rn2483Emulator::transmit(uint8_t confirmed, unsigned int port, const std::string &data){
+    unsigned int retries = 7;
+    unsigned int rx1Delay = 1000;
+    unsigned int rx2Delay = 2000;
+    uint16_t length = data.size() / 2;
+    uint32_t air = timeOnAir(dataRate(), length);
+    uint64_t now = hostClock.getTime();
+    uint64_t start;
+    uint64_t elapsed = 0;
+    uint8_t received = 0;
+    int8_t channel = -1;
+    unsigned int offTime;
+    rn2483Reception_t reception;
+    char text[24];
+    if(!joined){
+        reply("not_joined");
+        return;
+    }
+    if(((data.size() % 2) != 0) || (port < 1) || (port > 223)){
+        reply("invalid_param");
+        return;
+    }
+    if(length > maxPayload[dataRate()]){
+        reply("invalid_data_len");
+        return;
+    }
+    if(dutyCycle && (freeChannel(now + latency) < 0)){
+        noFreeChannel++;
+        reply("no_free_ch");
+        return;
+    }
+    sscanf(parameter("retx").c_str(), "%u", &retries);
+    sscanf(parameter("rxdelay1").c_str(), "%u", &rx1Delay);
+    rx2Delay = rx1Delay + 1000;
+    reply("ok");
+    start = (lastOutput > now) ? lastOutput : now;
+    uplinks++;
+    payloadBytes += length;
+    for(unsigned int attempt = 0; attempt <= (confirmed ? retries : 0); attempt++){
+        if(attempt > 0){
+            elapsed += RN2483_ACK_TIMEOUT;
+        }
+        if(dutyCycle){
+            while((channel = freeChannel(start + elapsed)) < 0){
+                elapsed = channelAvailable() - start;
+            }
+            offTime = 302;
+            snprintf(text, sizeof(text), "ch dcycle %d", channel);
+            sscanf(parameter(text).c_str(), "%u", &offTime);
+            channelFree[channel] = start + elapsed + (uint64_t)air * (offTime + 1);
+        }
+        transmissions++;
+        if(network != NULL){
+            network->uplink(start + elapsed, air, confirmed, upCounter, &reception);
+        }else{
+            localUplink(confirmed, &reception);
+        }
+        txTime += air;
+        elapsed += air;
+        if(reception.received && !received){
+            delivered++;
+            deliveredBytes += length;
+            received = 1;
+        }
+        if(reception.window == 1){
+            rxTime += reception.airtime;
+            elapsed += rx1Delay + reception.airtime;
+            break;
+        }
+        rxTime += RN2483_RX_WINDOW;
+        if(reception.window == 2){
+            rxTime += reception.airtime;
+            elapsed += rx2Delay + reception.airtime;
+            break;
+        }
+        rxTime += RN2483_RX_WINDOW;
+        elapsed += rx2Delay + RN2483_RX_WINDOW;
+        if(!confirmed){
+            break;
+        }
+    }
+    upCounter++;
+    if(confirmed && (reception.window == 0)){
+        answer(elapsed, "mac_err");
+    }else if(reception.hasData){
+        snprintf(text, sizeof(text), "mac_rx %u ", reception.downlink.port);
+        answer(elapsed, text + reception.downlink.data);
+        downCounter++;
+        downlinksReceived++;
+    }else{
+        answer(elapsed, "mac_tx_ok");
+    }
+}
+
+/*! \fn void execute(const std::string &line)
+    \brief Answer a command line
+*/
+void Rn2483Emulator::execute(const std::string &line){
+    char mode[8];
+    unsigned int port;
+    int offset = 0;
+    commands++;
+    commandCount[commandName(line)]++;
+    latency = processingTime(line);
+    if(line == "sys get ver"){
+        reply("RN2483 1.0.5 Oct 31 2018 15:06:52");
+    }else if(line.compare(0, 8, "mac set ") == 0){
+        setParameter(line.substr(8));
+    }else if(line.compare(0, 8, "mac get ") == 0){
+        getParameter(line.substr(8));
+    }else if(line == "mac save"){
+        reply("ok");
+    }else if(line == "mac join otaa"){
+        reply("ok");
+        txTime += timeOnAir(dataRate(), 23 - RN2483_FRAME_OVERHEAD);
+        rxTime += RN2483_RX_WINDOW;
+        answer(RN2483_JOIN_ACCEPT_DELAY, "accepted");
+        joined = 1;
+    }else if(line == "mac join abp"){
+        reply("ok");
+        answer(RN2483_COMMAND_LATENCY, "accepted");
+        joined = 1;
+    }else if(sscanf(line.c_str(), "mac tx %7s %u %n", mode, &port, &offset) == 2){
+        transmit(strcmp(mode, "cnf") == 0, port, line.substr(offset));
+    }else{
+        reply("invalid_param");
+    }
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS                                                           *
+ ******************************************************************************/
+
+/*! class constructor
+  Factory settings, not joined, without losses and without duty cycle limit
+  \param seed Seed of the random generator
+  \return void
+*/
+Rn2483Emulator::Rn2483Emulator(uint32_t seed) : random(seed){
+    lastOutput = 0;
+    joined = 0;
+    lossProbability = 0;
+    upCounter = 0;
+    downCounter = 0;
+    uplinks = 0;
+    transmissions = 0;
+    delivered = 0;
+    payloadBytes = 0;
+    downlinksReceived = 0;
+    txTime = 0;
+    rxTime = 0;
+    network = NULL;
+    deliveredBytes = 0;
+    noFreeChannel = 0;
+    latency = RN2483_COMMAND_LATENCY;
+    commands = 0;
+    bytesReceived = 0;
+    bytesSent = 0;
+    dutyCycle = 0;
+    for(uint8_t channel = 0; channel < RN2483_CHANNELS; channel++){
+        channelFree[channel] = 0;
+    }
+    for(uint8_t i = 0; i < sizeof(defaultLatency) / sizeof(defaultLatency[0]); i++){
+        commandLatency[defaultLatency[i].prefix] = defaultLatency[i].ms;
+    }
+    for(uint8_t i = 0; i < sizeof(defaultParameters) / sizeof(defaultParameters[0]); i++){
+        parameters[defaultParameters[i][0]] = defaultParameters[i][1];
+    }
+}
+
+/*! \fn void setLossProbability(double probability)
+    \brief Set the probability of losing each transmission (uplink or its acknowledgement)
+*/
+void Rn2483Emulator::setLossProbability(double probability){
+    lossProbability = probability;
+}
+
+/*! \fn void setNetwork(Rn2483Network *uplinkNetwork)
+    \brief Resolve the transmissions with a shared channel and network server instead of the loss probability
+*/
+void Rn2483Emulator::setNetwork(Rn2483Network *uplinkNetwork){
+    network = uplinkNetwork;
+}
+
+/*! \fn void queueDownlink(uint8_t port, const char *data)
+    \brief Queue a downlink in the network server, sent after the next uplink received
+    \param  port  FPort
+    \param  data  Payload as hexadecimal digits
+*/
+void Rn2483Emulator::queueDownlink(uint8_t port, const char *data){
+    rn2483Downlink_t downlink;
+    downlink.port = port;
+    downlink.data = data;
+    downlinks.push_back(downlink);
+}
+
+/*! \fn void setCommandLatency(const char *prefix, uint32_t ms)
+    \brief Set the processing time of the commands starting with prefix ("mac save"), the longest prefix applies
+*/
+void Rn2483Emulator::setCommandLatency(const char *prefix, uint32_t ms){
+    commandLatency[prefix] = ms;
+}
+
+/*! \fn void setDutyCycle(uint8_t enabled)
+    \brief Enforce the duty cycle of the channels ("ch dcycle") as the RN2483 does, 0 to transmit at any time
+*/
+void Rn2483Emulator::setDutyCycle(uint8_t enabled){
+    dutyCycle = enabled;
+}
+
+/*! \fn void receive(const uint8_t *data, uint16_t length)
+    \brief Characters written by the node, each command ends with "\r\n"
+*/
+void Rn2483Emulator::receive(const uint8_t *data, uint16_t length){
+    bytesReceived += length;
+    for(uint16_t i = 0; i < length; i++){
+        if(data[i] == '\n'){
+            execute(input);
+            input.clear();
+        }else if(data[i] != '\r'){
+            input.push_back(data[i]);
+        }
+    }
+}
+
+/*! \fn void update(uint64_t now)
+    \brief Deliver the answers due at now
+*/
+void Rn2483Emulator::update(uint64_t now){
+    while(!output.empty() && (output.begin()->first <= now)){
+        uart->deliver((const uint8_t *)output.begin()->second.data(), output.begin()->second.size());
+        bytesSent += output.begin()->second.size();
+        output.erase(output.begin());
+    }
+}
+
+/*! \fn uint64_t nextActivity()
+    \brief Virtual time of the next answer
+*/
+uint64_t Rn2483Emulator::nextActivity(){
+    return output.empty() ? HOST_NEVER : output.begin()->first;
+}
+
+uint32_t Rn2483Emulator::getUplinks(){
+    return uplinks;
+}
+
+uint32_t Rn2483Emulator::getTransmissions(){
+    return transmissions;
+}
+
+uint32_t Rn2483Emulator::getDelivered(){
+    return delivered;
+}
+
+uint32_t Rn2483Emulator::getPayloadBytes(){
+    return payloadBytes;
+}
+
+uint32_t Rn2483Emulator::getDownlinks(){
+    return downlinksReceived;
+}
+
+uint64_t Rn2483Emulator::getTxTime(){
+    return txTime;
+}
+
+uint64_t Rn2483Emulator::getRxTime(){
+    return rxTime;
+}
+
+uint32_t Rn2483Emulator::getDeliveredBytes(){
+    return deliveredBytes;
+}
+
+uint32_t Rn2483Emulator::getNoFreeChannel(){
+    return noFreeChannel;
+}
+
+uint32_t Rn2483Emulator::getCommands(){
+    return commands;
+}
+
+/*! \fn const std::map<std::string, uint32_t>& getCommandCounts()
+    \brief Commands received by name ("mac set ch status")
+*/
+const std::map<std::string, uint32_t>& Rn2483Emulator::getCommandCounts(){
+    return commandCount;
+}
+
+uint64_t Rn2483Emulator::getBytesReceived(){
+    return bytesReceived;
+}
+
+uint64_t Rn2483Emulator::getBytesSent(){
+    return bytesSent;
+}
+
+/*! \fn void resetCounters()
+    \brief Clear the command and byte counters
+*/
+void Rn2483Emulator::resetCounters(){
+    commandCount.clear();
+    commands = 0;
+    bytesReceived = 0;
+    bytesSent = 0;
+}
+
+/*! \fn uint32_t timeOnAir(uint8_t dataRate, uint16_t payloadLength)
+    \brief Time on air of an uplink (Semtech AN1200.13)
+    \param  dataRate       EU868 DR0 (SF12) to DR5 (SF7), 125 kHz
+    \param  payloadLength  Application payload bytes, the frame overhead is added
+    \retval ms on air
+*/
+uint32_t Rn2483Emulator::timeOnAir(uint8_t dataRate, uint16_t payloadLength){
+    int sf = 12 - ((dataRate > 5) ? 5 : dataRate);
+    int lowDataRate = (sf >= 11) ? 1 : 0;
+    double symbol = (double)(1 << sf) / 125.0;
+    double bits = 8.0 * (payloadLength + RN2483_FRAME_OVERHEAD) - 4.0 * sf + 28 + 16;
+    double symbols = ceil(bits / (4.0 * (sf - 2 * lowDataRate))) * 5;
+    if(symbols < 0){
+        symbols = 0;
+    }
+    return (uint32_t)ceil((8 + 4.25 + 8 + symbols) * symbol);
+}
@@ -0,0 +1,205 @@
+/*! \file Rn2483Emulator.h
+    \brief Emulator of the RN2483 LoRaWAN module and of its network, attached to SOCKET1 in the host build
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    It answers the ASCII commands sent by WaspLoRaWAN, timed on the virtual clock: each answer comes
+    after the command processing time of the module (per command, setCommandLatency()) and the
+    transfer of the command and of the answer over the 57600 bps UART. "mac tx" is
+    answered with "ok" and, after the time on air and the RX windows, with "mac_tx_ok", "mac_rx" if
+    a downlink is queued, or "mac_err" if a confirmed uplink is not acknowledged after its retries.
+    Each transmission is lost with a fixed probability, or resolved by an Rn2483Network (channel,
+    gateway and network server shared by several nodes). The time on air follows the LoRa
+    modulation (EU868, 125 kHz, coding rate 4/5, explicit header and CRC). With setDutyCycle() the
+    uplinks use the enabled channels within their "ch dcycle" limit, "no_free_ch" otherwise.
+
+    The emulator counts the commands received, by name ("mac set dr", "mac tx"...), and the bytes
+    in both directions, so uplink paths can be compared by command count and module time.
+*/
+
+/*! \def _RN2483EMULATOR_H
+    \brief The library flag
+ */
+#ifndef _RN2483EMULATOR_H
+#define _RN2483EMULATOR_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+#include <deque>
+#include <map>
+#include <random>
+#include <string>
+#include "HostUart.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define RN2483_COMMAND_LATENCY 5/*!< ms to process a command without a latency of its own */
+#define RN2483_BAUD_RATE 57600/*!< bps of the UART, 10 bits per character */
+#define RN2483_CHANNELS 16/*!< Channels of the EU868 band plan */
+#define RN2483_RX_WINDOW 25/*!< ms the receiver stays open in an RX window without a downlink */
+#define RN2483_JOIN_ACCEPT_DELAY 5000/*!< ms from the join request to the join accept (JOIN_ACCEPT_DELAY1) */
+#define RN2483_ACK_TIMEOUT 2000/*!< ms between the retransmissions of a confirmed uplink */
+#define RN2483_FRAME_OVERHEAD 13/*!< Bytes of the PHY payload that are not the application payload */
+
+/*! \struct rn2483Downlink_t
+    \brief  Downlink queued in the network server
+ */
+typedef struct {
+  uint8_t port;/**< FPort */
+  std::string data;/**< Payload as hexadecimal digits */
+}rn2483Downlink_t;
+
+/*! \struct rn2483Reception_t
+    \brief  Outcome of one transmission of an uplink
+ */
+typedef struct {
+  uint8_t received;/**< The network has received the uplink */
+  uint8_t window;/**< RX window of the answer (acknowledgement and/or downlink): 1, 2, 0 if none */
+  uint32_t airtime;/**< ms on air of the answer */
+  uint8_t hasData;/**< The answer carries downlink */
+  rn2483Downlink_t downlink;/**< The downlink if hasData */
+}rn2483Reception_t;
+
+/******************************************************************************
+ * Class                                                                      *
+ ******************************************************************************/
+
+//! Rn2483Network Class
+/*!
+  Radio channel, gateway and network server seen by one module. Without it the emulator loses
+  each transmission with its loss probability and answers with its own downlink queue.
+ */
+class Rn2483Network{
+
+/// public methods ////////////
+public:
+
+    virtual ~Rn2483Network(){}
+
+    virtual void uplink(uint64_t start, uint32_t airtime, uint8_t confirmed, uint32_t counter,
+                        rn2483Reception_t *reception) = 0;/*!< Resolve a transmission starting at start */
+};
+
+//! Rn2483Emulator Class
+/*!
+  RN2483 module, gateway and network server
+ */
+class Rn2483Emulator : public HostDevice{
+
+/// private attributes //////////////
+private:
+
+    std::multimap<uint64_t, std::string> output;/*!< Answer lines to deliver, by virtual time */
+    std::string input;/*!< Characters of the command being received */
+    std::map<std::string, std::string> parameters;/*!< Values of "mac set", by "mac get" key */
+    std::deque<rn2483Downlink_t> downlinks;/*!< Downlinks queued in the network server */
+    uint64_t lastOutput;/*!< Virtual time of the last line scheduled */
+    uint8_t joined;/*!< 1 after a join accepted */
+    double lossProbability;/*!< Probability of losing each transmission */
+    uint32_t upCounter;/*!< Uplink frame counter */
+    uint32_t downCounter;/*!< Downlink frame counter */
+    uint32_t uplinks;/*!< "mac tx" transmitted */
+    uint32_t transmissions;/*!< Transmissions, retransmissions included */
+    uint32_t delivered;/*!< Uplinks received by the network server */
+    uint32_t payloadBytes;/*!< Application bytes of the uplinks */
+    uint32_t downlinksReceived;/*!< Downlinks delivered to the node */
+    uint64_t txTime;/*!< ms transmitting */
+    uint64_t rxTime;/*!< ms with the receiver open */
+    uint32_t deliveredBytes;/*!< Application bytes of the uplinks received by the network server */
+    uint32_t noFreeChannel;/*!< "mac tx" answered with no_free_ch */
+    uint32_t latency;/*!< ms from the end of the current command to its first answer */
+    std::map<std::string, uint32_t> commandLatency;/*!< ms to process the commands, by command prefix */
+    std::map<std::string, uint32_t> commandCount;/*!< Commands received, by name */
+    uint32_t commands;/*!< Commands received */
+    uint64_t bytesReceived;/*!< Bytes written by the node */
+    uint64_t bytesSent;/*!< Bytes delivered to the node */
+    uint8_t dutyCycle;/*!< 1 if the duty cycle of the channels is enforced */
+    uint64_t channelFree[RN2483_CHANNELS];/*!< Virtual time each channel can transmit again */
+    Rn2483Network *network;/*!< Channel and network server, NULL for the local loss model */
+    std::mt19937 random;/*!< Random generator of the run */
+
+/// private methods //////////////////////////
+private:
+
+    void answer(uint64_t delay, const std::string &line);
+
+    void reply(const std::string &line);
+
+    uint32_t processingTime(const std::string &line);
+
+    std::string commandName(const std::string &line);
+
+    int8_t freeChannel(uint64_t time);
+
+    uint64_t channelAvailable();
+
+    std::string parameter(const std::string &key);
+
+    void execute(const std::string &line);
+
+    void setParameter(const std::string &arguments);
+
+    void getParameter(const std::string &key);
+
+    void localUplink(uint8_t confirmed, rn2483Reception_t *reception);
+
+    void transmit(uint8_t confirmed, unsigned int port, const std::string &data);
+
+    uint8_t dataRate();
+
+/// public methods ////////////
+public:
+
+    Rn2483Emulator(uint32_t seed = 1);
+
+    void setLossProbability(double probability);
+
+    void setNetwork(Rn2483Network *uplinkNetwork);
+
+    void queueDownlink(uint8_t port, const char *data);
+
+    void setCommandLatency(const char *prefix, uint32_t ms);
+
+    void setDutyCycle(uint8_t enabled);
+
+    void receive(const uint8_t *data, uint16_t length);
+
+    void update(uint64_t now);
+
+    uint64_t nextActivity();
+
+    uint32_t getUplinks();
+
+    uint32_t getTransmissions();
+
+    uint32_t getDelivered();
+
+    uint32_t getPayloadBytes();
+
+    uint32_t getDownlinks();
+
+    uint64_t getTxTime();
+
+    uint64_t getRxTime();
+
+    uint32_t getDeliveredBytes();
+
+    uint32_t getNoFreeChannel();
+
+    uint32_t getCommands();
+
+    const std::map<std::string, uint32_t>& getCommandCounts();
+
+    uint64_t getBytesReceived();
+
+    uint64_t getBytesSent();
+
+    void resetCounters();
+
+    static uint32_t timeOnAir(uint8_t dataRate, uint16_t payloadLength);
+};
+
+#endif
@@ -0,0 +1,198 @@
+/*! \file UartReplay.cpp
+    \brief Module of a socket played back from a UartTrace capture in the host build
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include <string.h>
+#include "UartReplay.h"
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS                                                           *
+ ******************************************************************************/
+
+/*! class constructor
+  Keep the records of the socket, the bytes the module sent before the first write of the node are
+  delivered at their recorded time from the current virtual time
+  \param trace The records of a capture (UartTrace::load())
+  \param socket The socket played back
+  \return void
+*/
+UartReplay::UartReplay(const std::vector<uartTraceRecord_t> &trace, uint8_t socket){
+    for(size_t i = 0; i < trace.size(); i++){
+        if(trace[i].socket == socket){
+            records.push_back(trace[i]);
+        }
+    }
+    cursor = 0;
+    recordedAnchor = 0;
+    replayedAnchor = hostClock.getTime();
+    replayedAnswer = replayedAnchor;
+    matched = 0;
+    skipped = 0;
+    unexpected = 0;
+    recordedTurnaround = 0;
+    replayedTurnaround = 0;
+    recordedMaxTurnaround = 0;
+    replayedMaxTurnaround = 0;
+    replayedEnd = replayedAnchor;
+    schedule();
+}
+
+/*! \fn void receive(const uint8_t *data, uint16_t length)
+    \brief Match the bytes written by the node with the recorded writes and schedule the recorded answers
+*/
+void UartReplay::receive(const uint8_t *data, uint16_t length){
+    uint64_t now = hostClock.getTime();
+    size_t index;
+    uint32_t writes;
+    written.insert(written.end(), data, data + length);
+    while(!written.empty()){
+        if(!matches(cursor)){
+            // The write is searched further in the trace, the recorded writes in between are skipped
+            writes = 0;
+            for(index = cursor; index < records.size(); index++){
+                if(records[index].direction == UART_TRACE_TO_MODULE){
+                    if(matches(index)){
+                        break;
+                    }
+                    writes++;
+                }
+            }
+            if(index == records.size()){
+                unexpected++;
+                written.clear();
+                return;
+            }
+            skipped += writes;
+            cursor = index;
+        }
+        const uartTraceRecord_t &expected = records[cursor];
+        if(written.size() < expected.data.size()){
+            return;
+        }
+        uint64_t recorded = expected.time - ((cursor > 0) ? records[cursor - 1].time : 0);
+        uint64_t replayed = now - replayedAnswer;
+        recordedTurnaround += recorded;
+        replayedTurnaround += replayed;
+        if(recorded > recordedMaxTurnaround){
+            recordedMaxTurnaround = recorded;
+        }
+        if(replayed > replayedMaxTurnaround){
+            replayedMaxTurnaround = replayed;
+        }
+        written.erase(written.begin(), written.begin() + expected.data.size());
+        matched++;
+        recordedAnchor = expected.time;
+        replayedAnchor = now;
+        replayedAnswer = now;
+        replayedEnd = now;
+        cursor++;
+        schedule();
+    }
+}
+
+/*! \fn void update(uint64_t now)
+    \brief Deliver the recorded module bytes due at now
+*/
+void UartReplay::update(uint64_t now){
+    while(!scheduled.empty() && (scheduled.front().time <= now)){
+        uart->deliver(scheduled.front().data.data(), scheduled.front().data.size());
+        replayedAnswer = scheduled.front().time;
+        replayedEnd = replayedAnswer;
+        scheduled.pop_front();
+    }
+}
+
+/*! \fn uint64_t nextActivity()
+    \brief Virtual time of the next module bytes
+*/
+uint64_t UartReplay::nextActivity(){
+    return scheduled.empty() ? HOST_NEVER : scheduled.front().time;
+}
+
+/*! \fn uint8_t isFinished()
+    \retval 1 if every record has been played or skipped
+*/
+uint8_t UartReplay::isFinished(){
+    return (cursor == records.size()) && scheduled.empty();
+}
+
+uint32_t UartReplay::getRecords(){
+    return records.size();
+}
+
+uint32_t UartReplay::getMatched(){
+    return matched;
+}
+
+uint32_t UartReplay::getSkipped(){
+    return skipped;
+}
+
+uint32_t UartReplay::getUnexpected(){
+    return unexpected;
+}
+
+uint64_t UartReplay::getRecordedTurnaround(){
+    return recordedTurnaround;
+}
+
+uint64_t UartReplay::getReplayedTurnaround(){
+    return replayedTurnaround;
+}
+
+uint64_t UartReplay::getRecordedMaxTurnaround(){
+    return recordedMaxTurnaround;
+}
+
+uint64_t UartReplay::getReplayedMaxTurnaround(){
+    return replayedMaxTurnaround;
+}
+
+/*! \fn uint64_t getRecordedEnd()
+    \retval Recorded time of the last record of the socket
+*/
+uint64_t UartReplay::getRecordedEnd(){
+    return records.empty() ? 0 : records.back().time;
+}
+
+/*! \fn uint64_t getReplayedEnd()
+    \retval Replay time of the last record played
+*/
+uint64_t UartReplay::getReplayedEnd(){
+    return replayedEnd;
+}
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS                                                          *
+ ******************************************************************************/
+
+/*! \fn void schedule()
+    \brief Schedule the module records that follow the last matched write at their recorded offset from it
+*/
+void UartReplay::schedule(){
+    uartTraceRecord_t delivery;
+    while((cursor < records.size()) && (records[cursor].direction == UART_TRACE_TO_NODE)){
+        delivery = records[cursor];
+        delivery.time = replayedAnchor + (records[cursor].time - recordedAnchor);
+        scheduled.push_back(delivery);
+        cursor++;
+    }
+}
+
+/*! \fn uint8_t matches(size_t index)
+    \brief Compare the bytes written with a record
+    \retval 1 if the record is a write of the node that starts as the bytes written (or the reverse)
+*/
+uint8_t UartReplay::matches(size_t index){
+    size_t length;
+    if((index >= records.size()) || (records[index].direction != UART_TRACE_TO_MODULE)){
+        return 0;
+    }
+    length = (written.size() < records[index].data.size()) ? written.size() : records[index].data.size();
+    return memcmp(written.data(), records[index].data.data(), length) == 0;
+}
@@ -0,0 +1,101 @@
+/*! \file UartReplay.h
+    \brief Module of a socket played back from a UartTrace capture in the host build
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    The device expects the node to write the bytes recorded towards the module, in order. Once a
+    recorded write is matched, the bytes the module sent until the next recorded write are delivered
+    at the recorded offsets from it, so the module answers as in the capture and the time the node
+    takes between an answer and its next command can be compared with the captured session.
+
+    A write that differs from the one expected is searched further in the trace: the recorded
+    writes in between are skipped, or the write is counted as unexpected and left unanswered if it
+    is nowhere in the rest of the trace.
+*/
+
+/*! \def _UARTREPLAY_H
+    \brief The library flag
+ */
+#ifndef _UARTREPLAY_H
+#define _UARTREPLAY_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+#include <deque>
+#include <vector>
+#include "HostUart.h"
+#include "UartTrace.h"
+
+/******************************************************************************
+ * Class                                                                      *
+ ******************************************************************************/
+
+//! UartReplay Class
+/*!
+  Plays back the records of one socket
+ */
+class UartReplay : public HostDevice{
+
+/// private attributes //////////////
+private:
+
+    std::vector<uartTraceRecord_t> records;/*!< The records of the socket */
+    size_t cursor;/*!< Next record to play */
+    std::deque<uartTraceRecord_t> scheduled;/*!< Module bytes to deliver, with their replay time */
+    std::vector<uint8_t> written;/*!< Bytes written by the node not matched yet */
+    uint64_t recordedAnchor;/*!< Recorded time of the last write matched */
+    uint64_t replayedAnchor;/*!< Replay time of the last write matched */
+    uint64_t replayedAnswer;/*!< Replay time of the last module bytes delivered or write matched */
+    uint32_t matched;/*!< Recorded writes matched */
+    uint32_t skipped;/*!< Recorded writes the node did not do */
+    uint32_t unexpected;/*!< Node writes not in the trace */
+    uint64_t recordedTurnaround;/*!< Sum of the recorded ms between the module bytes and the next node write */
+    uint64_t replayedTurnaround;/*!< Sum of the same ms in the replay */
+    uint64_t recordedMaxTurnaround;/*!< Longest recorded turnaround */
+    uint64_t replayedMaxTurnaround;/*!< Longest replayed turnaround */
+    uint64_t replayedEnd;/*!< Replay time of the last record played */
+
+/// private methods //////////////
+private:
+
+    void schedule();
+
+    uint8_t matches(size_t index);
+
+/// public methods ////////////
+public:
+
+    UartReplay(const std::vector<uartTraceRecord_t> &trace, uint8_t socket);
+
+    void receive(const uint8_t *data, uint16_t length);
+
+    void update(uint64_t now);
+
+    uint64_t nextActivity();
+
+    uint8_t isFinished();
+
+    uint32_t getRecords();
+
+    uint32_t getMatched();
+
+    uint32_t getSkipped();
+
+    uint32_t getUnexpected();
+
+    uint64_t getRecordedTurnaround();
+
+    uint64_t getReplayedTurnaround();
+
+    uint64_t getRecordedMaxTurnaround();
+
+    uint64_t getReplayedMaxTurnaround();
+
+    uint64_t getRecordedEnd();
+
+    uint64_t getReplayedEnd();
+};
+
+#endif
@@ -0,0 +1,211 @@
+/*! \file UartTrace.cpp
+    \brief Binary trace of the bytes exchanged on the socket UARTs in the host build
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include <string.h>
+#include "UartTrace.h"
+#include "HostClock.h"
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+/*! \fn static uint8_t readVarint(FILE *file, uint64_t *value)
+    \brief Read a varint of the trace
+    \retval 1 if read, 0 at the end of the file
+*/
+static uint8_t readVarint(FILE *file, uint64_t *value){
+    int byte;
+    uint8_t shift = 0;
+    *value = 0;
+    do{
+        byte = fgetc(file);
+        if((byte == EOF) || (shift > 63)){
+            return 0;
+        }
+        *value |= (uint64_t)(byte & 0x7F) << shift;
+        shift += 7;
+    }while(byte & 0x80);
+    return 1;
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS                                                           *
+ ******************************************************************************/
+
+/*! class constructor
+  Not capturing
+  \param void
+  \return void
+*/
+UartTrace::UartTrace(){
+    file = NULL;
+    hasPending = 0;
+    lastTime = 0;
+    records = 0;
+    fileBytes = 0;
+}
+
+/*! class destructor
+  Write the last record and close the file
+*/
+UartTrace::~UartTrace(){
+    close();
+}
+
+/*! \fn uint8_t open(const char *path)
+    \brief Create the capture file, the time of the records starts at the current virtual time
+    \param path The file, overwritten
+    \retval 1 if created, 0 otherwise
+*/
+uint8_t UartTrace::open(const char *path){
+    close();
+    file = fopen(path, "wb");
+    if(file == NULL){
+        return 0;
+    }
+    fwrite(UART_TRACE_MAGIC, 1, strlen(UART_TRACE_MAGIC), file);
+    fileBytes = strlen(UART_TRACE_MAGIC);
+    lastTime = hostClock.getTime();
+    records = 0;
+    return 1;
+}
+
+/*! \fn void record(uint8_t socket, uint8_t direction, const uint8_t *data, uint16_t length)
+    \brief Record bytes sent at the current virtual time, appended to the previous record if it is the same socket, direction and ms
+*/
+void UartTrace::record(uint8_t socket, uint8_t direction, const uint8_t *data, uint16_t length){
+    uint64_t now = hostClock.getTime();
+    if((file == NULL) || (length == 0)){
+        return;
+    }
+    if(hasPending && ((pending.socket != socket) || (pending.direction != direction) || (pending.time != now))){
+        writePending();
+    }
+    if(!hasPending){
+        pending.time = now;
+        pending.socket = socket;
+        pending.direction = direction;
+        pending.data.clear();
+        hasPending = 1;
+    }
+    pending.data.insert(pending.data.end(), data, data + length);
+}
+
+/*! \fn void close()
+    \brief Write the last record and close the file
+*/
+void UartTrace::close(){
+    if(file == NULL){
+        return;
+    }
+    if(hasPending){
+        writePending();
+    }
+    fclose(file);
+    file = NULL;
+}
+
+/*! \fn uint32_t getRecords()
+    \retval Records written to the file
+*/
+uint32_t UartTrace::getRecords(){
+    return records;
+}
+
+/*! \fn uint64_t getFileBytes()
+    \retval Size of the file
+*/
+uint64_t UartTrace::getFileBytes(){
+    return fileBytes;
+}
+
+/*! \fn static uint8_t load(const char *path, std::vector<uartTraceRecord_t> &trace)
+    \brief Read a trace file, the times are relative to the start of the capture
+    \param path The file
+    \param trace The records read
+    \retval 1 if read, 0 if the file cannot be opened, is not a trace or is truncated
+*/
+uint8_t UartTrace::load(const char *path, std::vector<uartTraceRecord_t> &trace){
+    char magic[sizeof(UART_TRACE_MAGIC)] = {0};
+    uartTraceRecord_t entry;
+    uint64_t length;
+    uint64_t delta;
+    uint64_t time = 0;
+    int header;
+    FILE *input = fopen(path, "rb");
+    if(input == NULL){
+        return 0;
+    }
+    trace.clear();
+    if((fread(magic, 1, strlen(UART_TRACE_MAGIC), input) != strlen(UART_TRACE_MAGIC))
+       || (strcmp(magic, UART_TRACE_MAGIC) != 0)){
+        fclose(input);
+        return 0;
+    }
+    while((header = fgetc(input)) != EOF){
+        length = header & UART_TRACE_SHORT_LENGTH;
+        if(((length == UART_TRACE_SHORT_LENGTH) && !readVarint(input, &length)) || !readVarint(input, &delta)){
+            fclose(input);
+            return 0;
+        }
+        time += delta;
+        entry.time = time;
+        entry.socket = (header >> 7) & 0x01;
+        entry.direction = (header >> 6) & 0x01;
+        entry.data.resize(length);
+        if(fread(entry.data.data(), 1, length, input) != length){
+            fclose(input);
+            return 0;
+        }
+        trace.push_back(entry);
+    }
+    fclose(input);
+    return 1;
+}
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS                                                          *
+ ******************************************************************************/
+
+/*! \fn void writeVarint(uint64_t value)
+    \brief Write 7 bits per byte, least significant first
+*/
+void UartTrace::writeVarint(uint64_t value){
+    do{
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        if(value != 0){
+            byte |= 0x80;
+        }
+        fputc(byte, file);
+        fileBytes++;
+    }while(value != 0);
+}
+
+/*! \fn void writePending()
+    \brief Write the record being coalesced
+*/
+void UartTrace::writePending(){
+    size_t length = pending.data.size();
+    uint8_t header = (pending.socket << 7) | (pending.direction << 6);
+    if(length < UART_TRACE_SHORT_LENGTH){
+        fputc(header | length, file);
+        fileBytes++;
+    }else{
+        fputc(header | UART_TRACE_SHORT_LENGTH, file);
+        fileBytes++;
+        writeVarint(length);
+    }
+    writeVarint(pending.time - lastTime);
+    fwrite(pending.data.data(), 1, length, file);
+    fileBytes += length;
+    lastTime = pending.time;
+    records++;
+    hasPending = 0;
+}
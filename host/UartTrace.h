@@ -0,0 +1,97 @@
+/*! \file UartTrace.h
+    \brief Binary trace of the bytes exchanged on the socket UARTs in the host build
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    A capture attached to hostUart[] with HostUart::capture() records the bytes written by the node
+    to the BLE112 (SOCKET0) and to the RN2483 (SOCKET1), and the bytes of the modules delivered to
+    the node, with their virtual time. Consecutive chunks of the same socket and direction at the
+    same ms are one record, so a command or an answer is usually a single record.
+
+    File format: the 4 bytes "UTR1" and the records. A record is a header byte, socket << 7 |
+    direction << 6 | length (63: the length follows as a varint), the ms since the previous record as
+    a varint (7 bits per byte, least significant first, bit 7 set if another byte follows) and the
+    bytes. A BGAPI command and its response take 2 to 4 bytes of overhead each.
+
+    UartReplay plays a trace back to the node, tools/TraceReplay runs the node against it.
+*/
+
+/*! \def _UARTTRACE_H
+    \brief The library flag
+ */
+#ifndef _UARTTRACE_H
+#define _UARTTRACE_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+#include <stdio.h>
+#include <vector>
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define UART_TRACE_MAGIC "UTR1"/*!< First bytes of a trace file */
+#define UART_TRACE_TO_MODULE 0/*!< Direction of the bytes written by the node */
+#define UART_TRACE_TO_NODE 1/*!< Direction of the bytes delivered by the module */
+#define UART_TRACE_SHORT_LENGTH 63/*!< Length field of the header meaning that a varint length follows */
+
+/*! \struct uartTraceRecord_t
+    \brief  Bytes sent in one direction of one socket at one ms
+ */
+typedef struct {
+  uint64_t time;/**< Virtual ms */
+  uint8_t socket;/**< SOCKET0 or SOCKET1 */
+  uint8_t direction;/**< UART_TRACE_TO_MODULE or UART_TRACE_TO_NODE */
+  std::vector<uint8_t> data;/**< The bytes */
+}uartTraceRecord_t;
+
+/******************************************************************************
+ * Class                                                                      *
+ ******************************************************************************/
+
+//! UartTrace Class
+/*!
+  Writer and reader of the trace files
+ */
+class UartTrace{
+
+/// private attributes //////////////
+private:
+
+    FILE *file;/*!< The capture file, NULL if not capturing */
+    uartTraceRecord_t pending;/*!< Record being coalesced, written when a record of another socket, direction or ms comes */
+    uint8_t hasPending;/*!< 1 if pending holds bytes */
+    uint64_t lastTime;/*!< Time of the last record written */
+    uint32_t records;/*!< Records written */
+    uint64_t fileBytes;/*!< Bytes of the file */
+
+/// private methods //////////////
+private:
+
+    void writeVarint(uint64_t value);
+
+    void writePending();
+
+/// public methods ////////////
+public:
+
+    UartTrace();
+
+    ~UartTrace();
+
+    uint8_t open(const char *path);
+
+    void record(uint8_t socket, uint8_t direction, const uint8_t *data, uint16_t length);
+
+    void close();
+
+    uint32_t getRecords();
+
+    uint64_t getFileBytes();
+
+    static uint8_t load(const char *path, std::vector<uartTraceRecord_t> &trace);
+};
+
+#endif
@@ -0,0 +1,474 @@
+/*! \file WaspBLE.cpp
+    \brief BLE112 BGAPI client of the host build, subset of the Waspmote WaspBLE library
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include "WaspClasses.h"
+#include "WaspBLE.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+thread_local WaspBLE BLE = WaspBLE();
+
+/*! \struct bleEventId_t
+    \brief  BGAPI class and event of each bleEventCode_t
+ */
+typedef struct {
+  uint8_t classID;
+  uint8_t eventID;
+  uint8_t code;
+}bleEventId_t;
+
+static const bleEventId_t eventIds[] = {
+    {0, 0, BLE_EVENT_SYSTEM_BOOT},
+    {3, 0, BLE_EVENT_CONNECTION_STATUS},
+    {3, 4, BLE_EVENT_CONNECTION_DISCONNECTED},
+    {4, 0, BLE_EVENT_ATTCLIENT_INDICATED},
+    {4, 1, BLE_EVENT_ATTCLIENT_PROCEDURE_COMPLETED},
+    {4, 2, BLE_EVENT_ATTCLIENT_GROUP_FOUND},
+    {4, 3, BLE_EVENT_ATTCLIENT_ATTRIBUTE_FOUND},
+    {4, 4, BLE_EVENT_ATTCLIENT_FIND_INFORMATION_FOUND},
+    {4, 5, BLE_EVENT_ATTCLIENT_ATTRIBUTE_VALUE},
+    {6, 0, BLE_EVENT_GAP_SCAN_RESPONSE}
+};
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS                                                          *
+ ******************************************************************************/
+
+/*! \fn static uint8_t eventCode(const uint8_t *packet)
+    \brief The bleEventCode_t of a BGAPI event
+*/
+static uint8_t eventCode(const uint8_t *packet){
+    for(uint8_t i = 0; i < sizeof(eventIds) / sizeof(eventIds[0]); i++){
+        if((eventIds[i].classID == packet[2]) && (eventIds[i].eventID == packet[3])){
+            return eventIds[i].code;
+        }
+    }
+    return BLE_EVENT_UNKNOWN;
+}
+
+/*! \fn uint8_t readPacket(uint8_t *packet, unsigned long timeout)
+    \brief Read a BGAPI packet (response or event) from the UART
+    \retval The length of the packet, 0 if no packet was received before the timeout
+
+    Bytes that can not start a BLE packet (technology bits not 0) are skipped.
+*/
+uint8_t WaspBLE::readPacket(uint8_t *packet, unsigned long timeout){
+    unsigned long start = millis();
+    uint16_t received = 0;
+    uint16_t length = 4;
+    while(received < length){
+        if((millis() - start) > timeout){
+            return 0;
+        }
+        if(serialAvailable(socket) == 0){
+            continue;
+        }
+        packet[received++] = serialRead(socket);
+        if((received == 1) && ((packet[0] & 0x78) != 0)){
+            received = 0;
+        }else if(received == 2){
+            length = 4 + ((((uint16_t)packet[0] & 0x07) << 8) | packet[1]);
+            if(length > BLE_PACKET_SIZE){
+                serialFlush(socket);
+                return 0;
+            }
+        }
+    }
+    return length;
+}
+
+/*! \fn uint16_t command(uint8_t classID, uint8_t commandID, const uint8_t *payload, uint8_t length)
+    \brief Send a command in packet mode and read its response in answer[]
+    \retval 0 if the response was received, 1 otherwise
+*/
+uint16_t WaspBLE::command(uint8_t classID, uint8_t commandID, const uint8_t *payload, uint8_t length){
+    uint8_t packet[BLE_PACKET_SIZE + 1];
+    packet[0] = length + 4;
+    packet[1] = 0;
+    packet[2] = length;
+    packet[3] = classID;
+    packet[4] = commandID;
+    if(length > 0){
+        memcpy(packet + 5, payload, length);
+    }
+    sendCommand(packet, length + 5);
+    return readCommandAnswer();
+}
+
+/*! \fn uint16_t waitEventFor(uint8_t code, unsigned long timeout)
+    \brief Wait for an event, the other events received meanwhile are kept for waitEvent()
+    \retval code if the event is in event[], 0 otherwise
+*/
+uint16_t WaspBLE::waitEventFor(uint8_t code, unsigned long timeout){
+    std::deque< std::vector<uint8_t> > others;
+    unsigned long start = millis();
+    uint16_t received = 0;
+    while((millis() - start) <= timeout){
+        received = waitEvent(timeout - (millis() - start));
+        if((received == 0) || (received == code)){
+            break;
+        }
+        others.push_back(std::vector<uint8_t>(event, event + 4 + event[1]));
+    }
+    pending.insert(pending.begin(), others.begin(), others.end());
+    return (received == code) ? code : 0;
+}
+
+/*! \fn uint8_t parseMac(char *mac, uint8_t *address)
+    \brief Parse a MAC as 12 hexadecimal digits into a BGAPI bd_addr (least significant byte first)
+    \retval 1 if OK, 0 if the MAC is not valid
+*/
+uint8_t WaspBLE::parseMac(char *mac, uint8_t *address){
+    unsigned int byte;
+    if(strlen(mac) != 12){
+        return 0;
+    }
+    for(uint8_t i = 0; i < 6; i++){
+        if(sscanf(mac + 2 * i, "%2x", &byte) != 1){
+            return 0;
+        }
+        address[5 - i] = byte;
+    }
+    return 1;
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS                                                           *
+ ******************************************************************************/
+
+/*! class constructor
+  Default scanning parameters of the module
+  \param void
+  \return void
+*/
+WaspBLE::WaspBLE(){
+    socket = 0;
+    discoverMode = BLE_GAP_DISCOVER_OBSERVATION;
+    txPower = 15;
+    scanInterval = 75;
+    scanWindow = 50;
+    scanning = BLE_ACTIVE_SCANNING;
+    connection_handle = 0;
+    memset(event, 0, sizeof(event));
+    memset(attributeValue, 0, sizeof(attributeValue));
+    memset(&BLEDev, 0, sizeof(BLEDev));
+}
+
+/*! \fn uint8_t ON(uint8_t socket)
+    \brief Open the UART of the module
+    \retval 0
+*/
+uint8_t WaspBLE::ON(uint8_t uartSocket){
+    socket = uartSocket;
+    pending.clear();
+    beginSerial(115200, socket);
+    return 0;
+}
+
+/*! \fn void OFF()
+    \brief Close the UART of the module
+*/
+void WaspBLE::OFF(){
+    closeSerial(socket);
+}
+
+/*! \fn uint16_t sendCommand(uint8_t *data, uint16_t length)
+    \brief Write a command as it is, the first byte is the packet mode length
+    \retval 0
+*/
+uint16_t WaspBLE::sendCommand(uint8_t *data, uint16_t length){
+    hostUart[socket].write(data, length);
+    return 0;
+}
+
+/*! \fn uint16_t readCommandAnswer()
+    \brief Read the response of the last command in answer[]
+    \retval 0 if OK, 1 if no response was received
+
+    The disconnections, notifications and indications received before the response are kept for
+    waitEvent(). The other events belong to a previous procedure that has not been waited for
+    (e.g. the procedure_completed after a find_information_found) and are discarded, as the
+    Waspmote library does.
+*/
+uint16_t WaspBLE::readCommandAnswer(){
+    uint8_t packet[BLE_PACKET_SIZE];
+    uint8_t length;
+    uint8_t code;
+    while((length = readPacket(packet, BLE_ANSWER_TIMEOUT)) != 0){
+        if(packet[0] & 0x80){
+            code = eventCode(packet);
+            if((code == BLE_EVENT_CONNECTION_DISCONNECTED)
+               || ((code == BLE_EVENT_ATTCLIENT_ATTRIBUTE_VALUE) && ((packet[7] == 1) || (packet[7] == 2)))){
+                pending.push_back(std::vector<uint8_t>(packet, packet + length));
+            }
+        }else{
+            memcpy(answer, packet, length);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*! \fn uint16_t waitEvent(unsigned long time)
+    \brief Wait for the next event and leave it in event[]
+    \param  time ms to wait
+    \retval bleEventCode_t of the event, 0 if no event was received
+*/
+uint16_t WaspBLE::waitEvent(unsigned long time){
+    uint8_t packet[BLE_PACKET_SIZE];
+    uint8_t length;
+    unsigned long start = millis();
+    if(!pending.empty()){
+        memcpy(event, &pending.front()[0], pending.front().size());
+        pending.pop_front();
+        return eventCode(event);
+    }
+    while((millis() - start) <= time){
+        length = readPacket(packet, time - (millis() - start));
+        if(length == 0){
+            break;
+        }
+        if(packet[0] & 0x80){
+            memcpy(event, packet, length);
+            return eventCode(event);
+        }
+    }
+    return 0;
+}
+
+/*! \fn void setDiscoverMode(uint8_t mode)
+    \brief Set the BLE_GAP_DISCOVER_* mode of the next scans
+*/
+void WaspBLE::setDiscoverMode(uint8_t mode){
+    discoverMode = mode;
+}
+
+/*! \fn uint16_t setTXPower(uint8_t power)
+    \brief Send hardware_set_txpower
+    \retval 0 if OK, 1 if no response was received
+*/
+uint16_t WaspBLE::setTXPower(uint8_t power){
+    txPower = power;
+    return command(2, 12, &power, 1);
+}
+
+/*! \fn uint16_t setScanningParameters(uint16_t interval, uint16_t window, uint8_t mode)
+    \brief Send gap_set_scan_parameters
+    \retval 0 if OK, the BGAPI error or 1 if no response was received
+*/
+uint16_t WaspBLE::setScanningParameters(uint16_t interval, uint16_t window, uint8_t mode){
+    uint8_t payload[5] = {(uint8_t)interval, (uint8_t)(interval >> 8), (uint8_t)window, (uint8_t)(window >> 8), mode};
+    scanInterval = interval;
+    scanWindow = window;
+    scanning = mode;
+    if(command(6, 7, payload, sizeof(payload)) != 0){
+        return 1;
+    }
+    return ((uint16_t)answer[5] << 8) | answer[4];
+}
+
+/*! \fn void getScanningParameters()
+    \brief Print the scanning parameters
+*/
+void WaspBLE::getScanningParameters(){
+    USB.print(F("BLE scanning parameters: discover mode "));
+    USB.print(discoverMode, DEC);
+    USB.print(F(", TX power "));
+    USB.print(txPower, DEC);
+    USB.print(F(", interval "));
+    USB.print(scanInterval, DEC);
+    USB.print(F(", window "));
+    USB.print(scanWindow, DEC);
+    USB.print(F(", active "));
+    USB.println(scanning, DEC);
+}
+
+/*! \fn uint16_t scanDevice(char *mac)
+    \brief Scan until the device is found or BLE_SCAN_TIMEOUT, the device is left in BLEDev
+    \retval 1 if found, 0 if not found, 2 if the module does not answer
+*/
+uint16_t WaspBLE::scanDevice(char *mac){
+    uint8_t address[6];
+    uint8_t found = 0;
+    unsigned long start;
+    if(!parseMac(mac, address) || (command(6, 2, &discoverMode, 1) != 0)){
+        return 2;
+    }
+    start = millis();
+    while(!found && ((millis() - start) <= BLE_SCAN_TIMEOUT)){
+        if(waitEventFor(BLE_EVENT_GAP_SCAN_RESPONSE, BLE_SCAN_TIMEOUT - (millis() - start)) == 0){
+            break;
+        }
+        /* gap_scan_response: [rssi][packet_type][sender 6][address_type][bond][data length][data] */
+        if(memcmp(event + 6, address, 6) == 0){
+            for(uint8_t i = 0; i < 6; i++){
+                BLEDev.mac[i] = event[11 - i];
+            }
+            BLEDev.rssi = (int8_t)event[4];
+            BLEDev.advData[0] = (event[14] < sizeof(BLEDev.advData)) ? event[14] : sizeof(BLEDev.advData) - 1;
+            memcpy(BLEDev.advData + 1, event + 15, BLEDev.advData[0]);
+            found = 1;
+        }
+    }
+    command(6, 4, NULL, 0);//gap_end_procedure
+    return found;
+}
+
+/*! \fn uint16_t scanNetwork(uint8_t time)
+    \brief Scan for time seconds
+    \retval 0 if OK, 2 if the module does not answer
+*/
+uint16_t WaspBLE::scanNetwork(uint8_t time){
+    unsigned long start;
+    if(command(6, 2, &discoverMode, 1) != 0){
+        return 2;
+    }
+    start = millis();
+    while((millis() - start) <= (time * 1000UL)){
+        if(waitEventFor(BLE_EVENT_GAP_SCAN_RESPONSE, time * 1000UL - (millis() - start)) == 0){
+            break;
+        }
+    }
+    command(6, 4, NULL, 0);
+    return 0;
+}
+
+/*! \fn uint16_t connectDirect(char *mac)
+    \brief connectDirect() with the default parameters of the Waspmote library (60, 76, 100, 0)
+*/
+uint16_t WaspBLE::connectDirect(char *mac){
+    return connectDirect(mac, 60, 76, 100, 0);
+}
+
+/*! \fn uint16_t connectDirect(char *mac, uint16_t intervalMin, uint16_t intervalMax, uint16_t timeout, uint16_t latency)
+    \brief Send gap_connect_direct and wait for the connection_status event
+    \retval 1 if connected, 0 if the MAC is not valid, the BGAPI error of the response,
+            2 if the module does not answer or the connection is not established
+*/
+uint16_t WaspBLE::connectDirect(char *mac, uint16_t intervalMin, uint16_t intervalMax, uint16_t timeout, uint16_t latency){
+    uint8_t payload[15];
+    uint16_t result;
+    if(!parseMac(mac, payload)){
+        return 0;
+    }
+    payload[6] = 0;//public address
+    payload[7] = intervalMin;
+    payload[8] = intervalMin >> 8;
+    payload[9] = intervalMax;
+    payload[10] = intervalMax >> 8;
+    payload[11] = timeout;
+    payload[12] = timeout >> 8;
+    payload[13] = latency;
+    payload[14] = latency >> 8;
+    if(command(6, 3, payload, sizeof(payload)) != 0){
+        return 2;
+    }
+    result = ((uint16_t)answer[5] << 8) | answer[4];
+    if(result != 0){
+        return result;
+    }
+    if((waitEventFor(BLE_EVENT_CONNECTION_STATUS, BLE_CONNECT_TIMEOUT) == 0) || ((event[5] & 0x01) == 0)){
+        return 2;
+    }
+    connection_handle = event[4];
+    return 1;
+}
+
+/*! \fn uint16_t disconnect(uint8_t connection)
+    \brief Send connection_disconnect and wait for the connection_disconnected event
+    \retval 0 if OK, 1 if the connection handle is not right, 2 if the module does not answer
+*/
+uint16_t WaspBLE::disconnect(uint8_t connection){
+    if(command(3, 0, &connection, 1) != 0){
+        return 2;
+    }
+    if((answer[5] | answer[6]) != 0){
+        return 1;
+    }
+    return (waitEventFor(BLE_EVENT_CONNECTION_DISCONNECTED, BLE_ANSWER_TIMEOUT) != 0) ? 0 : 2;
+}
+
+/*! \fn uint8_t getStatus(uint8_t connection)
+    \brief Send connection_get_status
+    \retval 1 if connected, 0 if not connected, 2 if the module does not answer
+*/
+uint8_t WaspBLE::getStatus(uint8_t connection){
+    if(command(3, 7, &connection, 1) != 0){
+        return 2;
+    }
+    if((waitEventFor(BLE_EVENT_CONNECTION_STATUS, BLE_ANSWER_TIMEOUT) == 0) || (event[4] != connection)){
+        return 0;
+    }
+    return event[5] & 0x01;
+}
+
+/*! \fn uint16_t attributeRead(uint8_t connection, uint16_t handle)
+    \brief Send attclient_read_by_handle and copy the value in attributeValue[] as [length][value]
+    \retval 0 if OK, the BGAPI error, 2 if the module does not answer or the value is not received
+*/
+uint16_t WaspBLE::attributeRead(uint8_t connection, uint16_t handle){
+    uint8_t payload[3] = {connection, (uint8_t)handle, (uint8_t)(handle >> 8)};
+    unsigned long start;
+    uint16_t result;
+    attributeValue[0] = 0;
+    if(command(4, 4, payload, sizeof(payload)) != 0){
+        return 2;
+    }
+    result = ((uint16_t)answer[6] << 8) | answer[5];
+    if(result != 0){
+        return result;
+    }
+    start = millis();
+    while((millis() - start) <= BLE_ANSWER_TIMEOUT){
+        if(waitEventFor(BLE_EVENT_ATTCLIENT_ATTRIBUTE_VALUE, BLE_ANSWER_TIMEOUT - (millis() - start)) == 0){
+            break;
+        }
+        if((event[5] == payload[1]) && (event[6] == payload[2])){
+            memcpy(attributeValue, event + 8, event[8] + 1);
+            return 0;
+        }
+    }
+    return 2;
+}
+
+/*! \fn uint16_t attributeWrite(uint8_t connection, uint16_t handle, uint8_t *data, uint8_t length)
+    \brief Send attclient_attribute_write and wait for the procedure_completed event
+    \retval 0 if OK, the BGAPI error, 2 if the module does not answer
+*/
+uint16_t WaspBLE::attributeWrite(uint8_t connection, uint16_t handle, uint8_t *data, uint8_t length){
+    uint8_t payload[BLE_PACKET_SIZE];
+    uint16_t result;
+    if(length > (BLE_PACKET_SIZE - 8)){
+        length = BLE_PACKET_SIZE - 8;
+    }
+    payload[0] = connection;
+    payload[1] = handle;
+    payload[2] = handle >> 8;
+    payload[3] = length;
+    memcpy(payload + 4, data, length);
+    if(command(4, 5, payload, length + 4) != 0){
+        return 2;
+    }
+    result = ((uint16_t)answer[6] << 8) | answer[5];
+    if(result != 0){
+        return result;
+    }
+    if(waitEventFor(BLE_EVENT_ATTCLIENT_PROCEDURE_COMPLETED, BLE_ANSWER_TIMEOUT) == 0){
+        return 2;
+    }
+    return ((uint16_t)event[6] << 8) | event[5];
+}
+
+/*! \fn uint16_t attributeWrite(uint8_t connection, uint16_t handle, char *data)
+    \brief attributeWrite() of a string, without the end of string
+*/
+uint16_t WaspBLE::attributeWrite(uint8_t connection, uint16_t handle, char *data){
+    return attributeWrite(connection, handle, (uint8_t *)data, strlen(data));
+}
@@ -0,0 +1,150 @@
+/*! \file WaspBLE.h
+    \brief BLE112 BGAPI client of the host build, subset of the Waspmote WaspBLE library
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    The commands are written to the SOCKET0 UART in packet mode (length byte + BGAPI packet) and the
+    module answers with plain BGAPI packets ([type][length][class][command][payload]). The last event
+    is left in event[], as BLECentral parses it there.
+*/
+
+/*! \def _WASPBLE_H
+    \brief The library flag
+ */
+#ifndef _WASPBLE_H
+#define _WASPBLE_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+#include <deque>
+#include <vector>
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define BLE_PACKET_SIZE 64/*!< Longest BGAPI packet handled, header included */
+#define BLE_ANSWER_TIMEOUT 1000/*!< ms to wait for the response of a command */
+#define BLE_SCAN_TIMEOUT 10000/*!< ms to look for the device in scanDevice() */
+#define BLE_CONNECT_TIMEOUT 5000/*!< ms to wait for the connection_status event */
+
+#define BLE_GAP_DISCOVER_LIMITED 0
+#define BLE_GAP_DISCOVER_GENERIC 1
+#define BLE_GAP_DISCOVER_OBSERVATION 2
+
+#define BLE_PASSIVE_SCANNING 0
+#define BLE_ACTIVE_SCANNING 1
+
+/*! \enum bleEventCode_t
+    \brief Identifier returned by waitEvent(), 0 if no event was received
+ */
+typedef enum {
+    BLE_EVENT_SYSTEM_BOOT = 1,
+    BLE_EVENT_CONNECTION_STATUS,
+    BLE_EVENT_CONNECTION_DISCONNECTED,
+    BLE_EVENT_ATTCLIENT_INDICATED,
+    BLE_EVENT_ATTCLIENT_PROCEDURE_COMPLETED,
+    BLE_EVENT_ATTCLIENT_GROUP_FOUND,
+    BLE_EVENT_ATTCLIENT_ATTRIBUTE_FOUND,
+    BLE_EVENT_ATTCLIENT_FIND_INFORMATION_FOUND,
+    BLE_EVENT_ATTCLIENT_ATTRIBUTE_VALUE,
+    BLE_EVENT_GAP_SCAN_RESPONSE,
+    BLE_EVENT_UNKNOWN = 0xFF
+}bleEventCode_t;
+
+/*! \struct bleDevice_t
+    \brief  Last device found by scanDevice()
+ */
+typedef struct {
+  uint8_t mac[6];/**< Address, most significant byte first */
+  int8_t rssi;/**< RSSI of the scan response in dBm */
+  uint8_t advData[32];/**< [length][advertising data] */
+}bleDevice_t;
+
+/******************************************************************************
+ * Class                                                                      *
+ ******************************************************************************/
+
+//! WaspBLE Class
+/*!
+  BGAPI client over the SOCKET0 UART
+ */
+class WaspBLE{
+
+/// private attributes //////////////
+private:
+
+    uint8_t socket;/*!< UART of the module */
+    uint8_t discoverMode;/*!< BLE_GAP_DISCOVER_* of gap_discover */
+    uint8_t txPower;/*!< hardware_set_txpower value */
+    uint16_t scanInterval;/*!< gap_set_scan_parameters values */
+    uint16_t scanWindow;
+    uint8_t scanning;
+    uint8_t answer[BLE_PACKET_SIZE];/*!< Response of the last command */
+    std::deque< std::vector<uint8_t> > pending;/*!< Events received while waiting for a response */
+
+/// private methods //////////////////////////
+private:
+
+    uint8_t readPacket(uint8_t *packet, unsigned long timeout);
+
+    uint16_t command(uint8_t classID, uint8_t commandID, const uint8_t *payload, uint8_t length);
+
+    uint16_t waitEventFor(uint8_t code, unsigned long timeout);
+
+    uint8_t parseMac(char *mac, uint8_t *address);
+
+/// public attributes ////////////
+public:
+
+    uint8_t event[BLE_PACKET_SIZE];/*!< Last event: [0x80][length][class][event][payload] */
+    uint8_t attributeValue[BLE_PACKET_SIZE];/*!< Value of the last attributeRead(): [length][value] */
+    bleDevice_t BLEDev;/*!< Last device found */
+    uint8_t connection_handle;/*!< Handle of the connection */
+
+/// public methods ////////////
+public:
+
+    WaspBLE();
+
+    uint8_t ON(uint8_t socket);
+
+    void OFF();
+
+    uint16_t sendCommand(uint8_t *data, uint16_t length);
+
+    uint16_t readCommandAnswer();
+
+    uint16_t waitEvent(unsigned long time);
+
+    void setDiscoverMode(uint8_t mode);
+
+    uint16_t setTXPower(uint8_t power);
+
+    uint16_t setScanningParameters(uint16_t interval, uint16_t window, uint8_t mode);
+
+    void getScanningParameters();
+
+    uint16_t scanDevice(char *mac);
+
+    uint16_t scanNetwork(uint8_t time);
+
+    uint16_t connectDirect(char *mac);
+
+    uint16_t connectDirect(char *mac, uint16_t intervalMin, uint16_t intervalMax, uint16_t timeout, uint16_t latency);
+
+    uint16_t disconnect(uint8_t connection);
+
+    uint8_t getStatus(uint8_t connection);
+
+    uint16_t attributeRead(uint8_t connection, uint16_t handle);
+
+    uint16_t attributeWrite(uint8_t connection, uint16_t handle, uint8_t *data, uint8_t length);
+
+    uint16_t attributeWrite(uint8_t connection, uint16_t handle, char *data);
+};
+
+extern thread_local WaspBLE BLE;
+
+#endif
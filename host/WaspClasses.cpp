@@ -0,0 +1,293 @@
+/*! \file WaspClasses.cpp
+    \brief Subset of the Waspmote API used by the node, implemented on the host
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include "WaspClasses.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+thread_local WaspUSB USB = WaspUSB();
+thread_local WaspRTC RTC = WaspRTC();
+thread_local WaspUtils Utils = WaspUtils();
+
+/******************************************************************************
+ * WaspUSB                                                                    *
+ ******************************************************************************/
+
+/*! \fn void printNumber(unsigned long number, int base)
+    \brief Print a number without sign in base 2..16
+*/
+/*! class constructor
+  The logs go to stdout
+  \param void
+  \return void
+*/
+WaspUSB::WaspUSB(){
+    stream = stdout;
+    pendingBits = 0;
+}
+
+/*! \fn void output(const char *text)
+    \brief Write the text in the stream, nothing if it is NULL
+
+    The node waits for the UART while it prints, so the virtual clock advances the time of
+    the characters at USB_BAUD_RATE even if the logs are discarded.
+*/
+void WaspUSB::output(const char *text){
+    if(stream != NULL){
+        fputs(text, stream);
+    }
+    pendingBits += strlen(text) * USB_CHARACTER_BITS * 1000UL;
+    hostClock.advance(pendingBits / USB_BAUD_RATE);
+    pendingBits %= USB_BAUD_RATE;
+}
+
+void WaspUSB::printNumber(unsigned long number, int base){
+    char digits[sizeof(unsigned long) * 8 + 1];
+    uint8_t i = sizeof(digits) - 1;
+    if((base < 2) || (base > 16)){
+        base = DEC;
+    }
+    digits[i] = '\0';
+    do{
+        digits[--i] = "0123456789ABCDEF"[number % base];
+        number /= base;
+    }while(number > 0);
+    output(digits + i);
+}
+
+void WaspUSB::print(const char *string){
+    output(string);
+}
+
+void WaspUSB::print(char character){
+    char text[2] = {character, '\0'};
+    output(text);
+}
+
+void WaspUSB::print(unsigned char number, int base){
+    printNumber(number, base);
+}
+
+void WaspUSB::print(int number, int base){
+    print((long)number, base);
+}
+
+void WaspUSB::print(unsigned int number, int base){
+    printNumber(number, base);
+}
+
+void WaspUSB::print(long number, int base){
+    if((base == DEC) && (number < 0)){
+        output("-");
+        printNumber(-(unsigned long)number, base);
+    }else{
+        printNumber((unsigned long)number, base);
+    }
+}
+
+void WaspUSB::print(unsigned long number, int base){
+    printNumber(number, base);
+}
+
+void WaspUSB::print(double number, int digits){
+    char text[32];
+    snprintf(text, sizeof(text), "%.*f", digits, number);
+    output(text);
+}
+
+void WaspUSB::println(){
+    output("\r\n");
+}
+
+void WaspUSB::println(const char *string){
+    print(string);
+    println();
+}
+
+void WaspUSB::println(char character){
+    print(character);
+    println();
+}
+
+void WaspUSB::println(unsigned char number, int base){
+    print(number, base);
+    println();
+}
+
+void WaspUSB::println(int number, int base){
+    print(number, base);
+    println();
+}
+
+void WaspUSB::println(unsigned int number, int base){
+    print(number, base);
+    println();
+}
+
+void WaspUSB::println(long number, int base){
+    print(number, base);
+    println();
+}
+
+void WaspUSB::println(unsigned long number, int base){
+    print(number, base);
+    println();
+}
+
+void WaspUSB::println(double number, int digits){
+    print(number, digits);
+    println();
+}
+
+/*! \fn void printHex(uint8_t number)
+    \brief Print a byte as two hexadecimal digits
+*/
+void WaspUSB::printHex(uint8_t number){
+    char text[3];
+    snprintf(text, sizeof(text), "%02X", number);
+    output(text);
+}
+
+/*! \fn void setStream(FILE *output)
+    \brief Host only: send the logs to another stream, NULL discards them
+*/
+void WaspUSB::setStream(FILE *output){
+    stream = output;
+}
+
+/******************************************************************************
+ * WaspRTC                                                                    *
+ ******************************************************************************/
+
+/*! class constructor
+  The Alarm 1 is not set
+  \param void
+  \return void
+*/
+WaspRTC::WaspRTC(){
+    alarm1Time = HOST_NEVER;
+}
+
+void WaspRTC::ON(){
+}
+
+void WaspRTC::OFF(){
+}
+
+/*! \fn uint32_t getEpochTime()
+    \retval The epoch of the virtual clock, HOST_EPOCH_START at the start of the run
+*/
+uint32_t WaspRTC::getEpochTime(){
+    return HOST_EPOCH_START + (uint32_t)(hostClock.getTime() / 1000);
+}
+
+/*! \fn uint8_t setAlarm1(uint8_t day, uint8_t hour, uint8_t minute, uint8_t second, uint8_t offset, uint8_t mode)
+    \brief Set the Alarm 1
+    \param  offset Only RTC_OFFSET is supported on the host, the mode is ignored
+    \retval 0 if OK, 1 if the parameters are not correct
+*/
+uint8_t WaspRTC::setAlarm1(uint8_t day, uint8_t hour, uint8_t minute, uint8_t second, uint8_t offset, uint8_t mode){
+    (void)mode;
+    if((offset != RTC_OFFSET) || (hour > 23) || (minute > 59) || (second > 59)){
+        return 1;
+    }
+    alarm1Time = hostClock.getTime() + (((uint64_t)day * 86400UL + hour * 3600UL + minute * 60UL + second) * 1000UL);
+    return 0;
+}
+
+/*! \fn void clearAlarmFlag()
+    \brief Called when the Alarm 1 interrupt has been attended
+*/
+void WaspRTC::clearAlarmFlag(){
+    alarm1Time = HOST_NEVER;
+}
+
+/*! \fn uint64_t getAlarm1Time()
+    \retval Virtual time of the Alarm 1 in ms, HOST_NEVER if it is not set
+*/
+uint64_t WaspRTC::getAlarm1Time(){
+    return alarm1Time;
+}
+
+/******************************************************************************
+ * WaspUtils                                                                  *
+ ******************************************************************************/
+
+/*! \fn void hex2str(uint8_t *number, char *string, uint8_t length)
+    \brief Write length bytes as hexadecimal digits, with the end of string
+*/
+void WaspUtils::hex2str(uint8_t *number, char *string, uint8_t length){
+    for(uint8_t i = 0; i < length; i++){
+        sprintf(string + 2 * i, "%02X", number[i]);
+    }
+    string[2 * length] = '\0';
+}
+
+void WaspUtils::muxOFF1(){
+}
+
+/******************************************************************************
+ * FUNCTIONS                                                                  *
+ ******************************************************************************/
+
+/*! \fn unsigned long millis()
+    \retval ms of virtual time
+*/
+unsigned long millis(){
+    return (unsigned long)hostClock.getTime();
+}
+
+/*! \fn void delay(unsigned long ms)
+    \brief Let ms of virtual time pass
+*/
+void delay(unsigned long ms){
+    hostClock.advance(ms);
+}
+
+/*! \fn int freeMemory()
+    \retval 0, the free memory of the ATmega1281 is not modelled
+*/
+int freeMemory(){
+    return 0;
+}
+
+void beginSerial(long speed, uint8_t port){
+    (void)speed;
+    hostUart[port].open();
+}
+
+void closeSerial(uint8_t port){
+    hostUart[port].close();
+}
+
+/*! \fn int serialAvailable(uint8_t port)
+    \brief Bytes received in the UART of the socket
+
+    A poll without bytes lets 1 ms of virtual time pass, as the polling loops end with millis() timeouts.
+*/
+int serialAvailable(uint8_t port){
+    int available = hostUart[port].available();
+    if(available == 0){
+        hostClock.advance(1);
+    }
+    return available;
+}
+
+int serialRead(uint8_t port){
+    return hostUart[port].read();
+}
+
+void serialWrite(uint8_t byte, uint8_t port){
+    hostUart[port].write(&byte, 1);
+}
+
+void serialFlush(uint8_t port){
+    hostUart[port].flush();
+}
@@ -0,0 +1,172 @@
+/*! \file WaspClasses.h
+    \brief Subset of the Waspmote API used by the node, implemented on the host
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    USB prints on stdout and takes the virtual time of the UART at USB_BAUD_RATE, the RTC and millis() follow the virtual clock (HostClock.h) and the
+    socket UARTs are HostUart objects. Only the functions used by the node are provided.
+
+    The API objects, the virtual clock and the UARTs are thread_local, as the node globals
+    (NODE_LOCAL in defines.h): every thread runs an independent node.
+*/
+
+/*! \def __WPROGRAM_H__
+    \brief The Waspmote API flag, checked by the .cpp files of the node
+ */
+#ifndef __WPROGRAM_H__
+#define __WPROGRAM_H__
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "HostClock.h"
+#include "HostUart.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define F(string) (string)/*!< The strings are not in flash on the host */
+
+#define USB_BAUD_RATE 115200/*!< USB.ON() speed, every character takes 10 bits (8N1) */
+#define USB_CHARACTER_BITS 10
+
+#define BIN 2
+#define OCT 8
+#define DEC 10
+#define HEX 16
+
+#define RTC_OFFSET 0/*!< setAlarm1() time relative to the current time */
+#define RTC_ABSOLUTE 1/*!< setAlarm1() time of the day, not supported on the host */
+#define RTC_ALM1_MODE1 0
+#define RTC_ALM1_MODE2 1
+#define RTC_ALM1_MODE3 2
+#define RTC_ALM1_MODE4 3
+#define RTC_ALM1_MODE5 4
+#define RTC_ALM1_MODE6 5
+
+/******************************************************************************
+ * Class                                                                      *
+ ******************************************************************************/
+
+//! WaspUSB Class
+/*!
+  Logging through stdout
+ */
+class WaspUSB{
+
+/// private attributes //////////////
+private:
+
+    FILE *stream;/*!< Where the logs are written, NULL to discard them */
+    uint32_t pendingBits;/*!< Bits sent x 1000 that do not make a whole ms of virtual time yet */
+
+/// private methods //////////////////////////
+private:
+
+    void output(const char *text);
+
+    void printNumber(unsigned long number, int base);
+
+/// public methods ////////////
+public:
+
+    WaspUSB();
+
+    void setStream(FILE *output);
+
+    void print(const char *string);
+    void print(char character);
+    void print(unsigned char number, int base = DEC);
+    void print(int number, int base = DEC);
+    void print(unsigned int number, int base = DEC);
+    void print(long number, int base = DEC);
+    void print(unsigned long number, int base = DEC);
+    void print(double number, int digits = 2);
+
+    void println();
+    void println(const char *string);
+    void println(char character);
+    void println(unsigned char number, int base = DEC);
+    void println(int number, int base = DEC);
+    void println(unsigned int number, int base = DEC);
+    void println(long number, int base = DEC);
+    void println(unsigned long number, int base = DEC);
+    void println(double number, int digits = 2);
+
+    void printHex(uint8_t number);
+};
+
+//! WaspRTC Class
+/*!
+  RTC epoch and Alarm 1 over the virtual clock
+ */
+class WaspRTC{
+
+/// private attributes //////////////
+private:
+
+    uint64_t alarm1Time;/*!< Virtual time of the Alarm 1 in ms, HOST_NEVER if it is not set */
+
+/// public methods ////////////
+public:
+
+    WaspRTC();
+
+    void ON();
+
+    void OFF();
+
+    uint32_t getEpochTime();
+
+    uint8_t setAlarm1(uint8_t day, uint8_t hour, uint8_t minute, uint8_t second, uint8_t offset, uint8_t mode);
+
+    void clearAlarmFlag();
+
+    uint64_t getAlarm1Time();
+};
+
+//! WaspUtils Class
+/*!
+  Utilities
+ */
+class WaspUtils{
+
+/// public methods ////////////
+public:
+
+    void hex2str(uint8_t *number, char *string, uint8_t length);
+
+    void muxOFF1();
+};
+
+extern thread_local WaspUSB USB;
+extern thread_local WaspRTC RTC;
+extern thread_local WaspUtils Utils;
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+unsigned long millis();
+
+void delay(unsigned long ms);
+
+int freeMemory();
+
+void beginSerial(long speed, uint8_t port);
+
+void closeSerial(uint8_t port);
+
+int serialAvailable(uint8_t port);
+
+int serialRead(uint8_t port);
+
+void serialWrite(uint8_t byte, uint8_t port);
+
+void serialFlush(uint8_t port);
+
+#endif
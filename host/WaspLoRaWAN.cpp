@@ -0,0 +1,549 @@
+/*! \file WaspLoRaWAN.cpp
+    \brief RN2483 client of the host build, subset of the Waspmote WaspLoRaWAN library
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include "WaspClasses.h"
+#include "WaspLoRaWAN.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+thread_local WaspLoRaWAN LoRaWAN = WaspLoRaWAN();
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS                                                          *
+ ******************************************************************************/
+
+/*! \fn uint8_t readLine(unsigned long timeout)
+    \brief Read a line ended by "\r\n" in answer[], without the end of line
+    \retval 1 if a line was received, 0 otherwise
+*/
+uint8_t WaspLoRaWAN::readLine(unsigned long timeout){
+    unsigned long start = millis();
+    uint8_t length = 0;
+    int byte;
+    while((millis() - start) <= timeout){
+        if(serialAvailable(socket) == 0){
+            continue;
+        }
+        byte = serialRead(socket);
+        if(byte == '\n'){
+            answer[length] = '\0';
+            return 1;
+        }
+        if((byte != '\r') && (length < (LORAWAN_ANSWER_SIZE - 1))){
+            answer[length++] = byte;
+        }
+    }
+    answer[0] = '\0';
+    return 0;
+}
+
+/*! \fn uint8_t command(const char *text, unsigned long timeout)
+    \brief Send a command and read the first line of the answer in answer[]
+    \retval 0 if answered, 2 if there is no answer
+*/
+uint8_t WaspLoRaWAN::command(const char *text, unsigned long timeout){
+    serialFlush(socket);
+    hostUart[socket].write((const uint8_t *)text, strlen(text));
+    hostUart[socket].write((const uint8_t *)"\r\n", 2);
+    return readLine(timeout) ? 0 : 2;
+}
+
+/*! \fn uint8_t commandOk(const char *text)
+    \brief Send a command answered with "ok"
+    \retval 0 if OK, 1 if error, 2 if no answer
+*/
+uint8_t WaspLoRaWAN::commandOk(const char *text){
+    if(command(text) != 0){
+        return 2;
+    }
+    return (strcmp(answer, "ok") == 0) ? 0 : 1;
+}
+
+/*! \fn uint8_t getNumber(const char *text, uint32_t *number)
+    \brief Send a "get" command answered with a decimal number
+    \retval 0 if OK, 1 if error, 2 if no answer
+*/
+uint8_t WaspLoRaWAN::getNumber(const char *text, uint32_t *number){
+    unsigned long value;
+    if(command(text) != 0){
+        return 2;
+    }
+    if(sscanf(answer, "%lu", &value) != 1){
+        return 1;
+    }
+    *number = value;
+    return 0;
+}
+
+/*! \fn uint8_t send(const char *mode, uint8_t port, uint8_t *data, uint16_t length)
+    \brief "mac tx <mode> <port> <hex>" and the answer after the RX windows
+    \retval 0 if OK, 1 if error, 2 if no answer, 4 if data length error, 5 if error sending,
+            6 if not joined, 7 if port error
+*/
+uint8_t WaspLoRaWAN::send(const char *mode, uint8_t port, uint8_t *data, uint16_t length){
+    char text[16 + 2 * LORAWAN_MAX_PAYLOAD];
+    unsigned int rxPort;
+    int offset;
+    _dataReceived = false;
+    if((port < 1) || (port > 223)){
+        return 7;
+    }
+    if(length > LORAWAN_MAX_PAYLOAD){
+        return 4;
+    }
+    offset = sprintf(text, "mac tx %s %u ", mode, port);
+    for(uint16_t i = 0; i < length; i++){
+        offset += sprintf(text + offset, "%02X", data[i]);
+    }
+    if(command(text) != 0){
+        return 2;
+    }
+    if(strcmp(answer, "not_joined") == 0){
+        return 6;
+    }
+    if(strcmp(answer, "invalid_data_len") == 0){
+        return 4;
+    }
+    if(strcmp(answer, "ok") != 0){
+        return 1;
+    }
+    if(!readLine(LORAWAN_TX_TIMEOUT)){
+        return 2;
+    }
+    if(strcmp(answer, "mac_tx_ok") == 0){
+        return 0;
+    }
+    if(sscanf(answer, "mac_rx %u %n", &rxPort, &offset) == 1){
+        _port = rxPort;
+        strncpy(_data, answer + offset, sizeof(_data) - 1);
+        _data[sizeof(_data) - 1] = '\0';
+        _dataReceived = true;
+        return 0;
+    }
+    return 5;
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS                                                           *
+ ******************************************************************************/
+
+/*! class constructor
+  Default values of the RN2483 in the 868 band
+  \param void
+  \return void
+*/
+WaspLoRaWAN::WaspLoRaWAN(){
+    static const uint32_t defaultFreq[3] = {868100000UL, 868300000UL, 868500000UL};
+    socket = 1;
+    answer[0] = '\0';
+    _adr = false;
+    _ar = false;
+    for(uint8_t channel = 0; channel < LORAWAN_CHANNELS; channel++){
+        _freq[channel] = (channel < 3) ? defaultFreq[channel] : 0;
+        _dCycle[channel] = (channel < 3) ? 302 : 0;
+        _drrMin[channel] = 0;
+        _drrMax[channel] = (channel < 3) ? 5 : 0;
+        _status[channel] = (channel < 3) ? 1 : 0;
+    }
+    _powerIndex = 1;
+    strcpy(_devAddr, "00000000");
+    _retries = 7;
+    _upCounter = 0;
+    _downCounter = 0;
+    _gwNumber = 0;
+    _rx1Delay = 1000;
+    _rx2Delay = 2000;
+    _rx2DataRate = 3;
+    _rx2Frequency = 869525000UL;
+    _data[0] = '\0';
+    _port = 0;
+    _dataReceived = false;
+}
+
+/*! \fn uint8_t ON(uint8_t socket)
+    \brief Open the UART and check the module with "sys get ver"
+    \retval 0 if OK, 1 if the module is not a RN2483, 2 if no answer
+*/
+uint8_t WaspLoRaWAN::ON(uint8_t uartSocket){
+    socket = uartSocket;
+    beginSerial(57600, socket);
+    if(command("sys get ver") != 0){
+        return 2;
+    }
+    return (strncmp(answer, "RN2483", 6) == 0) ? 0 : 1;
+}
+
+/*! \fn uint8_t OFF(uint8_t socket)
+    \brief Close the UART
+    \retval 0
+*/
+uint8_t WaspLoRaWAN::OFF(uint8_t uartSocket){
+    closeSerial(uartSocket);
+    return 0;
+}
+
+uint8_t WaspLoRaWAN::setADR(char *state){
+    char text[32];
+    uint8_t response;
+    snprintf(text, sizeof(text), "mac set adr %s", state);
+    response = commandOk(text);
+    if(response == 0){
+        _adr = (strcmp(state, "on") == 0);
+    }
+    return response;
+}
+
+uint8_t WaspLoRaWAN::setAR(char *state){
+    char text[32];
+    uint8_t response;
+    snprintf(text, sizeof(text), "mac set ar %s", state);
+    response = commandOk(text);
+    if(response == 0){
+        _ar = (strcmp(state, "on") == 0);
+    }
+    return response;
+}
+
+uint8_t WaspLoRaWAN::getAR(){
+    if(command("mac get ar") != 0){
+        return 2;
+    }
+    _ar = (strcmp(answer, "on") == 0);
+    return 0;
+}
+
+uint8_t WaspLoRaWAN::setChannelFreq(uint8_t channel, uint32_t frequency){
+    char text[48];
+    uint8_t response;
+    if(channel >= LORAWAN_CHANNELS){
+        return 7;
+    }
+    snprintf(text, sizeof(text), "mac set ch freq %u %lu", channel, (unsigned long)frequency);
+    response = commandOk(text);
+    if(response == 0){
+        _freq[channel] = frequency;
+    }
+    return response;
+}
+
+uint8_t WaspLoRaWAN::getChannelFreq(uint8_t channel){
+    char text[32];
+    if(channel >= LORAWAN_CHANNELS){
+        return 7;
+    }
+    snprintf(text, sizeof(text), "mac get ch freq %u", channel);
+    return getNumber(text, &_freq[channel]);
+}
+
+uint8_t WaspLoRaWAN::setChannelDRRange(uint8_t channel, uint8_t minimum, uint8_t maximum){
+    char text[48];
+    uint8_t response;
+    if(channel >= LORAWAN_CHANNELS){
+        return 7;
+    }
+    snprintf(text, sizeof(text), "mac set ch drrange %u %u %u", channel, minimum, maximum);
+    response = commandOk(text);
+    if(response == 0){
+        _drrMin[channel] = minimum;
+        _drrMax[channel] = maximum;
+    }
+    return response;
+}
+
+uint8_t WaspLoRaWAN::getChannelDRRange(uint8_t channel){
+    char text[32];
+    unsigned int minimum, maximum;
+    if(channel >= LORAWAN_CHANNELS){
+        return 7;
+    }
+    snprintf(text, sizeof(text), "mac get ch drrange %u", channel);
+    if(command(text) != 0){
+        return 2;
+    }
+    if(sscanf(answer, "%u %u", &minimum, &maximum) != 2){
+        return 1;
+    }
+    _drrMin[channel] = minimum;
+    _drrMax[channel] = maximum;
+    return 0;
+}
+
+uint8_t WaspLoRaWAN::setChannelDutyCycle(uint8_t channel, uint16_t dutyCycle){
+    char text[48];
+    uint8_t response;
+    if(channel >= LORAWAN_CHANNELS){
+        return 7;
+    }
+    snprintf(text, sizeof(text), "mac set ch dcycle %u %u", channel, dutyCycle);
+    response = commandOk(text);
+    if(response == 0){
+        _dCycle[channel] = dutyCycle;
+    }
+    return response;
+}
+
+uint8_t WaspLoRaWAN::getChannelDutyCycle(uint8_t channel){
+    char text[32];
+    uint32_t dutyCycle;
+    uint8_t response;
+    if(channel >= LORAWAN_CHANNELS){
+        return 7;
+    }
+    snprintf(text, sizeof(text), "mac get ch dcycle %u", channel);
+    response = getNumber(text, &dutyCycle);
+    if(response == 0){
+        _dCycle[channel] = dutyCycle;
+    }
+    return response;
+}
+
+uint8_t WaspLoRaWAN::setChannelStatus(uint8_t channel, char *state){
+    char text[48];
+    uint8_t response;
+    if(channel >= LORAWAN_CHANNELS){
+        return 7;
+    }
+    snprintf(text, sizeof(text), "mac set ch status %u %s", channel, state);
+    response = commandOk(text);
+    if(response == 0){
+        _status[channel] = (strcmp(state, "on") == 0);
+    }
+    return response;
+}
+
+uint8_t WaspLoRaWAN::getChannelStatus(uint8_t channel){
+    char text[32];
+    if(channel >= LORAWAN_CHANNELS){
+        return 7;
+    }
+    snprintf(text, sizeof(text), "mac get ch status %u", channel);
+    if(command(text) != 0){
+        return 2;
+    }
+    _status[channel] = (strcmp(answer, "on") == 0);
+    return 0;
+}
+
+uint8_t WaspLoRaWAN::setPower(uint8_t index){
+    char text[32];
+    uint8_t response;
+    snprintf(text, sizeof(text), "mac set pwridx %u", index);
+    response = commandOk(text);
+    if(response == 0){
+        _powerIndex = index;
+    }
+    return response;
+}
+
+uint8_t WaspLoRaWAN::getPower(){
+    uint32_t index;
+    uint8_t response = getNumber("mac get pwridx", &index);
+    if(response == 0){
+        _powerIndex = index;
+    }
+    return response;
+}
+
+uint8_t WaspLoRaWAN::setDataRate(uint8_t datarate){
+    char text[32];
+    snprintf(text, sizeof(text), "mac set dr %u", datarate);
+    return commandOk(text);
+}
+
+uint8_t WaspLoRaWAN::setRetries(uint8_t retries){
+    char text[32];
+    uint8_t response;
+    snprintf(text, sizeof(text), "mac set retx %u", retries);
+    response = commandOk(text);
+    if(response == 0){
+        _retries = retries;
+    }
+    return response;
+}
+
+uint8_t WaspLoRaWAN::getRetries(){
+    uint32_t retries;
+    uint8_t response = getNumber("mac get retx", &retries);
+    if(response == 0){
+        _retries = retries;
+    }
+    return response;
+}
+
+uint8_t WaspLoRaWAN::setDeviceEUI(char *eui){
+    char text[48];
+    snprintf(text, sizeof(text), "mac set deveui %s", eui);
+    return commandOk(text);
+}
+
+uint8_t WaspLoRaWAN::setAppEUI(char *eui){
+    char text[48];
+    snprintf(text, sizeof(text), "mac set appeui %s", eui);
+    return commandOk(text);
+}
+
+uint8_t WaspLoRaWAN::setAppKey(char *key){
+    char text[64];
+    snprintf(text, sizeof(text), "mac set appkey %s", key);
+    return commandOk(text);
+}
+
+uint8_t WaspLoRaWAN::setDeviceAddr(char *address){
+    char text[48];
+    snprintf(text, sizeof(text), "mac set devaddr %s", address);
+    return commandOk(text);
+}
+
+uint8_t WaspLoRaWAN::getDeviceAddr(){
+    if(command("mac get devaddr") != 0){
+        return 2;
+    }
+    strncpy(_devAddr, answer, sizeof(_devAddr) - 1);
+    _devAddr[sizeof(_devAddr) - 1] = '\0';
+    return 0;
+}
+
+uint8_t WaspLoRaWAN::setNwkSessionKey(char *key){
+    char text[64];
+    snprintf(text, sizeof(text), "mac set nwkskey %s", key);
+    return commandOk(text);
+}
+
+uint8_t WaspLoRaWAN::setAppSessionKey(char *key){
+    char text[64];
+    snprintf(text, sizeof(text), "mac set appskey %s", key);
+    return commandOk(text);
+}
+
+/*! \fn uint8_t joinOTAA()
+    \brief "mac join otaa" and the answer of the network
+    \retval 0 if accepted, 1 if error or denied, 2 if no answer
+*/
+uint8_t WaspLoRaWAN::joinOTAA(){
+    uint8_t response = commandOk("mac join otaa");
+    if(response != 0){
+        return response;
+    }
+    if(!readLine(LORAWAN_JOIN_TIMEOUT)){
+        return 2;
+    }
+    return (strcmp(answer, "accepted") == 0) ? 0 : 1;
+}
+
+/*! \fn uint8_t joinABP()
+    \brief "mac join abp" and the answer of the module
+    \retval 0 if accepted, 1 if error, 2 if no answer
+*/
+uint8_t WaspLoRaWAN::joinABP(){
+    uint8_t response = commandOk("mac join abp");
+    if(response != 0){
+        return response;
+    }
+    if(!readLine(LORAWAN_ANSWER_TIMEOUT)){
+        return 2;
+    }
+    return (strcmp(answer, "accepted") == 0) ? 0 : 1;
+}
+
+uint8_t WaspLoRaWAN::saveConfig(){
+    if(command("mac save", LORAWAN_JOIN_TIMEOUT) != 0){
+        return 2;
+    }
+    return (strcmp(answer, "ok") == 0) ? 0 : 1;
+}
+
+uint8_t WaspLoRaWAN::sendUnconfirmed(uint8_t port, uint8_t *data, uint16_t length){
+    return send("uncnf", port, data, length);
+}
+
+uint8_t WaspLoRaWAN::sendConfirmed(uint8_t port, uint8_t *data, uint16_t length){
+    return send("cnf", port, data, length);
+}
+
+/*! \fn uint8_t setBatteryLevel()
+    \brief "mac set bat 0": the host is connected to an external power source
+*/
+uint8_t WaspLoRaWAN::setBatteryLevel(){
+    return commandOk("mac set bat 0");
+}
+
+uint8_t WaspLoRaWAN::getUpCounter(){
+    return getNumber("mac get upctr", &_upCounter);
+}
+
+uint8_t WaspLoRaWAN::getDownCounter(){
+    return getNumber("mac get dnctr", &_downCounter);
+}
+
+uint8_t WaspLoRaWAN::getGatewayNumber(){
+    uint32_t number;
+    uint8_t response = getNumber("mac get gwnb", &number);
+    if(response == 0){
+        _gwNumber = number;
+    }
+    return response;
+}
+
+uint8_t WaspLoRaWAN::setRX1Delay(uint16_t delay){
+    char text[32];
+    uint8_t response;
+    snprintf(text, sizeof(text), "mac set rxdelay1 %u", delay);
+    response = commandOk(text);
+    if(response == 0){
+        _rx1Delay = delay;
+    }
+    return response;
+}
+
+uint8_t WaspLoRaWAN::getRX1Delay(){
+    uint32_t delay;
+    uint8_t response = getNumber("mac get rxdelay1", &delay);
+    if(response == 0){
+        _rx1Delay = delay;
+    }
+    return response;
+}
+
+uint8_t WaspLoRaWAN::getRX2Delay(){
+    uint32_t delay;
+    uint8_t response = getNumber("mac get rxdelay2", &delay);
+    if(response == 0){
+        _rx2Delay = delay;
+    }
+    return response;
+}
+
+uint8_t WaspLoRaWAN::setRX2Parameters(uint8_t datarate, uint32_t frequency){
+    char text[48];
+    uint8_t response;
+    snprintf(text, sizeof(text), "mac set rx2 %u %lu", datarate, (unsigned long)frequency);
+    response = commandOk(text);
+    if(response == 0){
+        _rx2DataRate = datarate;
+        _rx2Frequency = frequency;
+    }
+    return response;
+}
+
+uint8_t WaspLoRaWAN::getRX2Parameters(char *band){
+    char text[32];
+    unsigned int datarate;
+    unsigned long frequency;
+    snprintf(text, sizeof(text), "mac get rx2 %s", band);
+    if(command(text) != 0){
+        return 2;
+    }
+    if(sscanf(answer, "%u %lu", &datarate, &frequency) != 2){
+        return 7;
+    }
+    _rx2DataRate = datarate;
+    _rx2Frequency = frequency;
+    return 0;
+}
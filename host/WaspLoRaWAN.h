@@ -0,0 +1,174 @@
+/*! \file WaspLoRaWAN.h
+    \brief RN2483 client of the host build, subset of the Waspmote WaspLoRaWAN library
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    The commands are the ASCII commands of the RN2483 ("mac set adr on\r\n") written to the SOCKET1
+    UART, and the answers are read line by line. The results are left in the public attributes, as
+    in the Waspmote library.
+
+    Return codes: 0 OK, 1 error, 2 no answer, 4 data length error, 5 error sending,
+    6 not joined, 7 input parameter error.
+*/
+
+/*! \def _WASPLORAWAN_H
+    \brief The library flag
+ */
+#ifndef _WASPLORAWAN_H
+#define _WASPLORAWAN_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define LORAWAN_ANSWER_SIZE 128/*!< Longest answer line */
+#define LORAWAN_ANSWER_TIMEOUT 500/*!< ms to wait for the answer of a command */
+#define LORAWAN_JOIN_TIMEOUT 10000/*!< ms to wait for the second answer of mac join */
+#define LORAWAN_TX_TIMEOUT 20000/*!< ms to wait for the second answer of mac tx (RX windows and retries) */
+#define LORAWAN_MAX_PAYLOAD 242/*!< Longest payload of mac tx */
+#define LORAWAN_CHANNELS 16
+
+/******************************************************************************
+ * Class                                                                      *
+ ******************************************************************************/
+
+//! WaspLoRaWAN Class
+/*!
+  RN2483 commands over the SOCKET1 UART
+ */
+class WaspLoRaWAN{
+
+/// private attributes //////////////
+private:
+
+    uint8_t socket;/*!< UART of the module */
+    char answer[LORAWAN_ANSWER_SIZE];/*!< Last line received */
+
+/// private methods //////////////////////////
+private:
+
+    uint8_t readLine(unsigned long timeout);
+
+    uint8_t command(const char *text, unsigned long timeout = LORAWAN_ANSWER_TIMEOUT);
+
+    uint8_t commandOk(const char *text);
+
+    uint8_t getNumber(const char *text, uint32_t *number);
+
+    uint8_t send(const char *mode, uint8_t port, uint8_t *data, uint16_t length);
+
+/// public attributes ////////////
+public:
+
+    bool _adr;
+    bool _ar;
+    uint32_t _freq[LORAWAN_CHANNELS];
+    uint16_t _dCycle[LORAWAN_CHANNELS];
+    uint8_t _drrMin[LORAWAN_CHANNELS];
+    uint8_t _drrMax[LORAWAN_CHANNELS];
+    uint8_t _status[LORAWAN_CHANNELS];
+    uint8_t _powerIndex;
+    char _devAddr[9];
+    uint8_t _retries;
+    uint32_t _upCounter;
+    uint32_t _downCounter;
+    uint8_t _gwNumber;
+    uint16_t _rx1Delay;
+    uint16_t _rx2Delay;
+    uint8_t _rx2DataRate;
+    uint32_t _rx2Frequency;
+    char _data[2 * LORAWAN_MAX_PAYLOAD + 1];/*!< Downlink payload as hexadecimal digits */
+    uint8_t _port;/*!< Port of the downlink */
+    bool _dataReceived;/*!< true if the last send received a downlink */
+
+/// public methods ////////////
+public:
+
+    WaspLoRaWAN();
+
+    uint8_t ON(uint8_t socket);
+
+    uint8_t OFF(uint8_t socket);
+
+    uint8_t setADR(char *state);
+
+    uint8_t setAR(char *state);
+
+    uint8_t getAR();
+
+    uint8_t setChannelFreq(uint8_t channel, uint32_t frequency);
+
+    uint8_t getChannelFreq(uint8_t channel);
+
+    uint8_t setChannelDRRange(uint8_t channel, uint8_t minimum, uint8_t maximum);
+
+    uint8_t getChannelDRRange(uint8_t channel);
+
+    uint8_t setChannelDutyCycle(uint8_t channel, uint16_t dutyCycle);
+
+    uint8_t getChannelDutyCycle(uint8_t channel);
+
+    uint8_t setChannelStatus(uint8_t channel, char *state);
+
+    uint8_t getChannelStatus(uint8_t channel);
+
+    uint8_t setPower(uint8_t index);
+
+    uint8_t getPower();
+
+    uint8_t setDataRate(uint8_t datarate);
+
+    uint8_t setRetries(uint8_t retries);
+
+    uint8_t getRetries();
+
+    uint8_t setDeviceEUI(char *eui);
+
+    uint8_t setAppEUI(char *eui);
+
+    uint8_t setAppKey(char *key);
+
+    uint8_t setDeviceAddr(char *address);
+
+    uint8_t getDeviceAddr();
+
+    uint8_t setNwkSessionKey(char *key);
+
+    uint8_t setAppSessionKey(char *key);
+
+    uint8_t joinOTAA();
+
+    uint8_t joinABP();
+
+    uint8_t saveConfig();
+
+    uint8_t sendUnconfirmed(uint8_t port, uint8_t *data, uint16_t length);
+
+    uint8_t sendConfirmed(uint8_t port, uint8_t *data, uint16_t length);
+
+    uint8_t setBatteryLevel();
+
+    uint8_t getUpCounter();
+
+    uint8_t getDownCounter();
+
+    uint8_t getGatewayNumber();
+
+    uint8_t setRX1Delay(uint16_t delay);
+
+    uint8_t getRX1Delay();
+
+    uint8_t getRX2Delay();
+
+    uint8_t setRX2Parameters(uint8_t datarate, uint32_t frequency);
+
+    uint8_t getRX2Parameters(char *band);
+};
+
+extern thread_local WaspLoRaWAN LoRaWAN;
+
+#endif
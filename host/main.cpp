@@ -0,0 +1,32 @@
+/*! \file main.cpp
+    \brief Linux executable of the node state machine
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    Usage: node [seconds]
+
+    Runs setup() and loop() of main.pde until the virtual clock reaches the given seconds
+    (one day by default). The modules are the devices attached to hostUart[], none by default.
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include "WaspClasses.h"
+#include "main.pde"
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+int main(int argc, char *argv[]){
+    uint64_t duration = 86400ULL * 1000;
+    if(argc > 1){
+        duration = strtoull(argv[1], NULL, 10) * 1000;
+    }
+    setup();
+    while(hostClock.getTime() < duration){
+        loop();
+    }
+    return 0;
+}
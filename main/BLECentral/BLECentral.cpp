@@ -14,6 +14,37 @@
 #include <WaspBLE.h>
 #include "defines.h"
 #include "BLECentral.h"
+#include "Log.h"
+#include "Trace.h"
+#include "Profile.h"
+#include "MemoryStats.h"
+
+/*! \var sensorUuid
+    \brief Characteristic read for each UplinkTypes_t, indexed by type
+*/
+uint8_t *sensorUuid[FIELD_STRENGHT_TYPE + 1] = {
+    0,/*BLE_DISCONNECT, not a characteristic*/
+    Service4_Characrteristic0_UV_Index_uuid,
+    Service4_Characrteristic1_Pressure_uuid,
+    Service4_Characrteristic2_Temperature_uuid,
+    Service4_Characrteristic4_Ambient_Light_uuid,
+    Service4_Characrteristic5_Sound_Level_uuid,
+    Service4_Characrteristic3_Humidity_uuid,
+    Service3_Characrteristic0_Battery_Level_uuid,
+    Service6_Characrteristic0_ECO2_uuid,
+    Service6_Characrteristic1_TVOC_uuid,
+    ServiceA_Characrteristic0_State_uuid,
+    ServiceA_Characrteristic1_Field_Strength_uuid
+};
+
+/*! \var wakeUpEvents
+    \brief Events that may wake the node up while it sleeps connected
+*/
+static const bgapiEventFormat_t wakeUpEvents[] = {
+    {4, 5, 5, 4, BLE_WAKE_NOTIFICATION},/*attclient_attribute_value: connection, atthandle, type, value*/
+    {3, 4, 3, 0xFF, BLE_WAKE_DISCONNECTED},/*connection_disconnected: connection, reason*/
+    {4, 1, 5, 0xFF, BLE_WAKE_OTHER}/*attclient_procedure_completed: connection, result, chrhandle*/
+};
 
 /******************************************************************************
  * PUBLIC FUNCTIONS                                                           *
@@ -25,7 +56,10 @@ It does nothing
 \return void
 */
 BLECentral::BLECentral(){
-  
+    device = NULL;
+    memset(sensorHandle, 0, sizeof(sensorHandle));
+    memset(sensorCccdHandle, 0, sizeof(sensorCccdHandle));
+    attMtu = ATT_DEFAULT_MTU;
 }
 
 /*! class Destructor
@@ -47,13 +81,14 @@ BLECentral::~BLECentral(){
     This function opens the UART and powers the module in the corresponding socket 
 */
 int8_t BLECentral::turnOnModule(uint8_t socket){
+  PROFILE(PROFILE_BLE_TURN_ON);
   int8_t response;
   response = BLE.ON(socket);
   if(response == 0){
-    USB.println(F("BLE module switch on Ok "));
+    LOG_INFOLN(F("BLE module switch on Ok "));
   }else{
-     USB.print(F("BLE module switch, ERROR = "));
-     USB.println(response, DEC);
+     LOG_ERROR(F("BLE module switch, ERROR = "));
+     LOG_ERRORLN(response, DEC);
   }
   return response;
 }
@@ -66,6 +101,7 @@ int8_t BLECentral::turnOnModule(uint8_t socket){
     This function closes the UART and switches off the module
 */
 void BLECentral::turnOffModule(){
+  PROFILE(PROFILE_BLE_TURN_OFF);
   BLE.OFF(); 
 }
 
@@ -89,10 +125,10 @@ uint8_t BLECentral::bleAdvdataDecode(uint8_t type, uint8_t advdata_len, uint8_t
     while (index < advdata_len ) {
         field_length = p_advdata[index];
         field_type = p_advdata[index + 1];
-        USB.print(F("      - AVD/SR data decoding -> ad_type: "));
-        USB.print(field_type, HEX);
-        USB.print(F(", length: "));
-        USB.println(field_length, HEX);    
+        LOG_VERBOSE(F("      - AVD/SR data decoding -> ad_type: "));
+        LOG_VERBOSE(field_type, HEX);
+        LOG_VERBOSE(F(", length: "));
+        LOG_VERBOSELN(field_length, HEX);    
         if (field_type == type) {
             memcpy(p_field_data, &p_advdata[index + 2], (field_length - 1));
             *len = field_length - 1;
@@ -112,35 +148,39 @@ uint8_t BLECentral::bleAdvdataDecode(uint8_t type, uint8_t advdata_len, uint8_t
     This function handle the report scan response and search for the Device adv_name.
 */
 uint8_t BLECentral::scanReport(char *nameToSearch) {
-    USB.println(F(""));
-    USB.println(F("* BLE scan report: "));
-    USB.print(F("   - Peer device address: "));
+    PROFILE(PROFILE_BLE_SCAN_REPORT);
+    if((device == NULL) && !newDevice()){
+        return 0;
+    }
+    LOG_INFOLN(F(""));
+    LOG_INFOLN(F("* BLE scan report: "));
+    LOG_INFO(F("   - Peer device address: "));
     Utils.hex2str(BLE.BLEDev.mac, device->mac, 6);
-    USB.println(device->mac);
-    USB.print(F("   - RSSI: "));
-    USB.print(BLE.BLEDev.rssi, DEC);
-    USB.println(F(" dBm "));
-    USB.print(F("   - Advertising data packet("));
-    USB.print(BLE.BLEDev.advData[0], DEC);
-    USB.print(F(" Bytes): "));
+    LOG_INFOLN(device->mac);
+    LOG_INFO(F("   - RSSI: "));
+    LOG_INFO(BLE.BLEDev.rssi, DEC);
+    LOG_INFOLN(F(" dBm "));
+    LOG_INFO(F("   - Advertising data packet("));
+    LOG_INFO(BLE.BLEDev.advData[0], DEC);
+    LOG_INFO(F(" Bytes): "));
     for (int index = 1; index < BLE.BLEDev.advData[0]; index++) {
-        USB.print(BLE.BLEDev.advData[index], HEX);
-        USB.print(F(" "));
+        LOG_VERBOSE(BLE.BLEDev.advData[index], HEX);
+        LOG_VERBOSE(F(" "));
     }
-    USB.println(F(" "));
+    LOG_INFOLN(F(" "));
     
     uint8_t len;
     uint8_t adv_name[31];
 
     if (0x00 == bleAdvdataDecode(0x09, BLE.BLEDev.advData[0], BLE.BLEDev.advData, &len, adv_name)) {
-        USB.print(F("  The length of Complete Local Name : "));
-        USB.println(len, HEX);
-        USB.print(F("  The Complete Local Name is        : "));
+        LOG_INFO(F("  The length of Complete Local Name : "));
+        LOG_INFOLN(len, HEX);
+        LOG_INFO(F("  The Complete Local Name is        : "));
         adv_name[len]= 0;
-        USB.println((const char *)adv_name); 
-        USB.println(F(""));
+        LOG_INFOLN((const char *)adv_name); 
+        LOG_INFOLN(F(""));
         if (0x00 == memcmp(adv_name, nameToSearch, len)) {
-            USB.println(F("* Thunder Sense #02735 found"));
+            LOG_INFOLN(F("* Thunder Sense #02735 found"));
             return 1;	
         }
     } 
@@ -168,6 +208,7 @@ uint8_t BLECentral::scanReport(char *nameToSearch) {
     This function performs the BLE scanner configuration
 */
 void BLECentral::configureScanner(uint8_t txPower, uint8_t discoverMode, uint16_t scanInterval, uint16_t scanWindow, uint8_t scanningFilter){	
+  PROFILE(PROFILE_BLE_CONFIGURE_SCANNER);
   BLE.setDiscoverMode(discoverMode);
 	BLE.setTXPower(txPower);
 	BLE.setScanningParameters(scanInterval, scanWindow, scanningFilter );
@@ -190,16 +231,17 @@ void BLECentral::configureScanner(uint8_t txPower, uint8_t discoverMode, uint16_
     This function starts the BLE scan process to discover specific device by its Mac 
 */
 uint16_t BLECentral::startScanningDevice(char mac[]){
+	PROFILE(PROFILE_BLE_START_SCANNING_DEVICE);
 	uint16_t response = 0;
 	
 	response = BLE.scanDevice(mac);//devuelve 1
 	if(response == 1){
-		USB.println(F("__________Device found"));
+		LOG_INFOLN(F("__________Device found"));
 	}else if (response == 0){
-		USB.println(F("__________Device NOT found"));	
+		LOG_ERRORLN(F("__________Device NOT found"));	
 	}else{
-    USB.print(F("Scanner, ERROR = "));
-    USB.println(response, DEC);
+    LOG_ERROR(F("Scanner, ERROR = "));
+    LOG_ERRORLN(response, DEC);
   }
   return response;
 }
@@ -214,13 +256,14 @@ uint16_t BLECentral::startScanningDevice(char mac[]){
     This function starts the BLE scan process for the specified time.
 */ 
 uint16_t BLECentral::startScanning(uint8_t time){
+    PROFILE(PROFILE_BLE_START_SCANNING);
     uint16_t response = 0;
     response = BLE.scanNetwork(time);
     if(response == 0){
-        USB.println(F("__________Device found"));
+        LOG_INFOLN(F("__________Device found"));
     }else{
-        USB.print(F("Scanner, ERROR = "));
-        USB.println(response, DEC);
+        LOG_ERROR(F("Scanner, ERROR = "));
+        LOG_ERRORLN(response, DEC);
     }
     return response;
 }
@@ -236,20 +279,22 @@ uint16_t BLECentral::startScanning(uint8_t time){
     This function will start direct connection establishment procedure to a dedicated BLE device. Central<--->Peripheral(MAC). 
 */
 uint16_t BLECentral::connect(char mac[]){
+	PROFILE(PROFILE_BLE_CONNECT);
 	
 	uint8_t response;
-	USB.println(F("_________Connecting... "));
+	LOG_INFOLN(F("_________Connecting... "));
 	response = BLE.connectDirect(mac);
 	if (response == 1){
-        USB.println(F("_________Connected"));
-        USB.print(F("             -connection_handle: "));
-        USB.println(BLE.connection_handle, DEC);
-        USB.print(F(""));
+        LOG_INFOLN(F("_________Connected"));
+        LOG_INFO(F("             -connection_handle: "));
+        LOG_INFOLN(BLE.connection_handle, DEC);
+        LOG_INFO(F(""));
+        attMtu = ATT_DEFAULT_MTU;//The BLE112 does not exchange the MTU, the link keeps the default
     }else if (response == 0){
-        USB.println(F("Invalid parameters"));  
+        LOG_ERRORLN(F("Invalid parameters"));  
     }else{
-        USB.print(F("Connection ERROR = "));
-        USB.println(response, DEC);
+        LOG_ERROR(F("Connection ERROR = "));
+        LOG_ERRORLN(response, DEC);
     }
     return response; 
 }
@@ -267,19 +312,21 @@ uint16_t BLECentral::connect(char mac[]){
 */
 uint16_t BLECentral::connectWithSelectedParameters(char mac[], uint16_t conn_interval_min, uint16_t conn_interval_max, 
 uint16_t timeout, uint16_t latency){
+	PROFILE(PROFILE_BLE_CONNECT_PARAMETERS);
 	
 	uint16_t response = 0;
 	
-	USB.println(F("_________Connecting... "));
+	LOG_INFOLN(F("_________Connecting... "));
 	response = BLE.connectDirect(mac, conn_interval_min, conn_interval_max, timeout, latency);//default connectDirect(BLEAddress, 60, 76, 100, 0);
 	if (response == 1){
-        USB.println(F("_________Connected"));
-        USB.print(F("             -connection_handle: "));
-        USB.println(BLE.connection_handle, DEC);
-        USB.print(F(""));
+        LOG_INFOLN(F("_________Connected"));
+        LOG_INFO(F("             -connection_handle: "));
+        LOG_INFOLN(BLE.connection_handle, DEC);
+        LOG_INFO(F(""));
+        attMtu = ATT_DEFAULT_MTU;//The BLE112 does not exchange the MTU, the link keeps the default
         return 1;
     }else{
-        USB.println(F("NOT Connected"));  
+        LOG_ERRORLN(F("NOT Connected"));  
         return 0;
     }
     
@@ -297,15 +344,16 @@ uint16_t timeout, uint16_t latency){
     This function disconnects an active connection.
 */ 
 uint16_t BLECentral::disconnect(uint8_t connectionHandle){
+	PROFILE(PROFILE_BLE_DISCONNECT);
 	uint16_t response = 0;
 	response =  BLE.disconnect(connectionHandle);
 	if (response == 0){
-        USB.println(F("_________Disconnected"));
+        LOG_INFOLN(F("_________Disconnected"));
     }else if (response == 1){
-        USB.print(F("Connection handle is not right")); 
+        LOG_ERROR(F("Connection handle is not right")); 
     }else{
-        USB.print(F("Disconnect, Error = "));  
-        USB.println(response, HEX);  
+        LOG_ERROR(F("Disconnect, Error = "));  
+        LOG_ERRORLN(response, HEX);  
     }
     return response;
 }
@@ -320,11 +368,12 @@ uint16_t BLECentral::disconnect(uint8_t connectionHandle){
     The result is save in Device_t->servicio[].service 
 */
 uint8_t BLECentral::discoverServices(){
+    PROFILE(PROFILE_BLE_DISCOVER_SERVICES);
     
     uint16_t event = 0;
     readByGroupCommand_t command;
     command = getDiscoverServiceGroupCommand();
-    USB.println(F("_________Discovering Services... "));
+    LOG_INFOLN(F("_________Discovering Services... "));
     BLE.sendCommand((uint8_t *)&command, command.t_length+1);
     BLE.readCommandAnswer();
     while(event != BLE_EVENT_ATTCLIENT_PROCEDURE_COMPLETED){
@@ -332,13 +381,13 @@ uint8_t BLECentral::discoverServices(){
         if(event == BLE_EVENT_ATTCLIENT_GROUP_FOUND){ 
             newService( BLE.event);
         }else if(event == 0){//No hay evento
-            USB.println(F("The connection to the peripheral device has been disconnected"));
+            LOG_ERRORLN(F("The connection to the peripheral device has been disconnected"));
             return 0;  
         }
     }
-    USB.print(F("_________Discovering Services completed ("));
-    USB.print(device->numberOfServices, DEC);
-    USB.println(F(")"));
+    LOG_INFO(F("_________Discovering Services completed ("));
+    LOG_INFO(device->numberOfServices, DEC);
+    LOG_INFOLN(F(")"));
     return 1;
 }
 
@@ -352,11 +401,12 @@ uint8_t BLECentral::discoverServices(){
     because it use the discovery service to search the characteristics.
 */
 uint8_t BLECentral::discoverCharacteristics(){
+    PROFILE(PROFILE_BLE_DISCOVER_CHARACTERISTICS);
     
     uint16_t event;
     readByGroupCommand_t command;
     command = getDiscoverCharacteristicsCommand();
-    USB.println(F("_________Discovering Characteristics... "));
+    LOG_INFOLN(F("_________Discovering Characteristics... "));
     for(uint8_t numSer = 0; numSer < device->numberOfServices; numSer++){
         command.startFirstAttributeHandle = ((device->service[numSer].service.start_group_handle)+1);
         command.endLastAttributeHandle = ((device->service[numSer].service.end_group_handle)-1);
@@ -368,13 +418,13 @@ uint8_t BLECentral::discoverCharacteristics(){
             if(event == BLE_EVENT_ATTCLIENT_ATTRIBUTE_VALUE){ 
                 newCharacteristic(&device->service[numSer], BLE.event);
             }else if(event == 0){
-                USB.println(F("The connection to the peripheral device has been disconnected"));
+                LOG_ERRORLN(F("The connection to the peripheral device has been disconnected"));
                 return 0; 
             }
         }
     }
-    USB.println(F("_________Discovering Characteristics completed"));
-    USB.println(F(""));
+    LOG_INFOLN(F("_________Discovering Characteristics completed"));
+    LOG_INFOLN(F(""));
     return 1;
 }
 
@@ -389,11 +439,12 @@ uint8_t BLECentral::discoverCharacteristics(){
     because it use the Characteristics parameters to search the descriptors.
 */ 
 uint8_t BLECentral::discoverDescriptors(){
+  PROFILE(PROFILE_BLE_DISCOVER_DESCRIPTORS);
   uint8_t numSer, numCar;
   findInformationCommand_t command;
   command = getDiscoverDescriptorsCommand();
   uint16_t servEndHandle, carcValueHandle, nexCarcStarHandle;
-  USB.println(F("_________Discovering Descriptors... "));
+  LOG_INFOLN(F("_________Discovering Descriptors... "));
   for(numSer = 0; numSer < device->numberOfServices; numSer++){
     servEndHandle = device->service[numSer].service.end_group_handle;
     for(numCar = 0; numCar < device->service[numSer].numberOfCharacteristics; numCar++){
@@ -439,8 +490,8 @@ uint8_t BLECentral::discoverDescriptors(){
       }
     }
   }       
-  USB.println(F("_________Discovering Descriptors completed"));
-  USB.println(F(""));
+  LOG_INFOLN(F("_________Discovering Descriptors completed"));
+  LOG_INFOLN(F(""));
   return 1;
 } 
 
@@ -451,14 +502,23 @@ uint8_t BLECentral::discoverDescriptors(){
             0: Error
             
     This function discovers the BLE profile.
+    The profile of a previous connection is freed first, after a reconnection the services would be appended to it.
     * Idea para no tener el problema de primero descubrir servicios, despues caract y luego descrip 
 */
 uint8_t BLECentral::discoverBLEProfile(){
+    PROFILE(PROFILE_BLE_DISCOVER_PROFILE);
     
+    if((device == NULL) && !newDevice()){
+        return 0;
+    }
+    if(device->numberOfServices > 0){
+        freeDevice();
+    }
     if(discoverServices()){
         if(discoverCharacteristics()){
             if(discoverDescriptors()){
                 printBLEProfile();
+                resolveSensorHandles();
                 return 1;
             }
         }
@@ -476,58 +536,58 @@ uint8_t BLECentral::discoverBLEProfile(){
 */
 void BLECentral::printBLEProfile(){
     uint8_t numSer, numCar, numDesc;
-    USB.println(F("___________________BLE Profile___________________"));
-    USB.println(F(""));
+    LOG_INFOLN(F("___________________BLE Profile___________________"));
+    LOG_INFOLN(F(""));
     for(numSer = 0; numSer < device->numberOfServices; numSer++){
-        USB.print(F("* Service number "));
-        USB.println( numSer, HEX );
-        USB.print(F("   - Service start handle: "));
-        USB.println(device->service[numSer].service.start_group_handle, HEX);
-        USB.print(F("   - Service end handle: "));
-        USB.println(device->service[numSer].service.end_group_handle, HEX);
-        USB.print(F("   - Service uuid16: "));
-        USB.println(device->service[numSer].service.uuid16, HEX);
-        USB.print(F("   - Service uuid128: "));
+        LOG_VERBOSE(F("* Service number "));
+        LOG_VERBOSELN( numSer, HEX );
+        LOG_VERBOSE(F("   - Service start handle: "));
+        LOG_VERBOSELN(device->service[numSer].service.start_group_handle, HEX);
+        LOG_VERBOSE(F("   - Service end handle: "));
+        LOG_VERBOSELN(device->service[numSer].service.end_group_handle, HEX);
+        LOG_VERBOSE(F("   - Service uuid16: "));
+        LOG_VERBOSELN(device->service[numSer].service.uuid16, HEX);
+        LOG_VERBOSE(F("   - Service uuid128: "));
         for(int p = 0; p < 16; p++){
-            USB.print(device->service[numSer].service.uuid128[p],HEX);
-            USB.print(" ");
+            LOG_VERBOSE(device->service[numSer].service.uuid128[p],HEX);
+            LOG_VERBOSE(F(" "));
         }
-        USB.println("");
-        USB.print(F("   * Service number of characteristics: "));
-        USB.print(device->service[numSer].numberOfCharacteristics, DEC);
-        USB.println(F(""));
+        LOG_VERBOSELN(F(""));
+        LOG_VERBOSE(F("   * Service number of characteristics: "));
+        LOG_VERBOSE(device->service[numSer].numberOfCharacteristics, DEC);
+        LOG_VERBOSELN(F(""));
         for(numCar = 0; numCar < device->service[numSer].numberOfCharacteristics; numCar++){
-            USB.print(F("* Service "));
-            USB.print( numSer,HEX );
-            USB.print(F("   - Characteristic: "));
-            USB.println( numCar,HEX );
-            USB.print(F("   - Characteristic start handle: "));
-            USB.print(device->service[numSer].characteristic[numCar].charac.start_handle,HEX);
-            USB.println("");
-            USB.print(F("   - Characteristic value handle: "));
-            USB.print(device->service[numSer].characteristic[numCar].charac.value_handle ,HEX);
-            USB.println("");
-            USB.print(F("   - Characteristic properties: "));
-            USB.print(device->service[numSer].characteristic[numCar].charac.properties,HEX);
-            USB.println("");
-            USB.print(F("   - Characteristic uuid16: "));
-            USB.print( device->service[numSer].characteristic[numCar].charac.uuid16,HEX);
-            USB.println(F(""));
-            USB.print(F("   - Characteristic uuid128: "));
+            LOG_VERBOSE(F("* Service "));
+            LOG_VERBOSE( numSer,HEX );
+            LOG_VERBOSE(F("   - Characteristic: "));
+            LOG_VERBOSELN( numCar,HEX );
+            LOG_VERBOSE(F("   - Characteristic start handle: "));
+            LOG_VERBOSE(device->service[numSer].characteristic[numCar].charac.start_handle,HEX);
+            LOG_VERBOSELN(F(""));
+            LOG_VERBOSE(F("   - Characteristic value handle: "));
+            LOG_VERBOSE(device->service[numSer].characteristic[numCar].charac.value_handle ,HEX);
+            LOG_VERBOSELN(F(""));
+            LOG_VERBOSE(F("   - Characteristic properties: "));
+            LOG_VERBOSE(device->service[numSer].characteristic[numCar].charac.properties,HEX);
+            LOG_VERBOSELN(F(""));
+            LOG_VERBOSE(F("   - Characteristic uuid16: "));
+            LOG_VERBOSE( device->service[numSer].characteristic[numCar].charac.uuid16,HEX);
+            LOG_VERBOSELN(F(""));
+            LOG_VERBOSE(F("   - Characteristic uuid128: "));
             for(int p = 0; p < 16 ; p++){
-            USB.print(device->service[numSer].characteristic[numCar].charac.uuid128[p],HEX);
-            USB.print(" ");
+            LOG_VERBOSE(device->service[numSer].characteristic[numCar].charac.uuid128[p],HEX);
+            LOG_VERBOSE(F(" "));
             }
-            USB.println(" ");
+            LOG_VERBOSELN(F(" "));
             for(numDesc = 0; numDesc < device->service[numSer].characteristic[numCar].numberOfDescriptors; numDesc++){
-                USB.print(F("   - Characteristic: "));
-                USB.print( numCar,HEX );
-                USB.print(F("   - Descriptor: "));
-                USB.println( numDesc, HEX );
-                USB.print(F("   - Descriptor handle: "));
-                USB.println( device->service[numSer].characteristic[numCar].descriptor[numDesc].descriptor.handle,HEX );
-                USB.print(F("   - Descriptor uuid16: "));
-                USB.println( device->service[numSer].characteristic[numCar].descriptor[numDesc].descriptor.uuid16, HEX );  
+                LOG_VERBOSE(F("   - Characteristic: "));
+                LOG_VERBOSE( numCar,HEX );
+                LOG_VERBOSE(F("   - Descriptor: "));
+                LOG_VERBOSELN( numDesc, HEX );
+                LOG_VERBOSE(F("   - Descriptor handle: "));
+                LOG_VERBOSELN( device->service[numSer].characteristic[numCar].descriptor[numDesc].descriptor.handle,HEX );
+                LOG_VERBOSE(F("   - Descriptor uuid16: "));
+                LOG_VERBOSELN( device->service[numSer].characteristic[numCar].descriptor[numDesc].descriptor.uuid16, HEX );  
             }
         }
     }
@@ -538,6 +598,53 @@ void BLECentral::printBLEProfile(){
     #endif
 }
 
+/*! \fn uint8_t resolveSensorHandles()
+    \brief Fill the handle tables of the sensors from the discovered profile
+    \retval The number of sensors whose characteristic has been found
+
+    The characteristic of each UplinkTypes_t (sensorUuid) is searched once after the discovery, so
+    readSensorValue() and enableSensorNotification() only index the tables. The CCCD is the 0x2902
+    descriptor of the characteristic, or the handle after the value if the descriptors do not have it
+    and the characteristic notifies. The tables are cleared by freeDevice().
+*/
+uint8_t BLECentral::resolveSensorHandles(){
+    uint8_t resolved = 0;
+    characteristic_t *characteristic;
+    memset(sensorHandle, 0, sizeof(sensorHandle));
+    memset(sensorCccdHandle, 0, sizeof(sensorCccdHandle));
+    for(uint8_t type = UV_INDEX_TYPE; type < SENSOR_HANDLES; type++){
+        characteristic = uuid128ToCharacteristic(sensorUuid[type]);
+        if(characteristic == NULL){
+            LOG_ERROR(F("Sensor not found in the profile: "));
+            LOG_ERRORLN(type, DEC);
+            continue;
+        }
+        sensorHandle[type] = characteristic->charac.value_handle;
+        for(uint8_t numDesc = 0; numDesc < characteristic->numberOfDescriptors; numDesc++){
+            if(characteristic->descriptor[numDesc].descriptor.uuid16 == GATT_CCCD_UUID16){
+                sensorCccdHandle[type] = characteristic->descriptor[numDesc].descriptor.handle;
+                break;
+            }
+        }
+        if((sensorCccdHandle[type] == 0) && (characteristic->charac.properties & (GATT_PROPERTY_NOTIFY | GATT_PROPERTY_INDICATE))){
+            sensorCccdHandle[type] = sensorHandle[type] + 1;
+        }
+        resolved++;
+    }
+    LOG_INFO(F("Sensor handles resolved: "));
+    LOG_INFOLN(resolved, DEC);
+    return resolved;
+}
+
+/*! \fn uint16_t getSensorHandle(uint8_t type)
+    \brief Return the value handle of the characteristic of a sensor
+    \param   type The UplinkTypes_t of the sensor
+    \retval The handle, 0 if the sensor is not resolved
+*/
+uint16_t BLECentral::getSensorHandle(uint8_t type){
+    return (type < SENSOR_HANDLES) ? sensorHandle[type] : 0;
+}
+
 /*! \fn uint8_t* readAttribute( uint8_t *uuid128)
     \brief Read Attribute by the given uuid128
     \param   *uuid128 the uuid from 128 bits to be read
@@ -546,21 +653,169 @@ void BLECentral::printBLEProfile(){
     This function read Attribute by the given uuid128
 */
 uint8_t* BLECentral::readAttribute( uint8_t *uuid128){
-    USB.println(F("BLE Central read Attribute "));
-    USB.print(F("  -UUID128: ")); 
+    PROFILE(PROFILE_BLE_READ_ATTRIBUTE);
+    LOG_INFOLN(F("BLE Central read Attribute "));
+    LOG_INFO(F("  -UUID128: ")); 
     for(uint8_t i=0; i<16; i++){
-      USB.print(uuid128[i], HEX); 
-      USB.print(" "); 
+      LOG_VERBOSE(uuid128[i], HEX); 
+      LOG_VERBOSE(F(" ")); 
     }
-    USB.println(F(""));   
-    USB.print(F("  -Handle: "));
-    USB.println(uuid128ToHandle(uuid128), HEX);
-    USB.println(F(""));//probado
+    LOG_INFOLN(F(""));   
+    LOG_INFO(F("  -Handle: "));
+    LOG_INFOLN(uuid128ToHandle(uuid128), HEX);
+    LOG_INFOLN(F(""));//probado
     BLE.attributeRead(BLE.connection_handle, uuid128ToHandle(uuid128));
     return BLE.attributeValue;
 	
 }
 
+/*! \fn uint8_t readAttributeValue(uint8_t *uuid128, uint8_t *value, uint8_t maxLength)
+    \brief Read Attribute by the given uuid128 directly into the caller buffer
+    \param[in]  *uuid128  the uuid from 128 bits to be read
+    \param[out] *value    where the attribute value is written (without size byte)
+    \param[in]  maxLength the space available in value, longer values are truncated
+    \retval The number of bytes written, 0 if the read failed
+
+    The handle is searched in the profile, readSensorValue() avoids the search for the sensors.
+*/
+uint8_t BLECentral::readAttributeValue(uint8_t *uuid128, uint8_t *value, uint8_t maxLength){
+    PROFILE(PROFILE_BLE_READ_ATTRIBUTE_VALUE);
+    uint16_t handle;
+    handle = uuid128ToHandle(uuid128);
+    if(handle == 0){
+        LOG_ERRORLN(F("BLE Central read Attribute, unknown UUID128"));
+        return 0;
+    }
+    return readHandleValue(handle, value, maxLength);
+}
+
+/*! \fn uint8_t readSensorValue(uint8_t type, uint8_t *value, uint8_t maxLength)
+    \brief Read the characteristic of a sensor directly into the caller buffer
+    \param[in]  type      The UplinkTypes_t of the sensor
+    \param[out] *value    where the attribute value is written (without size byte)
+    \param[in]  maxLength the space available in value, longer values are truncated
+    \retval The number of bytes written, 0 if the read failed or the sensor is not resolved
+
+    As readAttributeValue(), with the handle taken from the table of resolveSensorHandles()
+    instead of searching the profile.
+*/
+uint8_t BLECentral::readSensorValue(uint8_t type, uint8_t *value, uint8_t maxLength){
+    PROFILE(PROFILE_BLE_READ_SENSOR_VALUE);
+    uint16_t handle = getSensorHandle(type);
+    if(handle == 0){
+        LOG_ERROR(F("BLE Central read sensor, not resolved: "));
+        LOG_ERRORLN(type, DEC);
+        return 0;
+    }
+    return readHandleValue(handle, value, maxLength);
+}
+
+/*! \fn uint16_t readLongAttributeValue(uint8_t *uuid128, uint8_t *value, uint16_t maxLength)
+    \brief Read a value of any length by the given uuid128 directly into the caller buffer
+    \param[in]  *uuid128  the uuid from 128 bits to be read
+    \param[out] *value    where the attribute value is written (without size byte)
+    \param[in]  maxLength the space available in value, longer values are truncated
+    \retval The number of bytes written, 0 if the read failed
+
+    A single read returns up to attMtu - 1 bytes (22), longer values (device strings, IMU
+    orientation) need the read long procedure.
+*/
+uint16_t BLECentral::readLongAttributeValue(uint8_t *uuid128, uint8_t *value, uint16_t maxLength){
+    PROFILE(PROFILE_BLE_READ_LONG_ATTRIBUTE_VALUE);
+    uint16_t handle;
+    handle = uuid128ToHandle(uuid128);
+    if(handle == 0){
+        LOG_ERRORLN(F("BLE Central read long Attribute, unknown UUID128"));
+        return 0;
+    }
+    return readLongHandleValue(handle, value, maxLength);
+}
+
+/*! \fn uint16_t readLongHandleValue(uint16_t handle, uint8_t *value, uint16_t maxLength)
+    \brief Read a value of any length by its handle, chunk by chunk into the caller buffer
+    \param[in]  handle    The attribute handle
+    \param[out] *value    where the attribute value is written (without size byte)
+    \param[in]  maxLength the space available in value, the chunks beyond it are dropped
+    \retval The number of bytes written, 0 if the read failed
+
+    One attclient_read_long command: the module does the Read and the Read Blob requests by itself,
+    one per connection event, and reports each chunk of up to attMtu - 1 bytes in an attribute
+    value event, followed by the procedure completed event. A value shorter than attMtu - 1 takes
+    the same round trip as a single read. Each chunk is copied from BLE.event at its offset, so the
+    value is never held whole in the BGAPI buffers.
+*/
+uint16_t BLECentral::readLongHandleValue(uint16_t handle, uint8_t *value, uint16_t maxLength){
+    uint16_t event;
+    uint16_t length = 0;
+    uint8_t chunks = 0;
+    readByHandleCommand_t command;
+    command = getReadLongCommand(handle);
+    BLE.sendCommand((uint8_t *)&command, command.t_length+1);
+    BLE.readCommandAnswer();
+    do{
+        event = BLE.waitEvent(BGAPI_READ_LONG_TIMEOUT);
+        if((event == BLE_EVENT_ATTCLIENT_ATTRIBUTE_VALUE) && ((((uint16_t)BLE.event[6] << 8) | BLE.event[5]) == handle)){
+            if(length < maxLength){
+                length += copyAttributeValue(value + length, ((maxLength - length) > 0xFF) ? 0xFF : (maxLength - length));
+            }
+            chunks++;
+        }else if(event == BLE_EVENT_ATTCLIENT_PROCEDURE_COMPLETED){
+            if((BLE.event[5] | BLE.event[6]) != 0){
+                break;
+            }
+            TRACE(TRACE_BLE_READ, handle);
+            LOG_INFO(F("BLE Central read long Attribute, chunks: "));
+            LOG_INFO(chunks, DEC);
+            LOG_INFO(F(", bytes: "));
+            LOG_INFOLN(length, DEC);
+            return length;
+        }
+    }while(event != 0);
+    TRACE(TRACE_BLE_READ_ERROR, handle);
+    LOG_ERROR(F("BLE Central read long Attribute ERROR, handle: "));
+    LOG_ERRORLN(handle, HEX);
+    return 0;
+}
+
+/*! \fn uint8_t getAttMtu()
+    \brief Return the ATT MTU of the connection
+*/
+uint8_t BLECentral::getAttMtu(){
+    return attMtu;
+}
+
+/*! \fn uint8_t readHandleValue(uint16_t handle, uint8_t *value, uint8_t maxLength)
+    \brief Read an attribute by its handle directly into the caller buffer
+    \param[in]  handle    The attribute handle
+    \param[out] *value    where the attribute value is written (without size byte)
+    \param[in]  maxLength the space available in value, longer values are truncated
+    \retval The number of bytes written, 0 if the read failed
+
+    This function sends the BGAPI read by handle command and copies the value from the
+    attribute value event, so it is not copied again through BLE.attributeValue.
+*/
+uint8_t BLECentral::readHandleValue(uint16_t handle, uint8_t *value, uint8_t maxLength){
+    uint16_t event;
+    readByHandleCommand_t command;
+    command = getReadByHandleCommand(handle);
+    BLE.sendCommand((uint8_t *)&command, command.t_length+1);
+    BLE.readCommandAnswer();
+    do{
+        event = BLE.waitEvent(1000);
+        if((event == BLE_EVENT_ATTCLIENT_ATTRIBUTE_VALUE) && ((((uint16_t)BLE.event[6] << 8) | BLE.event[5]) == handle)){
+            TRACE(TRACE_BLE_READ, handle);
+            if((BLE.event[8] >= (attMtu - 1)) && (maxLength > BLE.event[8])){
+                LOG_INFOLN(F("BLE Central read Attribute, the value may be longer: readLongAttributeValue()"));
+            }
+            return copyAttributeValue(value, maxLength);
+        }
+    }while((event != 0) && (event != BLE_EVENT_ATTCLIENT_PROCEDURE_COMPLETED));
+    TRACE(TRACE_BLE_READ_ERROR, handle);
+    LOG_ERROR(F("BLE Central read Attribute ERROR, handle: "));
+    LOG_ERRORLN(handle, HEX);
+    return 0;
+}
+
 /*! \fn uint8_t* writeAttribute(uint8_t connection, uint16_t atthandle, uint8_t *data, uint8_t length)
     \brief Write attribute by the given uuid128
     \param   connection The connection handle
@@ -575,13 +830,14 @@ uint8_t* BLECentral::readAttribute( uint8_t *uuid128){
     This function write Attribute by the given uuid128
 */
 uint16_t BLECentral::writeAttribute(uint8_t connection,  uint8_t *uuid128, uint8_t *data, uint8_t length){
+    PROFILE(PROFILE_BLE_WRITE_ATTRIBUTE);
     uint16_t response;
-    USB.println(F("Writing attribute.. "));
+    LOG_INFOLN(F("Writing attribute.. "));
     response = BLE.attributeWrite(connection, uuid128ToHandle(uuid128), data, length);
     if (response == 0){
-        USB.println(F("Write attribute OK"));
+        LOG_INFOLN(F("Write attribute OK"));
     }else{
-       USB.println(F("Write ERROR = "));
+       LOG_ERRORLN(F("Write ERROR = "));
     }
     return response;
 }
@@ -596,22 +852,54 @@ uint16_t BLECentral::writeAttribute(uint8_t connection,  uint8_t *uuid128, uint8
     This function enable notifications of the Characteristic with the uuid128
 */
 uint8_t BLECentral::enableNotification(uint8_t *uuid128){
+    PROFILE(PROFILE_BLE_ENABLE_NOTIFICATION);
   
+    if(enableHandleNotification(uuid128ToHandle(uuid128) + 1)){
+      LOG_INFO(F("  -For UUID128: "));
+      for(uint8_t i=0; i<16; i++){
+        LOG_VERBOSE(uuid128[i], HEX);
+        LOG_VERBOSE(F(" "));  
+      }
+    LOG_INFOLN(F(""));
+		return 1;
+    }
+    return 0;
+}
+
+/*! \fn uint8_t enableSensorNotification(uint8_t type)
+    \brief Enable the notifications of the characteristic of a sensor
+    \param   type The UplinkTypes_t of the sensor
+    \retval 1: if notifications were enabled ok
+            0: if failed subscribing or the sensor has no CCCD
+
+    The CCCD handle is taken from the table of resolveSensorHandles().
+*/
+uint8_t BLECentral::enableSensorNotification(uint8_t type){
+    PROFILE(PROFILE_BLE_ENABLE_SENSOR_NOTIFICATION);
+    if((type >= SENSOR_HANDLES) || (sensorCccdHandle[type] == 0)){
+        LOG_ERROR(F("____________Failed subscribing, no CCCD for sensor "));
+        LOG_ERRORLN(type, DEC);
+        return 0;
+    }
+    return enableHandleNotification(sensorCccdHandle[type]);
+}
+
+/*! \fn uint8_t enableHandleNotification(uint16_t cccdHandle)
+    \brief Write the Client Characteristic Configuration descriptor to enable the notifications
+    \param   cccdHandle The handle of the CCCD
+    \retval 1: if notifications were enabled ok
+            0: if failed subscribing
+*/
+uint8_t BLECentral::enableHandleNotification(uint16_t cccdHandle){
     uint16_t response;
     char notify[2] = "1";
-    response = BLE.attributeWrite(BLE.connection_handle, (uuid128ToHandle(uuid128) + 1), notify);
+    response = BLE.attributeWrite(BLE.connection_handle, cccdHandle, notify);
     if (response == 0){
-      USB.println(F("____________Notification enable"));
-      USB.print(F("  -For UUID128: "));
-      for(uint8_t i=0; i<16; i++){
-        USB.print(uuid128[i], HEX);
-        USB.print(" ");  
-      }
-    USB.println(F(""));
+      LOG_INFOLN(F("____________Notification enable"));
 		return 1;
     }else{
-        USB.println(F("____________Failed subscribing"));
-        USB.println(F(""));
+        LOG_ERRORLN(F("____________Failed subscribing"));
+        LOG_ERRORLN(F(""));
 		return 0;
     }
 }
@@ -619,37 +907,118 @@ uint8_t BLECentral::enableNotification(uint8_t *uuid128){
 /*! \fn void receiveNotifications()
     \brief Receives notifications if they have been enabled. 
     \param   
-    \retval  uint8_t* Pointer to the BLE.event The buffer that store the notifications events
+    \retval  uint8_t* Pointer to the value inside BLE.event, [size][value...], NULL if no notification
                     
     This function recive notifications if they have been enabled before.
 */
 uint8_t* BLECentral::receiveNotifications(){
+    PROFILE(PROFILE_BLE_RECEIVE_NOTIFICATIONS);
     uint16_t event;
     uint16_t handler;
-    USB.println(F("Waiting events..."));
+    LOG_INFOLN(F("Waiting events..."));
     event = BLE.waitEvent(1000);
     if (event == BLE_EVENT_ATTCLIENT_ATTRIBUTE_VALUE){
-		USB.println(F("Notification received"));
+		LOG_INFOLN(F("Notification received"));
             /* attribute value event structure:
              Field:   | Message type | Payload| Msg Class | Method |  Connection | att handle | att type | value |
              Length:  |       1      |    1   |     1     |    1   |      1      |     2      |     8    |   n   |
              Example: |      80      |   05   |     04    |   05   |     00      |   2c 00    |     x    |   n   |*/
         handler = ((uint16_t)BLE.event[6] << 8) | BLE.event[5]; 
-        USB.print(F("  -Attribute with handler "));
-        USB.print(handler, DEC);
-        USB.println(F(" has changed "));
-        USB.print(F("  -Attribute value: "));
-        BLE.event[0] = BLE.event[8];
+        LOG_INFO(F("  -Attribute with handler "));
+        LOG_INFO(handler, DEC);
+        LOG_INFOLN(F(" has changed "));
+        LOG_INFO(F("  -Attribute value: "));
         for(uint8_t i = 0; i < BLE.event[8]; i++){ 
-        USB.printHex(BLE.event[i+9]);
-            BLE.event[i+1] = BLE.event[i+9];      
+            LOG_VERBOSEHEX(BLE.event[i+9]);
         }
-        USB.println(F("")); 
-        return BLE.event;
+        LOG_INFOLN(F("")); 
+        return BLE.event + 8;//[size][value...]
     }
+    return NULL;
 	
 }
 
+/*! \fn uint8_t receiveNotification(uint8_t *value, uint8_t maxLength)
+    \brief Receives a notification directly into the caller buffer
+    \param[out] *value    where the attribute value is written (without size byte)
+    \param[in]  maxLength the space available in value, longer values are truncated
+    \retval The number of bytes written, 0 if no notification was received
+
+    A notification carries up to attMtu - 3 bytes (20), it always fits in BLE.event.
+*/
+uint8_t BLECentral::receiveNotification(uint8_t *value, uint8_t maxLength){
+    PROFILE(PROFILE_BLE_RECEIVE_NOTIFICATION);
+    if (BLE.waitEvent(1000) == BLE_EVENT_ATTCLIENT_ATTRIBUTE_VALUE){
+        TRACE(TRACE_BLE_NOTIFICATION, BLE.event[8]);
+        return copyAttributeValue(value, maxLength);
+    }
+    LOG_ERRORLN(F("No notification received"));
+    return 0;
+}
+
+/*! \fn uint8_t readWakeUpEvent(unsigned long timeout)
+    \brief Read the BGAPI event that woke the node up (PCINT8) from the UART, without waitEvent()
+    \param  timeout ms to receive the whole event
+    \retval bleWakeEvent_t, the event is left in BLE.event
+
+    The MCU wakes up from power down with the start bit of the first byte, so the first header byte(s)
+    may not be received. The header is rebuilt with syncEvent() from the class and the event ID.
+    If the bytes cannot be synchronised from the first one, the event is searched again from each
+    later BGAPI_EVENT_HEADER received. If none gives an event the UART is flushed, so the rest of
+    the broken event is not taken as the header of the next one by waitEvent().
+*/
+uint8_t BLECentral::readWakeUpEvent(unsigned long timeout){
+    PROFILE(PROFILE_BLE_READ_WAKE_UP_EVENT);
+    uint8_t raw[sizeof(BLE.event)];
+    uint8_t received = 0;
+    uint8_t length = 0;
+    uint8_t lost = 0;
+    unsigned long start = millis();
+    while((length == 0) && (received < sizeof(raw)) && ((millis() - start) < timeout)){
+        if(serialAvailable(SOCKET0) == 0){
+            continue;
+        }
+        raw[received++] = serialRead(SOCKET0);
+        length = syncEvent(raw, received, &lost);
+    }
+    for(uint8_t first = 1; (length == 0) && (first < received); first++){//Drain to the next header
+        if(raw[first] == BGAPI_EVENT_HEADER){
+            length = syncEvent(raw + first, received - first, &lost);
+        }
+    }
+    if(length == 0){
+        serialFlush(SOCKET0);
+        TRACE(TRACE_BLE_RESYNC, 0xFF);
+        LOG_ERROR(F("BLE wake up event not synchronised, bytes: "));
+        LOG_ERRORLN(received, DEC);
+        return BLE_WAKE_NONE;
+    }
+    if(lost > 0){
+        TRACE(TRACE_BLE_RESYNC, lost);
+        LOG_INFO(F("BLE wake up event header rebuilt, bytes lost: "));
+        LOG_INFOLN(lost, DEC);
+    }
+    for(uint8_t i = 0; i < sizeof(wakeUpEvents) / sizeof(wakeUpEvents[0]); i++){
+        if((wakeUpEvents[i].classID == BLE.event[2]) && (wakeUpEvents[i].commandID == BLE.event[3])){
+            if(wakeUpEvents[i].wakeEvent == BLE_WAKE_NOTIFICATION){
+                TRACE(TRACE_BLE_NOTIFICATION, BLE.event[8]);
+            }
+            return wakeUpEvents[i].wakeEvent;
+        }
+    }
+    return BLE_WAKE_OTHER;
+}
+
+/*! \fn uint8_t copyWakeUpValue(uint8_t *value, uint8_t maxLength)
+    \brief Copy the value of the notification read by readWakeUpEvent()
+    \param[out] *value    where the attribute value is written (without size byte)
+    \param[in]  maxLength the space available in value, longer values are truncated
+    \retval The number of bytes written
+*/
+uint8_t BLECentral::copyWakeUpValue(uint8_t *value, uint8_t maxLength){
+    return copyAttributeValue(value, maxLength);
+}
+
 /*! \fn uint8_t getConnectionHandler()
     \brief Get the connection handle
     \param  None
@@ -675,14 +1044,14 @@ uint8_t BLECentral::getConnectionStatus(){//idea limpiar device aqui usuario no
     status =  BLE.getStatus(BLE.connection_handle);
     if( status == 0 ) { //Se ha desconectado
        // central.limpiarPerfil();
-       USB.print(F("The connection has been disconnected, satus: "));
-       USB.println(status, DEC);
+       LOG_INFO(F("The connection has been disconnected, satus: "));
+       LOG_INFOLN(status, DEC);
     }else if (status == 1){
-       USB.print(F("The device is connected, satus: "));
-       USB.println(status, DEC);
+       LOG_INFO(F("The device is connected, satus: "));
+       LOG_INFOLN(status, DEC);
     }else{
-       USB.print(F("The module does not response, satus: "));
-       USB.println(status, DEC);
+       LOG_ERROR(F("The module does not response, satus: "));
+       LOG_ERRORLN(status, DEC);
     }
     return status;
 }
@@ -774,28 +1143,154 @@ findInformationCommand_t BLECentral::getDiscoverDescriptorsCommand(){
         return command;
 }
 
-/*! \fn void newDevice()
+/*! \fn readByHandleCommand_t getReadByHandleCommand(uint16_t attHandle)
+    \brief get the read by handle command acording to the BLE112 MODULE BGAPI
+    \param   attHandle The handle of the attribute to read
+    \retval readByHandleCommand_t command
+*/
+readByHandleCommand_t BLECentral::getReadByHandleCommand(uint16_t attHandle){
+        /*//~ Byte Type Name Description
+        //~ 0 0x00 hilen Message type: command
+        //~ 1 0x03 lolen Minimum payload length
+        //~ 2 0x04 class Message class: Attribute Client
+        //~ 3 0x04 method Message ID
+        //~ 4 uint8 connection Connection handle
+        //~ 5 - 6 uint16 chrhandle Attribute handle
+        */
+        readByHandleCommand_t command;
+        command.t_length = 7;
+        command.messageType = 0;
+        command.payloadLenght = 3;
+        command.classID = 4;
+        command.commandID = 4;
+        command.Connectionhandle = BLE.connection_handle;
+        command.attHandle = attHandle;
+        return command;
+}
+
+/*! \fn readByHandleCommand_t getReadLongCommand(uint16_t attHandle)
+    \brief get the read long command acording to the BLE112 MODULE BGAPI
+    \param   attHandle The handle of the attribute to read
+    \retval readByHandleCommand_t command, the payload is the one of read by handle
+*/
+readByHandleCommand_t BLECentral::getReadLongCommand(uint16_t attHandle){
+        /*//~ Byte Type Name Description
+        //~ 0 0x00 hilen Message type: command
+        //~ 1 0x03 lolen Minimum payload length
+        //~ 2 0x04 class Message class: Attribute Client
+        //~ 3 0x08 method Message ID
+        //~ 4 uint8 connection Connection handle
+        //~ 5 - 6 uint16 chrhandle Attribute handle
+        */
+        readByHandleCommand_t command = getReadByHandleCommand(attHandle);
+        command.commandID = 8;
+        return command;
+}
+
+/*! \fn uint8_t copyAttributeValue(uint8_t *value, uint8_t maxLength)
+    \brief Copy the value of the attribute value event in BLE.event
+    \param[out] *value    where the value is written
+    \param[in]  maxLength the space available in value
+    \retval The number of bytes written
+*/
+uint8_t BLECentral::copyAttributeValue(uint8_t *value, uint8_t maxLength){
+    /* attribute value event structure:
+     Field:   | Message type | Payload| Msg Class | Method |  Connection | att handle | att type | value |
+     Length:  |       1      |    1   |     1     |    1   |      1      |     2      |     1    |   n   |*/
+    uint8_t length = BLE.event[8];
+    if(length > maxLength){
+        length = maxLength;
+    }
+    memcpy(value, BLE.event + 9, length);
+    return length;
+}
+
+/*! \fn uint8_t syncEvent(const uint8_t *raw, uint8_t received, uint8_t *lost)
+    \brief Find a whole BGAPI event in the bytes received, rebuilding the header bytes lost
+    \param[in]  *raw      The bytes received
+    \param[in]  received  The number of bytes received
+    \param[out] *lost     The header bytes rebuilt
+    \retval The length of the event copied to BLE.event, 0 if it is not complete yet or not recognised
+
+    With the header complete any event is accepted. With 1 byte lost the length is checked against
+    the format of the event, with 2 bytes lost it is taken from the format. BGAPI_MAX_LOST_BYTES
+    is the most that can be rebuilt: without the class and the event ID nothing identifies the event.
+*/
+uint8_t BLECentral::syncEvent(const uint8_t *raw, uint8_t received, uint8_t *lost){
+    uint8_t payloadLength;
+    const bgapiEventFormat_t *format;
+    for(*lost = 0; *lost <= BGAPI_MAX_LOST_BYTES; (*lost)++){
+        if((received + *lost) < 4){
+            return 0;
+        }
+        if((*lost == 0) && (raw[0] != BGAPI_EVENT_HEADER)){
+            continue;
+        }
+        format = NULL;
+        for(uint8_t i = 0; i < sizeof(wakeUpEvents) / sizeof(wakeUpEvents[0]); i++){
+            if((wakeUpEvents[i].classID == raw[2 - *lost]) && (wakeUpEvents[i].commandID == raw[3 - *lost])){
+                format = &wakeUpEvents[i];
+            }
+        }
+        if(format == NULL){
+            if(*lost > 0){
+                continue;
+            }
+            payloadLength = raw[1];//Unknown event with the header complete
+        }else{
+            payloadLength = format->payloadLength;
+            if(format->arrayOffset != 0xFF){
+                if((received + *lost) <= (4 + format->arrayOffset)){
+                    return 0;
+                }
+                payloadLength += raw[4 + format->arrayOffset - *lost];
+            }
+            if((*lost < 2) && (raw[1 - *lost] != payloadLength)){
+                continue;
+            }
+        }
+        if((size_t)(4 + payloadLength) > sizeof(BLE.event)){
+            continue;
+        }
+        if((received + *lost) < (4 + payloadLength)){
+            return 0;
+        }
+        BLE.event[0] = BGAPI_EVENT_HEADER;
+        BLE.event[1] = payloadLength;
+        memcpy(BLE.event + *lost, raw, 4 + payloadLength - *lost);
+        return 4 + payloadLength;
+    }
+    return 0;
+}
+
+/*! \fn uint8_t newDevice()
     \brief  Initialize the struct Device_t.
     \param 
-    \retval
+    \retval 1 if OK, 0 if there is not memory enough (device stays NULL)
 
     This function initialize the storage to save a BLE device and its related data.
+    If it fails in configureScanner(), scanReport() and discoverBLEProfile() try again.
 */
-void BLECentral::newDevice(){
+uint8_t BLECentral::newDevice(){
     #if DEBUG >= 1
         USB.print(F("Free Memory(Before New Device):"));
         USB.println(freeMemory());
     #endif
     
-    device = (Device_t*)malloc(sizeof(Device_t));
+    device = (Device_t*)memoryStats.allocate(sizeof(Device_t));
+    if(device == NULL){
+        LOG_ERRORLN(F("____________Storage to manage new device not available____________"));
+        return 0;
+    }
     device->numberOfServices = 0;
     device->service = NULL;
-    USB.println(F("____________Storage to manage new device started____________"));
+    LOG_INFOLN(F("____________Storage to manage new device started____________"));
     
     #if DEBUG >= 1
         USB.print(F("Free Memory(After New Device):"));
         USB.println(freeMemory());
     #endif
+    return 1;
 }
 
 /*! \fn void newService(uint8_t discoveredService[])
@@ -821,9 +1316,12 @@ void BLECentral::newService(uint8_t discoveredService[]){
     //~ Length is 0 if no services are found. 
     */  
     int contador = 0;
-    device->numberOfServices++;
-    service_t *tmp = (service_t*)malloc(sizeof(service_t)*device->numberOfServices);    
+    service_t *tmp = (service_t*)memoryStats.allocate(sizeof(service_t)*(device->numberOfServices + 1));
     service_t *basura;
+    if(tmp == NULL){
+        return;
+    }
+    device->numberOfServices++;
     for(contador = 0; contador <(device->numberOfServices-1); contador++){
         tmp[contador] = device->service[contador];
     }
@@ -843,10 +1341,7 @@ void BLECentral::newService(uint8_t discoveredService[]){
     }
     basura = device->service;
     device->service = tmp;
-    if(basura!= NULL){
-        free(basura);
-        tmp = NULL;
-    }
+    memoryStats.release(basura, sizeof(service_t)*(device->numberOfServices - 1));
 }
 
 /*! \fn void newCharacteristic(servicio_t* servicio, uint8_t discoveredCharacteristic[])
@@ -871,9 +1366,12 @@ void BLECentral::newCharacteristic(service_t* service, uint8_t discoveredCharact
     */
     uint8_t contador = 0;
     uint8_t posicion = 0;   
-    service->numberOfCharacteristics++;
-    characteristic_t* tmp = (characteristic_t*)malloc(sizeof(characteristic_t)*service->numberOfCharacteristics);    
+    characteristic_t* tmp = (characteristic_t*)memoryStats.allocate(sizeof(characteristic_t)*(service->numberOfCharacteristics + 1));
     characteristic_t* basura;
+    if(tmp == NULL){
+        return;
+    }
+    service->numberOfCharacteristics++;
     for(contador = 0; contador <(service->numberOfCharacteristics-1); contador++){
         tmp[contador] = service->characteristic[contador];
     }
@@ -895,10 +1393,7 @@ void BLECentral::newCharacteristic(service_t* service, uint8_t discoveredCharact
     }
     basura = service->characteristic;
     service->characteristic = tmp;
-    if(basura!= NULL){
-        free(basura);
-        tmp = NULL;
-    }
+    memoryStats.release(basura, sizeof(characteristic_t)*(service->numberOfCharacteristics - 1));
 }
 
 /*! \fn void newDescriptor(caracteristica_t* caracteristica, uint8_t discoveredDescriptor[])
@@ -922,9 +1417,12 @@ void BLECentral::newDescriptor(characteristic_t *characteristic , uint8_t discov
     */ 
     uint16_t flag1;
     uint8_t contador = 0;
-    characteristic->numberOfDescriptors++;
-    descriptor_t* tmp = (descriptor_t*)malloc(sizeof(descriptor_t)*characteristic->numberOfDescriptors);    
+    descriptor_t* tmp = (descriptor_t*)memoryStats.allocate(sizeof(descriptor_t)*(characteristic->numberOfDescriptors + 1));
     descriptor_t* basura;
+    if(tmp == NULL){
+        return;
+    }
+    characteristic->numberOfDescriptors++;
     for(contador = 0; contador <(characteristic->numberOfDescriptors-1); contador++){
         tmp[contador] = characteristic->descriptor[contador];
     }
@@ -933,10 +1431,7 @@ void BLECentral::newDescriptor(characteristic_t *characteristic , uint8_t discov
     
     basura = characteristic->descriptor;
     characteristic->descriptor = tmp;
-    if(basura!= NULL){
-        free(basura);
-        tmp = NULL;
-    }
+    memoryStats.release(basura, sizeof(descriptor_t)*(characteristic->numberOfDescriptors - 1));
 }
 
 /*! \fn  void freeDevice()
@@ -946,6 +1441,9 @@ void BLECentral::newDescriptor(characteristic_t *characteristic , uint8_t discov
     
 */
 void BLECentral::freeDevice(){
+    if(device == NULL){
+        return;
+    }
     #if DEBUG >= 1
         USB.print(F("Free Memory(Before freeDevice):"));
         USB.println(freeMemory());
@@ -954,21 +1452,21 @@ void BLECentral::freeDevice(){
     uint8_t numCar;
     for(numSer = 0; numSer < device->numberOfServices; numSer++){
         for(numCar = 0; numCar < device->service[numSer].numberOfCharacteristics; numCar++){
-            if(device->service[numSer].characteristic[numCar].descriptor != NULL){
-                free(device->service[numSer].characteristic[numCar].descriptor);
-            }
+            memoryStats.release(device->service[numSer].characteristic[numCar].descriptor,
+                                sizeof(descriptor_t)*device->service[numSer].characteristic[numCar].numberOfDescriptors);
         }
     }
     for(uint8_t numSer = 0; numSer < device->numberOfServices; numSer++){
-        if(device->service[numSer].characteristic != NULL){
-                free(device->service[numSer].characteristic);
-        }
+        memoryStats.release(device->service[numSer].characteristic,
+                            sizeof(characteristic_t)*device->service[numSer].numberOfCharacteristics);
     }
     if(device->service != NULL){
-        free(device->service);
+        memoryStats.release(device->service, sizeof(service_t)*device->numberOfServices);
          device->numberOfServices = 0;
          device->service = NULL;
     }
+    memset(sensorHandle, 0, sizeof(sensorHandle));
+    memset(sensorCccdHandle, 0, sizeof(sensorCccdHandle));
     //~ free(device);
     #if DEBUG >= 1
         USB.print(F("Free Memory(After freeDevice):"));
@@ -1003,6 +1501,7 @@ uint16_t BLECentral::uuid16ToHandle(uint16_t uuid16){
             }
         }
     } 
+    return 0;
 }
 
 /*! \fn  uint16_t uuid128ToHandle(uint8_t *uuid128)
@@ -1031,6 +1530,22 @@ uint16_t BLECentral::uuid128ToHandle(uint8_t *uuid128){
   return 0;
 }
 
+/*! \fn  characteristic_t* uuid128ToCharacteristic(uint8_t *uuid128)
+    \brief Search a characteristic of the profile by its uuid128
+    \param   uuid128 The uuid of the characteristic
+    \retval The characteristic, NULL if it is not in the profile
+*/
+characteristic_t* BLECentral::uuid128ToCharacteristic(uint8_t *uuid128){
+  for(uint8_t numSer = 0; numSer < device->numberOfServices; numSer++){
+    for(uint8_t numCar = 0; numCar < device->service[numSer].numberOfCharacteristics; numCar++){
+      if(0x00 == memcmp(device->service[numSer].characteristic[numCar].charac.uuid128, uuid128, 16)){
+        return &device->service[numSer].characteristic[numCar];
+      }
+    }
+  }
+  return NULL;
+}
+
 /*! \fn  uint16_t service_uuid16_to_uuid128(service_t *service);
     \brief From the service uuid16 get the service uuid128 associated
     \param   uuid16       
@@ -99,8 +99,53 @@ typedef struct {
     Bytes 4-n:  0 - 2048 Bytes, Payload (PL)     Up to 2048 bytes of payload
 */
 
+#define ATT_DEFAULT_MTU 23/*!< ATT MTU of the BLE112 links: BGAPI 1.x has no MTU exchange, both sides keep the default */
+#define ATT_MAX_VALUE_LENGTH 512/*!< Longest attribute value (Bluetooth Core, Vol 3, Part F, 3.2.9) */
+#define BGAPI_READ_LONG_TIMEOUT 1000/*!< ms to wait for each chunk of a read long procedure */
+#define GATT_CCCD_UUID16 0x2902/*!< Client Characteristic Configuration descriptor, it enables the notifications */
+#define GATT_PROPERTY_NOTIFY 0x10/*!< Characteristic property: notify */
+#define GATT_PROPERTY_INDICATE 0x20/*!< Characteristic property: indicate */
+#define SENSOR_HANDLES (FIELD_STRENGHT_TYPE + 1)/*!< Entries of the handle tables, indexed by UplinkTypes_t */
+
+#define BGAPI_EVENT_HEADER 0x80/*!< Byte 0 of the BLE112 events (MT = 1, TT = 0, LH = 0) */
+/*! \def BGAPI_MAX_LOST_BYTES
+    \brief Header bytes rebuilt when they are lost while the MCU wakes up from the first edge
+
+    2 is the most that can be rebuilt: the class and the event ID are needed to know the event. The
+    loss itself depends on the start-up of the oscillator from power down: 16K CK with the crystal
+    fuses of the Waspmote is 1.1 ms at 14.7456 MHz, up to 12 bytes at 115200 bps, while with a fast
+    start-up (1K CK, 69 us) no byte is lost. A wake up that loses more than 2 bytes is not
+    synchronised (TRACE_BLE_RESYNC with 0xFF) and the UART is flushed. BLECentralTest replays wake ups
+    with 0 to 3 bytes lost.
+ */
+#define BGAPI_MAX_LOST_BYTES 2
+#define BGAPI_WAKE_TIMEOUT 100/*!< ms to receive the event that woke the node up */
+
+/*! \enum bleWakeEvent_t
+    \brief  BGAPI event that woke the node up
+*/
+typedef enum {
+    BLE_WAKE_NONE,/**< No event could be synchronised */
+    BLE_WAKE_NOTIFICATION,/**< attclient_attribute_value, in BLE.event */
+    BLE_WAKE_DISCONNECTED,/**< connection_disconnected, in BLE.event */
+    BLE_WAKE_OTHER/**< Another event, in BLE.event */
+}bleWakeEvent_t;
+
+/*! \struct bgapiEventFormat_t
+    \brief  Payload layout of the events expected on a wake up, used to rebuild a header with lost bytes
+*/
+typedef struct {
+    uint8_t classID;/**< Event class ID */
+    uint8_t commandID;/**< Event ID */
+    uint8_t payloadLength;/**< Fixed payload length, without the uint8array data */
+    uint8_t arrayOffset;/**< Offset in the payload of the uint8array length, 0xFF if there is not */
+    uint8_t wakeEvent;/**< bleWakeEvent_t of the event */
+}bgapiEventFormat_t;
+
 /*! \struct trama_grupo_t
     \brief  Struct to make command to discover services and characteristics
+
+    The command structs are sent byte by byte, so they are packed: uuid is at offset 11.
 */ 
 typedef struct {
 	uint8_t t_length;/**< The total lenght of the command*/
@@ -113,7 +158,7 @@ typedef struct {
   uint16_t endLastAttributeHandle;/**< endLastAttributeHandle*/
   uint8_t uuidLenght;/**< uuidLenght*/
   uint16_t uuid;/**< uuid*/
-} readByGroupCommand_t;
+} __attribute__((packed)) readByGroupCommand_t;
 
 /*! \struct trama_descriptor_t
     \brief  Struct to make command to discover descriptors
@@ -127,7 +172,20 @@ typedef struct {
 	uint8_t Connectionhandle;/**< Connectionhandle*/
 	uint16_t startFirstAttributeHandle;/**< startFirstAttributeHandle*/
   uint16_t endLastAttributeHandle;/**< endLastAttributeHandle*/
-} findInformationCommand_t;
+} __attribute__((packed)) findInformationCommand_t;
+
+/*! \struct readByHandleCommand_t
+    \brief  Struct to make command to read an attribute by its handle
+*/
+typedef struct {
+	uint8_t t_length;/**< The total lenght of the command*/
+	uint8_t messageType;/**< The type of command*/
+	uint8_t payloadLenght;/**< The payloadLenght of the command*/
+	uint8_t classID;/**< Command class ID*/
+	uint8_t commandID;/**< Command ID*/
+	uint8_t Connectionhandle;/**< Connectionhandle*/
+	uint16_t attHandle;/**< Handle of the attribute to read*/
+} __attribute__((packed)) readByHandleCommand_t;
 
 /******************************************************************************
  * Class                                                                      *
@@ -175,19 +233,59 @@ public:
     uint8_t discoverBLEProfile();
 
     void printBLEProfile();
+
+    uint8_t resolveSensorHandles();
+
+    uint16_t getSensorHandle(uint8_t type);
  
     uint8_t* readAttribute( uint8_t *uuid128);
+
+    uint8_t readAttributeValue(uint8_t *uuid128, uint8_t *value, uint8_t maxLength);
     
     uint16_t writeAttribute(uint8_t connection, uint8_t *uuid128, uint8_t *data, uint8_t length);
     
+    uint8_t readSensorValue(uint8_t type, uint8_t *value, uint8_t maxLength);
+
+    uint16_t readLongAttributeValue(uint8_t *uuid128, uint8_t *value, uint16_t maxLength);
+
+    uint8_t getAttMtu();
+
     uint8_t enableNotification(uint8_t *uuid128);
 
+    uint8_t enableSensorNotification(uint8_t type);
+
     uint8_t* receiveNotifications();
 
+    uint8_t receiveNotification(uint8_t *value, uint8_t maxLength);
+
+    uint8_t readWakeUpEvent(unsigned long timeout);
+
+    uint8_t copyWakeUpValue(uint8_t *value, uint8_t maxLength);
+
     uint8_t getConnectionHandler();
     
     uint8_t getConnectionStatus();
     
+/// protected methods and attributes ////////////
+protected:
+
+    //The profile storage, public in the host benchmark subclass (tools/MicroBenchmark)
+
+    //! Variable : Struct to save a BLE device and its data
+    /*! For the management of the device by the master
+    */
+    Device_t *device;
+
+    uint8_t newDevice();
+
+    void newService( uint8_t discoveredService[]);
+
+    void newCharacteristic(service_t *service, uint8_t discoveredCharacteristic[]);
+
+    void freeDevice();
+
+    uint16_t uuid128ToHandle(uint8_t *uuid128);
+
 /// private methods //////////////////////////    
 private:
 
@@ -197,24 +295,31 @@ private:
   
     findInformationCommand_t getDiscoverDescriptorsCommand();
 
-    //! Variable : Struct to save a BLE device and its data
-    /*! For the management of the device by the master
-    */
-    Device_t *device;
+    readByHandleCommand_t getReadByHandleCommand(uint16_t attHandle);
+
+    readByHandleCommand_t getReadLongCommand(uint16_t attHandle);
+
+    uint8_t copyAttributeValue(uint8_t *value, uint8_t maxLength);
+
+    uint8_t readHandleValue(uint16_t handle, uint8_t *value, uint8_t maxLength);
+
+    uint16_t readLongHandleValue(uint16_t handle, uint8_t *value, uint16_t maxLength);
+
+    uint8_t enableHandleNotification(uint16_t cccdHandle);
+
+    uint8_t syncEvent(const uint8_t *raw, uint8_t received, uint8_t *lost);
+
+    uint16_t sensorHandle[SENSOR_HANDLES];/*!< Value handle of the characteristic of each UplinkTypes_t, 0 if not found */
+
+    uint16_t sensorCccdHandle[SENSOR_HANDLES];/*!< Handle of its CCCD, 0 if it has not */
+
+    uint8_t attMtu;/*!< ATT MTU of the connection, a read returns up to attMtu - 1 bytes */
       
-    void newDevice();
-   
-    void newService( uint8_t discoveredService[]);
-    
-    void newCharacteristic(service_t *service, uint8_t discoveredCharacteristic[]);
-    
     void newDescriptor(characteristic_t *characteristic, uint8_t discoveredDescriptor[]);
  
-    void freeDevice();
-  
     uint16_t uuid16ToHandle(uint16_t uuid16);
-    
-    uint16_t uuid128ToHandle(uint8_t *uuid128);
+
+    characteristic_t* uuid128ToCharacteristic(uint8_t *uuid128);
     
     void service_uuid16_to_uuid128(service_t *service);
     
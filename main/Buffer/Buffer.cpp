@@ -7,23 +7,124 @@
 #endif
 
 #include "Buffer.h"
+#include "Log.h"
+#include "Trace.h"
 
 /******************************************************************************
  * PRIVATE FUNCTIONS                                                          *
  ******************************************************************************/
 
 
+/*! \fn uint8_t evictFrame(uint8_t priority)
+    \brief  Remove a pending frame to queue a new one of the given priority
+    \param  priority The priority of the new frame
+    \retval 1: a frame has been evicted
+            0: no frame can be evicted, the new one has to be dropped
+
+    The victim is the oldest frame of the lowest priority. It is evicted if its priority is lower
+    than the new one, or if both are periodic (the stale readings are replaced by the new ones).
+    Pending events are never evicted.
+*/
+uint8_t Buffer::evictFrame(uint8_t priority){
+    uint8_t victim = 0;
+    frame_t *frame;
+    if(frames.isEmpty()){
+      return 0;
+    }
+    for(uint8_t i = 1; i < frames.size(); i++){
+      if(frames.at(i)->priority < frames.at(victim)->priority){
+        victim = i;
+      }
+    }
+    frame = frames.at(victim);
+    if((frame->priority > priority) || ((frame->priority == priority) && (priority != FRAME_PRIORITY_PERIODIC))){
+      return 0;
+    }
+    countItems(frame, evictedItems);
+    TRACE(TRACE_FRAME_EVICTED, ((uint16_t)frame->port << 8) | frame->priority);
+    LOG_ERROR(F("Buffer: pending frame evicted, port "));
+    LOG_ERRORLN(frame->port, DEC);
+    frames.erase(victim);
+    return 1;
+}
+
+/*! \fn uint8_t hasRoom(uint8_t elementLength)
+    \brief  Check that an element fits in the opened frame
+    \param  elementLength The bytes of the element, [type][size][data...]
+    \retval 1: the element fits
+            0: it does not fit
+
+    The elements of a frame share its priority (openFrame()), so there is no lower priority element
+    to evict inside it: the priorities are applied to whole frames by evictFrame().
+*/
+uint8_t Buffer::hasRoom(uint8_t elementLength){
+    return (openedFrame->length + elementLength) <= dataToSend_Size;
+}
+
+/*! \fn void countItems(frame_t *frame, uint16_t *counters)
+    \brief  Add the elements of a frame to the counters of their priority class
+    \param  *frame    The frame
+    \param  *counters droppedItems or evictedItems
+*/
+void Buffer::countItems(frame_t *frame, uint16_t *counters){
+    for(uint8_t index = 0; (index + 1) < frame->length; index += 2 + frame->data[index + 1]){
+      if((frame->data[index] != REDUNDANCY_TYPE) && (frame->data[index] != FRAME_EPOCH_TYPE)){
+        counters[getTypePriority(frame->data[index])]++;
+      }
+    }
+}
+
+/*! \fn uint8_t putTimeOffset(uint8_t *out)
+    \brief  Encode the seconds from the epoch of the opened frame to now
+    \param[out] *out The varint offset, VARINT_MAX_SIZE bytes at most
+    \retval The bytes written, 0 if the elements are not timestamped
+*/
+uint8_t Buffer::putTimeOffset(uint8_t *out){
+#if TIMESTAMPED_ELEMENTS
+    uint32_t now = RTC.getEpochTime();
+    return varintEncode(now > openedFrame->timestamp ? now - openedFrame->timestamp : 0, out);
+#else
+    (void)out;
+    return 0;
+#endif
+}
+
+/*! \fn uint8_t reopenFrame()
+    \brief  Close the opened frame and open a new one with the same port, confirmation and priority
+    \retval 1 if a new frame is opened, 0 if the opened frame has no elements (a new one would not have
+            more room) or no frame could be opened
+*/
+uint8_t Buffer::reopenFrame(){
+    uint8_t port;
+    uint8_t confirmed;
+    uint8_t priority;
+    if((openedFrame == NULL) || (openedFrame->length <= (TIMESTAMPED_ELEMENTS ? FRAME_EPOCH_SIZE : 0))){
+        return 0;
+    }
+    port = openedFrame->port;
+    confirmed = openedFrame->confirmed;
+    priority = openedFrame->priority;
+    closeFrame();
+    return openFrame(port, confirmed, priority);
+}
+
 /******************************************************************************
  * PUBLIC FUNCTIONS                                                           *
  ******************************************************************************/
  
 /*! class constructor
-It does nothing
+It sets the default redundancy
 \param void
 \return void
 */
 Buffer::Buffer(){
-  
+    openedFrame = NULL;
+    frameSequence = 0;
+    historyCount = 0;
+    reservedOffsetLength = 0;
+    memset(droppedItems, 0, sizeof(droppedItems));
+    memset(evictedItems, 0, sizeof(evictedItems));
+    setRedundancy(REDUNDANCY_MODE, REDUNDANCY_DEPTH);
 }
 
 /*! class Destructor
@@ -38,87 +139,588 @@ Buffer::~Buffer(){
               To Send uplink data to the LoRaWAN network                      *
 ******************************************************************************/
 
+/*! \fn uint8_t openFrame(uint8_t port, uint8_t confirmed, uint8_t priority)
+    \brief  Start a new uplink frame, the next data stored goes to it
+    \param  uint8_t port      The LoRaWAN port of the frame
+    \param  uint8_t confirmed 1 to send the frame confirmed
+    \param  uint8_t priority  The priority of the frame
+    \retval 1: frame opened
+            0: there are FRAME_QUEUE_SIZE frames pending, no frame opened
+
+    The frame is built in its slot of the queue, a frame already opened is closed first.
+    If the queue is full a pending frame is evicted following evictFrame().
+*/
+uint8_t Buffer::openFrame(uint8_t port, uint8_t confirmed, uint8_t priority){
+    closeFrame();
+    if(frames.isFull()){
+        evictFrame(priority);
+    }
+    openedFrame = frames.reserve();
+    if(openedFrame == NULL){
+        LOG_ERRORLN(F("The buffer is full, there is no space for a new frame"));
+        return 0;
+    }
+    openedFrame->port = port;
+    openedFrame->confirmed = confirmed;
+    openedFrame->priority = priority;
+    openedFrame->retries = 0;
+    openedFrame->timestamp = RTC.getEpochTime();
+    openedFrame->length = 0;
+#if TIMESTAMPED_ELEMENTS
+    openedFrame->data[0] = FRAME_EPOCH_TYPE;
+    openedFrame->data[1] = 4;
+    for(uint8_t i = 0; i < 4; i++){
+        openedFrame->data[2 + i] = (uint8_t)(openedFrame->timestamp >> (8 * i));
+    }
+    openedFrame->length = FRAME_EPOCH_SIZE;
+#endif
+    return 1;
+}
+
+/*! \fn void closeFrame()
+    \brief  Queue the opened frame to be sent
+    \param  void
+    \retval void
+
+    The unconfirmed DATA_PORT frames get their redundancy element here. An empty frame (or with the epoch
+    element only) is discarded.
+*/
+void Buffer::closeFrame(){
+    if(openedFrame == NULL){
+        return;
+    }
+    if(openedFrame->length > (TIMESTAMPED_ELEMENTS ? FRAME_EPOCH_SIZE : 0)){
+        if(!openedFrame->confirmed && (openedFrame->port == DATA_PORT)){
+            putRedundancy();
+        }
+        TRACE(TRACE_FRAME_CLOSED, ((uint16_t)openedFrame->port << 8) | openedFrame->length);
+        frames.push();
+    }
+    openedFrame = NULL;
+}
+
 /*! \fn void putDataToSend(uint8_t *value, uint8_t type)
-    \brief  Store the data to send to the network  
-    \param  uint8_t *value The data to store, data[0] contains the size of the data 
+    \brief  Store the data to send to the network in the opened frame
+    \param  uint8_t *value The data to store, data[0] contains the size of the data
     \param  uint8_t type The type of the data
-    
+
     \retval void
-    
-    This function put the data to be send uplink to the LoRaWAN network
+
+    This function put the data to be send uplink to the LoRaWAN network. If the element does not fit,
+    the frame is closed and the element goes to a new frame with the same port and priority.
 */
 void Buffer::putDataToSend(uint8_t *value, uint8_t type) {
-  
+
     uint8_t nextIndex;
+    uint8_t offset[VARINT_MAX_SIZE];
+    uint8_t offsetLength;
+    if(openedFrame == NULL){
+      droppedItems[getTypePriority(type)]++;
+      LOG_ERRORLN(F("Buffer: there is no frame opened"));
+      return;
+    }
+    offsetLength = putTimeOffset(offset);
     nextIndex = (value[0] + 1);//value[0] contains the size of the data + 1 for the type
-    if((nextIndex + dataToSend_Index) < dataToSend_Size){
-      dataToSend[dataToSend_Index++]= type;
-      memcpy(dataToSend + dataToSend_Index, value, (value[0] + 1));
-      dataToSend_Index = dataToSend_Index + nextIndex;
-      USB.print("Buffer: data stored correctly, stored data = ");
-      for(uint8_t i = 0; i < dataToSend_Index; i++){
-        USB.print(dataToSend[i], HEX);  
-        USB.print(":");  
+    if(!hasRoom(nextIndex + 1 + offsetLength) && reopenFrame()){//The element goes to a new frame
+      offsetLength = putTimeOffset(offset);
+    }
+    if((openedFrame != NULL) && hasRoom(nextIndex + 1 + offsetLength)){
+      openedFrame->data[openedFrame->length++]= type | (offsetLength ? TIMESTAMP_TYPE_FLAG : 0);
+      openedFrame->data[openedFrame->length++]= value[0] + offsetLength;
+      if(offsetLength > 0){
+        memcpy(openedFrame->data + openedFrame->length, offset, offsetLength);
+      }
+      memcpy(openedFrame->data + openedFrame->length + offsetLength, value + 1, value[0]);
+      openedFrame->length = openedFrame->length + offsetLength + value[0];
+      LOG_INFO(F("Buffer: data stored correctly, type "));
+      LOG_INFO(type, DEC);
+      LOG_INFO(F(", index "));
+      LOG_INFOLN(openedFrame->length, DEC);
+      for(uint8_t i = 1; i <= value[0]; i++){//Only the new element, the frame is dumped by getDataToSend()
+        LOG_VERBOSE(value[i], HEX);
+        LOG_VERBOSE(F(":"));
       }
-      USB.println("");
-      USB.print("  -Index ");
-      USB.println(dataToSend_Index, DEC);
-      USB.println("");
+      LOG_VERBOSELN(F(""));
     }else{
-      USB.print("The buffer is full, there is no more space ");
+      droppedItems[getTypePriority(type)]++;
+      TRACE(TRACE_BUFFER_FULL, type);
+      LOG_ERRORLN(F("The buffer is full, there is no more space "));
+    }
+}
+
+/*! \fn uint8_t* reserveDataToSend(uint8_t type, uint8_t maxLength)
+    \brief  Reserve an element in the opened frame to be written in place
+    \param  type      The type of the data
+    \param  maxLength The bytes that may be written in the returned slot
+    \retval Pointer where the data (without size byte) has to be written, NULL if there is no space
+
+    The slot needs room for maxLength bytes, if the opened frame does not have it the frame is closed
+    and the slot is reserved in a new frame with the same port and priority. Nothing is stored until
+    commitDataToSend() is called, so the slot is dropped if the caller does not commit it.
+*/
+uint8_t* Buffer::reserveDataToSend(uint8_t type, uint8_t maxLength) {
+    uint8_t offset[VARINT_MAX_SIZE];
+    if(openedFrame == NULL){
+      droppedItems[getTypePriority(type)]++;
+      LOG_ERRORLN(F("Buffer: there is no frame opened"));
+      return NULL;
+    }
+    reservedOffsetLength = putTimeOffset(offset);
+    if(!hasRoom(maxLength + 2 + reservedOffsetLength) && reopenFrame()){//The element goes to a new frame
+      reservedOffsetLength = putTimeOffset(offset);
+    }
+    if((openedFrame == NULL) || !hasRoom(maxLength + 2 + reservedOffsetLength)){//[type][size][offset][data...]
+      droppedItems[getTypePriority(type)]++;
+      TRACE(TRACE_BUFFER_FULL, type);
+      LOG_ERRORLN(F("The buffer is full, there is no more space "));
+      return NULL;
     }
+    if(reservedOffsetLength > 0){
+      memcpy(openedFrame->data + openedFrame->length + 2, offset, reservedOffsetLength);
+    }
+    openedFrame->data[openedFrame->length] = type | (reservedOffsetLength ? TIMESTAMP_TYPE_FLAG : 0);
+    return openedFrame->data + openedFrame->length + 2 + reservedOffsetLength;
+}
+
+/*! \fn void commitDataToSend(uint8_t length)
+    \brief  Store the element reserved with reserveDataToSend()
+    \param  length The bytes written in the slot, 0 drops the element
+*/
+void Buffer::commitDataToSend(uint8_t length) {
+    if((openedFrame == NULL) || (length == 0)){
+      return;
+    }
+    length += reservedOffsetLength;
+    openedFrame->data[openedFrame->length + 1] = length;
+    openedFrame->length = openedFrame->length + length + 2;
+    LOG_INFO(F("Buffer: data stored correctly, type "));
+    LOG_INFO(openedFrame->data[openedFrame->length - length - 2], DEC);
+    LOG_INFO(F(", index "));
+    LOG_INFOLN(openedFrame->length, DEC);
+}
+
+/*! \fn uint8_t getTypePriority(uint8_t type)
+    \brief  Return the priority class of an element type
+    \param  type The type of the element, DELTA_TYPE_FLAG, TIMESTAMP_TYPE_FLAG and STATISTICS_TYPE_FLAG are ignored
+    \retval FRAME_PRIORITY_EVENT or FRAME_PRIORITY_PERIODIC (types out of UplinkTypes_t)
+*/
+uint8_t Buffer::getTypePriority(uint8_t type){
+    type &= ~(DELTA_TYPE_FLAG | TIMESTAMP_TYPE_FLAG | STATISTICS_TYPE_FLAG);
+    if(type > FIELD_STRENGHT_TYPE){
+      return FRAME_PRIORITY_PERIODIC;
+    }
+    return uplinkTypePriority[type];
+}
+
+/*! \fn uint16_t getDroppedCount(uint8_t priority)
+    \brief  Return the elements of a priority class that could not be stored
+*/
+uint16_t Buffer::getDroppedCount(uint8_t priority){
+    return priority < PRIORITY_CLASSES ? droppedItems[priority] : 0;
+}
+
+/*! \fn uint16_t getEvictedCount(uint8_t priority)
+    \brief  Return the elements of a priority class in the frames evicted to queue higher priority ones
+*/
+uint16_t Buffer::getEvictedCount(uint8_t priority){
+    return priority < PRIORITY_CLASSES ? evictedItems[priority] : 0;
+}
+
+/*! \fn uint8_t hasDataToSend()
+    \brief Return if there are frames pending to be sent
+    \param   void
+    \retval 1 if there are frames pending
+*/
+uint8_t Buffer::hasDataToSend(){
+    return !frames.isEmpty();
 }
 
 /*! \fn void getDataToSend()
-    \brief Return the data to be send to the network
+    \brief Return the data of the oldest pending frame
     \param   void
-    \retval void
-  
+    \retval Pointer to the frame data, NULL if there are no frames pending
+
     This function returns the data to be sent through the uplink to the LoRaWAN network
 */
 uint8_t* Buffer::getDataToSend(){
-  
+
     uint8_t currentIndex = 0;
     uint8_t elemtLenght;
-    USB.println(F("________Data stored in the buffer to send:"));
-    while(currentIndex < dataToSend_Index){
-      USB.print(F(" Element Type: "));
-      USB.print( dataToSend[currentIndex++], DEC );
-      elemtLenght = dataToSend[currentIndex++];
-      USB.print(F(", Element Lenght: "));
-      USB.print( elemtLenght, DEC );
-      USB.print(F(", Element Data: "));
+    frame_t *frame = frames.front();
+    if(frame == NULL){
+      return NULL;
+    }
+    LOG_INFOLN(F("________Data stored in the buffer to send:"));
+    while(currentIndex < frame->length){
+      LOG_VERBOSE(F(" Element Type: "));
+      LOG_VERBOSE( frame->data[currentIndex++], DEC );
+      elemtLenght = frame->data[currentIndex++];
+      LOG_VERBOSE(F(", Element Lenght: "));
+      LOG_VERBOSE( elemtLenght, DEC );
+      LOG_VERBOSE(F(", Element Data: "));
       for(uint8_t i=0; i<elemtLenght; i++){
-        USB.print( dataToSend[currentIndex++], HEX );
-        USB.print(F(" "));
+        LOG_VERBOSE( frame->data[currentIndex++], HEX );
+        LOG_VERBOSE(F(" "));
       }
-      USB.println(F(""));
-    } 
-    return dataToSend;
+      LOG_VERBOSELN(F(""));
+    }
+    return frame->data;
 }
 
 /*! \fn void getDataToSendSize()
-    \brief Returns the size of the data stored in the buffer.
+    \brief Returns the size of the oldest pending frame
     \param   void
-    \retval void
-  
+    \retval The size, 0 if there are no frames pending
+
 */
 uint8_t Buffer::getDataToSendSize(){
-  return dataToSend_Index;
+    frame_t *frame = frames.front();
+    if(frame == NULL){
+      return 0;
+    }
+    return frame->length;
+}
+
+/*! \fn uint8_t getDataToSendPort()
+    \brief Returns the LoRaWAN port of the oldest pending frame
+    \param   void
+    \retval The port, 0 if there are no frames pending
+*/
+uint8_t Buffer::getDataToSendPort(){
+    frame_t *frame = frames.front();
+    if(frame == NULL){
+      return 0;
+    }
+    return frame->port;
+}
+
+/*! \fn uint8_t isDataToSendConfirmed()
+    \brief Returns if the oldest pending frame must be sent confirmed
+    \param   void
+    \retval 1 if confirmed
+*/
+uint8_t Buffer::isDataToSendConfirmed(){
+    frame_t *frame = frames.front();
+    if(frame == NULL){
+      return 0;
+    }
+    return frame->confirmed;
+}
+
+/*! \fn uint8_t retryDataToSend()
+    \brief  The send of the oldest pending frame failed, keep it to retry
+    \param   void
+    \retval 1: the frame is kept
+            0: the frame reached FRAME_MAX_RETRIES and it has been discarded
+*/
+uint8_t Buffer::retryDataToSend(){
+    frame_t *frame = frames.front();
+    if(frame == NULL){
+      return 0;
+    }
+    if(++frame->retries >= FRAME_MAX_RETRIES){
+      LOG_ERRORLN(F("Buffer: frame discarded after the maximum retries"));
+      TRACE(TRACE_FRAME_DISCARDED, frame->port);
+      frames.pop();
+      return 0;
+    }
+    return 1;
 }
 
 /*! \fn void clearDataToSend()
-    \brief  Reset the DataToSend
+    \brief  Remove the oldest pending frame
     \param   void
     \retval void
-    
-    This function resets the buffer with the uplink data that has already been sent to the network.
+
+    This function removes the uplink frame that has already been sent to the network.
 */
 void Buffer::clearDataToSend(){
-    memset(dataToSend, 0x00, sizeof(dataToSend));
-    dataToSend_Index = 0;
+    frames.pop();
+}
+
+
+/******************************************************************************
+          Redundancy of the periodic uplinks                                  *
+******************************************************************************/
+
+/*! \fn void setRedundancy(uint8_t mode, uint8_t depth)
+    \brief  Set the redundancy appended to the periodic uplinks
+    \param  uint8_t mode  REDUNDANCY_NONE, REDUNDANCY_COPY or REDUNDANCY_PARITY
+    \param  uint8_t depth Number of previous frames covered [1..REDUNDANCY_MAX_DEPTH]
+    \retval void
+
+    More depth recovers longer losses but costs airtime in every uplink, the parity only
+    recovers one lost frame of the depth covered.
+*/
+void Buffer::setRedundancy(uint8_t mode, uint8_t depth){
+    if(mode > REDUNDANCY_PARITY){
+        mode = REDUNDANCY_NONE;
+    }
+    if(depth < 1){
+        depth = 1;
+    }else if(depth > REDUNDANCY_MAX_DEPTH){
+        depth = REDUNDANCY_MAX_DEPTH;
+    }
+    redundancyMode = mode;
+    redundancyDepth = depth;
+}
+
+/*! \fn uint8_t getRedundancyMode()
+    \brief  Return the redundancy mode of the periodic uplinks
+*/
+uint8_t Buffer::getRedundancyMode(){
+    return redundancyMode;
 }
 
+/*! \fn uint8_t getRedundancyDepth()
+    \brief  Return the number of previous frames covered by the redundancy
+*/
+uint8_t Buffer::getRedundancyDepth(){
+    return redundancyDepth;
+}
+
+/*! \fn void putRedundancy()
+    \brief  Append the redundancy element to the opened frame and keep the frame for the next ones
+    \param  void
+    \retval void
+
+    The number of previous frames covered is reduced until the element fits in the buffer,
+    if not even one fits the element is not appended. Redundancy.h describes the element.
+*/
+void Buffer::putRedundancy(){
+    uint8_t *dataToSend = openedFrame->data;
+    uint8_t dataLength = openedFrame->length;
+    uint8_t depth = redundancyDepth;
+    uint8_t *element;
+    uint8_t length;
+    uint8_t slot;
+    uint8_t block;
+    uint8_t maxLength;
+    if(depth > historyCount){
+        depth = historyCount;
+    }
+    while((redundancyMode != REDUNDANCY_NONE) && (depth > 0)){
+        element = dataToSend + dataLength;
+        length = 4;
+        if((dataLength + length) > dataToSend_Size){
+            break;
+        }
+        if(redundancyMode == REDUNDANCY_COPY){
+            for(uint8_t i = 0; i < depth; i++){
+                slot = (historyCount - 1 - i) % REDUNDANCY_MAX_DEPTH;
+                if((dataLength + length + 2) >= dataToSend_Size){
+                    length = 0;
+                    break;
+                }
+                block = xorRunEncode(historyData[slot], historyLength[slot], dataToSend, dataLength,
+                                     element + length + 2, dataToSend_Size - dataLength - length - 2);
+                if((block == 0) && (historyLength[slot] > 0)){
+                    length = 0;
+                    break;
+                }
+                element[length++] = historyLength[slot];
+                element[length++] = block;
+                length += block;
+            }
+        }else{
+            maxLength = 0;
+            for(uint8_t i = 0; i < depth; i++){
+                slot = (historyCount - 1 - i) % REDUNDANCY_MAX_DEPTH;
+                if(historyLength[slot] > maxLength){
+                    maxLength = historyLength[slot];
+                }
+            }
+            if((dataLength + length + depth + maxLength) > dataToSend_Size){
+                length = 0;
+            }else{
+                memset(element + length + depth, 0x00, maxLength);
+                for(uint8_t i = 0; i < depth; i++){
+                    slot = (historyCount - 1 - i) % REDUNDANCY_MAX_DEPTH;
+                    element[length + i] = historyLength[slot];
+                    for(uint8_t j = 0; j < historyLength[slot]; j++){
+                        element[length + depth + j] ^= historyData[slot][j];
+                    }
+                }
+                length += depth + maxLength;
+            }
+        }
+        if(length > 0){
+            element[0] = REDUNDANCY_TYPE;
+            element[1] = length - 2;
+            element[2] = frameSequence;
+            element[3] = (redundancyMode << 4) | depth;
+            openedFrame->length = dataLength + length;
+            break;
+        }
+        depth--;
+    }
+    slot = historyCount % REDUNDANCY_MAX_DEPTH;
+    memcpy(historyData[slot], dataToSend, dataLength);
+    historyLength[slot] = dataLength;
+    historyCount++;
+    if(historyCount == (2 * REDUNDANCY_MAX_DEPTH)){
+        historyCount = REDUNDANCY_MAX_DEPTH;
+    }
+    frameSequence++;
+}
+
+#if AGGREGATED_SAMPLES > 1
+/******************************************************************************
+          To aggregate several samples in one uplink (delta series)           *
+******************************************************************************/
+
+/*! \fn uint8_t putAggregatedData(uint8_t *value, uint8_t type)
+    \brief  Add a sensor value to the delta series of its type
+    \param  uint8_t *value The data to store, data[0] contains the size of the data
+    \param  uint8_t type The type of the data
+    \retval 1: value added
+            0: the series or the frame are full, flushAggregatedData() must be called and the value put again
+
+    The series are written to the opened frame by flushAggregatedData(), that must be empty (or with
+    the epoch element only). The space they will take there ([type][lenght][time][count][stream]) is
+    checked here, related to the epoch of the frame opened now, so that the flush always fits.
+*/
+uint8_t Buffer::putAggregatedData(uint8_t *value, uint8_t type){
+    int32_t sample;
+    uint16_t needed = TIMESTAMPED_ELEMENTS ? FRAME_EPOCH_SIZE : 0;
+    uint8_t time[2 * VARINT_MAX_SIZE];
+    uint32_t first = aggregatedFirstEpoch[type];
+    uint32_t last = aggregatedLastEpoch[type];
+    sample = rawToValue(value, isSignedType(type));
+    if(aggregatedData[type].getCount() == 0){
+        aggregatedFirstEpoch[type] = RTC.getEpochTime();
+    }
+    aggregatedLastEpoch[type] = RTC.getEpochTime();
+    for(uint8_t i = 0; i < 12; i++){
+        if((aggregatedData[i].getCount() > 0) && (i != type)){
+            needed += 3 + aggregatedData[i].getLength() + putSeriesTime(i, time);
+        }
+    }
+    needed += 3 + aggregatedData[type].getLength();
+    if(TIMESTAMPED_ELEMENTS){//The interval is not known until the value is added, last - first is its upper bound
+        needed += varintLength(zigzagEncode((int32_t)(aggregatedLastEpoch[type] - (openedFrame ? openedFrame->timestamp : 0))));
+        needed += varintLength(aggregatedLastEpoch[type] - aggregatedFirstEpoch[type]);
+    }
+    needed += aggregatedData[type].encodedLength(sample);
+    if((needed > dataToSend_Size) || !aggregatedData[type].putValue(sample)){
+        aggregatedFirstEpoch[type] = first;
+        aggregatedLastEpoch[type] = last;
+        return 0;
+    }
+    return 1;
+}
+
+/*! \fn uint8_t putSeriesTime(uint8_t type, uint8_t *out)
+    \brief  Encode the time of a delta series related to the epoch of the opened frame
+    \param[in]  type The type of the series
+    \param[out] *out zig-zag varint offset of the last sample, varint seconds between samples
+    \retval The bytes written, 0 if the elements are not timestamped
+*/
+uint8_t Buffer::putSeriesTime(uint8_t type, uint8_t *out){
+#if TIMESTAMPED_ELEMENTS
+    uint8_t length;
+    uint32_t interval = 0;
+    if(openedFrame == NULL){
+        return 0;
+    }
+    if(aggregatedData[type].getCount() > 1){
+        interval = (aggregatedLastEpoch[type] - aggregatedFirstEpoch[type]) / (aggregatedData[type].getCount() - 1);
+    }
+    length = varintEncode(zigzagEncode((int32_t)(aggregatedLastEpoch[type] - openedFrame->timestamp)), out);
+    return length + varintEncode(interval, out + length);
+#else
+    return 0;
+#endif
+}
+
+/*! \fn void flushAggregatedData()
+    \brief  Move the delta series to the opened frame
+    \param  void
+    \retval void
+
+    Each series is stored as an element with type = (type | DELTA_TYPE_FLAG), data = [count][stream].
+    With TIMESTAMPED_ELEMENTS the type has TIMESTAMP_TYPE_FLAG too and data = [time][count][stream] (putSeriesTime()).
+*/
+void Buffer::flushAggregatedData(){
+    uint8_t length;
+    uint8_t timeLength;
+    uint8_t *dataToSend;
+    if(openedFrame == NULL){
+        return;
+    }
+    dataToSend = openedFrame->data;
+    for(uint8_t type = 0; type < 12; type++){
+        if(aggregatedData[type].getCount() == 0){
+            continue;
+        }
+        length = aggregatedData[type].getLength();
+        timeLength = putSeriesTime(type, dataToSend + openedFrame->length + 2);
+        dataToSend[openedFrame->length++] = type | DELTA_TYPE_FLAG | (timeLength ? TIMESTAMP_TYPE_FLAG : 0);
+        dataToSend[openedFrame->length++] = timeLength + length + 1;
+        openedFrame->length = openedFrame->length + timeLength;
+        dataToSend[openedFrame->length++] = aggregatedData[type].getCount();
+        memcpy(dataToSend + openedFrame->length, aggregatedData[type].getStream(), length);
+        openedFrame->length = openedFrame->length + length;
+        aggregatedData[type].clear();
+    }
+}
+#endif
+
+#if STATISTICS_SAMPLES > 1
+/******************************************************************************
+          To summarise several samples in one uplink (statistics)             *
+******************************************************************************/
+
+/*! \fn void putStatisticsData(uint8_t *value, uint8_t type)
+    \brief  Add a sample to the statistics of its type
+    \param  uint8_t *value Pointer to the value, value[0] contains the size of the data
+    \param  uint8_t type   The type of the data
+    \retval void
+*/
+void Buffer::putStatisticsData(uint8_t *value, uint8_t type){
+    if((type >= 12) || (value[0] == 0)){
+        return;
+    }
+    statisticsData[type].putValue(rawToValue(value, isSignedType(type)));
+}
+
+/*! \fn void flushStatisticsData()
+    \brief  Move the statistics summaries to the opened frame and start new windows
+    \param  void
+    \retval void
+
+    Each summary is stored as an element with type = (type | STATISTICS_TYPE_FLAG), data = the
+    RunningStats summary, after the RTC offset when TIMESTAMPED_ELEMENTS. If a summary does not fit,
+    reserveDataToSend() closes the frame and the rest go to a new frame with the same port and priority.
+*/
+void Buffer::flushStatisticsData(){
+    uint8_t summary[STATISTICS_SUMMARY_SIZE];
+    uint8_t length;
+    uint8_t *slot;
+    for(uint8_t type = 0; type < 12; type++){
+        if((openedFrame == NULL) || (statisticsData[type].getCount() == 0)){
+            continue;
+        }
+        length = statisticsData[type].encode(summary);
+        slot = reserveDataToSend(type | STATISTICS_TYPE_FLAG, length);
+        if(slot != NULL){
+            memcpy(slot, summary, length);
+            commitDataToSend(length);
+        }
+        statisticsData[type].clear();
+    }
+}
+#endif
+
+/*! \fn uint8_t isSignedType(uint8_t type)
+    \brief  Return if the values of the type are signed in the Thunderboard Sense 2 profile
+    \param  uint8_t type The type of the data
+    \retval 1: signed (temperature, sound level, field strength)
+            0: unsigned
+*/
+uint8_t Buffer::isSignedType(uint8_t type){
+    return (type == TEMPERATURE_TYPE) || (type == SOUND_LEVEL_TYPE) || (type == FIELD_STRENGHT_TYPE);
+}
 
 /******************************************************************************
           To receive downlink data from the LoRaWAN network                   *
@@ -131,17 +733,22 @@ void Buffer::clearDataToSend(){
     
     This function Store the data received from the downlink.
     The data is received in ASCII and store as uint8_t
-    Only two cases are considered:
+    Only these cases are considered:
        Case 1: Establish the time to send. Data received-->type = 1 H1 H2 M1 M2
        Case 2: Establish the sensor value to be send. Data received-->type = 2 S1 S2 S3 S4 S5 S6 S7 S8 S9 S10 S11
+       Case 3: Establish the redundancy of the periodic uplinks. Data received-->type = 3 M K
+       Case 4: Establish the sampling period of a sensor. Data received-->type = 4 T1 T2 P1 P2 P3 P4
+               (T: UplinkTypes_t, P: period in minutes, 0 follows the time of case 1)
+       Case 5: Establish the send-on-delta threshold of a sensor. Data received-->type = 5 T1 T2 D1 D2 D3 D4 H1 H2
+               (T: UplinkTypes_t, D: threshold in raw units, 0 sends every value, H: maximum silence in hours, 0 never)
        *Note: Every item is received as 2 element. Example: type = 1-->31(HEX),51(ASCII)(value[0] and value[1])
        Therefore only odd positions are taken into account 
 */                                            
 void Buffer::putNetworkReceivedData(char *value){
     uint8_t type;
     type = (uint8_t)(value[1]-48);
-    USB.print("Message type: ");
-    USB.println(type, DEC);
+    LOG_INFO(F("Message type: "));
+    LOG_INFOLN(type, DEC);
     
     switch(type){
     case 1://Establish the time to send 
@@ -156,6 +763,37 @@ void Buffer::putNetworkReceivedData(char *value){
       networkReceivedData[i+1] = (uint8_t) value[((i*2)+3)] - 48;
       }
     break;
+
+    case 3://Establish the redundancy of the periodic uplinks
+      networkReceivedData[0] = type;
+      networkReceivedData[1] = (uint8_t)(value[3]-48);//mode
+      networkReceivedData[2] = (uint8_t)(value[5]-48);//depth
+    break;
+
+    case 4:{//Establish the sampling period of a sensor
+      uint16_t period = 0;
+      networkReceivedData[0] = type;
+      networkReceivedData[1] = (uint8_t)((value[3]-48) * 10) + (value[5]-48);//sensor type
+      for(uint8_t i = 0; i < 4; i++){
+        period = period * 10 + (value[(i*2)+7]-48);
+      }
+      networkReceivedData[2] = (uint8_t)(period >> 8);//period in minutes, big endian
+      networkReceivedData[3] = (uint8_t)period;
+    }
+    break;
+
+    case 5:{//Establish the send-on-delta threshold of a sensor
+      uint16_t threshold = 0;
+      networkReceivedData[0] = type;
+      networkReceivedData[1] = (uint8_t)((value[3]-48) * 10) + (value[5]-48);//sensor type
+      for(uint8_t i = 0; i < 4; i++){
+        threshold = threshold * 10 + (value[(i*2)+7]-48);
+      }
+      networkReceivedData[2] = (uint8_t)(threshold >> 8);//threshold, big endian
+      networkReceivedData[3] = (uint8_t)threshold;
+      networkReceivedData[4] = (uint8_t)((value[15]-48) * 10) + (value[17]-48);//maximum silence in hours
+    }
+    break;
     
     default:
       networkReceivedData[0] = 0;
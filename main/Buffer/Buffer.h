@@ -9,57 +9,175 @@
  ******************************************************************************/
 
 #include <inttypes.h>
+#include "defines.h"
+#include "DeltaCodec.h"
+#include "Redundancy.h"
+#include "RingBuffer.h"
+#include "RunningStats.h"
 /******************************************************************************
- * Class
+ * Definitions & Declarations
  ******************************************************************************/
 #define dataToSend_Size 60
 #define ReceivedData_Size 30
+#define FRAME_QUEUE_SIZE 4/*!< Number of uplink frames that can be pending */
+#define FRAME_MAX_RETRIES 3/*!< Sends of a confirmed frame before it is discarded */
+#define FRAME_EPOCH_SIZE 6/*!< [FRAME_EPOCH_TYPE][4][epoch] */
+
+/*! \struct frame_t
+    \brief  Uplink frame and its metadata
+ */
+typedef struct {
+  uint8_t port;/**< LoRaWAN port: EVENT_PORT or DATA_PORT */
+  uint8_t confirmed;/**< 1 to be sent confirmed */
+  uint8_t priority;/**< Priority of the frame, the higher the more important */
+  uint8_t retries;/**< Number of failed sends */
+  uint32_t timestamp;/**< RTC epoch when the frame was opened */
+  uint8_t length;/**< Bytes used in data */
+  uint8_t data[dataToSend_Size];/**< The elements [type][lenght][data...] */
+}frame_t;
+
+/******************************************************************************
+ * Class
+ ******************************************************************************/
 //! Buffer Class
 /*!
-  defines all the variables and functions used 
+  defines all the variables and functions used
  */
 class Buffer{
 
   /// private methods //////////////////////////
 private:
 
-   
+    RingBuffer<frame_t, FRAME_QUEUE_SIZE> frames;/*!< Frames closed and pending to be sent */
+
+    frame_t *openedFrame;/*!< Frame being filled, reserved in frames but not pushed yet */
+
+    uint8_t redundancyMode;
+
+    uint8_t redundancyDepth;
+
+    uint8_t frameSequence;
+
+    uint8_t historyData[REDUNDANCY_MAX_DEPTH][dataToSend_Size];
+
+    uint8_t historyLength[REDUNDANCY_MAX_DEPTH];
+
+    uint8_t historyCount;
+
+    void putRedundancy();
+
+    uint16_t droppedItems[PRIORITY_CLASSES];/*!< Elements not stored, per priority class */
+
+    uint16_t evictedItems[PRIORITY_CLASSES];/*!< Elements of the frames evicted to queue higher priority ones, per priority class */
+
+    uint8_t evictFrame(uint8_t priority);
+
+    uint8_t hasRoom(uint8_t elementLength);
+
+    uint8_t reopenFrame();
+
+    void countItems(frame_t *frame, uint16_t *counters);
+
+    uint8_t reservedOffsetLength;/*!< Bytes of the RTC offset written by reserveDataToSend() */
+
+    uint8_t putTimeOffset(uint8_t *out);
+
   /// public methods and attributes ////////////
 public:
 
 
     Buffer();
-    
+
     ~Buffer();
-    
+
 /******************************************************************************
               To Send uplink data to the LoRaWAN network                      *
 ******************************************************************************/
-    
-    uint8_t dataToSend_Index;
-    
-    uint8_t dataToSend[dataToSend_Size];
-    
+
+    uint8_t openFrame(uint8_t port, uint8_t confirmed, uint8_t priority);
+
+    void closeFrame();
+
     void putDataToSend(uint8_t *value, uint8_t type);
-    
+
+    uint8_t* reserveDataToSend(uint8_t type, uint8_t maxLength);
+
+    void commitDataToSend(uint8_t length);
+
+    uint8_t hasDataToSend();
+
     uint8_t* getDataToSend();
-    
+
     uint8_t getDataToSendSize();
-    
+
+    uint8_t getDataToSendPort();
+
+    uint8_t isDataToSendConfirmed();
+
+    uint8_t retryDataToSend();
+
     void clearDataToSend();
 
+    uint8_t getTypePriority(uint8_t type);
+
+    uint16_t getDroppedCount(uint8_t priority);
+
+    uint16_t getEvictedCount(uint8_t priority);
+
+/******************************************************************************
+          Redundancy of the periodic uplinks                                  *
+******************************************************************************/
+
+    void setRedundancy(uint8_t mode, uint8_t depth);
+
+    uint8_t getRedundancyMode();
+
+    uint8_t getRedundancyDepth();
+
 /******************************************************************************
           To receive downlink data from the LoRaWAN network                   *
 ******************************************************************************/
-    
+
     uint8_t networkReceivedData[ReceivedData_Size];
-    
+
     void putNetworkReceivedData(char *value);
 
     uint8_t getNetworkReceivedData(uint8_t index);
-    
+
     void clearNetworkReceivedData();
-    
-#endif 
+
+#if AGGREGATED_SAMPLES > 1
+/******************************************************************************
+          To aggregate several samples in one uplink (delta series)           *
+******************************************************************************/
+
+    DeltaEncoder aggregatedData[12];
+
+    uint32_t aggregatedFirstEpoch[12];/*!< RTC epoch of the first sample of each series */
+
+    uint32_t aggregatedLastEpoch[12];/*!< RTC epoch of the last sample of each series */
+
+    uint8_t putSeriesTime(uint8_t type, uint8_t *out);
+
+    uint8_t putAggregatedData(uint8_t *value, uint8_t type);
+
+    void flushAggregatedData();
+#endif
+
+#if STATISTICS_SAMPLES > 1
+/******************************************************************************
+          To summarise several samples in one uplink (statistics)             *
+******************************************************************************/
+
+    RunningStats statisticsData[12];
+
+    void putStatisticsData(uint8_t *value, uint8_t type);
+
+    void flushStatisticsData();
+#endif
+
+    uint8_t isSignedType(uint8_t type);
+
+#endif
 
 };
@@ -0,0 +1,218 @@
+/*! \file DeltaCodec.cpp
+    \brief Library for the delta/zig-zag varint compression of the sensor series
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    This library does not use the Waspmote API, so it is also built by the host side decoder.
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include <string.h>
+#include "DeltaCodec.h"
+
+/******************************************************************************
+ * FUNCTIONS                                                                  *
+ ******************************************************************************/
+
+/*! \fn uint32_t zigzagEncode(int32_t value)
+    \brief Map a signed value to an unsigned one, small magnitudes to small values
+    \param  value The signed value
+    \retval The zig-zag value: 0->0, -1->1, 1->2, -2->3...
+*/
+uint32_t zigzagEncode(int32_t value){
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+/*! \fn int32_t zigzagDecode(uint32_t value)
+    \brief Inverse of zigzagEncode()
+    \param  value The zig-zag value
+    \retval The signed value
+*/
+int32_t zigzagDecode(uint32_t value){
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+/*! \fn uint8_t varintLength(uint32_t value)
+    \brief Number of bytes needed to varint encode the value
+    \param  value The value to encode
+    \retval 1..VARINT_MAX_SIZE
+*/
+uint8_t varintLength(uint32_t value){
+    uint8_t length = 1;
+    while(value >= 0x80){
+        value >>= 7;
+        length++;
+    }
+    return length;
+}
+
+/*! \fn uint8_t varintEncode(uint32_t value, uint8_t *out)
+    \brief Varint encode the value
+    \param[in]  value The value to encode
+    \param[out] *out  Where the bytes are written, at least varintLength(value) bytes
+    \retval The number of bytes written
+*/
+uint8_t varintEncode(uint32_t value, uint8_t *out){
+    uint8_t length = 0;
+    while(value >= 0x80){
+        out[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = (uint8_t)value;
+    return length;
+}
+
+/*! \fn uint8_t varintDecode(const uint8_t *in, uint8_t length, uint32_t *value)
+    \brief Decode one varint
+    \param[in]  *in    The encoded bytes
+    \param[in]  length The number of bytes available in in
+    \param[out] *value The decoded value
+    \retval The number of bytes consumed, 0 if the varint is truncated or too long
+*/
+uint8_t varintDecode(const uint8_t *in, uint8_t length, uint32_t *value){
+    uint32_t result = 0;
+    uint8_t i;
+    for(i = 0; (i < length) && (i < VARINT_MAX_SIZE); i++){
+        result |= (uint32_t)(in[i] & 0x7F) << (7 * i);
+        if((in[i] & 0x80) == 0){
+            *value = result;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+/*! \fn uint8_t deltaDecodeSeries(const uint8_t *stream, uint8_t length, uint8_t count, int32_t *values)
+    \brief Decode a series written by DeltaEncoder
+    \param[in]  *stream The encoded series (without the count byte)
+    \param[in]  length  The length of stream
+    \param[in]  count   The number of values in the series
+    \param[out] *values Where the count values are written
+    \retval The number of values decoded, lower than count if the stream is corrupted
+*/
+uint8_t deltaDecodeSeries(const uint8_t *stream, uint8_t length, uint8_t count, int32_t *values){
+    uint8_t index = 0;
+    uint8_t used;
+    uint8_t decoded;
+    uint32_t raw;
+    int32_t previous = 0;
+    for(decoded = 0; decoded < count; decoded++){
+        used = varintDecode(stream + index, length - index, &raw);
+        if(used == 0){
+            break;
+        }
+        index += used;
+        previous += zigzagDecode(raw);
+        values[decoded] = previous;
+    }
+    return decoded;
+}
+
+/*! \fn int32_t rawToValue(const uint8_t *value, uint8_t isSigned)
+    \brief Convert a raw BLE attribute value to an integer
+    \param  *value   The attribute value, value[0] contains the size of the data (1..4 bytes, little endian)
+    \param  isSigned 1 if the value must be sign extended
+    \retval The value
+*/
+int32_t rawToValue(const uint8_t *value, uint8_t isSigned){
+    uint8_t size = value[0];
+    uint32_t result = 0;
+    if(size > 4){
+        size = 4;
+    }
+    for(uint8_t i = 0; i < size; i++){
+        result |= (uint32_t)value[i + 1] << (8 * i);
+    }
+    if(isSigned && (size > 0) && (size < 4) && (value[size] & 0x80)){
+        result |= 0xFFFFFFFFUL << (8 * size);
+    }
+    return (int32_t)result;
+}
+
+/******************************************************************************
+ * DeltaEncoder                                                               *
+ ******************************************************************************/
+
+/*! class constructor
+It clears the series
+\param void
+\return void
+*/
+DeltaEncoder::DeltaEncoder(){
+    clear();
+}
+
+/*! class Destructor
+  It does nothing
+  \param void
+  \return void
+*/
+DeltaEncoder::~DeltaEncoder(){
+}
+
+/*! \fn uint8_t encodedLength(int32_t value)
+    \brief Number of bytes that putValue(value) would add to the stream
+    \param  value The value to add
+    \retval The number of bytes
+*/
+uint8_t DeltaEncoder::encodedLength(int32_t value){
+    if(count == 0){
+        return varintLength(zigzagEncode(value));
+    }
+    return varintLength(zigzagEncode(value - previous));
+}
+
+/*! \fn uint8_t putValue(int32_t value)
+    \brief Add a value to the series
+    \param  value The value to add
+    \retval 1: value added
+            0: there is no space left in the stream (or 255 values), the value is not added
+*/
+uint8_t DeltaEncoder::putValue(int32_t value){
+    uint32_t encoded;
+    if(count == 0){
+        encoded = zigzagEncode(value);
+    }else{
+        encoded = zigzagEncode(value - previous);
+    }
+    if((count == 0xFF) || ((length + varintLength(encoded)) > DELTA_STREAM_SIZE)){
+        return 0;
+    }
+    length += varintEncode(encoded, stream + length);
+    previous = value;
+    count++;
+    return 1;
+}
+
+/*! \fn uint8_t getCount()
+    \brief Number of values in the series
+*/
+uint8_t DeltaEncoder::getCount(){
+    return count;
+}
+
+/*! \fn uint8_t getLength()
+    \brief Number of bytes used by the encoded series
+*/
+uint8_t DeltaEncoder::getLength(){
+    return length;
+}
+
+/*! \fn uint8_t* getStream()
+    \brief Return the encoded series
+*/
+uint8_t* DeltaEncoder::getStream(){
+    return stream;
+}
+
+/*! \fn void clear()
+    \brief Reset the series
+*/
+void DeltaEncoder::clear(){
+    previous = 0;
+    count = 0;
+    length = 0;
+    memset(stream, 0x00, sizeof(stream));
+}
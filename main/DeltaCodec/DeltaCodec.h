@@ -0,0 +1,88 @@
+/*! \file DeltaCodec.h
+    \brief Library for the delta/zig-zag varint compression of the sensor series
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+*/
+
+/*! \def _DELTACODEC_H
+    \brief The library flag
+ */
+#ifndef _DELTACODEC_H
+#define _DELTACODEC_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define DELTA_STREAM_SIZE 16/*!< Maximum size in bytes of the encoded series of one sensor */
+#define VARINT_MAX_SIZE 5/*!< Maximum size in bytes of a varint encoded uint32_t */
+
+/*
+                        Delta series structure (element payload)
+    Byte 0:     8 bits, Count                    Number of samples in the series
+    Bytes 1-n:  varints                          zig-zag(first value), zig-zag(value[i] - value[i-1])...
+
+    Each varint stores 7 bits per byte, least significant group first, the bit 7 set
+    means that more bytes follow.
+*/
+
+uint32_t zigzagEncode(int32_t value);
+
+int32_t zigzagDecode(uint32_t value);
+
+uint8_t varintLength(uint32_t value);
+
+uint8_t varintEncode(uint32_t value, uint8_t *out);
+
+uint8_t varintDecode(const uint8_t *in, uint8_t length, uint32_t *value);
+
+uint8_t deltaDecodeSeries(const uint8_t *stream, uint8_t length, uint8_t count, int32_t *values);
+
+int32_t rawToValue(const uint8_t *value, uint8_t isSigned);
+
+/******************************************************************************
+ * Class                                                                      *
+ ******************************************************************************/
+
+//! DeltaEncoder Class
+/*!
+  Encodes the series of values of one sensor: first value absolute, then zig-zag varint deltas
+ */
+class DeltaEncoder{
+
+/// public methods ////////////
+public:
+
+    DeltaEncoder();
+
+    ~DeltaEncoder();
+
+    uint8_t encodedLength(int32_t value);
+
+    uint8_t putValue(int32_t value);
+
+    uint8_t getCount();
+
+    uint8_t getLength();
+
+    uint8_t* getStream();
+
+    void clear();
+
+/// private methods and attributes //////////////
+private:
+
+    int32_t previous;/*!< Last value added to the series */
+
+    uint8_t count;/*!< Number of values in the series */
+
+    uint8_t length;/*!< Number of bytes used in stream */
+
+    uint8_t stream[DELTA_STREAM_SIZE];/*!< The encoded series */
+};
+
+#endif
@@ -0,0 +1,198 @@
+/*! \file Hal.cpp
+    \brief Hardware abstraction of the node: sleep, wake up interrupts, the tick counter and the memory use (Waspmote implementation)
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#ifndef __WPROGRAM_H__
+  #include <WaspClasses.h>
+#endif
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include "Hal.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define HAL_STACK_PAINT_MARGIN 32/*!< Bytes below the stack pointer not painted, used by halPaintStack() itself */
+
+static volatile halCallback_t bleWakeUpCallback = NULL;/*!< Called by the PCINT8 ISR */
+static uint8_t *heapHighWater = NULL;/*!< Highest heap top seen by halPaintStack() and halGetMemory() */
+
+/*! \struct __freelist
+    \brief  Free block of the avr-libc malloc(), its list starts at __flp
+ */
+struct __freelist {
+  size_t sz;/**< Size of the block without this field */
+  struct __freelist *nx;/**< Next free block */
+};
+
+extern uint8_t __heap_start;/*!< Start of the heap, set by the linker */
+extern void *__brkval;/*!< Top of the heap, NULL before the first malloc() */
+extern struct __freelist *__flp;/*!< Free list of malloc() */
+extern size_t __malloc_margin;/*!< Bytes malloc() leaves below the stack pointer */
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS                                                          *
+ ******************************************************************************/
+
+/*! \fn static uint8_t* heapTop()
+    \retval The first byte above the heap
+*/
+static uint8_t* heapTop(){
+    return (__brkval == NULL) ? &__heap_start : (uint8_t*)__brkval;
+}
+
+/******************************************************************************
+ * FUNCTIONS                                                                  *
+ ******************************************************************************/
+
+/*! \fn void halAttachAlarm(halCallback_t callback)
+    \brief Attach the function called by the RTC alarm interrupt
+    \param  callback The function, it must only set flags
+*/
+void halAttachAlarm(halCallback_t callback){
+    attachInterrupt(RTC_INT, callback, 1);
+}
+
+/*! \fn void halAttachBleWakeUp(halCallback_t callback)
+    \brief Attach the function called by the PCINT8 interrupt (BLE module UART RX)
+    \param  callback The function, it must only set flags
+*/
+void halAttachBleWakeUp(halCallback_t callback){
+    bleWakeUpCallback = callback;
+}
+
+/*! \fn void halEnableBleWakeUp()
+    \brief Enables the PCINT8 interrupt, which corresponds to the RX pin of socket 0 where the BLE module is connected.
+    \param void
+    \retval void
+    
+    PCMSK1 – Pin Change Mask Register 1:
+    Each PCINT15:8-bit selects whether pin change interrupt is enabled on the corresponding I/O pin. 
+    If PCINT15:8 isset and the PCIE1 bit in PCICR is set, pin change interrupt is enabled on the corresponding I/O pin.
+    If PCINT15:8 is cleared, pin change interrupt on the corresponding I/O pin is disabled.
+    
+    PCIFR – Pin Change Interrupt Flag Register: 
+    When a logic change on any PCINT15:8 pin triggers an interrupt request, PCIF1 becomes set (one). 
+    If the I-bit inSREG and the PCIE1 bit in PCICR are set (one), the MCU will jump to the corresponding Interrupt Vector. 
+    The flagis cleared when the interrupt routine is executed. Alternatively, the flag can be cleared by writing a logical one to it.
+    
+    PCICR – Pin Change Interrupt Control Register:
+    When the PCIE1 bit is set (one) and the I-bit in the Status Register (SREG) is set (one), pin change interrupt 1 isenabled.
+    Any change on any enabled PCINT15:8 pin will cause an interrupt.
+    The corresponding interrupt of PinChange Interrupt Request is executed from the PCI1 Interrupt Vector. 
+    PCINT15:8 pins are enabled individually bythe PCMSK1 Register.
+*/
+void halEnableBleWakeUp(){
+    PCMSK1 |= (1 << PCINT8);
+    PCIFR  |= (1 << PCIF1);
+    PCICR  |= (1 << PCIE1);
+}
+
+/*! \fn void halDisableBleWakeUp()
+    \brief Disables the PCINT8 interrupt, which corresponds to the RX pin of socket0 where the BLE module is connected.
+    \param void
+    \retval void
+*/
+void halDisableBleWakeUp(){
+    PCICR &= ~(1 << PCIE1);
+}
+
+/*! \fn ISR( PCINT1_vect)
+    \brief ISR to handle the PCINT8(Pin PE0(RXD0/PCINT8/PDI)--> connected to Waspmote Socket0 (RXD0 BLE module))
+*/
+ISR( PCINT1_vect){ 
+    if(bleWakeUpCallback != NULL){
+        bleWakeUpCallback();
+    }
+}
+
+/*! \fn void halSleep()
+    \brief turn waspmote in sleep mode(SLEEP_MODE_PWR_DOWN) until an interrupt
+    \param  void
+    \retval void
+*/
+void halSleep(){
+    /* There are five different sleep modes in order of power saving:
+      SLEEP_MODE_IDLE - the lowest power saving mode
+      SLEEP_MODE_ADC
+      SLEEP_MODE_PWR_SAVE
+      SLEEP_MODE_STANDBY
+      SLEEP_MODE_EXT_STANDBY
+      SLEEP_MODE_PWR_DOWN - the highest power saving mode
+    */
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+    sleep_mode();//Put the device into sleep mode, taking care of setting the SE bit before, and clearing it afterwards 
+}
+
+/*! \fn uint32_t halTicks()
+    \brief Free running tick counter of the profiling (Profile.h), it wraps every 71 minutes
+    \param  void
+    \retval The microseconds of micros(): Timer0 overflows and TCNT0, 4.34 us resolution at 14.7456 MHz
+
+    Timer0 does not run in power down, the ticks only measure the time awake.
+*/
+uint32_t halTicks(){
+    return micros();
+}
+
+/*! \fn void halPaintStack()
+    \brief Fill the free memory between the heap top and the stack pointer with HAL_STACK_CANARY
+    \param  void
+    \retval void
+
+    Called once at the start of setup(), halGetMemory() then counts the painted bytes the stack has
+    not overwritten: the lowest the stack has reached since the painting.
+*/
+void halPaintStack(){
+    uint8_t *byte = heapTop();
+    uint8_t *limit = (uint8_t*)SP - HAL_STACK_PAINT_MARGIN;
+    heapHighWater = byte;
+    while(byte < limit){
+        *byte++ = HAL_STACK_CANARY;
+    }
+}
+
+/*! \fn void halGetMemory(halMemory_t *memory)
+    \brief Read the use of the RAM: heap, free list of malloc() and stack
+    \param[out] memory The use of the RAM
+
+    The free list is walked with the interrupts enabled, the node does not call malloc() from an ISR.
+    The heap can grow up to __malloc_margin bytes below the stack pointer, the largest free block is
+    the longest block of the free list or that gap.
+    The canaries are counted from the highest heap top seen: when free() lowers __brkval the bytes
+    above it keep the data of the heap, and counting from __brkval would find no canary at all.
+*/
+void halGetMemory(halMemory_t *memory){
+    uint8_t *top = heapTop();
+    uint8_t *stack = (uint8_t*)SP;
+    uint8_t *byte;
+    uint16_t gap = (stack > top) ? (stack - top) : 0;
+    memory->heapSize = top - &__heap_start;
+    memory->freeListBytes = 0;
+    memory->largestFreeBlock = 0;
+    for(struct __freelist *block = __flp; block != NULL; block = block->nx){
+        memory->freeListBytes += block->sz + sizeof(size_t);
+        if(block->sz > memory->largestFreeBlock){
+            memory->largestFreeBlock = block->sz;
+        }
+    }
+    if((gap > (__malloc_margin + sizeof(size_t))) && ((gap - __malloc_margin - sizeof(size_t)) > memory->largestFreeBlock)){
+        memory->largestFreeBlock = gap - __malloc_margin - sizeof(size_t);
+    }
+    memory->freeBytes = gap;
+    if(top > heapHighWater){
+        heapHighWater = top;
+    }
+    byte = heapHighWater;
+    while((byte < stack) && (*byte == HAL_STACK_CANARY)){
+        byte++;
+    }
+    memory->stackUnused = byte - heapHighWater;
+}
@@ -0,0 +1,65 @@
+/*! \file Hal.h
+    \brief Hardware abstraction of the node: sleep, wake up interrupts, the tick counter and the memory use
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    The node uses the modules through a small subset of the Waspmote API: BLE (BLE112 BGAPI transport),
+    LoRaWAN (RN2483), RTC (epoch and Alarm 1), USB (logging), Utils, millis(), delay() and the UART
+    functions serialAvailable()/serialRead(). The AVR specific parts (pin change and RTC interrupts,
+    power down, the fine timer of the profiling, the heap and stack layout) are behind the functions of this file.
+
+    Hal.cpp implements them for the Waspmote. The host build (host/) implements both this file and the
+    Waspmote API subset on Linux, with a virtual clock, so the same sources run as a Linux executable.
+*/
+
+/*! \def _HAL_H
+    \brief The library flag
+ */
+#ifndef _HAL_H
+#define _HAL_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+typedef void (*halCallback_t)();/*!< Function called from an interrupt */
+
+#define HAL_TICKS_PER_MS 1000/*!< halTicks() counts microseconds */
+#define HAL_STACK_CANARY 0xC5/*!< Value painted by halPaintStack() in the free memory */
+
+/*! \struct halMemory_t
+    \brief  Use of the RAM between the heap and the stack, in bytes
+ */
+typedef struct {
+  uint16_t heapSize;/**< From the start of the heap to its top (__brkval) */
+  uint16_t freeListBytes;/**< Blocks freed below the heap top, the fragmentation of the heap */
+  uint16_t largestFreeBlock;/**< Longest block malloc() can return */
+  uint16_t freeBytes;/**< Between the heap top and the stack pointer */
+  uint16_t stackUnused;/**< Painted bytes above the highest heap top never written by the stack */
+}halMemory_t;
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+void halAttachAlarm(halCallback_t callback);
+
+void halAttachBleWakeUp(halCallback_t callback);
+
+void halEnableBleWakeUp();
+
+void halDisableBleWakeUp();
+
+void halSleep();
+
+uint32_t halTicks();
+
+void halPaintStack();
+
+void halGetMemory(halMemory_t *memory);
+
+#endif
@@ -0,0 +1,67 @@
+/*! \file Log.h
+    \brief Compile time log levels over the USB port
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    The level is taken from DEBUG (defines.h). The calls above the level are removed by the
+    preprocessor, so neither the strings nor the USB time are spent on them:
+        0 --> nothing is printed
+        1 --> errors (and the state names printed by main.pde)
+        2 --> information of every module call
+        3 --> verbose dumps (frames, BLE profile, channels)
+*/
+
+/*! \def _LOG_H
+    \brief The library flag
+ */
+#ifndef _LOG_H
+#define _LOG_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "defines.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_VERBOSE 3
+
+#ifndef LOG_LEVEL
+  #define LOG_LEVEL DEBUG/*!< Highest level compiled in */
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+  #define LOG_ERROR(...) USB.print(__VA_ARGS__)
+  #define LOG_ERRORLN(...) USB.println(__VA_ARGS__)
+  #define LOG_ERRORHEX(value) USB.printHex(value)
+#else
+  #define LOG_ERROR(...) do{}while(0)
+  #define LOG_ERRORLN(...) do{}while(0)
+  #define LOG_ERRORHEX(value) do{}while(0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+  #define LOG_INFO(...) USB.print(__VA_ARGS__)
+  #define LOG_INFOLN(...) USB.println(__VA_ARGS__)
+  #define LOG_INFOHEX(value) USB.printHex(value)
+#else
+  #define LOG_INFO(...) do{}while(0)
+  #define LOG_INFOLN(...) do{}while(0)
+  #define LOG_INFOHEX(value) do{}while(0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_VERBOSE
+  #define LOG_VERBOSE(...) USB.print(__VA_ARGS__)
+  #define LOG_VERBOSELN(...) USB.println(__VA_ARGS__)
+  #define LOG_VERBOSEHEX(value) USB.printHex(value)
+#else
+  #define LOG_VERBOSE(...) do{}while(0)
+  #define LOG_VERBOSELN(...) do{}while(0)
+  #define LOG_VERBOSEHEX(value) do{}while(0)
+#endif
+
+#endif
@@ -13,6 +13,8 @@
 #endif
 
 #include "LoraWan.h"
+#include "Log.h"
+#include "Profile.h"
 /******************************************************************************
  * PRIVATE FUNCTIONS                                                          *
  ******************************************************************************/
@@ -28,6 +30,8 @@ It does nothing
 \return void
 */
 LoraWan::LoraWan(){
+    sendResponse = 0;
+    socket = SOCKET1;
 }
 
 /*! class Destructor
@@ -48,29 +52,35 @@ LoraWan::~LoraWan(){
     and it automatically enters into command mode.
 */
 uint8_t LoraWan::turnOnModule(uint8_t socket){
+    PROFILE(PROFILE_LORA_TURN_ON);
   
     uint8_t response;
+    this->socket = socket;
     response = LoRaWAN.ON(socket);
     if(response == 0){
-        USB.println(F("LoRaWAN module switch on Ok "));  
+        LOG_INFOLN(F("LoRaWAN module switch on Ok "));  
     }else{
-        USB.print(F("LoRaWAN turnOnModule(),ERROR = "));
-        USB.println(response, DEC);
+        LOG_ERROR(F("LoRaWAN turnOnModule(),ERROR = "));
+        LOG_ERRORLN(response, DEC);
     }
     return response;
 }
 
 /*! \fn void turnOffModule()
-    \brief Switches off the multiplexer on UART1. 
+    \brief Switches off the multiplexer on UART1 and the LoRaWAN module. 
     \param   
     \retval 
     
     This function turn off the mux1(Socket1 connect to mux1), and disconnect the BLE module from the socket1.
-    This is because that sometimes when we put module off, it resets. This solve the problem for me. 
+    Then the module is switched off (LoRaWAN.OFF(), UART closed and socket powered down), with the mux
+    only it stayed powered between the uplinks. The module resets when it is powered again, so the
+    session of the join must have been saved (saveModuleConfig()) for joinABP() to restore it.
 */
 void LoraWan::turnOffModule(){
+    PROFILE(PROFILE_LORA_TURN_OFF);
     Utils.muxOFF1();
-    USB.println(F("LoRaWAN module switch off ")); 
+    LoRaWAN.OFF(socket);
+    LOG_INFOLN(F("LoRaWAN module switch off ")); 
 }
 
 /*! \fn void turnOffModule2()
@@ -84,13 +94,14 @@ void LoraWan::turnOffModule(){
     * (Error:Sometimes when we put module off using this function, it resets) 
 */
 uint8_t LoraWan::turnOffModule2(uint8_t socket){
+    PROFILE(PROFILE_LORA_TURN_OFF_UART);
     uint8_t response;
     response = LoRaWAN.OFF(socket);
     if(response == 0){
-       USB.println(F("LoRaWAN module switch off ok"));  
+       LOG_INFOLN(F("LoRaWAN module switch off ok"));  
     }else{
-        USB.print(F("LoRaWAN module switch ERROR = "));  
-        USB.println(response, DEC);  
+        LOG_ERROR(F("LoRaWAN module switch ERROR = "));  
+        LOG_ERRORLN(response, DEC);  
     }
     return response; 
 }
@@ -109,15 +120,16 @@ uint8_t LoraWan::turnOffModule2(uint8_t socket){
     
 */ 
 uint8_t LoraWan::setAdaptativeDataRate(char *onOff){
+    PROFILE(PROFILE_LORA_SET_ADR);
     uint8_t response;
     response = LoRaWAN.setADR(onOff);
     if( response == 0 ){
-        USB.println(F("LoRaWAN module Adaptive Data Rate OK "));    
-        USB.print(F("  -ADR:"));
-        USB.println(LoRaWAN._adr, DEC);   
+        LOG_INFOLN(F("LoRaWAN module Adaptive Data Rate OK "));    
+        LOG_INFO(F("  -ADR:"));
+        LOG_INFOLN(LoRaWAN._adr, DEC);   
     }else{
-        USB.print(F("LoRaWAN moduleAdaptive Data Rate, ERROR = ")); 
-        USB.println(response, DEC);
+        LOG_ERROR(F("LoRaWAN moduleAdaptive Data Rate, ERROR = ")); 
+        LOG_ERRORLN(response, DEC);
     }
     return response;
 }
@@ -137,17 +149,18 @@ uint8_t LoraWan::setAdaptativeDataRate(char *onOff){
     This function set the specific frecuency at the specific channel.
 */ 
 uint8_t LoraWan::setChannelFrequency( uint8_t channel, uint32_t frequency){
+    PROFILE(PROFILE_LORA_SET_CHANNEL_FREQUENCY);
     uint8_t response;
     response = LoRaWAN.setChannelFreq(channel, frequency);
     if( response == 0 ) {// Check status
-      USB.print(F("LoRaWAN module frequency set OK ")); 
-      USB.print(F("Frequency: "));
-      USB.print(LoRaWAN._freq[channel]);   
-      USB.print(F(" for channel: "));
-      USB.println(channel, DEC);
+      LOG_INFO(F("LoRaWAN module frequency set OK ")); 
+      LOG_INFO(F("Frequency: "));
+      LOG_INFO(LoRaWAN._freq[channel]);   
+      LOG_INFO(F(" for channel: "));
+      LOG_INFOLN(channel, DEC);
     }else{
-      USB.print(F("LoRaWAN module frequency set, ERROR = ")); 
-      USB.println(response, DEC);
+      LOG_ERROR(F("LoRaWAN module frequency set, ERROR = ")); 
+      LOG_ERRORLN(response, DEC);
     }
     return response;
 }
@@ -167,17 +180,18 @@ uint8_t LoraWan::setChannelFrequency( uint8_t channel, uint32_t frequency){
     This function sets the data rate range on the specific channel.
 */
 uint8_t LoraWan::setChannelDataRateRange(uint8_t channel, uint8_t drMin, uint8_t drMax){
+    PROFILE(PROFILE_LORA_SET_CHANNEL_DATA_RATE);
     uint8_t response;
     response = LoRaWAN.setChannelDRRange(channel, drMin, drMax);
     if( response == 0 ){
-        USB.println(F("LoRaWAN module Data Rate range set OK "));    
-        USB.print(F("  -Data Rate min:"));
-        USB.println(LoRaWAN._drrMin[channel], DEC); 
-        USB.print(F("  -Data Rate max:"));
-        USB.println(LoRaWAN._drrMax[channel], DEC);
+        LOG_INFOLN(F("LoRaWAN module Data Rate range set OK "));    
+        LOG_INFO(F("  -Data Rate min:"));
+        LOG_INFOLN(LoRaWAN._drrMin[channel], DEC); 
+        LOG_INFO(F("  -Data Rate max:"));
+        LOG_INFOLN(LoRaWAN._drrMax[channel], DEC);
     }else{
-        USB.print(F("LoRaWAN module Data rate range set, ERROR = ")); 
-        USB.println(response, DEC);
+        LOG_ERROR(F("LoRaWAN module Data rate range set, ERROR = ")); 
+        LOG_ERRORLN(response, DEC);
     }
     return response;
 }
@@ -196,15 +210,16 @@ uint8_t LoraWan::setChannelDataRateRange(uint8_t channel, uint8_t drMin, uint8_t
     This function sets the duty cycle for the specific channel
 */
 uint8_t LoraWan::setChannelDutyCycle( uint8_t channel, uint16_t dutyCycle){
+    PROFILE(PROFILE_LORA_SET_CHANNEL_DUTY_CYCLE);
     uint8_t response;
     response = LoRaWAN.setChannelDutyCycle(channel, dutyCycle);
     if( response == 0 ){
-        USB.println(F("LoRaWAN module Duty Cycle OK. "));    
-        USB.print(F("Duty Cycle:"));
-        USB.println(LoRaWAN._dCycle[channel], DEC);
+        LOG_INFOLN(F("LoRaWAN module Duty Cycle OK. "));    
+        LOG_INFO(F("Duty Cycle:"));
+        LOG_INFOLN(LoRaWAN._dCycle[channel], DEC);
     }else {
-        USB.print(F("LoRaWAN module Duty cycle set, ERROR = ")); 
-        USB.println(response, DEC);
+        LOG_ERROR(F("LoRaWAN module Duty cycle set, ERROR = ")); 
+        LOG_ERRORLN(response, DEC);
     }
     return response;
 }
@@ -223,13 +238,14 @@ uint8_t LoraWan::setChannelDutyCycle( uint8_t channel, uint16_t dutyCycle){
     This function enable or disable the specific channel 
 */
 uint8_t LoraWan::enableOrDisableChannel(uint8_t channel, char *onOff){
+    PROFILE(PROFILE_LORA_SET_CHANNEL_STATUS);
     uint8_t response;
     response = LoRaWAN.setChannelStatus(channel, onOff);
     if( response == 0 ){
-      USB.println(F("LoRaWAN module Channel status set OK"));     
+      LOG_INFOLN(F("LoRaWAN module Channel status set OK"));     
     }else {
-      USB.print(F("LoRaWAN module Channel status set, ERROR = ")); 
-      USB.println(response, DEC);
+      LOG_ERROR(F("LoRaWAN module Channel status set, ERROR = ")); 
+      LOG_ERRORLN(response, DEC);
     }
     return response;
 }
@@ -252,13 +268,14 @@ uint8_t LoraWan::enableOrDisableChannel(uint8_t channel, char *onOff){
    This function is used to configure the LoRaWAN RF power level 
 */
 uint8_t LoraWan::setTxPower(uint8_t power){
+  PROFILE(PROFILE_LORA_SET_TX_POWER);
   uint8_t response;
   response = LoRaWAN.setPower(power);
   if( response == 0 ){
-    USB.println(F("LoRaWAN module Power level set OK"));     
+    LOG_INFOLN(F("LoRaWAN module Power level set OK"));     
   }else{
-    USB.print(F("LoRaWAN module Power level set, ERROR = ")); 
-    USB.println(response, DEC);
+    LOG_ERROR(F("LoRaWAN module Power level set, ERROR = ")); 
+    LOG_ERRORLN(response, DEC);
   }
   return response;
 }
@@ -276,15 +293,16 @@ uint8_t LoraWan::setTxPower(uint8_t power){
     
 */
 uint8_t LoraWan::getTxPower(){
+  PROFILE(PROFILE_LORA_GET_TX_POWER);
   uint8_t response;
   response = LoRaWAN.getPower();
   if( response == 0 ){
-    USB.println(F("LoRaWAN module Power level get OK"));    
-    USB.print(F("  -Power index:"));
-    USB.println(LoRaWAN._powerIndex, DEC);
+    LOG_INFOLN(F("LoRaWAN module Power level get OK"));    
+    LOG_INFO(F("  -Power index:"));
+    LOG_INFOLN(LoRaWAN._powerIndex, DEC);
   }else{
-    USB.print(F("LoRaWAN module Power level get, ERROR = ")); 
-    USB.println(response, DEC);
+    LOG_ERROR(F("LoRaWAN module Power level get, ERROR = ")); 
+    LOG_ERRORLN(response, DEC);
   }
   return response;  
 }
@@ -294,33 +312,35 @@ uint8_t LoraWan::getTxPower(){
     \param         
     \retval  
     
-    This function print the module channels status for debug
+    This function print the module channels status for debug. It sends 4 commands per channel
+    (64 round trips with the module), so it is only called with DEBUG >= LOG_LEVEL_VERBOSE.
 */ 
 void LoraWan::printChannelsStatus(){
-    USB.println(F("\n----------------------------"));
-    USB.println(F("LoRaWAN module channels status: "));
+    PROFILE(PROFILE_LORA_CHANNELS_STATUS);
+    LOG_INFOLN(F("\n----------------------------"));
+    LOG_INFOLN(F("LoRaWAN module channels status: "));
     for( int Channel=0; Channel<16; Channel++){
         LoRaWAN.getChannelFreq(Channel);
         LoRaWAN.getChannelDutyCycle(Channel);
         LoRaWAN.getChannelDRRange(Channel);
         LoRaWAN.getChannelStatus(Channel);
-        USB.print(F("Channel: "));
-        USB.println(Channel);
-        USB.print(F("  -Freq: "));
-        USB.println(LoRaWAN._freq[Channel]);
-        USB.print(F("  -Duty cycle: "));
-        USB.println(LoRaWAN._dCycle[Channel]);
-        USB.print(F("  -DR min: "));
-        USB.println(LoRaWAN._drrMin[Channel], DEC);
-        USB.print(F("  -DR max: "));
-        USB.println(LoRaWAN._drrMax[Channel], DEC);
-        USB.print(F("  -Status: "));
+        LOG_VERBOSE(F("Channel: "));
+        LOG_VERBOSELN(Channel);
+        LOG_VERBOSE(F("  -Freq: "));
+        LOG_VERBOSELN(LoRaWAN._freq[Channel]);
+        LOG_VERBOSE(F("  -Duty cycle: "));
+        LOG_VERBOSELN(LoRaWAN._dCycle[Channel]);
+        LOG_VERBOSE(F("  -DR min: "));
+        LOG_VERBOSELN(LoRaWAN._drrMin[Channel], DEC);
+        LOG_VERBOSE(F("  -DR max: "));
+        LOG_VERBOSELN(LoRaWAN._drrMax[Channel], DEC);
+        LOG_VERBOSE(F("  -Status: "));
         if (LoRaWAN._status[Channel] == 1){
-            USB.println(F("on"));
+            LOG_VERBOSELN(F("on"));
         }else{
-            USB.println(F("off"));
+            LOG_VERBOSELN(F("off"));
         }
-        USB.println(F("----------------------------"));
+        LOG_VERBOSELN(F("----------------------------"));
     }  
 }  
 
@@ -332,14 +352,15 @@ void LoraWan::printChannelsStatus(){
     This function print the Device Address of the LoRaWAN module
 */
 uint8_t LoraWan::printDeviceAddr(){
+  PROFILE(PROFILE_LORA_DEVICE_ADDR);
   uint8_t response;
   response = LoRaWAN.getDeviceAddr();
   if( response == 0 ){
-    USB.println(F("LoRaWAN DeviceAddr = "));
-    USB.println(LoRaWAN._devAddr);
+    LOG_INFOLN(F("LoRaWAN DeviceAddr = "));
+    LOG_INFOLN(LoRaWAN._devAddr);
   }else{
-    USB.println(F("LoRaWAN DeviceAddr, ERROR = "));
-    USB.println(response, DEC);
+    LOG_ERRORLN(F("LoRaWAN DeviceAddr, ERROR = "));
+    LOG_ERRORLN(response, DEC);
   } 
   return response; 
 }
@@ -359,6 +380,7 @@ uint8_t LoraWan::printDeviceAddr(){
       •Application Key (128-bit)
 */
 void LoraWan::configure2OTAA(char DEVICE_EUI[], char APP_EUI[], char APP_KEY []){
+    PROFILE(PROFILE_LORA_CONFIGURE_OTAA);
     
     LoRaWAN.setDeviceEUI(DEVICE_EUI);
     LoRaWAN.setAppEUI(APP_EUI);
@@ -381,6 +403,7 @@ void LoraWan::configure2OTAA(char DEVICE_EUI[], char APP_EUI[], char APP_KEY [])
       •Application Session Key (128-bit key) ensures end-to-end security on application level
 */
 void LoraWan::configure2ABP(char DEVICE_EUI[], char DEVICE_ADDR[], char NWK_SESSION_KEY [], char APP_SESSION_KEY []){
+    PROFILE(PROFILE_LORA_CONFIGURE_ABP);
     
     LoRaWAN.setDeviceEUI(DEVICE_EUI);
     LoRaWAN.setDeviceAddr(DEVICE_ADDR);
@@ -400,13 +423,14 @@ void LoraWan::configure2ABP(char DEVICE_EUI[], char DEVICE_ADDR[], char NWK_SESS
     This function Join the LoRaWAN network by OTAA. First the module must by configure to OTAA.
 */
 uint8_t LoraWan::joinOTAA(){
+    PROFILE(PROFILE_LORA_JOIN_OTAA);
     uint8_t response;
     response = LoRaWAN.joinOTAA();
     if(response == 0){
-        USB.println(F("LoRaWAN module join the network by OTAA OK"));  
+        LOG_INFOLN(F("LoRaWAN module join the network by OTAA OK"));  
     }else{
-        USB.print(F("LoRaWAN module join OTAA, ERROR = "));
-        USB.println(response, DEC);    
+        LOG_ERROR(F("LoRaWAN module join OTAA, ERROR = "));
+        LOG_ERRORLN(response, DEC);    
     }
     return response;
 }
@@ -423,13 +447,14 @@ uint8_t LoraWan::joinOTAA(){
     This function Join the LoRaWAN network by ABP. First the module must by configure to ABP.
 */
 uint8_t LoraWan::joinABP(){
+    PROFILE(PROFILE_LORA_JOIN_ABP);
     uint8_t response;
     response = LoRaWAN.joinABP();
     if(response == 0){
-        USB.println(F("LoRaWAN module join the network by ABP OK"));  
+        LOG_INFOLN(F("LoRaWAN module join the network by ABP OK"));  
     }else{
-        USB.print(F("LoRaWAN module join ABP, ERROR = "));  
-        USB.println(response, DEC);  
+        LOG_ERROR(F("LoRaWAN module join ABP, ERROR = "));  
+        LOG_ERRORLN(response, DEC);  
     }
     return response;
 }
@@ -446,13 +471,14 @@ uint8_t LoraWan::joinABP(){
     
 */
 uint8_t LoraWan::setRetries(uint8_t retries){
+  PROFILE(PROFILE_LORA_SET_RETRIES);
   uint8_t response;
   response = LoRaWAN.setRetries(retries);
   if( response == 0 ) {
-    USB.println(F("LoRaWAN module Set Retransmissions for uplink confirmed packet OK"));     
+    LOG_INFOLN(F("LoRaWAN module Set Retransmissions for uplink confirmed packet OK"));     
   }else{
-    USB.print(F("LoRaWAN module Set Retransmissions for uplink confirmed packet, ERROR = ")); 
-    USB.println(response, DEC);
+    LOG_ERROR(F("LoRaWAN module Set Retransmissions for uplink confirmed packet, ERROR = ")); 
+    LOG_ERRORLN(response, DEC);
   }
   return response;
 }
@@ -467,15 +493,16 @@ uint8_t LoraWan::setRetries(uint8_t retries){
     This function get the number of retransmision for uplink.
 */
 uint8_t LoraWan::getRetries(){
+  PROFILE(PROFILE_LORA_GET_RETRIES);
   uint8_t response;
   response = LoRaWAN.getRetries();
   if( response == 0 ) {
-    USB.print(F("LoRaWAN module Get Retransmissions for uplink confirmed packet OK. ")); 
-    USB.print(F("TX retries: "));
-    USB.println(LoRaWAN._retries, DEC);
+    LOG_INFO(F("LoRaWAN module Get Retransmissions for uplink confirmed packet OK. ")); 
+    LOG_INFO(F("TX retries: "));
+    LOG_INFOLN(LoRaWAN._retries, DEC);
   }else{
-    USB.print(F("LoRaWAN module Get Retransmissions for uplink confirmed packet, ERROR = ")); 
-    USB.println(response, DEC);
+    LOG_ERROR(F("LoRaWAN module Get Retransmissions for uplink confirmed packet, ERROR = ")); 
+    LOG_ERRORLN(response, DEC);
   }
   return response;
 }
@@ -493,13 +520,14 @@ uint8_t LoraWan::getRetries(){
     This parameter cannot be stored in the module’s EEPROM using the saveConfig() function  
 */
 uint8_t LoraWan::setAutomaticReply(char *onOff){
+  PROFILE(PROFILE_LORA_SET_AUTOMATIC_REPLY);
   uint8_t response;
   response = LoRaWAN.setAR(onOff);
   if( response == 0 ) {
-    USB.println(F("LoRaWAN module Set automatic reply status on OK"));     
+    LOG_INFOLN(F("LoRaWAN module Set automatic reply status on OK"));     
   }else {
-    USB.print(F("LoRaWAN module Set automatic reply status on, ERROR = ")); 
-    USB.println(response, DEC);
+    LOG_ERROR(F("LoRaWAN module Set automatic reply status on, ERROR = ")); 
+    LOG_ERRORLN(response, DEC);
   }
   return response;
 } 
@@ -516,19 +544,20 @@ uint8_t LoraWan::setAutomaticReply(char *onOff){
     This function is used to get the automatic reply status from module
 */
 uint8_t LoraWan::getAutomaticReply(){ 
+  PROFILE(PROFILE_LORA_GET_AUTOMATIC_REPLY);
   uint8_t response;
   response = LoRaWAN.getAR();
   if( response == 0 ) {
-    USB.print(F("LoRaWAN module Get automatic reply status OK. ")); 
-    USB.print(F("LoRaWAN module Automatic reply status: "));
+    LOG_INFO(F("LoRaWAN module Get automatic reply status OK. ")); 
+    LOG_INFO(F("LoRaWAN module Automatic reply status: "));
     if (LoRaWAN._ar == true){
-      USB.println(F("on"));      
+      LOG_INFOLN(F("on"));      
     }else{
-      USB.println(F("off"));
+      LOG_INFOLN(F("off"));
     }
   }else{
-    USB.print(F("LoRaWAN module Get automatic reply status, ERROR = ")); 
-    USB.println(response, DEC);
+    LOG_ERROR(F("LoRaWAN module Get automatic reply status, ERROR = ")); 
+    LOG_ERRORLN(response, DEC);
   }
   return response;
 }
@@ -544,13 +573,14 @@ uint8_t LoraWan::getAutomaticReply(){
     This function save the LoRaWAN module config in the module’s non-volatile memory.
 */ 
 uint8_t LoraWan::saveModuleConfig(){
+    PROFILE(PROFILE_LORA_SAVE_CONFIG);
     uint8_t response;
     response = LoRaWAN.saveConfig();
     if(response == 0){
-       USB.println(F("LoRaWAN module saveConfig OK"));  
+       LOG_INFOLN(F("LoRaWAN module saveConfig OK"));  
     }else{
-        USB.print(F("LoRaWAN module saveConfig, ERROR = ")); 
-        USB.println(response, DEC);
+        LOG_ERROR(F("LoRaWAN module saveConfig, ERROR = ")); 
+        LOG_ERRORLN(response, DEC);
     }
     return response;
 }
@@ -569,13 +599,14 @@ uint8_t LoraWan::saveModuleConfig(){
     
 */
 uint8_t LoraWan::setDataRateNextTransmision(uint8_t dataRate){
+    PROFILE(PROFILE_LORA_SET_DATA_RATE);
     uint8_t respuesta;
    respuesta = LoRaWAN.setDataRate(dataRate); 
     if(respuesta == 0){
-        USB.println(F("LoRaWAN module Data Rate OK"));  
+        LOG_INFOLN(F("LoRaWAN module Data Rate OK"));  
     }else{
-        USB.println(F("LoRaWAN module Data Rate ERROR = "));
-        USB.println(respuesta, DEC);
+        LOG_ERRORLN(F("LoRaWAN module Data Rate ERROR = "));
+        LOG_ERRORLN(respuesta, DEC);
     }
     return respuesta;
 }
@@ -591,16 +622,18 @@ uint8_t LoraWan::setDataRateNextTransmision(uint8_t dataRate){
     This function send unconfirmed data to the LoRaWAN network, and will not expect any acknowledgement back from the server.
 */
 uint8_t LoraWan::sendUnconfirmedData(uint8_t port, uint8_t *data, uint8_t len){
+    PROFILE(PROFILE_LORA_SEND_UNCONFIRMED);
     uint8_t response;
     response = LoRaWAN.sendUnconfirmed( port, data, len);
+    sendResponse = response;
     if( response == 0 ) {
-        USB.println(F("LoRaWAN module Send Unconfirmed packet OK"));     
+        LOG_INFOLN(F("LoRaWAN module Send Unconfirmed packet OK"));     
         if (LoRaWAN._dataReceived == true){ 
           return 1;
         }
     }else{
-        USB.print(F("LoRaWAN module Send Unconfirmed packet ERROR = ")); 
-        USB.println(response, DEC);
+        LOG_ERROR(F("LoRaWAN module Send Unconfirmed packet ERROR = ")); 
+        LOG_ERRORLN(response, DEC);
         //~ '0' if OK
         //~ '1' if error 
         //~ '2' if no answer 
@@ -623,16 +656,18 @@ uint8_t LoraWan::sendUnconfirmedData(uint8_t port, uint8_t *data, uint8_t len){
     This function send confirmed data to the LoRaWAN network, and will expect acknowledgement back from the server.
 */
 uint8_t LoraWan::sendConfirmedData(uint8_t port, uint8_t *data, uint8_t len){
+    PROFILE(PROFILE_LORA_SEND_CONFIRMED);
     uint8_t response;    
     response = LoRaWAN.sendConfirmed( port, data, len);
+    sendResponse = response;
     if( response == 0 ) {
-        USB.println(F("LoRaWAN module Send Confirmed packet OK"));     
+        LOG_INFOLN(F("LoRaWAN module Send Confirmed packet OK"));     
         if (LoRaWAN._dataReceived == true){ 
           return 1;
         }
     }else{
-        USB.print(F("LoRaWAN module Send Confirmed packet error = ")); 
-        USB.println(response, DEC);
+        LOG_ERROR(F("LoRaWAN module Send Confirmed packet error = ")); 
+        LOG_ERRORLN(response, DEC);
         //~ '0' if OK
         //~ '1' if error 
         //~ '2' if no answer 
@@ -644,6 +679,18 @@ uint8_t LoraWan::sendConfirmedData(uint8_t port, uint8_t *data, uint8_t len){
     return 0;
 } 
 
+/*! \fn uint8_t getSendResponse()
+    \brief   Return the module response of the last send
+    \param       
+    \retval  '0' if the packet was sent (and acknowledged if it was confirmed)
+             error code of sendUnconfirmedData()/sendConfirmedData() otherwise
+    
+    The send functions only return if there is downlink data, this function tells if the packet has to be sent again.
+*/
+uint8_t LoraWan::getSendResponse(){
+    return sendResponse;
+}
+
 /*! \fn char* receiveDowlinkData()
     \brief After a uplink if the back-end send data this fuction recibe the dowlink data from the network.
     \param       
@@ -653,11 +700,12 @@ uint8_t LoraWan::sendConfirmedData(uint8_t port, uint8_t *data, uint8_t len){
     but the LoRaWAN module is a class A device and to receive dowlink it can only do it after an uplink.
 */ 
 char* LoraWan::receiveDowlinkData(){
+    PROFILE(PROFILE_LORA_RECEIVE_DOWNLINK);
     
-    USB.print(F("LoRaWAN module there's data on port number "));
-    USB.print(LoRaWAN._port,DEC);
-    USB.print(F(".\r\n   Data: "));
-    USB.println(LoRaWAN._data);
+    LOG_INFO(F("LoRaWAN module there's data on port number "));
+    LOG_INFO(LoRaWAN._port,DEC);
+    LOG_INFO(F(".\r\n   Data: "));
+    LOG_INFOLN(LoRaWAN._data);
     return LoRaWAN._data;
 }    
 
@@ -672,13 +720,14 @@ char* LoraWan::receiveDowlinkData(){
  *  Device Status Answer frame in use with the LoRaWAN Class A protocol.
  */ 
 uint8_t LoraWan::setBatteryLevelStatus(){
+  PROFILE(PROFILE_LORA_SET_BATTERY_LEVEL);
   uint8_t response;
   response = LoRaWAN.setBatteryLevel();
   if( response == 0 ){
-    USB.println(F("LoRaWAN module BatteryLevelStatus set OK. "));    
+    LOG_INFOLN(F("LoRaWAN module BatteryLevelStatus set OK. "));    
   }else{
-    USB.print(F("LoRaWAN module BatteryLevelStatus set, ERROR = ")); 
-    USB.println(response, DEC);
+    LOG_ERROR(F("LoRaWAN module BatteryLevelStatus set, ERROR = ")); 
+    LOG_ERRORLN(response, DEC);
   }
   return response;  
 }
@@ -692,6 +741,7 @@ uint8_t LoraWan::setBatteryLevelStatus(){
  * 	              '2' if no answer 
  */
 uint32_t LoraWan::getUplinkCounter(){
+  PROFILE(PROFILE_LORA_GET_UPLINK_COUNTER);
   uint8_t response;
   response = LoRaWAN.getUpCounter();
   if(response == 0){
@@ -711,6 +761,7 @@ uint32_t LoraWan::getUplinkCounter(){
  *  
  */
 uint32_t LoraWan::getDownlinkCounter(){
+  PROFILE(PROFILE_LORA_GET_DOWNLINK_COUNTER);
   uint8_t response;
   response = LoRaWAN.getDownCounter();
   if(response == 0){
@@ -732,6 +783,7 @@ uint32_t LoraWan::getDownlinkCounter(){
  * 	received the last Linck Check Request from the module
  */
 uint8_t LoraWan::getGatewayNumber(){
+  PROFILE(PROFILE_LORA_GET_GATEWAYS);
   uint8_t response;
   response = LoRaWAN.getGatewayNumber();
   if(response == 0){
@@ -753,6 +805,7 @@ uint8_t LoraWan::getGatewayNumber(){
  * This function allows the user to set the delay between the transmission and the first reception window. 
  */
 uint8_t LoraWan::setDowlinkRX1Delay(uint16_t delay){
+  PROFILE(PROFILE_LORA_SET_RX1_DELAY);
   uint8_t response;
   response = LoRaWAN.setRX1Delay(delay);
   if(response == 0){
@@ -774,6 +827,7 @@ uint8_t LoraWan::setDowlinkRX1Delay(uint16_t delay){
  * This function is used to get the first receive window delay
  */
 uint8_t LoraWan::getDowlinkRX1Delay(){
+  PROFILE(PROFILE_LORA_GET_RX1_DELAY);
   uint8_t response;
   response = LoRaWAN.getRX1Delay();
   if(response == 0){
@@ -804,6 +858,7 @@ uint8_t LoraWan::getDowlinkRX1Delay(){
  * 
  */
 uint8_t LoraWan::setDowlinkRX2Parameters(uint8_t datarate, uint32_t frequency){
+  PROFILE(PROFILE_LORA_SET_RX2_PARAMETERS);
   uint8_t response;
   response = LoRaWAN.setRX2Parameters(datarate, frequency);
   if(response == 0){
@@ -825,6 +880,7 @@ uint8_t LoraWan::setDowlinkRX2Parameters(uint8_t datarate, uint32_t frequency){
  * The second receiving delay is set internally by the module calculated with the first window delay plus 1000 ms.
  */
 uint8_t LoraWan::getDowlinkRX2Delay(){
+  PROFILE(PROFILE_LORA_GET_RX2_DELAY);
   uint8_t response;
   response = LoRaWAN.getRX2Delay();
   if(response == 0){
@@ -847,13 +903,14 @@ uint8_t LoraWan::getDowlinkRX2Delay(){
  *  @arg	'7' if input parameter error
  */
 uint8_t LoraWan::getDowlinkRX2Parameters(char* band){
+  PROFILE(PROFILE_LORA_GET_RX2_PARAMETERS);
   uint8_t response;
   response = LoRaWAN.getRX2Parameters(band);
   if(response == 0){
-    USB.print(F("LoRaWAN module Dowlink RX2 Parameters, Frequency = "));
-    USB.print(LoRaWAN._rx2Frequency, DEC);
-    USB.print(F(" ,data rate =  "));
-    USB.println(LoRaWAN._rx2DataRate);
+    LOG_INFO(F("LoRaWAN module Dowlink RX2 Parameters, Frequency = "));
+    LOG_INFO(LoRaWAN._rx2Frequency, DEC);
+    LOG_INFO(F(" ,data rate =  "));
+    LOG_INFOLN(LoRaWAN._rx2DataRate);
     //return LoRaWAN._rx2Frequency;
     //return LoRaWAN._rx2DataRate;
     return response;
@@ -29,6 +29,9 @@ class LoraWan{
 /// private methods //////////////////////////
 private:
 
+    uint8_t sendResponse;/*!< Module response of the last sendUnconfirmedData()/sendConfirmedData() */
+
+    uint8_t socket;/*!< Socket of the module, set by turnOnModule() */
    
 /// public methods ////////////
 public:
@@ -84,6 +87,8 @@ public:
     uint8_t sendUnconfirmedData(uint8_t port, uint8_t *data, uint8_t len);    
    
     uint8_t sendConfirmedData(uint8_t port, uint8_t *data, uint8_t len); 
+
+    uint8_t getSendResponse();
    
     char* receiveDowlinkData();
     
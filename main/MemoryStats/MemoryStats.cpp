@@ -0,0 +1,168 @@
+/*! \file MemoryStats.cpp
+    \brief Use of the RAM at run time: allocations of the GATT tree, heap and stack high water marks
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#ifndef __WPROGRAM_H__
+  #include <WaspClasses.h>
+#endif
+
+#include "MemoryStats.h"
+#include "DeltaCodec.h"
+#include "Log.h"
+#include "Trace.h"
+
+/******************************************************************************
+ * Global variables                                                           *
+ ******************************************************************************/
+NODE_LOCAL MemoryStats memoryStats;
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS                                                           *
+ ******************************************************************************/
+
+/*! class constructor
+  It clears the statistics
+  \param void
+  \return void
+*/
+MemoryStats::MemoryStats(){
+    stats.allocatedBytes = 0;
+    memset(&last, 0, sizeof(last));
+    clear();
+}
+
+/*! \fn void* allocate(size_t size)
+    \brief malloc() counted in the statistics
+    \param  size Bytes of the block
+    \retval The block, NULL if there is not memory enough
+*/
+void* MemoryStats::allocate(size_t size){
+    void *block = malloc(size);
+    if(block == NULL){
+        if(stats.failures < 0xFFFF){
+            stats.failures++;
+        }
+        LOG_ERROR(F("Allocation failed: "));
+        LOG_ERRORLN(size, DEC);
+        TRACE(TRACE_ALLOCATION_FAILED, size);
+        return NULL;
+    }
+    if(stats.allocations < 0xFFFF){
+        stats.allocations++;
+    }
+    stats.allocatedBytes += size;
+    if(stats.allocatedBytes > stats.peakAllocatedBytes){
+        stats.peakAllocatedBytes = stats.allocatedBytes;
+    }
+    return block;
+}
+
+/*! \fn void release(void *block, size_t size)
+    \brief free() counted in the statistics
+    \param  block A block returned by allocate(), or NULL
+    \param  size  Its size as given to allocate()
+*/
+void MemoryStats::release(void *block, size_t size){
+    if(block == NULL){
+        return;
+    }
+    free(block);
+    if(stats.releases < 0xFFFF){
+        stats.releases++;
+    }
+    stats.allocatedBytes -= (size < stats.allocatedBytes) ? size : stats.allocatedBytes;
+}
+
+/*! \fn void sample()
+    \brief Read the heap and the stack use and update the high water marks
+*/
+void MemoryStats::sample(){
+    halGetMemory(&last);
+    if(last.heapSize > stats.peakHeapSize){
+        stats.peakHeapSize = last.heapSize;
+    }
+    if(last.freeListBytes > stats.peakFreeListBytes){
+        stats.peakFreeListBytes = last.freeListBytes;
+    }
+    if(last.largestFreeBlock < stats.lowestLargestFreeBlock){
+        stats.lowestLargestFreeBlock = last.largestFreeBlock;
+    }
+    if(last.stackUnused < stats.lowestStackUnused){
+        stats.lowestStackUnused = last.stackUnused;
+    }
+}
+
+/*! \fn memoryStats_t* getStats()
+    \brief Return the statistics since the last clear()
+*/
+memoryStats_t* MemoryStats::getStats(){
+    return &stats;
+}
+
+/*! \fn halMemory_t* getLastSample()
+    \brief Return the use of the RAM read by the last sample()
+*/
+halMemory_t* MemoryStats::getLastSample(){
+    return &last;
+}
+
+/*! \fn uint8_t encode(uint8_t *out)
+    \brief Write the memory element (MemoryStats.h)
+    \param[out] *out At least MEMORY_ENTRY_MAX_SIZE bytes
+    \retval The number of bytes written
+*/
+uint8_t MemoryStats::encode(uint8_t *out){
+    uint8_t length = 0;
+    length += varintEncode(stats.allocations, out + length);
+    length += varintEncode(stats.releases, out + length);
+    length += varintEncode(stats.failures, out + length);
+    length += varintEncode(stats.allocatedBytes, out + length);
+    length += varintEncode(stats.peakAllocatedBytes, out + length);
+    length += varintEncode(stats.peakHeapSize, out + length);
+    length += varintEncode(stats.peakFreeListBytes, out + length);
+    length += varintEncode(stats.lowestLargestFreeBlock, out + length);
+    length += varintEncode(stats.lowestStackUnused, out + length);
+    return length;
+}
+
+/*! \fn void dump()
+    \brief Print the statistics and the last sample through the USB
+
+    One line: "M:<allocations>,<releases>,<failures>,<bytes>,<peak bytes>,<peak heap>,<peak free list>,
+    <lowest largest block>,<lowest stack headroom>,<heap>,<free list>,<largest block>,<free>,<stack headroom>"
+*/
+void MemoryStats::dump(){
+    uint16_t fields[] = {stats.allocations, stats.releases, stats.failures, stats.allocatedBytes,
+                         stats.peakAllocatedBytes, stats.peakHeapSize, stats.peakFreeListBytes,
+                         stats.lowestLargestFreeBlock, stats.lowestStackUnused, last.heapSize,
+                         last.freeListBytes, last.largestFreeBlock, last.freeBytes, last.stackUnused};
+    USB.print(F("M:"));
+    for(uint8_t i = 0; i < (sizeof(fields) / sizeof(fields[0])); i++){
+        if(i > 0){
+            USB.print(F(","));
+        }
+        USB.print(fields[i], DEC);
+    }
+    USB.println(F(""));
+}
+
+/*! \fn void clear()
+    \brief Clear the counters and the high water marks
+
+    The bytes allocated are kept, they are the blocks still in use.
+*/
+void MemoryStats::clear(){
+    stats.allocations = 0;
+    stats.releases = 0;
+    stats.failures = 0;
+    stats.peakAllocatedBytes = stats.allocatedBytes;
+    stats.peakHeapSize = 0;
+    stats.peakFreeListBytes = 0;
+    stats.lowestLargestFreeBlock = 0xFFFF;
+    stats.lowestStackUnused = 0xFFFF;
+}
@@ -0,0 +1,105 @@
+/*! \file MemoryStats.h
+    \brief Use of the RAM at run time: allocations of the GATT tree, heap and stack high water marks
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    BLECentral builds the GATT tree of the peripheral with allocate() and release(), that count the
+    allocations, the failures and the bytes in use. sample(), called after each state of the state
+    machine, reads the heap and the stack from the HAL (halGetMemory()) and keeps the worst values
+    since the last clear(): the highest heap top, the biggest free list, the smallest block malloc()
+    could return and the smallest stack headroom (stack painting, halPaintStack() at the start of
+    setup()). They tell how much RAM is left for caches and buffers.
+
+    The statistics are sent in the MEMORY_TYPE element of the DIAGNOSTIC_PORT health uplink, each
+    field a varint in this order:
+
+                        Memory element (payload)
+    varint:     Allocations                     allocate() calls that returned a block
+    varint:     Releases                        release() calls
+    varint:     Failures                        allocate() calls that returned NULL
+    varint:     Bytes allocated                 Now
+    varint:     Peak bytes allocated
+    varint:     Peak heap size                  halMemory_t::heapSize
+    varint:     Peak free list bytes            halMemory_t::freeListBytes
+    varint:     Lowest largest free block       halMemory_t::largestFreeBlock
+    varint:     Lowest stack headroom           halMemory_t::stackUnused
+
+    The host build does not model the RAM of the ATmega1281: the fields from the HAL are 0 there.
+*/
+
+/*! \def _MEMORYSTATS_H
+    \brief The library flag
+ */
+#ifndef _MEMORYSTATS_H
+#define _MEMORYSTATS_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+#include <stddef.h>
+#include "defines.h"
+#include "Hal.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define MEMORY_ENTRY_MAX_SIZE (9 * 3)/*!< Longest encoded memory element in bytes, 9 varints of 16 bits */
+
+/*! \struct memoryStats_t
+    \brief  Statistics of the RAM use, the counters stop at 0xFFFF
+ */
+typedef struct {
+  uint16_t allocations;/**< allocate() calls that returned a block */
+  uint16_t releases;/**< release() calls */
+  uint16_t failures;/**< allocate() calls that returned NULL */
+  uint16_t allocatedBytes;/**< Bytes returned by allocate() and not released */
+  uint16_t peakAllocatedBytes;/**< Highest allocatedBytes */
+  uint16_t peakHeapSize;/**< Highest halMemory_t::heapSize sampled */
+  uint16_t peakFreeListBytes;/**< Highest halMemory_t::freeListBytes sampled */
+  uint16_t lowestLargestFreeBlock;/**< Lowest halMemory_t::largestFreeBlock sampled */
+  uint16_t lowestStackUnused;/**< Lowest halMemory_t::stackUnused sampled */
+}memoryStats_t;
+
+/******************************************************************************
+ * Class                                                                      *
+ ******************************************************************************/
+
+//! MemoryStats Class
+/*!
+  Counted allocations and high water marks of the RAM use
+ */
+class MemoryStats{
+
+/// private attributes //////////////
+private:
+
+    memoryStats_t stats;/*!< Statistics since the last clear() */
+
+    halMemory_t last;/*!< Last sample of the HAL */
+
+/// public methods ////////////
+public:
+
+    MemoryStats();
+
+    void* allocate(size_t size);
+
+    void release(void *block, size_t size);
+
+    void sample();
+
+    memoryStats_t* getStats();
+
+    halMemory_t* getLastSample();
+
+    uint8_t encode(uint8_t *out);
+
+    void dump();
+
+    void clear();
+};
+
+extern NODE_LOCAL MemoryStats memoryStats;
+
+#endif
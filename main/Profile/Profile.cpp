@@ -0,0 +1,145 @@
+/*! \file Profile.cpp
+    \brief Histograms of the time spent in each radio operation of BLECentral and LoraWan
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#ifndef __WPROGRAM_H__
+  #include <WaspClasses.h>
+#endif
+
+#include "Profile.h"
+#include "DeltaCodec.h"
+
+#if PROFILE_ENABLED
+
+/******************************************************************************
+ * Global variables                                                           *
+ ******************************************************************************/
+NODE_LOCAL Profiler profiler;
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS                                                           *
+ ******************************************************************************/
+
+/*! class constructor
+  It clears the statistics
+  \param void
+  \return void
+*/
+Profiler::Profiler(){
+    clear();
+}
+
+/*! \fn void record(uint8_t id, uint32_t ticks)
+    \brief Add one measured operation
+    \param  id    The profileOperation_t
+    \param  ticks Its duration in halTicks()
+*/
+void Profiler::record(uint8_t id, uint32_t ticks){
+    uint8_t bin = 0;
+    uint32_t limit = PROFILE_FIRST_BIN;
+    if(id >= PROFILE_OPERATIONS){
+        return;
+    }
+    if(stats[id].count < 0xFFFF){
+        stats[id].count++;
+    }
+    stats[id].totalTicks += ticks;
+    if(ticks > stats[id].maxTicks){
+        stats[id].maxTicks = ticks;
+    }
+    while((ticks >= limit) && (bin < (PROFILE_HISTOGRAM_BINS - 1))){
+        limit <<= 2;
+        bin++;
+    }
+    if(stats[id].histogram[bin] < 0xFFFF){
+        stats[id].histogram[bin]++;
+    }
+}
+
+/*! \fn profileStats_t* getStats(uint8_t id)
+    \brief Return the statistics of an operation
+    \retval Pointer to the statistics, NULL if id is out of range
+*/
+profileStats_t* Profiler::getStats(uint8_t id){
+    if(id >= PROFILE_OPERATIONS){
+        return NULL;
+    }
+    return &stats[id];
+}
+
+/*! \fn uint8_t encode(uint8_t *out, uint8_t maxLength, uint8_t *next)
+    \brief Write the profile block of the operations that fit, from *next on (Profile.h)
+    \param[out]   *out      Where the block is written
+    \param[in]    maxLength Room in out
+    \param[inout] *next     First operation to write, updated to the first one not written,
+                            PROFILE_OPERATIONS when the block is complete
+    \retval The number of bytes written
+*/
+uint8_t Profiler::encode(uint8_t *out, uint8_t maxLength, uint8_t *next){
+    uint8_t entry[PROFILE_ENTRY_MAX_SIZE];
+    uint8_t entryLength;
+    uint8_t length = 0;
+    while(*next < PROFILE_OPERATIONS){
+        if(stats[*next].count > 0){
+            entry[0] = *next;
+            entryLength = 1;
+            entryLength += varintEncode(stats[*next].count, entry + entryLength);
+            entryLength += varintEncode(stats[*next].totalTicks, entry + entryLength);
+            entryLength += varintEncode(stats[*next].maxTicks, entry + entryLength);
+            for(uint8_t bin = 0; bin < PROFILE_HISTOGRAM_BINS; bin++){
+                entryLength += varintEncode(stats[*next].histogram[bin], entry + entryLength);
+            }
+            if((length + entryLength) > maxLength){
+                break;
+            }
+            memcpy(out + length, entry, entryLength);
+            length += entryLength;
+        }
+        (*next)++;
+    }
+    return length;
+}
+
+/*! \fn void dump()
+    \brief Print the profile block through the USB
+
+    One line per PROFILE_ENTRY_MAX_SIZE bytes or less: "P:<hexadecimal bytes>", the lines of a dump
+    together are the block
+*/
+void Profiler::dump(){
+    uint8_t block[PROFILE_ENTRY_MAX_SIZE];
+    uint8_t length;
+    uint8_t next = 0;
+    while(next < PROFILE_OPERATIONS){
+        length = encode(block, sizeof(block), &next);
+        if(length == 0){
+            continue;
+        }
+        USB.print(F("P:"));
+        for(uint8_t i = 0; i < length; i++){
+            USB.printHex(block[i]);
+        }
+        USB.println(F(""));
+    }
+}
+
+/*! \fn void clear()
+    \brief Clear the statistics of all the operations
+*/
+void Profiler::clear(){
+    memset(stats, 0, sizeof(stats));
+}
+
+/*! class destructor
+  Record the ticks since the construction
+*/
+ProfileScope::~ProfileScope(){
+    profiler.record(id, halTicks() - start);
+}
+
+#endif
@@ -0,0 +1,181 @@
+/*! \file Profile.h
+    \brief Histograms of the time spent in each radio operation of BLECentral and LoraWan
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    PROFILE(id) at the start of a method measures the halTicks() until it returns, whatever the
+    return path, and adds them to the statistics of the operation: count, total, longest and a
+    histogram. Nested operations are measured each one, so the time of an operation includes the
+    ones it calls. With PROFILE_ENABLED 0 (defines.h) the macro is empty and the profiler does not
+    exist, the node has no code nor RAM of the profiling. Enabled it takes
+    PROFILE_OPERATIONS * sizeof(profileStats_t) bytes of RAM (1.6 KB).
+
+    The statistics are exported as a binary block, by dump() through the USB or by encode() in the
+    PROFILE_TYPE element of a DIAGNOSTIC_PORT uplink:
+
+                        Profile block (element payload)
+    Per operation with count > 0, in profileOperation_t order:
+    Byte 0:     Operation                       profileOperation_t
+    varint:     Count                           Operations measured
+    varint:     Total ticks                     Sum of the durations (wraps at 2^32)
+    varint:     Longest ticks
+    varints:    Histogram                       PROFILE_HISTOGRAM_BINS counts
+*/
+
+/*! \def _PROFILE_H
+    \brief The library flag
+ */
+#ifndef _PROFILE_H
+#define _PROFILE_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+#include "defines.h"
+#include "Hal.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define PROFILE_HISTOGRAM_BINS 10/*!< Bin 0 counts the durations under PROFILE_FIRST_BIN ticks, each next bin 4 times longer ones, the last one the longer times */
+#define PROFILE_FIRST_BIN 256/*!< Ticks of the first bin limit (256 us) */
+#define PROFILE_ENTRY_MAX_SIZE (1 + 3 * 5 + PROFILE_HISTOGRAM_BINS * 3)/*!< Longest encoded operation in bytes */
+
+/*! \enum profileOperation_t
+    \brief The operations measured, the BLECentral and LoraWan methods that exchange with the modules
+ */
+enum profileOperation_t{
+    PROFILE_BLE_TURN_ON = 0,
+    PROFILE_BLE_TURN_OFF,
+    PROFILE_BLE_SCAN_REPORT,
+    PROFILE_BLE_CONFIGURE_SCANNER,
+    PROFILE_BLE_START_SCANNING_DEVICE,
+    PROFILE_BLE_START_SCANNING,
+    PROFILE_BLE_CONNECT,
+    PROFILE_BLE_CONNECT_PARAMETERS,
+    PROFILE_BLE_DISCONNECT,
+    PROFILE_BLE_DISCOVER_SERVICES,
+    PROFILE_BLE_DISCOVER_CHARACTERISTICS,
+    PROFILE_BLE_DISCOVER_DESCRIPTORS,
+    PROFILE_BLE_DISCOVER_PROFILE,
+    PROFILE_BLE_READ_ATTRIBUTE,
+    PROFILE_BLE_READ_ATTRIBUTE_VALUE,
+    PROFILE_BLE_READ_SENSOR_VALUE,
+    PROFILE_BLE_READ_LONG_ATTRIBUTE_VALUE,
+    PROFILE_BLE_WRITE_ATTRIBUTE,
+    PROFILE_BLE_ENABLE_NOTIFICATION,
+    PROFILE_BLE_ENABLE_SENSOR_NOTIFICATION,
+    PROFILE_BLE_RECEIVE_NOTIFICATIONS,
+    PROFILE_BLE_RECEIVE_NOTIFICATION,
+    PROFILE_BLE_READ_WAKE_UP_EVENT,
+    PROFILE_LORA_TURN_ON,
+    PROFILE_LORA_TURN_OFF,
+    PROFILE_LORA_TURN_OFF_UART,
+    PROFILE_LORA_SET_ADR,
+    PROFILE_LORA_SET_CHANNEL_FREQUENCY,
+    PROFILE_LORA_SET_CHANNEL_DATA_RATE,
+    PROFILE_LORA_SET_CHANNEL_DUTY_CYCLE,
+    PROFILE_LORA_SET_CHANNEL_STATUS,
+    PROFILE_LORA_SET_TX_POWER,
+    PROFILE_LORA_GET_TX_POWER,
+    PROFILE_LORA_CHANNELS_STATUS,
+    PROFILE_LORA_DEVICE_ADDR,
+    PROFILE_LORA_CONFIGURE_OTAA,
+    PROFILE_LORA_CONFIGURE_ABP,
+    PROFILE_LORA_JOIN_OTAA,
+    PROFILE_LORA_JOIN_ABP,
+    PROFILE_LORA_SET_RETRIES,
+    PROFILE_LORA_GET_RETRIES,
+    PROFILE_LORA_SET_AUTOMATIC_REPLY,
+    PROFILE_LORA_GET_AUTOMATIC_REPLY,
+    PROFILE_LORA_SAVE_CONFIG,
+    PROFILE_LORA_SET_DATA_RATE,
+    PROFILE_LORA_SEND_UNCONFIRMED,
+    PROFILE_LORA_SEND_CONFIRMED,
+    PROFILE_LORA_RECEIVE_DOWNLINK,
+    PROFILE_LORA_SET_BATTERY_LEVEL,
+    PROFILE_LORA_GET_UPLINK_COUNTER,
+    PROFILE_LORA_GET_DOWNLINK_COUNTER,
+    PROFILE_LORA_GET_GATEWAYS,
+    PROFILE_LORA_SET_RX1_DELAY,
+    PROFILE_LORA_GET_RX1_DELAY,
+    PROFILE_LORA_SET_RX2_PARAMETERS,
+    PROFILE_LORA_GET_RX2_DELAY,
+    PROFILE_LORA_GET_RX2_PARAMETERS,
+    PROFILE_OPERATIONS/*!< Number of operations */
+};
+
+/*! \struct profileStats_t
+    \brief  Statistics of one operation
+ */
+typedef struct {
+  uint16_t count;/**< Operations measured, it stops at 0xFFFF */
+  uint32_t totalTicks;/**< Sum of the durations */
+  uint32_t maxTicks;/**< Longest duration */
+  uint16_t histogram[PROFILE_HISTOGRAM_BINS];/**< Durations by bin, each bin stops at 0xFFFF */
+}profileStats_t;
+
+#if PROFILE_ENABLED
+  #define PROFILE(id) ProfileScope profileScope(id)
+#else
+  #define PROFILE(id) do{}while(0)
+#endif
+
+/******************************************************************************
+ * Class                                                                      *
+ ******************************************************************************/
+
+//! Profiler Class
+/*!
+  Statistics of the PROFILE_OPERATIONS operations
+ */
+class Profiler{
+
+/// private attributes //////////////
+private:
+
+    profileStats_t stats[PROFILE_OPERATIONS];/*!< Statistics of each operation */
+
+/// public methods ////////////
+public:
+
+    Profiler();
+
+    void record(uint8_t id, uint32_t ticks);
+
+    profileStats_t* getStats(uint8_t id);
+
+    uint8_t encode(uint8_t *out, uint8_t maxLength, uint8_t *next);
+
+    void dump();
+
+    void clear();
+};
+
+//! ProfileScope Class
+/*!
+  Measures its lifetime, declared by PROFILE()
+ */
+class ProfileScope{
+
+/// private attributes //////////////
+private:
+
+    uint8_t id;/*!< profileOperation_t measured */
+
+    uint32_t start;/*!< halTicks() at the construction */
+
+/// public methods ////////////
+public:
+
+    ProfileScope(uint8_t operation){ id = operation; start = halTicks(); }
+
+    ~ProfileScope();
+};
+
+#if PROFILE_ENABLED
+extern NODE_LOCAL Profiler profiler;
+#endif
+
+#endif
@@ -0,0 +1,100 @@
+/*! \file Redundancy.cpp
+    \brief Library to build and recover the redundancy of the periodic uplinks
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    This library does not use the Waspmote API, so it is also built by the host side decoder.
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include "Redundancy.h"
+
+/******************************************************************************
+ * FUNCTIONS                                                                  *
+ ******************************************************************************/
+
+/*! \fn uint8_t xorRunEncode(const uint8_t *previous, uint8_t previousLength, const uint8_t *current, uint8_t currentLength, uint8_t *out, uint8_t outSize)
+    \brief Encode a previous frame as the XOR with the current one, compressing the runs of zeros
+    \param[in]  *previous      The previous frame
+    \param[in]  previousLength The length of the previous frame
+    \param[in]  *current       The current frame, used as base
+    \param[in]  currentLength  The length of the current frame, bytes after it are taken as 0
+    \param[out] *out           The encoded block
+    \param[in]  outSize        The space available in out
+    \retval The length of the block, 0 if it does not fit in outSize
+
+    Block tokens: 0x80 | n --> n bytes of zeros,
+                  n        --> n literal bytes follow (n in 1..127)
+*/
+uint8_t xorRunEncode(const uint8_t *previous, uint8_t previousLength, const uint8_t *current, uint8_t currentLength, uint8_t *out, uint8_t outSize){
+    uint8_t index = 0;
+    uint8_t length = 0;
+    uint8_t run;
+    uint8_t diff;
+    while(index < previousLength){
+        diff = previous[index] ^ (index < currentLength ? current[index] : 0);
+        run = 0;
+        if(diff == 0){
+            while(((index + run) < previousLength) && (run < 0x7F) &&
+                  ((previous[index + run] ^ ((index + run) < currentLength ? current[index + run] : 0)) == 0)){
+                run++;
+            }
+            if(length >= outSize){
+                return 0;
+            }
+            out[length++] = 0x80 | run;
+        }else{
+            while(((index + run) < previousLength) && (run < 0x7F) &&
+                  ((previous[index + run] ^ ((index + run) < currentLength ? current[index + run] : 0)) != 0)){
+                run++;
+            }
+            if((length + 1 + run) > outSize){
+                return 0;
+            }
+            out[length++] = run;
+            for(uint8_t i = 0; i < run; i++){
+                out[length++] = previous[index + i] ^ ((index + i) < currentLength ? current[index + i] : 0);
+            }
+        }
+        index += run;
+    }
+    return length;
+}
+
+/*! \fn uint8_t xorRunDecode(const uint8_t *in, uint8_t inLength, const uint8_t *current, uint8_t currentLength, uint8_t *previous, uint8_t previousLength)
+    \brief Recover a previous frame from its block and the current frame
+    \param[in]  *in             The encoded block
+    \param[in]  inLength        The length of the block
+    \param[in]  *current        The current frame (without the redundancy element)
+    \param[in]  currentLength   The length of the current frame
+    \param[out] *previous       The recovered frame
+    \param[in]  previousLength  The length of the recovered frame
+    \retval 1: OK
+            0: the block is corrupted
+*/
+uint8_t xorRunDecode(const uint8_t *in, uint8_t inLength, const uint8_t *current, uint8_t currentLength, uint8_t *previous, uint8_t previousLength){
+    uint8_t index = 0;
+    uint8_t position = 0;
+    uint8_t run;
+    while(position < inLength){
+        run = in[position] & 0x7F;
+        if((run == 0) || ((index + run) > previousLength)){
+            return 0;
+        }
+        if(in[position++] & 0x80){
+            for(uint8_t i = 0; i < run; i++, index++){
+                previous[index] = index < currentLength ? current[index] : 0;
+            }
+        }else{
+            if((position + run) > inLength){
+                return 0;
+            }
+            for(uint8_t i = 0; i < run; i++, index++){
+                previous[index] = in[position++] ^ (index < currentLength ? current[index] : 0);
+            }
+        }
+    }
+    return index == previousLength;
+}
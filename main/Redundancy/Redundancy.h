@@ -0,0 +1,46 @@
+/*! \file Redundancy.h
+    \brief Library to build and recover the redundancy of the periodic uplinks
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+*/
+
+/*! \def _REDUNDANCY_H
+    \brief The library flag
+ */
+#ifndef _REDUNDANCY_H
+#define _REDUNDANCY_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define REDUNDANCY_NONE 0/*!< No redundancy appended */
+#define REDUNDANCY_COPY 1/*!< Compressed copies of the previous frames */
+#define REDUNDANCY_PARITY 2/*!< XOR parity of the previous frames */
+#define REDUNDANCY_MAX_DEPTH 3/*!< Maximum number of previous frames covered */
+
+/*
+                        Redundancy element (type REDUNDANCY_TYPE) data
+    Byte 0:     8 bits, Sequence                 Sequence number of this DATA_PORT frame
+    Byte 1:     [7:4] Mode, [3:0] Depth K        Frames sequence-1 ... sequence-K are covered
+    REDUNDANCY_COPY, for every covered frame, newest first:
+      Byte:     8 bits, Length                   Length of the covered frame
+      Byte:     8 bits, Encoded length           Length of the encoded block
+      Bytes:    XOR runs of (covered frame ^ this frame), see xorRunEncode()
+    REDUNDANCY_PARITY:
+      K bytes:  Length of every covered frame, newest first
+      Bytes:    XOR of the covered frames padded with 0 to the longest one
+
+    The base of the copies is this frame without the redundancy element, frames of the same
+    sensors change slowly so the XOR is mostly zeros.
+*/
+
+uint8_t xorRunEncode(const uint8_t *previous, uint8_t previousLength, const uint8_t *current, uint8_t currentLength, uint8_t *out, uint8_t outSize);
+
+uint8_t xorRunDecode(const uint8_t *in, uint8_t inLength, const uint8_t *current, uint8_t currentLength, uint8_t *previous, uint8_t previousLength);
+
+#endif
@@ -0,0 +1,139 @@
+/*! \file RingBuffer.h
+    \brief Fixed size ring buffer template, without heap use
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    The elements are built in place: reserve() returns the free slot after the last element,
+    the caller fills it and push() makes it part of the buffer. front()/at() return pointers
+    to the stored elements, so nothing is copied to queue, send or retry them.
+*/
+
+/*! \def _RINGBUFFER_H
+    \brief The library flag
+ */
+#ifndef _RINGBUFFER_H
+#define _RINGBUFFER_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+#include <stddef.h>
+
+/******************************************************************************
+ * Class                                                                      *
+ ******************************************************************************/
+
+//! RingBuffer Class
+/*!
+  Ring buffer of N elements of type T (N <= 255)
+ */
+template <typename T, uint8_t N>
+class RingBuffer{
+
+/// public methods ////////////
+public:
+
+    RingBuffer(){
+        clear();
+    }
+
+    /*! \fn T* reserve()
+        \brief Return the slot after the last element, it is not stored until push()
+        \retval Pointer to the slot, NULL if the buffer is full
+    */
+    T* reserve(){
+        if(count == N){
+            return NULL;
+        }
+        return &slots[(head + count) % N];
+    }
+
+    /*! \fn void push()
+        \brief Store the slot returned by reserve() as the last element
+    */
+    void push(){
+        if(count < N){
+            count++;
+        }
+    }
+
+    /*! \fn T* front()
+        \brief Return the oldest element
+        \retval Pointer to the element, NULL if the buffer is empty
+    */
+    T* front(){
+        if(count == 0){
+            return NULL;
+        }
+        return &slots[head];
+    }
+
+    /*! \fn void pop()
+        \brief Remove the oldest element
+    */
+    void pop(){
+        if(count > 0){
+            head = (head + 1) % N;
+            count--;
+        }
+    }
+
+    /*! \fn T* at(uint8_t index)
+        \brief Return the element in the position index, 0 is the oldest one
+        \retval Pointer to the element, NULL if index is out of range
+    */
+    T* at(uint8_t index){
+        if(index >= count){
+            return NULL;
+        }
+        return &slots[(head + index) % N];
+    }
+
+    /*! \fn void erase(uint8_t index)
+        \brief Remove the element in the position index
+
+        The newer elements are moved one position, it is O(N) and only meant for evictions.
+    */
+    void erase(uint8_t index){
+        if(index >= count){
+            return;
+        }
+        for(uint8_t i = index; (i + 1) < count; i++){
+            slots[(head + i) % N] = slots[(head + i + 1) % N];
+        }
+        count--;
+    }
+
+    uint8_t size(){
+        return count;
+    }
+
+    uint8_t capacity(){
+        return N;
+    }
+
+    uint8_t isEmpty(){
+        return count == 0;
+    }
+
+    uint8_t isFull(){
+        return count == N;
+    }
+
+    void clear(){
+        head = 0;
+        count = 0;
+    }
+
+/// private attributes //////////////
+private:
+
+    T slots[N];/*!< The elements */
+
+    uint8_t head;/*!< Position of the oldest element */
+
+    uint8_t count;/*!< Number of elements stored */
+};
+
+#endif
@@ -0,0 +1,168 @@
+/*! \file RunningStats.cpp
+    \brief Streaming statistics (count, min, max, mean, standard deviation) of the samples of one sensor
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    This library does not use the Waspmote API, so it is also built by the host side decoder.
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include <math.h>
+#include "DeltaCodec.h"
+#include "RunningStats.h"
+
+/******************************************************************************
+ * FUNCTIONS                                                                  *
+ ******************************************************************************/
+
+/*! \fn uint8_t statisticsDecode(const uint8_t *in, uint8_t length, uint32_t *count, int32_t *summary)
+    \brief Decode a summary written by RunningStats::encode()
+    \param[in]  *in      The encoded summary
+    \param[in]  length   The length of in
+    \param[out] *count   The number of samples summarised
+    \param[out] *summary min, max, mean and standard deviation
+    \retval The number of bytes used, 0 if the summary is corrupted
+*/
+uint8_t statisticsDecode(const uint8_t *in, uint8_t length, uint32_t *count, int32_t *summary){
+    uint8_t index;
+    uint8_t used;
+    uint32_t raw;
+    index = varintDecode(in, length, count);
+    if(index == 0){
+        return 0;
+    }
+    for(uint8_t i = 0; i < 4; i++){
+        used = varintDecode(in + index, length - index, &raw);
+        if(used == 0){
+            return 0;
+        }
+        index += used;
+        summary[i] = (i == 0) ? zigzagDecode(raw) : (int32_t)raw;
+    }
+    summary[1] += summary[0];//max
+    summary[2] += summary[0];//mean
+    return index;
+}
+
+/******************************************************************************
+ * RunningStats                                                               *
+ ******************************************************************************/
+
+/*! class constructor
+It clears the statistics
+\param void
+\return void
+*/
+RunningStats::RunningStats(){
+    clear();
+}
+
+/*! class Destructor
+  It does nothing
+  \param void
+  \return void
+*/
+RunningStats::~RunningStats(){
+}
+
+/*! \fn void putValue(int32_t value)
+    \brief Add a sample
+    \param  value The sample
+*/
+void RunningStats::putValue(int32_t value){
+    float delta;
+    float relative;
+    if(count == 0xFFFF){
+        return;
+    }
+    if(count == 0){
+        first = value;
+        min = value;
+        max = value;
+    }
+    if(value < min){
+        min = value;
+    }
+    if(value > max){
+        max = value;
+    }
+    count++;
+    relative = (float)(value - first);
+    delta = relative - mean;
+    mean += delta / count;
+    m2 += delta * (relative - mean);
+}
+
+/*! \fn uint16_t getCount()
+    \brief Return the number of samples
+*/
+uint16_t RunningStats::getCount(){
+    return count;
+}
+
+/*! \fn int32_t getMin()
+    \brief Return the lowest sample
+*/
+int32_t RunningStats::getMin(){
+    return min;
+}
+
+/*! \fn int32_t getMax()
+    \brief Return the highest sample
+*/
+int32_t RunningStats::getMax(){
+    return max;
+}
+
+/*! \fn int32_t getMean()
+    \brief Return the mean of the samples, rounded to the nearest integer
+*/
+int32_t RunningStats::getMean(){
+    return first + (int32_t)floor(mean + 0.5);
+}
+
+/*! \fn uint32_t getStdDev()
+    \brief Return the population standard deviation of the samples, rounded to the nearest integer
+*/
+uint32_t RunningStats::getStdDev(){
+    if(count == 0){
+        return 0;
+    }
+    return (uint32_t)floor(sqrt(m2 / count) + 0.5);
+}
+
+/*! \fn uint8_t encode(uint8_t *out)
+    \brief Write the summary
+    \param[out] *out At least STATISTICS_SUMMARY_SIZE bytes
+    \retval The number of bytes written
+*/
+uint8_t RunningStats::encode(uint8_t *out){
+    uint8_t length;
+    int32_t average = getMean();
+    if(average < min){//Rounding of a mean equal to min or max
+        average = min;
+    }
+    if(average > max){
+        average = max;
+    }
+    length = varintEncode(count, out);
+    length += varintEncode(zigzagEncode(min), out + length);
+    length += varintEncode((uint32_t)(max - min), out + length);
+    length += varintEncode((uint32_t)(average - min), out + length);
+    length += varintEncode(getStdDev(), out + length);
+    return length;
+}
+
+/*! \fn void clear()
+    \brief Start a new window
+*/
+void RunningStats::clear(){
+    count = 0;
+    first = 0;
+    min = 0;
+    max = 0;
+    mean = 0;
+    m2 = 0;
+}
@@ -0,0 +1,84 @@
+/*! \file RunningStats.h
+    \brief Streaming statistics (count, min, max, mean, standard deviation) of the samples of one sensor
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+*/
+
+/*! \def _RUNNINGSTATS_H
+    \brief The library flag
+ */
+#ifndef _RUNNINGSTATS_H
+#define _RUNNINGSTATS_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define STATISTICS_SUMMARY_SIZE 23/*!< Maximum size in bytes of an encoded summary */
+
+/*
+                        Statistics summary structure (element payload)
+    varint:     Count                           Number of samples summarised
+    varint:     zig-zag(min)
+    varint:     max - min
+    varint:     mean - min                      Rounded to the nearest integer
+    varint:     Standard deviation              Population, rounded to the nearest integer
+*/
+
+uint8_t statisticsDecode(const uint8_t *in, uint8_t length, uint32_t *count, int32_t *summary);
+
+/******************************************************************************
+ * Class                                                                      *
+ ******************************************************************************/
+
+//! RunningStats Class
+/*!
+  Welford accumulator in fixed memory. The mean and the variance are kept relative to the first
+  sample, so large raw values (pressure, light) do not lose the float precision.
+ */
+class RunningStats{
+
+/// public methods ////////////
+public:
+
+    RunningStats();
+
+    ~RunningStats();
+
+    void putValue(int32_t value);
+
+    uint16_t getCount();
+
+    int32_t getMin();
+
+    int32_t getMax();
+
+    int32_t getMean();
+
+    uint32_t getStdDev();
+
+    uint8_t encode(uint8_t *out);
+
+    void clear();
+
+/// private methods and attributes //////////////
+private:
+
+    uint16_t count;/*!< Number of samples */
+
+    int32_t first;/*!< First sample, reference of mean and m2 */
+
+    int32_t min;/*!< Lowest sample */
+
+    int32_t max;/*!< Highest sample */
+
+    float mean;/*!< Mean of (sample - first) */
+
+    float m2;/*!< Sum of the squared distances to the mean */
+};
+
+#endif
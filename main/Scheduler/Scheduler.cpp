@@ -0,0 +1,179 @@
+/*! \file Scheduler.cpp
+    \brief Logical timers multiplexed onto the RTC Alarm 1
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#ifndef __WPROGRAM_H__
+  #include <WaspClasses.h>
+#endif
+
+#include "Scheduler.h"
+#include "Log.h"
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS                                                           *
+ ******************************************************************************/
+
+/*! class constructor
+  All the timers are stopped
+  \param void
+  \return void
+*/
+Scheduler::Scheduler(){
+    memset(timers, 0, sizeof(timers));
+    armed = 0;
+}
+
+/*! \fn void start(uint8_t id, uint32_t delay, uint32_t period)
+    \brief Start (or restart) a timer
+    \param  id     The timer
+    \param  delay  Seconds from now to the first deadline
+    \param  period Seconds between the next deadlines, 0 for a one-shot timer
+
+    A deadline before the alarm programmed has not woken the node up yet, armed is moved below it so
+    programAlarm() does not skip it.
+*/
+void Scheduler::start(uint8_t id, uint32_t delay, uint32_t period){
+    if(id >= SCHEDULER_TIMERS){
+        return;
+    }
+    timers[id].deadline = RTC.getEpochTime() + delay;
+    timers[id].period = period;
+    timers[id].active = 1;
+    if(timers[id].deadline <= armed){
+        armed = timers[id].deadline - 1;
+    }
+}
+
+/*! \fn void startAligned(uint8_t id, uint32_t origin, uint32_t period)
+    \brief Start (or restart) a periodic timer on the grid of deadlines origin + k * period
+    \param  id     The timer
+    \param  origin RTC epoch of a deadline of the grid, it can be in the past
+    \param  period Seconds between deadlines, greater than 0
+
+    The first deadline is the first one of the grid after now, so the timers restarted with the
+    same origin and period keep being due in the same wake ups.
+*/
+void Scheduler::startAligned(uint8_t id, uint32_t origin, uint32_t period){
+    uint32_t now = RTC.getEpochTime();
+    if((id >= SCHEDULER_TIMERS) || (period == 0)){
+        return;
+    }
+    if(origin > now){
+        start(id, origin - now, period);
+    }else{
+        start(id, period - (now - origin) % period, period);
+    }
+}
+
+/*! \fn void stop(uint8_t id)
+    \brief Stop a timer
+*/
+void Scheduler::stop(uint8_t id){
+    if(id < SCHEDULER_TIMERS){
+        timers[id].active = 0;
+    }
+}
+
+/*! \fn uint8_t isActive(uint8_t id)
+    \brief Return 1 if the timer is running
+*/
+uint8_t Scheduler::isActive(uint8_t id){
+    return (id < SCHEDULER_TIMERS) && timers[id].active;
+}
+
+/*! \fn uint8_t isDue(uint8_t id)
+    \brief Return 1 if the deadline of the timer has been reached (within SCHEDULER_SLACK), the timer is not changed
+*/
+uint8_t Scheduler::isDue(uint8_t id){
+    return isActive(id) && (timers[id].deadline <= (RTC.getEpochTime() + SCHEDULER_SLACK));
+}
+
+/*! \fn uint8_t takeDue(uint8_t id)
+    \brief Consume the deadline of a due timer
+    \param  id The timer
+    \retval 1 if the timer was due: a periodic timer gets its next deadline, a one-shot timer is stopped
+            0 if it was not due
+
+    The deadlines missed while the node was busy are skipped, they are not attended one by one.
+    A deadline within SCHEDULER_SLACK seconds is taken as due, so the timers started one after
+    the other with the same period are attended in the same wake up.
+*/
+uint8_t Scheduler::takeDue(uint8_t id){
+    uint32_t now = RTC.getEpochTime() + SCHEDULER_SLACK;
+    if(!isActive(id) || (timers[id].deadline > now)){
+        return 0;
+    }
+    if(timers[id].period == 0){
+        timers[id].active = 0;
+    }else{
+        timers[id].deadline += ((now - timers[id].deadline) / timers[id].period + 1) * timers[id].period;
+    }
+    return 1;
+}
+
+/*! \fn uint32_t getNextDeadline()
+    \brief Return the nearest deadline of the running timers
+    \retval The RTC epoch of the deadline, 0 if no timer is running
+*/
+uint32_t Scheduler::getNextDeadline(){
+    uint32_t next = 0;
+    for(uint8_t id = 0; id < SCHEDULER_TIMERS; id++){
+        if(timers[id].active && ((next == 0) || (timers[id].deadline < next))){
+            next = timers[id].deadline;
+        }
+    }
+    return next;
+}
+
+/*! \fn uint8_t programAlarm()
+    \brief Program the RTC Alarm 1 at the nearest deadline
+    \retval 0 if OK, 1 if the RTC rejected the alarm (or no timer is running)
+
+    The alarm is set in offset mode (RTC_ALM1_MODE2, day, hours, minutes and seconds added to the
+    current time). A deadline reached after the last alarm was programmed (while the node was awake)
+    is programmed one second ahead, and one longer than SCHEDULER_MAX_SLEEP is programmed at
+    SCHEDULER_MAX_SLEEP.
+    A deadline the last alarm already woke the node up for and that was not taken with takeDue() is
+    not programmed again, or the node would wake up every second: it is skipped as a missed one.
+*/
+uint8_t Scheduler::programAlarm(){
+    uint32_t next;
+    uint32_t now = RTC.getEpochTime();
+    uint32_t delay;
+    uint8_t response;
+    for(uint8_t id = 0; id < SCHEDULER_TIMERS; id++){
+        if(!timers[id].active || (timers[id].deadline > now) || (timers[id].deadline > armed)){
+            continue;
+        }
+        LOG_ERROR(F("Scheduler: deadline not taken, timer "));
+        LOG_ERRORLN(id, DEC);
+        if(timers[id].period == 0){
+            timers[id].active = 0;
+        }else{
+            timers[id].deadline += ((now - timers[id].deadline) / timers[id].period + 1) * timers[id].period;
+        }
+    }
+    next = getNextDeadline();
+    if(next == 0){
+        LOG_ERRORLN(F("Scheduler: no timer running"));
+        return 1;
+    }
+    armed = next;
+    delay = (next > now) ? (next - now) : 1;
+    if(delay > SCHEDULER_MAX_SLEEP){
+        delay = SCHEDULER_MAX_SLEEP;
+    }
+    response = RTC.setAlarm1(delay / 86400UL, (delay / 3600UL) % 24, (delay / 60UL) % 60, delay % 60, RTC_OFFSET, RTC_ALM1_MODE2);
+    if(response == 0){
+        LOG_INFO(F("Scheduler: RTC Alarm 1 set in OFFSET MODE, seconds = "));
+        LOG_INFOLN(delay);
+    }else{
+        LOG_ERRORLN(F("Scheduler: RTC Alarm 1 error, Incorrect input parameters"));
+    }
+    return response;
+}
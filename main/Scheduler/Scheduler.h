@@ -0,0 +1,77 @@
+/*! \file Scheduler.h
+    \brief Logical timers multiplexed onto the RTC Alarm 1
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    Each timer has a deadline in RTC epoch seconds. Before sleeping only the nearest deadline
+    is programmed in the RTC alarm, so the node wakes up when a timer is due and not before.
+*/
+
+/*! \def _SCHEDULER_H
+    \brief The library flag
+ */
+#ifndef _SCHEDULER_H
+#define _SCHEDULER_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+#include "defines.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define SCHEDULER_TIMERS 16/*!< Number of logical timers */
+#define SCHEDULER_MAX_SLEEP 86400UL/*!< Longest alarm programmed (s), the node wakes up and sleeps again if nothing is due */
+#define SCHEDULER_SLACK 2/*!< Deadlines closer than SCHEDULER_SLACK seconds are attended in the same wake up */
+
+/*! \struct schedulerTimer_t
+    \brief  One logical timer
+ */
+typedef struct {
+  uint32_t deadline;/**< RTC epoch when the timer is due */
+  uint32_t period;/**< Seconds between deadlines, 0 for a one-shot timer */
+  uint8_t active;/**< 1 if the timer is running */
+}schedulerTimer_t;
+
+/******************************************************************************
+ * Class                                                                      *
+ ******************************************************************************/
+
+//! Scheduler Class
+/*!
+  Table of SCHEDULER_TIMERS timers, identified by their index
+ */
+class Scheduler{
+
+/// private attributes //////////////
+private:
+
+    schedulerTimer_t timers[SCHEDULER_TIMERS];/*!< The timers */
+
+    uint32_t armed;/*!< Deadline of the last alarm programmed, the deadlines up to it already woke the node up */
+
+/// public methods ////////////
+public:
+
+    Scheduler();
+
+    void start(uint8_t id, uint32_t delay, uint32_t period);
+
+    void startAligned(uint8_t id, uint32_t origin, uint32_t period);
+
+    void stop(uint8_t id);
+
+    uint8_t isActive(uint8_t id);
+
+    uint8_t isDue(uint8_t id);
+
+    uint8_t takeDue(uint8_t id);
+
+    uint32_t getNextDeadline();
+
+    uint8_t programAlarm();
+};
+
+#endif
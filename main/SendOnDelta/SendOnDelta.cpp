@@ -0,0 +1,177 @@
+/*! \file SendOnDelta.cpp
+    \brief Send-on-delta filter of the periodic sensor values
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#ifndef __WPROGRAM_H__
+  #include <WaspClasses.h>
+#endif
+
+#include "SendOnDelta.h"
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS                                                           *
+ ******************************************************************************/
+
+/*! class constructor
+  It loads the default thresholds and forgets the values sent
+  \param void
+  \return void
+*/
+SendOnDelta::SendOnDelta(){
+    for(uint8_t type = 0; type < SEND_ON_DELTA_TYPES; type++){
+        threshold[type] = defaultSensorThreshold[type];
+        maxSilence[type] = SEND_ON_DELTA_MAX_SILENCE;
+    }
+    sentTypes = 0;
+    clearCounters();
+}
+
+/*! \fn uint8_t filter(uint8_t type, int32_t value, uint32_t now)
+    \brief Decide if a periodic value has to be sent
+    \param  type  The UplinkTypes_t of the value
+    \param  value The value read
+    \param  now   The RTC epoch of the read
+    \retval 1 if the value has to be sent (it becomes the reference of the type), 0 if it is suppressed
+
+    The first value of a type is always sent.
+    The counters stop together when checkedCount reaches 0xFFFF, so they do not wrap and the
+    suppression rate stays the one of the values counted. housekeeping() clears them.
+*/
+uint8_t SendOnDelta::filter(uint8_t type, int32_t value, uint32_t now){
+    int32_t change;
+    uint8_t counted;
+    if(type >= SEND_ON_DELTA_TYPES){
+        return 1;
+    }
+    counted = (checkedCount < 0xFFFF);
+    if(counted){
+        checkedCount++;
+    }
+    change = value - lastValue[type];
+    if(change < 0){
+        change = -change;
+    }
+    if((threshold[type] == 0) || !(sentTypes & (1 << type)) || (change >= threshold[type]) ||
+       ((maxSilence[type] > 0) && ((now - lastEpoch[type]) >= (uint32_t)maxSilence[type] * 3600UL))){
+        lastValue[type] = value;
+        lastEpoch[type] = now;
+        sentTypes |= (1 << type);
+        return 1;
+    }
+    if(counted){
+        suppressed[type]++;
+        suppressedCount++;
+    }
+    return 0;
+}
+
+/*! \fn void setThreshold(uint8_t type, uint16_t delta, uint8_t silence)
+    \brief Set the deadband of a type
+    \param  type    The UplinkTypes_t
+    \param  delta   Minimum change to send a value in raw units, 0 sends every value
+    \param  silence Hours without sending before a value is sent anyway, 0 never
+*/
+void SendOnDelta::setThreshold(uint8_t type, uint16_t delta, uint8_t silence){
+    if(type >= SEND_ON_DELTA_TYPES){
+        return;
+    }
+    threshold[type] = delta;
+    maxSilence[type] = silence;
+}
+
+/*! \fn uint16_t getThreshold(uint8_t type)
+    \brief Return the threshold of a type
+    \retval The threshold in raw units
+*/
+uint16_t SendOnDelta::getThreshold(uint8_t type){
+    return (type < SEND_ON_DELTA_TYPES) ? threshold[type] : 0;
+}
+
+/*! \fn uint8_t getMaxSilence(uint8_t type)
+    \brief Return the maximum silence of a type
+    \retval The maximum silence in hours
+*/
+uint8_t SendOnDelta::getMaxSilence(uint8_t type){
+    return (type < SEND_ON_DELTA_TYPES) ? maxSilence[type] : 0;
+}
+
+/*! \fn void forget(uint8_t type)
+    \brief Forget the last value sent of a type, so the next one is sent
+    \param  type The UplinkTypes_t
+*/
+void SendOnDelta::forget(uint8_t type){
+    if(type < SEND_ON_DELTA_TYPES){
+        sentTypes &= ~(1 << type);
+    }
+}
+
+/*! \fn uint16_t getSuppressedCount(uint8_t type)
+    \brief Return the values of a type not sent
+*/
+uint16_t SendOnDelta::getSuppressedCount(uint8_t type){
+    return (type < SEND_ON_DELTA_TYPES) ? suppressed[type] : 0;
+}
+
+/*! \fn uint16_t getSuppressedCount()
+    \brief Return the values not sent
+*/
+uint16_t SendOnDelta::getSuppressedCount(){
+    return suppressedCount;
+}
+
+/*! \fn uint16_t getCheckedCount()
+    \brief Return the values filtered
+*/
+uint16_t SendOnDelta::getCheckedCount(){
+    return checkedCount;
+}
+
+/*! \fn uint8_t getSuppressionRate()
+    \brief Return the percentage of the values filtered that were not sent
+    \retval 0..100, suppressedCount never exceeds checkedCount
+*/
+uint8_t SendOnDelta::getSuppressionRate(){
+    if(checkedCount == 0){
+        return 0;
+    }
+    return (uint8_t)(((uint32_t)suppressedCount * 100) / checkedCount);
+}
+
+/*! \fn void dump()
+    \brief Print the thresholds and counters through the USB
+
+    "D:<checked>,<suppressed>,<rate %>" followed by one line per type:
+    "D:<type>,<threshold>,<max silence h>,<suppressed>"
+*/
+void SendOnDelta::dump(){
+    USB.print(F("D:"));
+    USB.print(checkedCount, DEC);
+    USB.print(F(","));
+    USB.print(suppressedCount, DEC);
+    USB.print(F(","));
+    USB.println(getSuppressionRate(), DEC);
+    for(uint8_t type = UV_INDEX_TYPE; type < SEND_ON_DELTA_TYPES; type++){
+        USB.print(F("D:"));
+        USB.print(type, DEC);
+        USB.print(F(","));
+        USB.print(threshold[type], DEC);
+        USB.print(F(","));
+        USB.print(maxSilence[type], DEC);
+        USB.print(F(","));
+        USB.println(suppressed[type], DEC);
+    }
+}
+
+/*! \fn void clearCounters()
+    \brief Clear the suppression counters, the thresholds and references are kept
+*/
+void SendOnDelta::clearCounters(){
+    memset(suppressed, 0, sizeof(suppressed));
+    checkedCount = 0;
+    suppressedCount = 0;
+}
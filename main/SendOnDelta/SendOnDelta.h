@@ -0,0 +1,85 @@
+/*! \file SendOnDelta.h
+    \brief Send-on-delta filter of the periodic sensor values
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    A periodic value is only sent when it differs from the last value sent of its type by
+    the threshold of the type or more, or when the type has not been sent for its maximum silence
+    (heartbeat). The thresholds are in the raw units of the Thunderboard Sense 2 characteristic.
+*/
+
+/*! \def _SENDONDELTA_H
+    \brief The library flag
+ */
+#ifndef _SENDONDELTA_H
+#define _SENDONDELTA_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+#include "defines.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define SEND_ON_DELTA_TYPES (FIELD_STRENGHT_TYPE + 1)/*!< Types filtered, indexed by UplinkTypes_t */
+
+/******************************************************************************
+ * Class                                                                      *
+ ******************************************************************************/
+
+//! SendOnDelta Class
+/*!
+  Deadband of each UplinkTypes_t and the last value sent
+ */
+class SendOnDelta{
+
+/// private attributes //////////////
+private:
+
+    uint16_t threshold[SEND_ON_DELTA_TYPES];/*!< Minimum change to send a value, 0 sends every value */
+
+    uint8_t maxSilence[SEND_ON_DELTA_TYPES];/*!< Hours without sending before a value is sent anyway, 0 never */
+
+    int32_t lastValue[SEND_ON_DELTA_TYPES];/*!< Last value sent */
+
+    uint32_t lastEpoch[SEND_ON_DELTA_TYPES];/*!< RTC epoch of the last value sent */
+
+    uint16_t sentTypes;/*!< Bit i set when a value of the type i has been sent */
+
+    uint16_t suppressed[SEND_ON_DELTA_TYPES];/*!< Values not sent of each type */
+
+    uint16_t checkedCount;/*!< Values filtered, it stops at 0xFFFF with the other counters */
+
+    uint16_t suppressedCount;/*!< Values not sent */
+
+/// public methods ////////////
+public:
+
+    SendOnDelta();
+
+    uint8_t filter(uint8_t type, int32_t value, uint32_t now);
+
+    void setThreshold(uint8_t type, uint16_t delta, uint8_t silence);
+
+    uint16_t getThreshold(uint8_t type);
+
+    uint8_t getMaxSilence(uint8_t type);
+
+    void forget(uint8_t type);
+
+    uint16_t getSuppressedCount(uint8_t type);
+
+    uint16_t getSuppressedCount();
+
+    uint16_t getCheckedCount();
+
+    uint8_t getSuppressionRate();
+
+    void dump();
+
+    void clearCounters();
+};
+
+#endif
@@ -0,0 +1,109 @@
+/*! \file StateStats.cpp
+    \brief Dwell time, entries and failures of each state of the node state machine
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#ifndef __WPROGRAM_H__
+  #include <WaspClasses.h>
+#endif
+
+#include "StateStats.h"
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS                                                           *
+ ******************************************************************************/
+
+/*! class constructor
+  It clears the statistics
+  \param void
+  \return void
+*/
+StateStats::StateStats(){
+    clear();
+}
+
+/*! \fn void record(uint8_t state, uint32_t dwellTime, uint8_t failed)
+    \brief Record one execution of a state
+    \param  state     The stateEnum_t executed
+    \param  dwellTime The time spent in the state in ms
+    \param  failed    1 if the state ended with a failure transition
+*/
+void StateStats::record(uint8_t state, uint32_t dwellTime, uint8_t failed){
+    uint8_t bin = 0;
+    if(state >= STATES_NUMBER){
+        return;
+    }
+    stats[state].entries++;
+    if(failed){
+        stats[state].failures++;
+    }
+    stats[state].totalTime += dwellTime;
+    if(dwellTime > stats[state].maxTime){
+        stats[state].maxTime = dwellTime;
+    }
+    while(((dwellTime >> 1) > 0) && (bin < (DWELL_HISTOGRAM_BINS - 1))){
+        dwellTime >>= 1;
+        bin++;
+    }
+    stats[state].histogram[bin]++;
+}
+
+/*! \fn stateStats_t* getStats(uint8_t state)
+    \brief Return the statistics of a state
+    \retval Pointer to the statistics, NULL if state is out of range
+*/
+stateStats_t* StateStats::getStats(uint8_t state){
+    if(state >= STATES_NUMBER){
+        return NULL;
+    }
+    return &stats[state];
+}
+
+/*! \fn uint32_t getCharge(uint8_t state)
+    \brief Return the charge estimated for a state from its dwell time and stateCurrent
+    \retval The charge in mAs
+*/
+uint32_t StateStats::getCharge(uint8_t state){
+    if(state >= STATES_NUMBER){
+        return 0;
+    }
+    return (stats[state].totalTime / 1000) * stateCurrent[state];
+}
+
+/*! \fn void dump()
+    \brief Print the statistics through the USB
+
+    One line per state: "S:<state>,<entries>,<failures>,<total ms>,<max ms>,<mAs>,<histogram bins...>"
+*/
+void StateStats::dump(){
+    for(uint8_t state = 0; state < STATES_NUMBER; state++){
+        USB.print(F("S:"));
+        USB.print(state, DEC);
+        USB.print(F(","));
+        USB.print(stats[state].entries, DEC);
+        USB.print(F(","));
+        USB.print(stats[state].failures, DEC);
+        USB.print(F(","));
+        USB.print(stats[state].totalTime);
+        USB.print(F(","));
+        USB.print(stats[state].maxTime);
+        USB.print(F(","));
+        USB.print(getCharge(state));
+        for(uint8_t bin = 0; bin < DWELL_HISTOGRAM_BINS; bin++){
+            USB.print(F(","));
+            USB.print(stats[state].histogram[bin], DEC);
+        }
+        USB.println(F(""));
+    }
+}
+
+/*! \fn void clear()
+    \brief Clear the statistics of all the states
+*/
+void StateStats::clear(){
+    memset(stats, 0, sizeof(stats));
+}
@@ -0,0 +1,86 @@
+/*! \file StateStats.h
+    \brief Dwell time, entries and failures of each state of the node state machine
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    The dwell time is measured with millis(), that does not run while the MCU is in power down,
+    so the SLEEP state only accounts for the time spent before and after the sleep itself.
+*/
+
+/*! \def _STATESTATS_H
+    \brief The library flag
+ */
+#ifndef _STATESTATS_H
+#define _STATESTATS_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+#include "defines.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define DWELL_HISTOGRAM_BINS 12/*!< Bin i counts the dwell times in [2^i, 2^(i+1)) ms, the last one the longer times */
+
+/*! \struct stateStats_t
+    \brief  Statistics of one state
+ */
+typedef struct {
+  uint16_t entries;/**< Times the state has been executed */
+  uint16_t failures;/**< Times the state ended with STATE_EVENT_FAIL */
+  uint32_t totalTime;/**< Sum of the dwell times in ms */
+  uint32_t maxTime;/**< Longest dwell time in ms */
+  uint16_t histogram[DWELL_HISTOGRAM_BINS];/**< log2 histogram of the dwell times */
+}stateStats_t;
+
+/*! \var stateCurrent
+    \brief Nominal current of the node in each state in mA (MCU, BLE112 and RN2483 datasheet figures)
+
+    It is used to turn the dwell time into charge (mAs), as an estimate of the energy profile.
+*/
+static const uint8_t stateCurrent[STATES_NUMBER] = {
+    23,/*BLE_SCANNING: MCU + BLE scanning*/
+    23,/*BLE_CONNECT*/
+    23,/*DISCOVER_BLE_PROFILE*/
+    23,/*ENABLE_BLE_NOTIFICATIONS*/
+    15,/*ENABLE_INTERRUPTIONS: MCU only*/
+    15,/*SLEEP: MCU until it is powered down*/
+    23,/*WAKE_UP_AND_CKECK: MCU + BLE reads*/
+    61,/*LORAWAN_SEND_UPLINK: MCU + BLE + LoRaWAN TX*/
+    37/*LORAWAN_RECEIVE_DOWNLINK: MCU + BLE + LoRaWAN RX*/
+};
+
+/******************************************************************************
+ * Class                                                                      *
+ ******************************************************************************/
+
+//! StateStats Class
+/*!
+  Statistics of the STATES_NUMBER states
+ */
+class StateStats{
+
+/// private attributes //////////////
+private:
+
+    stateStats_t stats[STATES_NUMBER];/*!< Statistics of each state */
+
+/// public methods ////////////
+public:
+
+    StateStats();
+
+    void record(uint8_t state, uint32_t dwellTime, uint8_t failed);
+
+    stateStats_t* getStats(uint8_t state);
+
+    uint32_t getCharge(uint8_t state);
+
+    void dump();
+
+    void clear();
+};
+
+#endif
@@ -0,0 +1,101 @@
+/*! \file Trace.cpp
+    \brief Binary trace of the node events kept in RAM
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#ifndef __WPROGRAM_H__
+  #include <WaspClasses.h>
+#endif
+
+#include "Trace.h"
+
+/******************************************************************************
+ * Global variables                                                           *
+ ******************************************************************************/
+NODE_LOCAL Trace trace;
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS                                                           *
+ ******************************************************************************/
+
+/*! class constructor
+  It does nothing
+  \param void
+  \return void
+*/
+Trace::Trace(){
+    overwritten = 0;
+}
+
+/*! \fn void record(uint8_t id, uint16_t arg)
+    \brief Record an event, overwriting the oldest one if the trace is full
+    \param  id  The traceEvent_t
+    \param  arg The argument of the event
+*/
+void Trace::record(uint8_t id, uint16_t arg){
+    traceRecord_t *slot;
+    if(records.isFull()){
+        records.pop();
+        overwritten++;
+    }
+    slot = records.reserve();
+    slot->id = id;
+    slot->timestamp = millis();
+    slot->arg = arg;
+    records.push();
+}
+
+/*! \fn uint8_t getSize()
+    \brief Return the number of events recorded
+*/
+uint8_t Trace::getSize(){
+    return records.size();
+}
+
+/*! \fn traceRecord_t* getRecord(uint8_t index)
+    \brief Return the event in the position index, 0 is the oldest one
+    \retval Pointer to the event, NULL if index is out of range
+*/
+traceRecord_t* Trace::getRecord(uint8_t index){
+    return records.at(index);
+}
+
+/*! \fn uint16_t getOverwritten()
+    \brief Return the events overwritten since the last dump
+*/
+uint16_t Trace::getOverwritten(){
+    return overwritten;
+}
+
+/*! \fn void dump()
+    \brief Print the recorded events through the USB and clear them
+
+    One line per event: "T:<id>,<timestamp ms>,<arg hex>"
+*/
+void Trace::dump(){
+    traceRecord_t *event;
+    USB.print(F("T:overwritten,"));
+    USB.println(overwritten, DEC);
+    for(uint8_t i = 0; i < records.size(); i++){
+        event = records.at(i);
+        USB.print(F("T:"));
+        USB.print(event->id, DEC);
+        USB.print(F(","));
+        USB.print(event->timestamp);
+        USB.print(F(","));
+        USB.println(event->arg, HEX);
+    }
+    clear();
+}
+
+/*! \fn void clear()
+    \brief Remove the recorded events
+*/
+void Trace::clear(){
+    records.clear();
+    overwritten = 0;
+}
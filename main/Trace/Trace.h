@@ -0,0 +1,102 @@
+/*! \file Trace.h
+    \brief Binary trace of the node events kept in RAM
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    Recording an event only stores 7 bytes in a ring, so it can be used with the radios powered
+    where a USB print would extend the wake cycle. The ring is dumped on demand with dump().
+*/
+
+/*! \def _TRACE_H
+    \brief The library flag
+ */
+#ifndef _TRACE_H
+#define _TRACE_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+#include "defines.h"
+#include "RingBuffer.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define TRACE_SIZE 32/*!< Events kept, the oldest are overwritten */
+
+/*! \enum traceEvent_t
+    \brief The events recorded, the meaning of arg is given for each one
+ */
+enum traceEvent_t{
+    TRACE_STATE = 1,/*!< arg: stateEnum_t entered */
+    TRACE_WAKE_UP,/*!< arg: wake source flags (WAKE_SOURCE_RTC, WAKE_SOURCE_BLE) */
+    TRACE_WAKE_CYCLE,/*!< arg: ms from the wake up to the sleep */
+    TRACE_BLE_READ,/*!< arg: handle read */
+    TRACE_BLE_READ_ERROR,/*!< arg: handle read */
+    TRACE_BLE_NOTIFICATION,/*!< arg: value length */
+    TRACE_FRAME_CLOSED,/*!< arg: port << 8 | length */
+    TRACE_FRAME_DISCARDED,/*!< arg: port */
+    TRACE_BUFFER_FULL,/*!< arg: type that did not fit */
+    TRACE_ELEMENT_EVICTED,/*!< Not recorded since the frames have a single priority, kept so the ids do not change */
+    TRACE_FRAME_EVICTED,/*!< arg: port << 8 | priority of the frame evicted from the queue */
+    TRACE_LORAWAN_SEND,/*!< arg: port << 8 | response */
+    TRACE_LORAWAN_DOWNLINK,/*!< arg: downlink type */
+    TRACE_VALUE_SUPPRESSED,/*!< arg: type suppressed by the send-on-delta filter */
+    TRACE_BLE_RESYNC,/*!< arg: BGAPI header bytes rebuilt on a wake up, 0xFF if not synchronised */
+    TRACE_ALLOCATION_FAILED/*!< arg: bytes requested to MemoryStats::allocate() */
+};
+
+/*! \struct traceRecord_t
+    \brief  One recorded event
+ */
+typedef struct {
+  uint8_t id;/**< traceEvent_t */
+  uint32_t timestamp;/**< millis() when recorded */
+  uint16_t arg;/**< Argument of the event */
+}traceRecord_t;
+
+#if TRACE_ENABLED
+  #define TRACE(id, arg) trace.record((id), (arg))
+#else
+  #define TRACE(id, arg) do{}while(0)
+#endif
+
+/******************************************************************************
+ * Class                                                                      *
+ ******************************************************************************/
+
+//! Trace Class
+/*!
+  Ring of the last TRACE_SIZE events
+ */
+class Trace{
+
+/// private attributes //////////////
+private:
+
+    RingBuffer<traceRecord_t, TRACE_SIZE> records;/*!< The recorded events */
+
+    uint16_t overwritten;/*!< Events lost since the last dump */
+
+/// public methods ////////////
+public:
+
+    Trace();
+
+    void record(uint8_t id, uint16_t arg);
+
+    uint8_t getSize();
+
+    traceRecord_t* getRecord(uint8_t index);
+
+    uint16_t getOverwritten();
+
+    void dump();
+
+    void clear();
+};
+
+extern NODE_LOCAL Trace trace;
+
+#endif
@@ -1,7 +1,17 @@
 #ifndef _DEFINES_H
 #define _DEFINES_H
 
-#define DEBUG 1
+#define DEBUG 1/*!< Log level (Log.h): 0 nothing, 1 errors and states, 2 info, 3 verbose dumps */
+#define TRACE_ENABLED 1/*!< 1 records the node events in the binary trace (Trace.h) */
+#ifndef PROFILE_ENABLED
+  #define PROFILE_ENABLED 0/*!< 1 measures the radio operations (Profile.h) and sends them in DIAGNOSTIC_PORT uplinks */
+#endif
+#ifndef HEALTH_UPLINK
+  #define HEALTH_UPLINK 0/*!< 1 sends the MEMORY_TYPE element (MemoryStats.h) in a DIAGNOSTIC_PORT uplink every HOUSEKEEPING_PERIOD */
+#endif
+#ifndef NODE_LOCAL
+  #define NODE_LOCAL/*!< Storage of the node state (globals of main.pde and trace): empty on the Waspmote, thread_local in the host build so that each thread runs its own node */
+#endif
 //BLE defines
 #define TX_POWER 10
 #define SCAN_INTERVAL 96
@@ -11,10 +21,44 @@
 //SOCKETs defines
 #define SOCKET0 0
 #define SOCKET1 1
+//Wake up sources
+#define WAKE_SOURCE_RTC 0x01/*!< wakeSource flag: RTC alarm, some timer is due */
+#define WAKE_SOURCE_BLE 0x02/*!< wakeSource flag: PCINT8, the BLE module sent an event */
 //LoRaWAN defines
 // Define port to use in Back-End: from 1 to 223
 #define EVENT_PORT 1/*!< Port associated with the notification of the device */
 #define DATA_PORT 3/*!< Port associated with the data values sent by the LoRa module */
+#define DIAGNOSTIC_PORT 4/*!< Port of the diagnostic uplinks of the node (MEMORY_TYPE and PROFILE_TYPE elements) */
+//Uplink frame defines
+#define AGGREGATED_SAMPLES 1/*!< Number of alarm samples delta encoded in each DATA_PORT uplink, 1 sends every sample raw */
+#define STATISTICS_SAMPLES 1/*!< Samples summarised (min/max/mean/stddev) in each DATA_PORT uplink, 1 sends every sample */
+#define STATISTICS_TYPE_FLAG 0x20/*!< Set in the element type when the element data is a statistics summary (RunningStats.h) */
+#define SENSOR_VALUE_MAX_SIZE 4/*!< Max bytes of a sensor characteristic value (Thunderboard values are 1 to 4 bytes) */
+#define DELTA_TYPE_FLAG 0x80/*!< Set in the element type when the element data is a delta series (DeltaCodec.h) */
+#ifndef TIMESTAMPED_ELEMENTS
+  #define TIMESTAMPED_ELEMENTS 0/*!< 1 stamps each element with its RTC offset from the frame epoch, the backend decoder must know FRAME_EPOCH_TYPE and TIMESTAMP_TYPE_FLAG first */
+#endif
+#define TIMESTAMP_TYPE_FLAG 0x40/*!< Set in the element type when the element data starts with its RTC offset */
+#define FRAME_EPOCH_TYPE 0x7E/*!< First element of a timestamped frame: RTC epoch the offsets refer to (4 bytes, little endian) */
+#define FRAME_PRIORITY_PERIODIC 0/*!< Priority of the DATA_PORT frames */
+#define FRAME_PRIORITY_EVENT 1/*!< Priority of the EVENT_PORT frames */
+#define REDUNDANCY_TYPE 0x7F/*!< Element with the redundancy of the previous DATA_PORT frames (Redundancy.h) */
+#define PROFILE_TYPE 0x7D/*!< Element of a DIAGNOSTIC_PORT frame with a part of the profile block (Profile.h) */
+#define MEMORY_TYPE 0x7C/*!< Element of the DIAGNOSTIC_PORT health frame with the RAM use (MemoryStats.h) */
+#define REDUNDANCY_MODE 0/*!< Default redundancy of the DATA_PORT frames: 0 none, 1 compressed copies, 2 XOR parity */
+#define REDUNDANCY_DEPTH 1/*!< Default number of previous DATA_PORT frames covered by the redundancy */
+//Scheduler defines (Scheduler.h)
+#define TIMER_RETRY 0/*!< Deferred send of the frames that could not be sent */
+#define TIMER_HOUSEKEEPING 1/*!< Periodic dump of the trace and the state statistics (DEBUG >= 2), diagnostic uplinks (HEALTH_UPLINK, PROFILE_ENABLED) */
+#define TIMER_SENSOR_BASE 2/*!< Timer TIMER_SENSOR_BASE + type: periodic read of each sensor type (UV_INDEX..FIELD_STRENGHT) */
+#define TIMER_REPORT (TIMER_SENSOR_BASE + FIELD_STRENGHT_TYPE + 1)/*!< Emission of the statistics summaries (STATISTICS_SAMPLES > 1) */
+#define RETRY_DELAY 60/*!< Seconds to retry the send of the pending frames */
+#define HOUSEKEEPING_PERIOD 3600/*!< Seconds between housekeeping tasks */
+#define SEND_ON_DELTA_MAX_SILENCE 6/*!< Default hours without sending a periodic type before a value is sent anyway */
+
+#if (AGGREGATED_SAMPLES > 1) && (STATISTICS_SAMPLES > 1)
+  #error "AGGREGATED_SAMPLES and STATISTICS_SAMPLES can not be used at the same time"
+#endif
 
 /*! \enum states
     \brief  Enum for the diferents states of the BLE-LoRaWAN Node
@@ -31,6 +75,19 @@ typedef enum states{
     LORAWAN_RECEIVE_DOWNLINK/**< State LORAWAN_RECEIVE_DOWNLINK */
 }stateEnum_t;
 
+#define STATES_NUMBER (LORAWAN_RECEIVE_DOWNLINK + 1)/*!< Number of states of stateEnum_t */
+
+/*! \enum stateEvents
+    \brief  Enum for the events returned by the states, they select the transition of the state machine
+*/
+typedef enum stateEvents{
+    STATE_EVENT_OK = 0,/**< The state has been completed */
+    STATE_EVENT_FAIL,/**< The state has failed */
+    STATE_EVENT_DATA,/**< There is uplink data to send */
+    STATE_EVENT_NO_DATA,/**< There is no uplink data to send */
+    STATE_EVENT_DOWNLINK/**< Downlink data has been received */
+}stateEvent_t;
+
 /*! \enum types_t
     \brief  Enum for the diferents uplink data types to be sent
     
@@ -51,6 +108,44 @@ typedef enum uplinkTypes{
     FIELD_STRENGHT_TYPE/**<type FIELD_STRENGHT*/
 }UplinkTypes_t;
 
+#define PRIORITY_CLASSES 2/*!< FRAME_PRIORITY_PERIODIC and FRAME_PRIORITY_EVENT */
+
+/*! \var uplinkTypePriority
+    \brief Priority class of each UplinkTypes_t, counted in the dropped and evicted elements of the buffer
+*/
+static const uint8_t uplinkTypePriority[FIELD_STRENGHT_TYPE + 1] = {
+    FRAME_PRIORITY_EVENT,/*BLE_DISCONNECT*/
+    FRAME_PRIORITY_PERIODIC, FRAME_PRIORITY_PERIODIC, FRAME_PRIORITY_PERIODIC,/*UV_INDEX, PRESSURE, TEMPERATURE*/
+    FRAME_PRIORITY_PERIODIC, FRAME_PRIORITY_PERIODIC, FRAME_PRIORITY_PERIODIC,/*AMBIENT_LIGHT, SOUND_LEVEL, HUMIDITY*/
+    FRAME_PRIORITY_PERIODIC, FRAME_PRIORITY_PERIODIC, FRAME_PRIORITY_PERIODIC,/*BATTERY_LEVEL, ECO2, TVOC*/
+    FRAME_PRIORITY_EVENT,/*HALL_STATE*/
+    FRAME_PRIORITY_PERIODIC/*FIELD_STRENGHT*/
+};
+
+/*! \var defaultSensorPeriod
+    \brief Default sampling period of each UplinkTypes_t in minutes, 0 follows the hours/minutes period
+*/
+static const uint16_t defaultSensorPeriod[FIELD_STRENGHT_TYPE + 1] = {
+    0,/*BLE_DISCONNECT, not sampled*/
+    0, 0, 0,/*UV_INDEX, PRESSURE, TEMPERATURE*/
+    0, 0, 0,/*AMBIENT_LIGHT, SOUND_LEVEL, HUMIDITY*/
+    60, 0, 0,/*BATTERY_LEVEL hourly, ECO2, TVOC*/
+    0,/*HALL_STATE*/
+    0/*FIELD_STRENGHT*/
+};
+
+/*! \var defaultSensorThreshold
+    \brief Default send-on-delta threshold of each UplinkTypes_t in raw units, 0 sends every value
+*/
+static const uint16_t defaultSensorThreshold[FIELD_STRENGHT_TYPE + 1] = {
+    0,/*BLE_DISCONNECT, event*/
+    1, 1000, 50,/*UV_INDEX (index), PRESSURE (1 hPa), TEMPERATURE (0.5 C)*/
+    1000, 300, 200,/*AMBIENT_LIGHT (10 lx), SOUND_LEVEL (3 dB), HUMIDITY (2 %)*/
+    1, 50, 25,/*BATTERY_LEVEL (1 %), ECO2 (50 ppm), TVOC (25 ppb)*/
+    1,/*HALL_STATE, any change*/
+    50/*FIELD_STRENGHT (50 uT)*/
+};
+
 /*! \enum types_t
     \brief  Enum for the diferents downlink data types to receive
     
@@ -59,7 +154,10 @@ typedef enum uplinkTypes{
 typedef enum downlinktypes{
     ERROR_TYPE,/**<type ERROR_TYPE*/
     CONFIGURE_TIME_TYPE,/**<type CONFIGURE_TIME_TYPE*/
-    CONFIGURE_SELECTED_SENSORS_TYPE/**<type CONFIGURE_SELECTED_SENSORS_TYPE*/
+    CONFIGURE_SELECTED_SENSORS_TYPE,/**<type CONFIGURE_SELECTED_SENSORS_TYPE*/
+    CONFIGURE_REDUNDANCY_TYPE,/**<type CONFIGURE_REDUNDANCY_TYPE*/
+    CONFIGURE_SENSOR_PERIOD_TYPE,/**<type CONFIGURE_SENSOR_PERIOD_TYPE*/
+    CONFIGURE_SENSOR_THRESHOLD_TYPE/**<type CONFIGURE_SENSOR_THRESHOLD_TYPE*/
 }downlinktypes_t;
 
 //UUIDs of the services and characrteristics associated with the Thunderboard Sense 2 device
@@ -134,4 +232,9 @@ static uint8_t ServiceA_Characrteristic0_State_uuid[16]            =      {0xF5,
 static uint8_t ServiceA_Characrteristic1_Field_Strength_uuid[16]   =      {0xF5, 0x98, 0xDB, 0xC5, 0x2F, 0x02, 0x4E, 0xC5, 0x99, 0x36, 0xB3, 0xD1, 0xAA, 0x4F, 0x95, 0x7F};  
 static uint8_t ServiceA_Characrteristic2_Control_Point_uuid[16]    =      {0xF5, 0x98, 0xDB, 0xC5, 0x2F, 0x03, 0x4E, 0xC5, 0x99, 0x36, 0xB3, 0xD1, 0xAA, 0x4F, 0x95, 0x7F};   
 
+/*! \var sensorUuid
+    \brief Characteristic read for each UplinkTypes_t, indexed by type (defined in BLECentral.cpp)
+*/
+extern uint8_t *sensorUuid[FIELD_STRENGHT_TYPE + 1];
+
 #endif
@@ -11,15 +11,20 @@
 #include "LoraWan.h"
 #include "Buffer.h"
 #include "defines.h"
-#include <avr/io.h>
-#include <avr/interrupt.h>
+#include "Log.h"
+#include "Trace.h"
+#include "StateStats.h"
+#include "Profile.h"
+#include "MemoryStats.h"
+#include "Scheduler.h"
+#include "SendOnDelta.h"
+#include "Hal.h"
 
 /******************************************************************************
  * Definitions & Declarations
  ******************************************************************************/
-volatile stateEnum_t state;/*!< variable for the state machine*/ 
-volatile uint8_t alarmFlag = 0;/*!< variable for the alarmInterruption*/ 
-volatile uint8_t pcint8 = 0;/*!< variable for the PCINT8 ISR*/
+NODE_LOCAL volatile stateEnum_t state;/*!< variable for the state machine*/ 
+NODE_LOCAL volatile uint8_t wakeSource = 0;/*!< WAKE_SOURCE_RTC and WAKE_SOURCE_BLE flags set by the ISRs*/
 //BLE MODULE 
 char MAC[13] = "000b57a90aaf";/*!< MAC of the device to search */
 //~ char DeviceToSearch = "Thunder Sense #02735";
@@ -30,289 +35,648 @@ char DEVICE_EUI[]  = "00D994825A4CEA00";/*!< Device Identifier*/
 char APP_EUI[] = "0000000000000000";/*!< Loraserver APP identifier*/
 char APP_KEY[] = "170957426080C62A29819A7D656368E4";/*!< APP Key to The Things Network and loraserver*/
 //To handle te alarm time, user can select the time and the minutes to receive the uplink data
-uint8_t hours;
-uint8_t minutes;
+NODE_LOCAL uint8_t hours;
+NODE_LOCAL uint8_t minutes;
 //Bit Map to select what sensors values will we send. In the corresponding position--> 1 value selected, 0  value not selected
-uint8_t sensorsBitMap[12];//{NOT USED, UV_INDEX, PRESSURE, TEMPERATURE, AMBIENT_LIGHT, SOUND_LEVEL, HUMIDITY, BATTERY_LEVEL, ECO2, TVOC, HALL_STATE, FIELD_STRENGHT}
+NODE_LOCAL uint8_t sensorsBitMap[12];//{NOT USED, UV_INDEX, PRESSURE, TEMPERATURE, AMBIENT_LIGHT, SOUND_LEVEL, HUMIDITY, BATTERY_LEVEL, ECO2, TVOC, HALL_STATE, FIELD_STRENGHT}
+NODE_LOCAL uint16_t sensorPeriod[12];/*!< Sampling period of each sensor in minutes, 0 follows hours/minutes */
+NODE_LOCAL uint32_t sensorGrid = 0;/*!< RTC epoch the sensor timers are aligned to, set by startSensorTimers() */
+#if AGGREGATED_SAMPLES > 1
+NODE_LOCAL uint8_t aggregatedSamples = 0;/*!< Number of alarm samples stored in the delta series of the buffer */
+#endif
+#if PROFILE_ENABLED
+NODE_LOCAL uint8_t profileNext = 0;/*!< First profileOperation_t of the next diagnostic uplink */
+#endif
+NODE_LOCAL unsigned long wakeUpTime = 0;/*!< millis() when the node woke up, 0 before the first sleep */
+NODE_LOCAL uint8_t bleDisconnected = 0;/*!< 1 from the loss of the BLE connection until the notifications are enabled again */
 //frame to indicate the BLE disconnection
 uint8_t BLE_Disconnected[2]= {0x01, 0x01};
 //Objects to be used
-BLECentral bleCentral = BLECentral();
-LoraWan    lorawan    = LoraWan();
-Buffer     buffer     = Buffer();
+NODE_LOCAL BLECentral bleCentral = BLECentral();
+NODE_LOCAL LoraWan    lorawan    = LoraWan();
+NODE_LOCAL Buffer     buffer     = Buffer();
+NODE_LOCAL StateStats stateStats = StateStats();
+NODE_LOCAL Scheduler  scheduler  = Scheduler();
+NODE_LOCAL SendOnDelta sendOnDelta = SendOnDelta();
+//State machine
+typedef uint8_t (*stateAction_t)();/*!< Function of a state, returns a stateEvent_t */
+typedef uint8_t (*transitionGuard_t)();/*!< Condition of a transition, 1 to take it */
+typedef void (*transitionAction_t)();/*!< Function run when a transition is taken */
+/*! \struct transition_t
+    \brief  One row of the transitions table
+ */
+typedef struct {
+  stateEnum_t state;/**< Current state */
+  uint8_t event;/**< stateEvent_t returned by the state */
+  transitionGuard_t guard;/**< NULL or condition to take the transition */
+  transitionAction_t action;/**< NULL or function run when the transition is taken */
+  stateEnum_t next;/**< Next state */
+}transition_t;
 
 /******************************************************************************
  * Function prototyping
  ******************************************************************************/
 
-/*! \fn void activarAlarma(uint8_t hora, uint8_t minutos)
-    \brief   sets Alarm1 to the specified time
-    \param   hours       Set the hours of the alarm
-    \param   minutes     Set the minutes of the alarm
+/*! \fn uint32_t getSamplingPeriod()
+    \brief   Return the period of the sensors reads from hours and minutes
+    \retval  The period in seconds, one minute at least
+ */
+uint32_t getSamplingPeriod(){
+    uint32_t period = (uint32_t)hours * 3600UL + (uint32_t)minutes * 60UL;
+    return period > 0 ? period : 60;
+}
+
+/*! \fn uint32_t getSensorPeriod(uint8_t type)
+    \brief   Return the sampling period of a sensor
+    \param   type The UplinkTypes_t of the sensor
+    \retval  The period in seconds
+
+    With STATISTICS_SAMPLES > 1 the sensors that follow hours/minutes are sampled STATISTICS_SAMPLES
+    times per report.
+ */
+uint32_t getSensorPeriod(uint8_t type){
+    return sensorPeriod[type] > 0 ? (uint32_t)sensorPeriod[type] * 60UL : getSamplingPeriod() / STATISTICS_SAMPLES;
+}
+
+/*! \fn void startSensorTimer(uint8_t type)
+    \brief   (Re)start the sampling timer of a selected sensor on the grid of sensorGrid, stop it if the sensor is not selected
+    \param   type The UplinkTypes_t of the sensor
     \retval  void
 
-    This function specifies the time for Alarm 1,in offset mode using RTC_ALM1_MODE4, sets alarm in RTC and enables interrupt.
+    The sensors with the same period (or multiples) keep being read in the same wake up after
+    a downlink changes one of them.
  */
-void activateAlarm(uint8_t hours, uint8_t minutes){
-    uint8_t response;
-    response = RTC.setAlarm1(0,hours,minutes,0,RTC_OFFSET,RTC_ALM1_MODE4);//RTC_OFFSET--> 'time' is added to the actual time read from RTC
-    if(response == 0){
-      USB.print(F("RTC Alarm 1 is set in OFFSET MODE, for hours = "));
-      USB.print(hours, DEC);
-      USB.print(F(" ,minutes = "));
-      USB.println(minutes, DEC);
+void startSensorTimer(uint8_t type){
+    if(sensorsBitMap[type] == 1){
+        scheduler.startAligned(TIMER_SENSOR_BASE + type, sensorGrid, getSensorPeriod(type));
     }else{
-      USB.print(F("RTC Alarm 1 error, Incorrect input parameters"));
+        scheduler.stop(TIMER_SENSOR_BASE + type);
+    }
+}
+
+/*! \fn void startSensorTimers()
+    \brief   (Re)start the sampling timers of all the selected sensors, their first read is one period from now
+    \retval  void
+ */
+void startSensorTimers(){
+    sensorGrid = RTC.getEpochTime();
+    for(uint8_t type = UV_INDEX_TYPE; type <= FIELD_STRENGHT_TYPE; type++){
+        startSensorTimer(type);
+    }
+    #if STATISTICS_SAMPLES > 1
+        scheduler.start(TIMER_REPORT, getSamplingPeriod(), getSamplingPeriod());
+    #endif
+}
+
+/*! \fn void storeNotification()
+    \brief  Store the Hall state notified in the BGAPI event that woke the node up
+    \retval void
+ */
+void storeNotification(){
+    uint8_t *slot;
+    #if STATISTICS_SAMPLES > 1
+        uint8_t value[SENSOR_VALUE_MAX_SIZE + 1];
+    #endif
+    buffer.openFrame(EVENT_PORT, 1, FRAME_PRIORITY_EVENT);
+    slot = buffer.reserveDataToSend(HALL_STATE_TYPE, SENSOR_VALUE_MAX_SIZE);
+    if(slot != NULL){
+        #if STATISTICS_SAMPLES > 1
+            value[0] = bleCentral.copyWakeUpValue(slot, SENSOR_VALUE_MAX_SIZE);
+            memcpy(value + 1, slot, value[0]);
+            buffer.putStatisticsData(value, HALL_STATE_TYPE);//The notified values are sampled too
+            buffer.commitDataToSend(value[0]);
+        #else
+            buffer.commitDataToSend(bleCentral.copyWakeUpValue(slot, SENSOR_VALUE_MAX_SIZE));
+        #endif
+    }
+    buffer.closeFrame();
+}
+
+#if HEALTH_UPLINK
+/*! \fn void sendHealth()
+    \brief  Queue the DIAGNOSTIC_PORT health uplink: the RAM use since the last one
+    \retval void
+ */
+void sendHealth(){
+    uint8_t *slot;
+    buffer.openFrame(DIAGNOSTIC_PORT, 0, FRAME_PRIORITY_PERIODIC);
+    slot = buffer.reserveDataToSend(MEMORY_TYPE, MEMORY_ENTRY_MAX_SIZE);
+    if(slot != NULL){
+        buffer.commitDataToSend(memoryStats.encode(slot));
+        memoryStats.clear();
+    }
+    buffer.closeFrame();
+}
+#endif
+
+#if PROFILE_ENABLED
+/*! \fn void sendProfile()
+    \brief  Queue a DIAGNOSTIC_PORT uplink with the next part of the profile block
+    \retval void
+
+    Each call sends the operations that fit in one PROFILE_TYPE element from profileNext on, the
+    block starts again once it has been sent completely.
+ */
+void sendProfile(){
+    uint8_t *slot;
+    buffer.openFrame(DIAGNOSTIC_PORT, 0, FRAME_PRIORITY_PERIODIC);
+    slot = buffer.reserveDataToSend(PROFILE_TYPE, PROFILE_ENTRY_MAX_SIZE);
+    if(slot != NULL){
+        buffer.commitDataToSend(profiler.encode(slot, PROFILE_ENTRY_MAX_SIZE, &profileNext));
+    }
+    buffer.closeFrame();
+    if(profileNext >= PROFILE_OPERATIONS){
+        profileNext = 0;
+    }
+}
+#endif
+
+/*! \fn void housekeeping()
+    \brief   Tasks of the TIMER_HOUSEKEEPING timer
+    \retval  void
+ */
+void housekeeping(){
+    #if DEBUG >= LOG_LEVEL_INFO
+        trace.dump();
+        stateStats.dump();
+        sendOnDelta.dump();
+        memoryStats.dump();
+        #if PROFILE_ENABLED
+            profiler.dump();
+        #endif
+    #endif
+    sendOnDelta.clearCounters();//The suppression counters cover one HOUSEKEEPING_PERIOD
+    #if HEALTH_UPLINK
+        sendHealth();
+    #endif
+    #if PROFILE_ENABLED
+        sendProfile();
+    #endif
+}
+
+/*! \fn uint8_t takeDueTimers(uint16_t *dueSensors)
+    \brief  Take all the deadlines reached: run the housekeeping and collect the selected sensors due
+    \param[out] dueSensors Bit map of the sensors to read, by UplinkTypes_t
+    \retval 1 if the retry of the pending frames is due, 0 if not
+
+    With STATISTICS_SAMPLES > 1 the TIMER_REPORT timer is left to the caller.
+ */
+uint8_t takeDueTimers(uint16_t *dueSensors){
+    uint8_t retry;
+    *dueSensors = 0;
+    if(scheduler.takeDue(TIMER_HOUSEKEEPING)){
+        housekeeping();
+    }
+    retry = scheduler.takeDue(TIMER_RETRY);
+    for(uint8_t type = UV_INDEX_TYPE; type <= FIELD_STRENGHT_TYPE; type++){//Only the sensors due are read
+        if(scheduler.takeDue(TIMER_SENSOR_BASE + type) && (sensorsBitMap[type] == 1)){
+            *dueSensors |= (1 << type);
+        }
     }
+    return retry;
 }
 
 /*! \fn void alarmInterruption()
     \brief ISR to handle the waspmote Alarm
     \param  
     \retval 
-    This function only changes the value of a flag, alarmFlag, to indicate that the alarm must be attended
+    This function only sets the WAKE_SOURCE_RTC flag of wakeSource, to indicate that the alarm must be attended
 */
 void alarmInterruption(){
-     alarmFlag = 1;
+     wakeSource |= WAKE_SOURCE_RTC;
 }
 
-/*! \fn void enableInterruptionPCINT8()
-    \brief Enables the PCINT8 interrupt, which corresponds to the RX pin of socket 0 where the BLE module is connected.
-    \param void
-    \retval void
-    
-    PCMSK1 – Pin Change Mask Register 1:
-    Each PCINT15:8-bit selects whether pin change interrupt is enabled on the corresponding I/O pin. 
-    If PCINT15:8 isset and the PCIE1 bit in PCICR is set, pin change interrupt is enabled on the corresponding I/O pin.
-    If PCINT15:8 is cleared, pin change interrupt on the corresponding I/O pin is disabled.
-    
-    PCIFR – Pin Change Interrupt Flag Register: 
-    When a logic change on any PCINT15:8 pin triggers an interrupt request, PCIF1 becomes set (one). 
-    If the I-bit inSREG and the PCIE1 bit in PCICR are set (one), the MCU will jump to the corresponding Interrupt Vector. 
-    The flagis cleared when the interrupt routine is executed. Alternatively, the flag can be cleared by writing a logical one to it.
-    
-    PCICR – Pin Change Interrupt Control Register:
-    When the PCIE1 bit is set (one) and the I-bit in the Status Register (SREG) is set (one), pin change interrupt 1 isenabled.
-    Any change on any enabled PCINT15:8 pin will cause an interrupt.
-    The corresponding interrupt of PinChange Interrupt Request is executed from the PCI1 Interrupt Vector. 
-    PCINT15:8 pins are enabled individually bythe PCMSK1 Register.
+/*! \fn void bleWakeUpInterruption()
+    \brief ISR to handle the PCINT8(Pin PE0(RXD0/PCINT8/PDI)--> connected to Waspmote Socket0 (RXD0 BLE module))
+    \param  
+    \retval 
     
+    Only the first edge is attended: it sets the WAKE_SOURCE_BLE flag of wakeSource and disables the interrupt,
+    so the rest of the bytes of the BGAPI event do not interrupt the MCU. The event is read from the UART
+    by BLECentral::readWakeUpEvent(), that rebuilds the header bytes lost while the MCU was waking up.
 */
-void enableInterruptionPCINT8(){
-  USB.println(F("Enabled PCINT8 interruption to receive notifications from the BLE module"));
-  PCMSK1 |= (1 << PCINT8);
-  PCIFR  |= (1 << PCIF1);
-  PCICR  |= (1 << PCIE1);
+void bleWakeUpInterruption(){ 
+    wakeSource |= WAKE_SOURCE_BLE;
+    halDisableBleWakeUp();
 }
 
-/*! \fn void disableInterruptionPCINT8()
-    \brief Disables the PCINT8 interrupt, which corresponds to the RX pin of socket0 where the BLE module is connected.
-    \param void
+/*! \fn void storeSensorValue(uint8_t type)
+    \brief Read a periodic sensor value and store it in the buffer
+    \param  type The type of the data, its characteristic is read by the handle table of bleCentral
     \retval void
-    
+
+    The value is read directly into the element reserved in the opened frame, and dropped if the
+    send-on-delta filter suppresses it.
+    With AGGREGATED_SAMPLES > 1 the value is added to the delta series of its type. If the series do not fit
+    in the frame anymore they are flushed to be sent in this cycle, and the value starts the next series.
+    The series are not filtered, their timestamps assume evenly spaced samples.
+    With STATISTICS_SAMPLES > 1 the value is added to the statistics of its type, the summaries are
+    stored at the TIMER_REPORT timer.
 */
-void disableInterruptionPCINT8(){
-        PCICR &= (0 << PCIE1);
+void storeSensorValue(uint8_t type){
+#if AGGREGATED_SAMPLES > 1
+    uint8_t value[SENSOR_VALUE_MAX_SIZE + 1];
+    value[0] = bleCentral.readSensorValue(type, value + 1, SENSOR_VALUE_MAX_SIZE);
+    if(value[0] == 0){
+        return;
+    }
+    if(buffer.putAggregatedData(value, type) == 0){
+        buffer.flushAggregatedData();
+        aggregatedSamples = AGGREGATED_SAMPLES;//The frame is complete, send it in this cycle
+        buffer.putAggregatedData(value, type);
+    }
+#elif STATISTICS_SAMPLES > 1
+    uint8_t value[SENSOR_VALUE_MAX_SIZE + 1];
+    value[0] = bleCentral.readSensorValue(type, value + 1, SENSOR_VALUE_MAX_SIZE);
+    buffer.putStatisticsData(value, type);
+#else
+    uint8_t value[SENSOR_VALUE_MAX_SIZE + 1];
+    uint8_t *slot = buffer.reserveDataToSend(type, SENSOR_VALUE_MAX_SIZE);
+    if(slot == NULL){
+        return;
+    }
+    value[0] = bleCentral.readSensorValue(type, slot, SENSOR_VALUE_MAX_SIZE);
+    memcpy(value + 1, slot, value[0]);
+    if((value[0] > 0) && !sendOnDelta.filter(type, rawToValue(value, buffer.isSignedType(type)), RTC.getEpochTime())){
+        TRACE(TRACE_VALUE_SUPPRESSED, type);
+        value[0] = 0;
+    }
+    buffer.commitDataToSend(value[0]);
+#endif
 }
 
-/*! \fn ISR( PCINT1_vect)
-    \brief ISR to handle the PCINT8(Pin PE0(RXD0/PCINT8/PDI)--> connected to Waspmote Socket0 (RXD0 BLE module))
-    \param  
-    \retval 
-    
-    Note: This ISR does not attend the interruption when the module wakes up for it, this is explained in the memory 
-   
+/******************************************************************************
+ * States: each one does its work and returns the stateEvent_t that selects
+ * the transition in the transitions table
+ ******************************************************************************/
+
+/*! \fn uint8_t bleScanningState()
+    \brief Scan for the BLE device
+    \retval STATE_EVENT_OK if the device has been found, STATE_EVENT_FAIL if not
 */
-ISR( PCINT1_vect){ 
-    pcint8++;
+uint8_t bleScanningState(){
+    LOG_ERRORLN(F("State: BLE_SCANNING"));
+    if(bleCentral.startScanningDevice(MAC) && bleCentral.scanReport("Thunder Sense #02735")){
+        return STATE_EVENT_OK;
+    }
+    return STATE_EVENT_FAIL;
 }
 
-/*! \fn void sleep()
-    \brief turn waspmote in sleep mode(SLEEP_MODE_PWR_DOWN)
-    \param  void
-    \retval void
-   
-    This function turn waspmote in sleep mode(SLEEP_MODE_PWR_DOWN) 
+/*! \fn uint8_t bleConnectState()
+    \brief Connect to the BLE device
+    \retval STATE_EVENT_OK if connected, STATE_EVENT_FAIL if not
 */
-void sleep(){
-    /* There are five different sleep modes in order of power saving:
-      SLEEP_MODE_IDLE - the lowest power saving mode
-      SLEEP_MODE_ADC
-      SLEEP_MODE_PWR_SAVE
-      SLEEP_MODE_STANDBY
-      SLEEP_MODE_EXT_STANDBY
-      SLEEP_MODE_PWR_DOWN - the highest power saving mode
-    */
-    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
-    sleep_mode();//Put the device into sleep mode, taking care of setting the SE bit before, and clearing it afterwards 
+uint8_t bleConnectState(){
+    LOG_ERRORLN(F("State: BLE_CONNECT"));
+    return bleCentral.connect(MAC) ? STATE_EVENT_OK : STATE_EVENT_FAIL;
 }
 
-/*! \fn void stateMachine()
-    \brief different states of the BLE-LoraWAN node
-    \param void 
-    \retval void
-    
-    This function implement the sate machine of the BLE-LoraWAN node 
+/*! \fn uint8_t discoverBLEProfileState()
+    \brief Discover the services, characteristics and descriptors of the BLE device
+    \retval STATE_EVENT_OK if discovered, STATE_EVENT_FAIL if not
 */
-void stateMachine(){
-  
-    uint8_t response = 0;
-    
-    switch(state){
-      
-        case BLE_SCANNING: 
-            #if DEBUG >= 1
-                USB.println(F("State: BLE_SCANNING"));
-            #endif
-            response = bleCentral.startScanningDevice(MAC);
-            if(response){
-                response = bleCentral.scanReport("Thunder Sense #02735");
-                if (response){
-                    state = BLE_CONNECT;	
-                }
-            }
-            break;
-            
-        case BLE_CONNECT: 
-            #if DEBUG >= 1
-                USB.println(F("State: BLE_CONNECT"));
+uint8_t discoverBLEProfileState(){
+    LOG_ERRORLN(F("State: DISCOVER_BLE_PROFILE"));
+    return bleCentral.discoverBLEProfile() ? STATE_EVENT_OK : STATE_EVENT_FAIL;
+}
+
+/*! \fn uint8_t enableBLENotificationsState()
+    \brief Enable the notifications of the Hall sensor state
+    \retval STATE_EVENT_OK
+*/
+uint8_t enableBLENotificationsState(){
+    LOG_ERRORLN(F("State: ENABLE_BLE_NOTIFICATIONS"));
+    bleCentral.enableSensorNotification(HALL_STATE_TYPE);
+    bleDisconnected = 0;
+    return STATE_EVENT_OK;
+}
+
+/*! \fn uint8_t enableInterruptionsState()
+    \brief Program the RTC alarm at the nearest timer deadline and the BLE notification interruption before sleeping
+    \retval STATE_EVENT_OK
+*/
+uint8_t enableInterruptionsState(){
+    LOG_ERRORLN(F("State: ENABLE_INTERRUPTIONS"));
+    if(wakeUpTime != 0){
+        TRACE(TRACE_WAKE_CYCLE, (uint16_t)(millis() - wakeUpTime));
+    }
+    wakeSource = 0;
+    scheduler.programAlarm();
+    LOG_INFOLN(F("Enabled PCINT8 interruption to receive notifications from the BLE module"));
+    halEnableBleWakeUp();
+    halAttachAlarm(alarmInterruption);
+    return STATE_EVENT_OK;
+}
+
+/*! \fn uint8_t sleepState()
+    \brief Sleep until the RTC alarm or a BLE event
+    \retval STATE_EVENT_OK
+
+    The node does not sleep if a wake up source was already flagged after the interrupts were enabled.
+*/
+uint8_t sleepState(){
+    LOG_ERRORLN(F("State: SLEEP"));
+    if(wakeSource == 0){
+        halSleep();
+    }
+    wakeUpTime = millis();
+    TRACE(TRACE_WAKE_UP, wakeSource);
+    LOG_INFOLN(F("Waspmote wake up"));
+    halDisableBleWakeUp();
+    return STATE_EVENT_OK;
+}
+
+/*! \fn uint8_t wakeUpAndCheckState()
+    \brief Attend the sources of the wake up: BGAPI event (Hall sensor notification or BLE disconnection) and timers due (RTC alarm)
+    \retval STATE_EVENT_DATA if there are frames to send now, STATE_EVENT_NO_DATA if not,
+            STATE_EVENT_FAIL if the BLE connection is lost and there is nothing to send
+
+    The BGAPI event is read before any command is sent to the BLE module, so it is not consumed by other waits.
+    The connection status is only asked on the RTC wake ups.
+    A lost connection queues one BLE_DISCONNECT_TYPE event. Until the notifications are enabled again the
+    timers due are taken without reading the sensors, and each wake up with nothing to send scans for the
+    device again.
+*/
+uint8_t wakeUpAndCheckState(){
+    uint8_t bleEvent = BLE_WAKE_NONE;
+    uint8_t event = STATE_EVENT_NO_DATA;
+    uint16_t dueSensors = 0;
+    LOG_ERRORLN(F("State: WAKE_UP_AND_CKECK"));
+    if(wakeSource & WAKE_SOURCE_BLE){
+        bleEvent = bleCentral.readWakeUpEvent(BGAPI_WAKE_TIMEOUT);
+        if(bleEvent == BLE_WAKE_NOTIFICATION){
+            storeNotification();
+            event = STATE_EVENT_DATA;
+        }
+    }
+    if(!bleDisconnected && ((bleEvent == BLE_WAKE_DISCONNECTED) || ((wakeSource & WAKE_SOURCE_RTC) && (bleCentral.getConnectionStatus() != 1)))){//The BLE connection has been disconnected
+        bleDisconnected = 1;//One event per outage
+        buffer.openFrame(EVENT_PORT, 1, FRAME_PRIORITY_EVENT);
+        buffer.putDataToSend(BLE_Disconnected, BLE_DISCONNECT_TYPE);
+        buffer.closeFrame();
+    }
+    if(bleDisconnected){//No sensor can be read, the timers due are taken anyway so they do not wake the node up again
+        if(wakeSource & WAKE_SOURCE_RTC){
+            takeDueTimers(&dueSensors);
+            #if STATISTICS_SAMPLES > 1
+                scheduler.takeDue(TIMER_REPORT);
             #endif
-            response = bleCentral.connect(MAC);
-            if (response){
-                state = DISCOVER_BLE_PROFILE;
-                delay(1000);	
-            }else{
-                state = BLE_SCANNING;
+        }
+        return buffer.hasDataToSend() ? STATE_EVENT_DATA : STATE_EVENT_FAIL;
+    }else if(wakeSource & WAKE_SOURCE_RTC){//Attend the timers due
+        if(takeDueTimers(&dueSensors) && buffer.hasDataToSend()){
+            event = STATE_EVENT_DATA;
+        }
+        #if STATISTICS_SAMPLES > 1
+        for(uint8_t type = UV_INDEX_TYPE; type <= FIELD_STRENGHT_TYPE; type++){
+            if(dueSensors & (1 << type)){
+                storeSensorValue(type);
             }
-            break;
-            
-        case DISCOVER_BLE_PROFILE: 
-            #if DEBUG >= 1
-                USB.println(F("State: DISCOVER_BLE_PROFILE"));
-            #endif
-            response = bleCentral.discoverBLEProfile(); 
-            if (response){
-              state = ENABLE_BLE_NOTIFICATIONS;
-            }else{
-                state = BLE_SCANNING;
+        }
+        if(!scheduler.takeDue(TIMER_REPORT)){
+            return event;
+        }
+        buffer.openFrame(DATA_PORT, 0, FRAME_PRIORITY_PERIODIC);
+        buffer.flushStatisticsData();
+        #else
+        if(dueSensors == 0){
+            return event;
+        }
+        buffer.openFrame(DATA_PORT, 0, FRAME_PRIORITY_PERIODIC);
+        for(uint8_t type = UV_INDEX_TYPE; type <= FIELD_STRENGHT_TYPE; type++){
+            if(dueSensors & (1 << type)){
+                storeSensorValue(type);
             }
-            break;
-            
-        case ENABLE_BLE_NOTIFICATIONS: 
-            #if DEBUG >= 1
-                USB.println(F("State: ENABLE_BLE_NOTIFICATIONS"));
-            #endif
-            bleCentral.enableNotification(ServiceA_Characrteristic0_State_uuid);
-            state = ENABLE_INTERRUPTIONS;
-            break;
-            
-        case ENABLE_INTERRUPTIONS: 
-            #if DEBUG >= 1
-                USB.println(F("State: ENABLE_INTERRUPTIONS"));
-            #endif
-            activateAlarm(hours, minutes);
-            enableInterruptionPCINT8();
-            attachInterrupt(RTC_INT, alarmInterruption, 1);
-            state = SLEEP;
-            break;
- 
-        case SLEEP:
-            #if DEBUG >= 1
-                USB.println(F("State: SLEEP"));
-            #endif
-            alarmFlag = 0;
-            sleep();
-            USB.println(F("Waspmote wake up"));
-            disableInterruptionPCINT8();
-            state = WAKE_UP_AND_CKECK;
-            break;
-            
-        case WAKE_UP_AND_CKECK:
-            #if DEBUG >= 1
-                USB.println(F("State: WAKE_UP_AND_CKECK"));
-            #endif
-            if(bleCentral.getConnectionStatus() != 1){//The BLE connection has been disconnected
-                buffer.putDataToSend(BLE_Disconnected, BLE_DISCONNECT_TYPE);
-            }else if( alarmFlag == 1){//Attend the Alarm, the established time has been met
-                if(sensorsBitMap[1]==1)
-                    buffer.putDataToSend(bleCentral.readAttribute(Service4_Characrteristic0_UV_Index_uuid), UV_INDEX_TYPE);
-                if(sensorsBitMap[2]==1)
-                    buffer.putDataToSend(bleCentral.readAttribute(Service4_Characrteristic1_Pressure_uuid), PRESSURE_TYPE);
-                if(sensorsBitMap[3]==1)
-                    buffer.putDataToSend(bleCentral.readAttribute(Service4_Characrteristic2_Temperature_uuid), TEMPERATURE_TYPE);
-                if(sensorsBitMap[4]==1)
-                    buffer.putDataToSend(bleCentral.readAttribute(Service4_Characrteristic4_Ambient_Light_uuid), AMBIENT_LIGHT_TYPE);
-                if(sensorsBitMap[5]==1)
-                    buffer.putDataToSend(bleCentral.readAttribute(Service4_Characrteristic5_Sound_Level_uuid), SOUND_LEVEL_TYPE);
-                if(sensorsBitMap[6]==1)
-                    buffer.putDataToSend(bleCentral.readAttribute(Service4_Characrteristic3_Humidity_uuid), HUMIDITY_TYPE);
-                if(sensorsBitMap[7]==1)
-                    buffer.putDataToSend(bleCentral.readAttribute(Service3_Characrteristic0_Battery_Level_uuid), BATTERY_LEVEL_TYPE);
-                if(sensorsBitMap[8]==1)
-                    buffer.putDataToSend(bleCentral.readAttribute(Service6_Characrteristic0_ECO2_uuid), ECO2_TYPE);
-                if(sensorsBitMap[9]==1)
-                    buffer.putDataToSend(bleCentral.readAttribute(Service6_Characrteristic1_TVOC_uuid), TVOC_TYPE);
-                if(sensorsBitMap[10]==1)
-                    buffer.putDataToSend(bleCentral.readAttribute(ServiceA_Characrteristic0_State_uuid), HALL_STATE_TYPE);
-                if(sensorsBitMap[11]==1)
-                    buffer.putDataToSend(bleCentral.readAttribute(ServiceA_Characrteristic1_Field_Strength_uuid), FIELD_STRENGHT_TYPE);
-            }else{//Attend the Hall sensor notification 
-                buffer.putDataToSend(bleCentral.receiveNotifications(), HALL_STATE_TYPE);
+        }
+        #if AGGREGATED_SAMPLES > 1
+            if(aggregatedSamples < AGGREGATED_SAMPLES){//The series were not flushed during the reads
+                if(++aggregatedSamples < AGGREGATED_SAMPLES){
+                    buffer.closeFrame();
+                    return event;
+                }
+                buffer.flushAggregatedData();
             }
-            state = LORAWAN_SEND_UPLINK;
-            break;
+            aggregatedSamples = 0;
+        #endif
+        #endif
+    }else{//Only a BGAPI event
+        return event;
+    }
+    buffer.closeFrame();
+    return buffer.hasDataToSend() ? STATE_EVENT_DATA : STATE_EVENT_NO_DATA;
+}
 
-        case LORAWAN_SEND_UPLINK:
-            #if DEBUG >= 1
-                USB.println(F("State: LORAWAN_SEND_UPLINK"));
-            #endif
-            lorawan.turnOnModule(SOCKET1);
-            lorawan.setAdaptativeDataRate("off");
-            lorawan.setAutomaticReply("on");
-            lorawan.joinABP();
-            lorawan.enableOrDisableChannel(1, "off");
-            lorawan.enableOrDisableChannel(2, "off");
-            if(alarmFlag == 1) { 
-              response = lorawan.sendUnconfirmedData(DATA_PORT, buffer.getDataToSend(), buffer.getDataToSendSize());
-            }else{
-              response = lorawan.sendConfirmedData(EVENT_PORT, buffer.getDataToSend(), buffer.getDataToSendSize());
-            }
-            if(response == 1){
-              state = LORAWAN_RECEIVE_DOWNLINK;
-            }else{
-              state = ENABLE_INTERRUPTIONS;
-            }
-            buffer.clearDataToSend();
-            lorawan.printChannelsStatus();
-            lorawan.turnOffModule();
-            USB.println(F(""));
-            break;
+/*! \fn uint8_t lorawanSendUplinkState()
+    \brief Send the pending frames, oldest first
+    \retval STATE_EVENT_DOWNLINK if downlink data has been received,
+            STATE_EVENT_FAIL if a frame could not be sent, STATE_EVENT_OK if not
+*/
+uint8_t lorawanSendUplinkState(){
+    uint8_t response = 0;
+    uint8_t event = STATE_EVENT_OK;
+    LOG_ERRORLN(F("State: LORAWAN_SEND_UPLINK"));
+    lorawan.turnOnModule(SOCKET1);
+    lorawan.setAdaptativeDataRate("off");
+    lorawan.setAutomaticReply("on");
+    lorawan.joinABP();
+    lorawan.enableOrDisableChannel(1, "off");
+    lorawan.enableOrDisableChannel(2, "off");
+    while(buffer.hasDataToSend()){//Send the pending frames, oldest first
+      if(buffer.isDataToSendConfirmed()){
+        response = lorawan.sendConfirmedData(buffer.getDataToSendPort(), buffer.getDataToSend(), buffer.getDataToSendSize());
+      }else{
+        response = lorawan.sendUnconfirmedData(buffer.getDataToSendPort(), buffer.getDataToSend(), buffer.getDataToSendSize());
+      }
+      TRACE(TRACE_LORAWAN_SEND, ((uint16_t)buffer.getDataToSendPort() << 8) | lorawan.getSendResponse());
+      if(lorawan.getSendResponse() != 0){//Not sent, the frame stays in the buffer for the next cycle
+        buffer.retryDataToSend();
+        event = STATE_EVENT_FAIL;
+        break;
+      }
+      buffer.clearDataToSend();
+      if(response == 1){//Downlink data received, attend it before sending more frames
+        event = STATE_EVENT_DOWNLINK;
+        break;
+      }
+    }
+    #if DEBUG >= LOG_LEVEL_VERBOSE
+        lorawan.printChannelsStatus();//64 module commands, only to debug
+    #endif
+    lorawan.turnOffModule();
+    LOG_INFOLN(F(""));
+    return event;
+}
 
-        case LORAWAN_RECEIVE_DOWNLINK: 
-            #if DEBUG >= 1
-                USB.println(F("State: LORAWAN_RECEIVE_DOWNLINK"));
-            #endif
-            buffer.putNetworkReceivedData( lorawan.receiveDowlinkData());
-            if(buffer.getNetworkReceivedData(0) == CONFIGURE_TIME_TYPE){
-              hours = buffer.getNetworkReceivedData(1);
-              minutes = buffer.getNetworkReceivedData(2);
-              USB.print(F("Hours received: "));
-              USB.println(hours,DEC);
-              USB.print(F("Minutes received: "));
-              USB.println(minutes,DEC);
-            }else if(buffer.getNetworkReceivedData(0) == CONFIGURE_SELECTED_SENSORS_TYPE){
-               USB.println(F("Selected sensors = "));
-              for(uint8_t i = 0; i < 12; i++){
-                sensorsBitMap[i] = buffer.getNetworkReceivedData(i);
-                USB.print(sensorsBitMap[i],DEC);
-                USB.print(F(":"));
-              }
-              USB.println(F(""));
+/*! \fn uint8_t lorawanReceiveDownlinkState()
+    \brief Attend the downlink data received
+    \retval STATE_EVENT_OK
+*/
+uint8_t lorawanReceiveDownlinkState(){
+    LOG_ERRORLN(F("State: LORAWAN_RECEIVE_DOWNLINK"));
+    buffer.putNetworkReceivedData( lorawan.receiveDowlinkData());
+    TRACE(TRACE_LORAWAN_DOWNLINK, buffer.getNetworkReceivedData(0));
+    if(buffer.getNetworkReceivedData(0) == CONFIGURE_TIME_TYPE){
+      hours = buffer.getNetworkReceivedData(1);
+      minutes = buffer.getNetworkReceivedData(2);
+      startSensorTimers();
+      LOG_INFO(F("Hours received: "));
+      LOG_INFOLN(hours,DEC);
+      LOG_INFO(F("Minutes received: "));
+      LOG_INFOLN(minutes,DEC);
+    }else if(buffer.getNetworkReceivedData(0) == CONFIGURE_SELECTED_SENSORS_TYPE){
+       LOG_INFOLN(F("Selected sensors = "));
+      for(uint8_t i = 0; i < 12; i++){
+        sensorsBitMap[i] = buffer.getNetworkReceivedData(i);
+        LOG_VERBOSE(sensorsBitMap[i],DEC);
+        LOG_VERBOSE(F(":"));
+      }
+      for(uint8_t type = UV_INDEX_TYPE; type <= FIELD_STRENGHT_TYPE; type++){//The sensors not selected do not wake the node up
+        startSensorTimer(type);
+      }
+      LOG_INFOLN(F(""));
+    }else if(buffer.getNetworkReceivedData(0) == CONFIGURE_REDUNDANCY_TYPE){
+      buffer.setRedundancy(buffer.getNetworkReceivedData(1), buffer.getNetworkReceivedData(2));
+      LOG_INFO(F("Redundancy mode received: "));
+      LOG_INFOLN(buffer.getRedundancyMode(), DEC);
+      LOG_INFO(F("Redundancy depth received: "));
+      LOG_INFOLN(buffer.getRedundancyDepth(), DEC);
+    }else if(buffer.getNetworkReceivedData(0) == CONFIGURE_SENSOR_PERIOD_TYPE){
+      if((buffer.getNetworkReceivedData(1) >= UV_INDEX_TYPE) && (buffer.getNetworkReceivedData(1) <= FIELD_STRENGHT_TYPE)){
+        sensorPeriod[buffer.getNetworkReceivedData(1)] = ((uint16_t)buffer.getNetworkReceivedData(2) << 8) | buffer.getNetworkReceivedData(3);
+        startSensorTimer(buffer.getNetworkReceivedData(1));
+        LOG_INFO(F("Sampling period received, sensor: "));
+        LOG_INFO(buffer.getNetworkReceivedData(1), DEC);
+        LOG_INFO(F(", minutes: "));
+        LOG_INFOLN(sensorPeriod[buffer.getNetworkReceivedData(1)], DEC);
+      }
+    }else if(buffer.getNetworkReceivedData(0) == CONFIGURE_SENSOR_THRESHOLD_TYPE){
+      if((buffer.getNetworkReceivedData(1) >= UV_INDEX_TYPE) && (buffer.getNetworkReceivedData(1) <= FIELD_STRENGHT_TYPE)){
+        sendOnDelta.setThreshold(buffer.getNetworkReceivedData(1), ((uint16_t)buffer.getNetworkReceivedData(2) << 8) | buffer.getNetworkReceivedData(3), buffer.getNetworkReceivedData(4));
+        sendOnDelta.forget(buffer.getNetworkReceivedData(1));//The next value is sent as the new reference
+        LOG_INFO(F("Threshold received, sensor: "));
+        LOG_INFO(buffer.getNetworkReceivedData(1), DEC);
+        LOG_INFO(F(", threshold: "));
+        LOG_INFO(sendOnDelta.getThreshold(buffer.getNetworkReceivedData(1)), DEC);
+        LOG_INFO(F(", max silence: "));
+        LOG_INFOLN(sendOnDelta.getMaxSilence(buffer.getNetworkReceivedData(1)), DEC);
+      }
+    }
+    buffer.clearNetworkReceivedData();
+    return STATE_EVENT_OK;
+}
+
+/******************************************************************************
+ * Guards and actions of the transitions
+ ******************************************************************************/
+
+/*! \fn uint8_t hasDataToSendGuard()
+    \brief Guard: there are frames pending to be sent
+*/
+uint8_t hasDataToSendGuard(){
+    return buffer.hasDataToSend();
+}
+
+/*! \fn uint8_t bleDisconnectedGuard()
+    \brief Guard: the BLE connection was lost after the setup, the node sleeps between the scans
+*/
+uint8_t bleDisconnectedGuard(){
+    return bleDisconnected;
+}
+
+/*! \fn void scheduleRetryAction()
+    \brief Action: retry the send of the pending frames after RETRY_DELAY
+*/
+void scheduleRetryAction(){
+    scheduler.start(TIMER_RETRY, RETRY_DELAY, 0);
+}
+
+/*! \fn void cancelRetryAction()
+    \brief Action: the pending frames have been sent, the retry is not needed
+*/
+void cancelRetryAction(){
+    scheduler.stop(TIMER_RETRY);
+}
+
+/*! \fn void waitConnectionAction()
+    \brief Action: let the BLE connection settle before discovering the profile
+*/
+void waitConnectionAction(){
+    delay(1000);
+}
+
+/******************************************************************************
+ * State machine
+ ******************************************************************************/
+
+/*! \var stateActions
+    \brief The function of each state, indexed by stateEnum_t
+*/
+const stateAction_t stateActions[STATES_NUMBER] = {
+    bleScanningState,
+    bleConnectState,
+    discoverBLEProfileState,
+    enableBLENotificationsState,
+    enableInterruptionsState,
+    sleepState,
+    wakeUpAndCheckState,
+    lorawanSendUplinkState,
+    lorawanReceiveDownlinkState
+};
+
+/*! \var transitions
+    \brief The transitions of the state machine, the first row that matches the state, the event and the guard is taken
+*/
+const transition_t transitions[] = {
+  /*  state                     event                 guard                  action                next state          */
+    { BLE_SCANNING,             STATE_EVENT_OK,       NULL,                  NULL,                 BLE_CONNECT              },
+    { BLE_SCANNING,             STATE_EVENT_FAIL,     bleDisconnectedGuard,  NULL,                 ENABLE_INTERRUPTIONS     },
+    { BLE_SCANNING,             STATE_EVENT_FAIL,     NULL,                  NULL,                 BLE_SCANNING             },
+    { BLE_CONNECT,              STATE_EVENT_OK,       NULL,                  waitConnectionAction, DISCOVER_BLE_PROFILE     },
+    { BLE_CONNECT,              STATE_EVENT_FAIL,     NULL,                  NULL,                 BLE_SCANNING             },
+    { DISCOVER_BLE_PROFILE,     STATE_EVENT_OK,       NULL,                  NULL,                 ENABLE_BLE_NOTIFICATIONS },
+    { DISCOVER_BLE_PROFILE,     STATE_EVENT_FAIL,     NULL,                  NULL,                 BLE_SCANNING             },
+    { ENABLE_BLE_NOTIFICATIONS, STATE_EVENT_OK,       NULL,                  NULL,                 ENABLE_INTERRUPTIONS     },
+    { ENABLE_INTERRUPTIONS,     STATE_EVENT_OK,       NULL,                  NULL,                 SLEEP                    },
+    { SLEEP,                    STATE_EVENT_OK,       NULL,                  NULL,                 WAKE_UP_AND_CKECK        },
+    { WAKE_UP_AND_CKECK,        STATE_EVENT_DATA,     NULL,                  NULL,                 LORAWAN_SEND_UPLINK      },
+    { WAKE_UP_AND_CKECK,        STATE_EVENT_NO_DATA,  NULL,                  NULL,                 ENABLE_INTERRUPTIONS     },
+    { WAKE_UP_AND_CKECK,        STATE_EVENT_FAIL,     NULL,                  NULL,                 BLE_SCANNING             },
+    { LORAWAN_SEND_UPLINK,      STATE_EVENT_DOWNLINK, NULL,                  NULL,                 LORAWAN_RECEIVE_DOWNLINK },
+    { LORAWAN_SEND_UPLINK,      STATE_EVENT_OK,       NULL,                  cancelRetryAction,    ENABLE_INTERRUPTIONS     },
+    { LORAWAN_SEND_UPLINK,      STATE_EVENT_FAIL,     NULL,                  scheduleRetryAction,  ENABLE_INTERRUPTIONS     },
+    { LORAWAN_RECEIVE_DOWNLINK, STATE_EVENT_OK,       hasDataToSendGuard,    NULL,                 LORAWAN_SEND_UPLINK      },
+    { LORAWAN_RECEIVE_DOWNLINK, STATE_EVENT_OK,       NULL,                  NULL,                 ENABLE_INTERRUPTIONS     }
+};
+
+/*! \fn void stateMachine()
+    \brief different states of the BLE-LoraWAN node
+    \param void 
+    \retval void
+    
+    This function runs the current state, takes the transition selected by its event,
+    records the dwell time of the state in stateStats and samples the RAM use in memoryStats
+*/
+void stateMachine(){
+    stateEnum_t current = state;
+    unsigned long enteredAt = millis();
+    uint8_t event;
+    TRACE(TRACE_STATE, current);
+    event = stateActions[current]();
+    for(uint8_t i = 0; i < (sizeof(transitions) / sizeof(transitions[0])); i++){
+        if((transitions[i].state == current) && (transitions[i].event == event) &&
+           ((transitions[i].guard == NULL) || transitions[i].guard())){
+            if(transitions[i].action != NULL){
+                transitions[i].action();
             }
-            buffer.clearNetworkReceivedData();
-            state = ENABLE_INTERRUPTIONS;
+            state = transitions[i].next;
             break;
+        }
     }
+    stateStats.record(current, millis() - enteredAt, event == STATE_EVENT_FAIL);
+    memoryStats.sample();
+    #if DEBUG >= LOG_LEVEL_VERBOSE
+        memoryStats.dump();
+    #endif
 }
  
 /*! \fn Setup()
@@ -322,9 +686,10 @@ void stateMachine(){
     BLE module: Turn On, and configure the BLE Scanner
  */
 void setup(){
-    USB.println(F("_______Starting setup"));
-    USB.println(F(""));
-    USB.println(F("_______Starting LoRaWAN module configuration"));
+    halPaintStack();//First, so that the stack headroom of memoryStats covers the whole run
+    LOG_INFOLN(F("_______Starting setup"));
+    LOG_INFOLN(F(""));
+    LOG_INFOLN(F("_______Starting LoRaWAN module configuration"));
     state = BLE_SCANNING;//Initial state of the State Machine (BLE-LoRaWAN Node) 
     hours = 0;//Initial hour and minute, 00:02, to receive the sensors data
     minutes = 2;
@@ -341,14 +706,22 @@ void setup(){
     lorawan.configure2OTAA(DEVICE_EUI, APP_EUI, APP_KEY);
     lorawan.saveModuleConfig();
     lorawan.joinOTAA();
+    lorawan.saveModuleConfig();//The session survives the power off of turnOffModule(), joinABP() restores it
     lorawan.turnOffModule();
-    USB.println(F("_______LoRaWAN module configuration completed"));
-    USB.println(F(""));
-    USB.println(F("_______BLE module configuration"));
+    halAttachBleWakeUp(bleWakeUpInterruption);
+    RTC.ON();//The RTC epoch is used to timestamp the uplink frames and by the scheduler
+    memcpy(sensorPeriod, defaultSensorPeriod, sizeof(sensorPeriod));
+    startSensorTimers();
+    #if (DEBUG >= LOG_LEVEL_INFO) || HEALTH_UPLINK || PROFILE_ENABLED
+        scheduler.start(TIMER_HOUSEKEEPING, HOUSEKEEPING_PERIOD, HOUSEKEEPING_PERIOD);
+    #endif
+    LOG_INFOLN(F("_______LoRaWAN module configuration completed"));
+    LOG_INFOLN(F(""));
+    LOG_INFOLN(F("_______BLE module configuration"));
     bleCentral.turnOnModule(SOCKET0);
     bleCentral.configureScanner(BLE_GAP_DISCOVER_OBSERVATION, TX_POWER, SCAN_INTERVAL, SCAN_WINDOW, BLE_PASSIVE_SCANNING);
-    USB.println(F("_______Finished setup"));
-    USB.println(F(""));
+    LOG_INFOLN(F("_______Finished setup"));
+    LOG_INFOLN(F(""));
 }
 
 /*! \fn loop()
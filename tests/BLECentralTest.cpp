@@ -0,0 +1,110 @@
+/*! \file BLECentralTest.cpp
+    \brief Unit test of the wake up event read by BLECentral::readWakeUpEvent(), with header bytes lost
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    Usage: BLECentralTest
+
+    Replays through the UART of SOCKET0 the events a BLE112 sends when the node sleeps (a notification
+    and a disconnection) with 0 to 3 bytes of the header lost, as the MCU does while it wakes up from
+    the first edge. Up to BGAPI_MAX_LOST_BYTES the event is rebuilt, with more it is not synchronised
+    and the UART is flushed. Noise before the event and events not expected on a wake up are replayed too.
+
+    Build: the BLECentralTest target of the root CMakeLists.txt
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include <string.h>
+#include <inttypes.h>
+#include "Check.h"
+#include "WaspClasses.h"
+#include "HostUart.h"
+#include "WaspBLE.h"
+#include "BLECentral.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+//attclient_attribute_value: connection 0, atthandle 0x002A, type 1, value AB CD
+static const uint8_t notification[] = {0x80, 0x07, 0x04, 0x05, 0x00, 0x2A, 0x00, 0x01, 0x02, 0xAB, 0xCD};
+//connection_disconnected: connection 0, reason 0x0213 (remote user terminated)
+static const uint8_t disconnection[] = {0x80, 0x03, 0x03, 0x04, 0x00, 0x13, 0x02};
+//system_boot, not expected on a wake up
+static const uint8_t boot[] = {0x80, 0x0C, 0x00, 0x00, 0x01, 0x00, 0x03, 0x00, 0x00, 0x00, 0x8A, 0x00, 0x01, 0x00, 0x01, 0x00};
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+/*! \fn static uint8_t replay(BLECentral &ble, const uint8_t *event, uint8_t length, uint8_t lost)
+    \brief Deliver an event without its first lost bytes and read it as a wake up event
+    \retval The bleWakeEvent_t returned by readWakeUpEvent()
+*/
+static uint8_t replay(BLECentral &ble, const uint8_t *event, uint8_t length, uint8_t lost){
+    hostUart[SOCKET0].deliver(event + lost, length - lost);
+    return ble.readWakeUpEvent(BGAPI_WAKE_TIMEOUT);
+}
+
+/*! \fn static void testLostBytes()
+    \brief The header is rebuilt with up to BGAPI_MAX_LOST_BYTES bytes lost
+*/
+static void testLostBytes(){
+    BLECentral ble;
+    uint8_t value[4];
+    for(uint8_t lost = 0; lost <= BGAPI_MAX_LOST_BYTES; lost++){
+        memset(BLE.event, 0, sizeof(BLE.event));
+        CHECK(replay(ble, notification, sizeof(notification), lost) == BLE_WAKE_NOTIFICATION);
+        CHECK(memcmp(BLE.event, notification, sizeof(notification)) == 0);
+        CHECK(ble.copyWakeUpValue(value, sizeof(value)) == 2);
+        CHECK((value[0] == 0xAB) && (value[1] == 0xCD));
+        CHECK(hostUart[SOCKET0].available() == 0);
+
+        memset(BLE.event, 0, sizeof(BLE.event));
+        CHECK(replay(ble, disconnection, sizeof(disconnection), lost) == BLE_WAKE_DISCONNECTED);
+        CHECK(memcmp(BLE.event, disconnection, sizeof(disconnection)) == 0);
+        CHECK(hostUart[SOCKET0].available() == 0);
+    }
+}
+
+/*! \fn static void testNotSynchronised()
+    \brief With more than BGAPI_MAX_LOST_BYTES lost nothing is taken and the UART is flushed
+*/
+static void testNotSynchronised(){
+    BLECentral ble;
+    CHECK(replay(ble, notification, sizeof(notification), BGAPI_MAX_LOST_BYTES + 1) == BLE_WAKE_NONE);
+    CHECK(hostUart[SOCKET0].available() == 0);
+    CHECK(replay(ble, disconnection, sizeof(disconnection), BGAPI_MAX_LOST_BYTES + 1) == BLE_WAKE_NONE);
+    CHECK(hostUart[SOCKET0].available() == 0);
+    CHECK(replay(ble, notification, sizeof(notification), 0) == BLE_WAKE_NOTIFICATION);//The next one is read
+}
+
+/*! \fn static void testOtherEvents()
+    \brief Noise before the event, and an event not expected on a wake up
+*/
+static void testOtherEvents(){
+    BLECentral ble;
+    const uint8_t noise[] = {0x13, 0x37};
+    hostUart[SOCKET0].deliver(noise, sizeof(noise));
+    CHECK(replay(ble, notification, sizeof(notification), 0) == BLE_WAKE_NOTIFICATION);
+    CHECK(memcmp(BLE.event, notification, sizeof(notification)) == 0);
+
+    CHECK(replay(ble, boot, sizeof(boot), 0) == BLE_WAKE_OTHER);
+    CHECK(memcmp(BLE.event, boot, sizeof(boot)) == 0);
+    CHECK(replay(ble, boot, sizeof(boot), 1) == BLE_WAKE_NONE);//Its header can not be rebuilt
+
+    CHECK(ble.readWakeUpEvent(BGAPI_WAKE_TIMEOUT) == BLE_WAKE_NONE);//Nothing received
+}
+
+/*! \fn int main()
+    \brief Run the checks
+    \retval 0 if all of them passed
+*/
+int main(){
+    hostUart[SOCKET0].open();
+    testLostBytes();
+    testNotSynchronised();
+    testOtherEvents();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,108 @@
+/*! \file BufferTest.cpp
+    \brief Unit test of the uplink frames built by Buffer for a full sweep of the sensors
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    Usage: BufferTest
+
+    The 11 sensors of the Thunderboard Sense 2 are stored in one DATA_PORT frame, with
+    reserveDataToSend()/commitDataToSend() as readSensor() does and with putDataToSend(). With
+    TIMESTAMPED_ELEMENTS the sweep does not fit in one frame: the elements that do not fit must go
+    to a new frame, none is dropped. The frames are decoded back with UplinkDecoder.
+
+    The BufferTimestampedTest target builds the same test with TIMESTAMPED_ELEMENTS.
+
+    Build: the BufferTest and BufferTimestampedTest targets of the root CMakeLists.txt
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include <string.h>
+#include <inttypes.h>
+#include <vector>
+#include "Check.h"
+#include "WaspClasses.h"
+#include "HostClock.h"
+#include "defines.h"
+#include "Buffer.h"
+#include "UplinkDecoder.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+//Size in bytes of the characteristic value of each UplinkTypes_t in the Thunderboard Sense 2
+static const uint8_t valueSize[12] = {1, 1, 4, 2, 4, 2, 2, 1, 2, 2, 1, 4};
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+/*! \fn static void fillValue(uint8_t type, uint8_t *value)
+    \brief Write the test value of a type, value[0] is the size
+*/
+static void fillValue(uint8_t type, uint8_t *value){
+    value[0] = valueSize[type];
+    for(uint8_t i = 1; i <= value[0]; i++){
+        value[i] = (uint8_t)(type * 16 + i);
+    }
+}
+
+/*! \fn static void checkSweep(uint8_t zeroCopy)
+    \brief Store a sweep, then every sensor must be decoded once, in order, with its value and time
+    \param zeroCopy 1 to store with reserveDataToSend(), 0 with putDataToSend()
+*/
+static void checkSweep(uint8_t zeroCopy){
+    Buffer buffer;
+    std::vector<uplinkElement_t> elements;
+    std::vector<uint32_t> epochs;
+    uint8_t value[SENSOR_VALUE_MAX_SIZE + 1];
+    uint8_t *slot;
+    uint8_t frames = 0;
+    CHECK(buffer.openFrame(DATA_PORT, 0, FRAME_PRIORITY_PERIODIC));
+    for(uint8_t type = UV_INDEX_TYPE; type <= FIELD_STRENGHT_TYPE; type++){
+        hostClock.advance(700);//Each read takes time, the offsets grow
+        epochs.push_back(RTC.getEpochTime());
+        fillValue(type, value);
+        if(zeroCopy){
+            slot = buffer.reserveDataToSend(type, SENSOR_VALUE_MAX_SIZE);
+            CHECK(slot != NULL);
+            if(slot != NULL){
+                memcpy(slot, value + 1, value[0]);
+                buffer.commitDataToSend(value[0]);
+            }
+        }else{
+            buffer.putDataToSend(value, type);
+        }
+    }
+    buffer.closeFrame();
+    CHECK(buffer.getDroppedCount(FRAME_PRIORITY_PERIODIC) == 0);
+    while(buffer.hasDataToSend()){
+        CHECK(buffer.getDataToSendPort() == DATA_PORT);
+        CHECK(buffer.getDataToSendSize() <= dataToSend_Size);
+        CHECK(decodeUplinkFrame(buffer.getDataToSend(), buffer.getDataToSendSize(), elements) > 0);
+        buffer.clearDataToSend();
+        frames++;
+    }
+    CHECK(frames == (TIMESTAMPED_ELEMENTS ? 2 : 1));
+    CHECK(elements.size() == FIELD_STRENGHT_TYPE);
+    for(uint8_t i = 0; i < elements.size(); i++){
+        fillValue(i + UV_INDEX_TYPE, value);
+        CHECK(elements[i].type == i + UV_INDEX_TYPE);
+        CHECK((elements[i].values.size() == 1) && (elements[i].values[0] == rawToValue(value, isSignedUplinkType(elements[i].type))));
+        CHECK(elements[i].timestamps.size() == (TIMESTAMPED_ELEMENTS ? 1 : 0));
+        if(!elements[i].timestamps.empty()){
+            CHECK(elements[i].timestamps[0] == epochs[i]);
+        }
+    }
+}
+
+/*! \fn int main()
+    \brief Run the checks
+    \retval 0 if all of them passed
+*/
+int main(){
+    checkSweep(1);
+    checkSweep(0);
+    return CHECK_RESULT();
+}
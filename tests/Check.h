@@ -0,0 +1,31 @@
+/*! \file Check.h
+    \brief Minimal checks of the host unit tests
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    CHECK(condition) prints the file, the line and the condition when it is false and counts
+    the failure. A test returns CHECK_RESULT(), the exit status that ctest reads.
+*/
+
+/*! \def _CHECK_H
+    \brief The library flag
+ */
+#ifndef _CHECK_H
+#define _CHECK_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stdio.h>
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+static unsigned checkFailures = 0;/*!< Number of failed checks of the test */
+
+#define CHECK(condition) do{ if(!(condition)){ checkFailures++; \
+    fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); } }while(0)/*!< Check a condition */
+
+#define CHECK_RESULT() (checkFailures == 0 ? 0 : 1)/*!< Exit status of the test */
+
+#endif
@@ -0,0 +1,95 @@
+/*! \file DeltaCodecTest.cpp
+    \brief Unit test of the zig-zag and varint coding and of the delta series
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    Usage: DeltaCodecTest
+
+    Round trips of zigzagEncode()/zigzagDecode() and varintEncode()/varintDecode() at the
+    limits of each varint length, truncated varints, and DeltaEncoder series decoded back
+    with deltaDecodeSeries().
+
+    Build: the DeltaCodecTest target of the root CMakeLists.txt
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include <string.h>
+#include <inttypes.h>
+#include "Check.h"
+#include "DeltaCodec.h"
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+/*! \fn static void testZigzag()
+    \brief Small magnitudes map to small codes and every value comes back
+*/
+static void testZigzag(){
+    const int32_t values[] = {0, -1, 1, -2, 2, 63, -64, 64, INT32_MAX, INT32_MIN};
+    CHECK(zigzagEncode(0) == 0);
+    CHECK(zigzagEncode(-1) == 1);
+    CHECK(zigzagEncode(1) == 2);
+    CHECK(zigzagEncode(INT32_MIN) == 0xFFFFFFFFUL);
+    for(uint8_t i = 0; i < sizeof(values) / sizeof(values[0]); i++){
+        CHECK(zigzagDecode(zigzagEncode(values[i])) == values[i]);
+    }
+}
+
+/*! \fn static void testVarint()
+    \brief Values at the limits of each length, and truncated varints
+*/
+static void testVarint(){
+    const uint32_t values[] = {0, 0x7F, 0x80, 0x3FFF, 0x4000, 0x1FFFFF, 0x200000, 0xFFFFFFF, 0x10000000, 0xFFFFFFFFUL};
+    const uint8_t lengths[] = {1, 1, 2, 2, 3, 3, 4, 4, 5, 5};
+    uint8_t out[VARINT_MAX_SIZE + 1];
+    uint32_t decoded;
+    uint8_t length;
+    for(uint8_t i = 0; i < sizeof(values) / sizeof(values[0]); i++){
+        length = varintEncode(values[i], out);
+        CHECK(length == lengths[i]);
+        CHECK(varintLength(values[i]) == length);
+        decoded = 0;
+        CHECK(varintDecode(out, length, &decoded) == length);
+        CHECK(decoded == values[i]);
+        CHECK(varintDecode(out, length - 1, &decoded) == 0);//Truncated
+    }
+    memset(out, 0x80, sizeof(out));
+    CHECK(varintDecode(out, sizeof(out), &decoded) == 0);//Longer than VARINT_MAX_SIZE
+}
+
+/*! \fn static void testSeries()
+    \brief A series is decoded back, and putValue() refuses the values that do not fit
+*/
+static void testSeries(){
+    const int32_t values[] = {2150, 2148, 2153, -40, 100000, 100000};
+    int32_t decoded[sizeof(values) / sizeof(values[0])];
+    DeltaEncoder encoder;
+    for(uint8_t i = 0; i < sizeof(values) / sizeof(values[0]); i++){
+        CHECK(encoder.putValue(values[i]));
+    }
+    CHECK(encoder.getCount() == sizeof(values) / sizeof(values[0]));
+    CHECK(deltaDecodeSeries(encoder.getStream(), encoder.getLength(), encoder.getCount(), decoded) == encoder.getCount());
+    CHECK(memcmp(decoded, values, sizeof(values)) == 0);
+    CHECK(deltaDecodeSeries(encoder.getStream(), encoder.getLength() - 1, encoder.getCount(), decoded) < encoder.getCount());
+
+    encoder.clear();
+    CHECK(encoder.getCount() == 0 && encoder.getLength() == 0);
+    while(encoder.putValue(encoder.getCount() * 0x1000000L)){//4 bytes per delta
+    }
+    CHECK(encoder.getLength() <= DELTA_STREAM_SIZE);
+    CHECK(encoder.getLength() + encoder.encodedLength(encoder.getCount() * 0x1000000L) > DELTA_STREAM_SIZE);
+}
+
+/*! \fn int main()
+    \brief Run the checks
+    \retval 0 if all of them passed
+*/
+int main(){
+    testZigzag();
+    testVarint();
+    testSeries();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,136 @@
+/*! \file RedundancyTest.cpp
+    \brief Unit test of the redundancy of the periodic uplinks, across the wrap of the frame history
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    Usage: RedundancyTest
+
+    Buffer closes 4 * REDUNDANCY_MAX_DEPTH unconfirmed DATA_PORT frames of different lengths, so
+    the history of the previous frames wraps several times. For every frame the redundancy element
+    is decoded with UplinkDecoder: the sequence, the depth, the copies (REDUNDANCY_COPY) and the
+    frame recovered from the parity (REDUNDANCY_PARITY) must match the frames sent before, as Buffer
+    queued them without their redundancy element.
+
+    The RedundancyTimestampedTest target builds the same test with TIMESTAMPED_ELEMENTS.
+
+    Build: the RedundancyTest and RedundancyTimestampedTest targets of the root CMakeLists.txt
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include <string.h>
+#include <inttypes.h>
+#include <vector>
+#include "Check.h"
+#include "defines.h"
+#include "Buffer.h"
+#include "UplinkDecoder.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define TEST_FRAMES (4 * REDUNDANCY_MAX_DEPTH)/*!< Frames sent, the history wraps every REDUNDANCY_MAX_DEPTH */
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+/*! \fn static std::vector<uint8_t> sendFrame(Buffer &buffer, uint8_t number, std::vector<uint8_t> &sent)
+    \brief Close a DATA_PORT frame of 1 to 4 bytes of temperature and pop it from the buffer
+    \param[out] sent The frame without the redundancy element
+    \retval The frame as queued, with the redundancy element
+*/
+static std::vector<uint8_t> sendFrame(Buffer &buffer, uint8_t number, std::vector<uint8_t> &sent){
+    uint8_t value[5];
+    std::vector<uint8_t> frame;
+    std::vector<uplinkElement_t> elements;
+    uint8_t index = 0;
+    value[0] = 1 + (number % 4);
+    for(uint8_t i = 1; i <= value[0]; i++){
+        value[i] = (uint8_t)(number * 37 + i);
+    }
+    CHECK(buffer.openFrame(DATA_PORT, 0, FRAME_PRIORITY_PERIODIC));
+    buffer.putDataToSend(value, TEMPERATURE_TYPE);
+    buffer.closeFrame();
+    CHECK(buffer.hasDataToSend());
+    frame.assign(buffer.getDataToSend(), buffer.getDataToSend() + buffer.getDataToSendSize());
+    buffer.clearDataToSend();
+    while(((index + 1) < frame.size()) && (frame[index] != REDUNDANCY_TYPE)){//The redundancy element is the last one
+        index += 2 + frame[index + 1];
+    }
+    sent.assign(frame.begin(), frame.begin() + (index < frame.size() ? index : frame.size()));
+    CHECK(decodeUplinkFrame(sent.data(), sent.size(), elements) == 1);//The temperature, with its time if timestamped
+    CHECK((elements.size() == 1) && (elements[0].type == TEMPERATURE_TYPE));
+    CHECK((elements.size() == 1) && (elements[0].values[0] == rawToValue(value, 1)));
+    return frame;
+}
+
+/*! \fn static void testCopy(uint8_t depth)
+    \brief The copies are the previous frames, newest first
+*/
+static void testCopy(uint8_t depth){
+    Buffer buffer;
+    std::vector<std::vector<uint8_t> > sent(TEST_FRAMES);
+    std::vector<uint8_t> frame;
+    redundancy_t redundancy;
+    buffer.setRedundancy(REDUNDANCY_COPY, depth);
+    for(uint8_t number = 0; number < TEST_FRAMES; number++){
+        frame = sendFrame(buffer, number, sent[number]);
+        if(number == 0){
+            CHECK(decodeRedundancy(frame.data(), frame.size(), &redundancy) == 0);
+            CHECK(frame == sent[0]);
+            continue;
+        }
+        CHECK(decodeRedundancy(frame.data(), frame.size(), &redundancy) == 1);
+        CHECK(redundancy.sequence == number);
+        CHECK(redundancy.mode == REDUNDANCY_COPY);
+        CHECK(redundancy.depth == (number < depth ? number : depth));
+        CHECK(redundancy.copies.size() == redundancy.depth);
+        for(uint8_t i = 0; i < redundancy.copies.size(); i++){
+            CHECK(redundancy.copies[i] == sent[number - 1 - i]);
+        }
+    }
+}
+
+/*! \fn static void testParity(uint8_t depth)
+    \brief Any one of the frames covered is recovered from the parity and the others
+*/
+static void testParity(uint8_t depth){
+    Buffer buffer;
+    std::vector<std::vector<uint8_t> > sent(TEST_FRAMES);
+    std::vector<const std::vector<uint8_t>*> received;
+    std::vector<uint8_t> frame;
+    std::vector<uint8_t> lost;
+    redundancy_t redundancy;
+    buffer.setRedundancy(REDUNDANCY_PARITY, depth);
+    for(uint8_t number = 0; number < TEST_FRAMES; number++){
+        frame = sendFrame(buffer, number, sent[number]);
+        if(number == 0){
+            continue;
+        }
+        CHECK(decodeRedundancy(frame.data(), frame.size(), &redundancy) == 1);
+        CHECK(redundancy.sequence == number);
+        CHECK(redundancy.depth == (number < depth ? number : depth));
+        for(uint8_t missing = 0; missing < redundancy.depth; missing++){
+            received.clear();
+            for(uint8_t i = 0; i < redundancy.depth; i++){
+                received.push_back(i == missing ? NULL : &sent[number - 1 - i]);
+            }
+            CHECK(recoverFromParity(redundancy, received, lost) == missing);
+            CHECK(lost == sent[number - 1 - missing]);
+        }
+    }
+}
+
+/*! \fn int main()
+    \brief Run the checks
+    \retval 0 if all of them passed
+*/
+int main(){
+    for(uint8_t depth = 1; depth <= REDUNDANCY_MAX_DEPTH; depth++){
+        testCopy(depth);
+        testParity(depth);
+    }
+    return CHECK_RESULT();
+}
@@ -0,0 +1,146 @@
+/*! \file RingBufferTest.cpp
+    \brief Unit test of the RingBuffer template: wrap of the slots and erase()
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    Usage: RingBufferTest
+
+    The buffer is full, emptied and erased from with the head at every position of the slots,
+    and a pseudo random sequence of operations is compared with a std::deque.
+
+    Build: the RingBufferTest target of the root CMakeLists.txt
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include <inttypes.h>
+#include <deque>
+#include "Check.h"
+#include "RingBuffer.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define TEST_SIZE 4/*!< Slots of the buffers tested, as FRAME_QUEUE_SIZE */
+
+typedef RingBuffer<uint16_t, TEST_SIZE> testBuffer_t;
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+/*! \fn static uint8_t add(testBuffer_t &ring, uint16_t value)
+    \brief reserve(), fill and push() a value
+    \retval 1 if it was stored, 0 if the buffer is full
+*/
+static uint8_t add(testBuffer_t &ring, uint16_t value){
+    uint16_t *slot = ring.reserve();
+    if(slot == NULL){
+        return 0;
+    }
+    *slot = value;
+    ring.push();
+    return 1;
+}
+
+/*! \fn static uint8_t matches(testBuffer_t &ring, const std::deque<uint16_t> &model)
+    \brief Return 1 if the buffer holds the elements of the model in the same order
+*/
+static uint8_t matches(testBuffer_t &ring, const std::deque<uint16_t> &model){
+    if(ring.size() != model.size() || ring.isEmpty() != model.empty() || ring.isFull() != (model.size() == TEST_SIZE)){
+        return 0;
+    }
+    for(uint8_t i = 0; i < model.size(); i++){
+        if((ring.at(i) == NULL) || (*ring.at(i) != model[i])){
+            return 0;
+        }
+    }
+    return (ring.at(model.size()) == NULL) && (model.empty() ? ring.front() == NULL : *ring.front() == model.front());
+}
+
+/*! \fn static void testWrap()
+    \brief Fill, erase and empty the buffer with the head at every slot
+*/
+static void testWrap(){
+    testBuffer_t ring;
+    std::deque<uint16_t> model;
+    uint16_t value = 0;
+    CHECK(ring.capacity() == TEST_SIZE);
+    CHECK(ring.front() == NULL);
+    ring.pop();//Nothing to pop
+    ring.erase(0);//Nothing to erase
+    CHECK(matches(ring, model));
+    for(uint8_t head = 0; head < 2 * TEST_SIZE; head++){
+        for(uint8_t erased = 0; erased < TEST_SIZE; erased++){
+            while(add(ring, value)){
+                model.push_back(value++);
+            }
+            CHECK(ring.reserve() == NULL);
+            CHECK(matches(ring, model));
+            ring.erase(erased);
+            model.erase(model.begin() + erased);
+            CHECK(matches(ring, model));
+            ring.erase(TEST_SIZE);//Out of range
+            CHECK(matches(ring, model));
+            while(!model.empty()){
+                ring.pop();
+                model.pop_front();
+                CHECK(matches(ring, model));
+            }
+        }
+        CHECK(add(ring, value));//Moves the head one slot
+        ring.pop();
+        value++;
+    }
+}
+
+/*! \fn static void testRandom()
+    \brief A pseudo random sequence of add(), pop() and erase() against a std::deque
+*/
+static void testRandom(){
+    testBuffer_t ring;
+    std::deque<uint16_t> model;
+    uint32_t seed = 12345;
+    uint8_t index;
+    for(uint16_t step = 0; step < 10000; step++){
+        seed = seed * 1103515245UL + 12345UL;
+        switch((seed >> 16) % 4){
+        case 0:
+        case 1:
+            if(add(ring, step)){
+                model.push_back(step);
+            }else{
+                CHECK(model.size() == TEST_SIZE);
+            }
+            break;
+        case 2:
+            ring.pop();
+            if(!model.empty()){
+                model.pop_front();
+            }
+            break;
+        default:
+            index = (seed >> 24) % (TEST_SIZE + 1);
+            ring.erase(index);
+            if(index < model.size()){
+                model.erase(model.begin() + index);
+            }
+            break;
+        }
+        CHECK(matches(ring, model));
+    }
+    ring.clear();
+    model.clear();
+    CHECK(matches(ring, model));
+}
+
+/*! \fn int main()
+    \brief Run the checks
+    \retval 0 if all of them passed
+*/
+int main(){
+    testWrap();
+    testRandom();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,127 @@
+/*! \file RunningStatsTest.cpp
+    \brief Unit test of the streaming statistics and of their summary element
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    Usage: RunningStatsTest
+
+    RunningStats against the statistics computed in double over the whole series (exact values,
+    large raw values as the pressure, negative values, one sample), and every summary encoded by
+    RunningStats::encode() decoded back with statisticsDecode(), whole and truncated.
+
+    Build: the RunningStatsTest target of the root CMakeLists.txt
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include <math.h>
+#include <inttypes.h>
+#include <vector>
+#include "Check.h"
+#include "RunningStats.h"
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+/*! \fn static void checkSeries(const std::vector<int32_t> &series)
+    \brief The statistics and the summary of a series match the ones computed in double
+*/
+static void checkSeries(const std::vector<int32_t> &series){
+    RunningStats stats;
+    uint8_t summary[STATISTICS_SUMMARY_SIZE];
+    uint8_t length;
+    uint32_t count;
+    int32_t decoded[4];
+    int32_t min = series[0];
+    int32_t max = series[0];
+    double sum = 0;
+    double squares = 0;
+    double mean;
+    double stdDev;
+    for(size_t i = 0; i < series.size(); i++){
+        stats.putValue(series[i]);
+        min = (series[i] < min) ? series[i] : min;
+        max = (series[i] > max) ? series[i] : max;
+        sum += series[i];
+    }
+    mean = sum / series.size();
+    for(size_t i = 0; i < series.size(); i++){
+        squares += (series[i] - mean) * (series[i] - mean);
+    }
+    stdDev = sqrt(squares / series.size());
+
+    CHECK(stats.getCount() == series.size());
+    CHECK(stats.getMin() == min);
+    CHECK(stats.getMax() == max);
+    CHECK(fabs(stats.getMean() - mean) <= 1);
+    CHECK(fabs(stats.getStdDev() - stdDev) <= 1);
+
+    length = stats.encode(summary);
+    CHECK((length > 0) && (length <= STATISTICS_SUMMARY_SIZE));
+    CHECK(statisticsDecode(summary, length, &count, decoded) == length);
+    CHECK(count == series.size());
+    CHECK(decoded[0] == min);
+    CHECK(decoded[1] == max);
+    CHECK((decoded[2] >= min) && (decoded[2] <= max) && (fabs(decoded[2] - mean) <= 1));
+    CHECK(decoded[3] == (int32_t)stats.getStdDev());
+    CHECK(statisticsDecode(summary, length - 1, &count, decoded) == 0);//Truncated
+}
+
+/*! \fn static void testSeries()
+    \brief Series of every kind of sensor
+*/
+static void testSeries(){
+    const int32_t exact[] = {2, 4, 4, 4, 5, 5, 7, 9};//Mean 5, standard deviation 2
+    std::vector<int32_t> series(exact, exact + sizeof(exact) / sizeof(exact[0]));
+    RunningStats stats;
+    for(size_t i = 0; i < series.size(); i++){
+        stats.putValue(series[i]);
+    }
+    CHECK(stats.getMean() == 5);
+    CHECK(stats.getStdDev() == 2);
+    checkSeries(series);
+
+    series.assign(1, -40);//One sample
+    checkSeries(series);
+
+    series.clear();
+    for(int32_t i = 0; i < 200; i++){//Pressure in Pa: large values, small changes
+        series.push_back(101325 + (i * 7919) % 41 - 20);
+    }
+    checkSeries(series);
+
+    series.clear();
+    for(int32_t i = 0; i < 100; i++){//Temperature around 0 in centidegrees
+        series.push_back((i * 31) % 400 - 250);
+    }
+    checkSeries(series);
+
+    series.assign(50, 123456);//Constant: mean on min and max
+    checkSeries(series);
+}
+
+/*! \fn static void testClear()
+    \brief clear() starts a new window
+*/
+static void testClear(){
+    RunningStats stats;
+    stats.putValue(1000);
+    stats.putValue(-1000);
+    stats.clear();
+    CHECK(stats.getCount() == 0);
+    CHECK(stats.getStdDev() == 0);
+    stats.putValue(7);
+    CHECK(stats.getMin() == 7 && stats.getMax() == 7 && stats.getMean() == 7 && stats.getStdDev() == 0);
+}
+
+/*! \fn int main()
+    \brief Run the checks
+    \retval 0 if all of them passed
+*/
+int main(){
+    testSeries();
+    testClear();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,179 @@
+/*! \file SchedulerTest.cpp
+    \brief Unit test of the Scheduler timers over the virtual clock
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    Usage: SchedulerTest
+
+    One-shot and periodic timers taken with takeDue() within SCHEDULER_SLACK, missed periods
+    skipped, timers aligned with startAligned(), and the alarm programmed by programAlarm():
+    nearest deadline, a deadline reached while awake, SCHEDULER_MAX_SLEEP and a deadline the
+    alarm already woke the node up for (the wake storm after a BLE disconnection).
+
+    Build: the SchedulerTest target of the root CMakeLists.txt
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include <inttypes.h>
+#include "Check.h"
+#include "WaspClasses.h"
+#include "HostClock.h"
+#include "Scheduler.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+static uint32_t origin = 0;/*!< Second of the virtual clock where the current check starts, the clock never goes back */
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+/*! \fn static void restart()
+    \brief Start the seconds of at() from the next second of the virtual clock
+*/
+static void restart(){
+    origin = (uint32_t)(hostClock.getTime() / 1000) + 1;
+    hostClock.setTime((uint64_t)origin * 1000);
+}
+
+/*! \fn static void at(uint32_t second)
+    \brief Move the virtual clock to a second after restart()
+*/
+static void at(uint32_t second){
+    hostClock.setTime((uint64_t)(origin + second) * 1000);
+}
+
+/*! \fn static uint32_t epoch(uint32_t second)
+    \brief Return the RTC epoch of a second after restart()
+*/
+static uint32_t epoch(uint32_t second){
+    return HOST_EPOCH_START + origin + second;
+}
+
+/*! \fn static uint32_t alarmSecond()
+    \brief Return the second after restart() the RTC Alarm 1 is set at
+*/
+static uint32_t alarmSecond(){
+    return (uint32_t)(RTC.getAlarm1Time() / 1000) - origin;
+}
+
+/*! \fn static void testOneShot()
+    \brief A one-shot timer is due SCHEDULER_SLACK seconds before its deadline and only once
+*/
+static void testOneShot(){
+    Scheduler scheduler;
+    restart();
+    CHECK(scheduler.getNextDeadline() == 0);
+    CHECK(scheduler.programAlarm() == 1);//No timer running
+    scheduler.start(0, 10, 0);
+    CHECK(scheduler.isActive(0));
+    CHECK(scheduler.getNextDeadline() == epoch(10));
+    at(10 - SCHEDULER_SLACK - 1);
+    CHECK(!scheduler.isDue(0));
+    CHECK(!scheduler.takeDue(0));
+    at(10 - SCHEDULER_SLACK);
+    CHECK(scheduler.isDue(0));
+    CHECK(scheduler.isActive(0));//isDue() does not change the timer
+    CHECK(scheduler.takeDue(0));
+    CHECK(!scheduler.isActive(0));
+    CHECK(!scheduler.takeDue(0));
+    scheduler.start(SCHEDULER_TIMERS, 10, 0);//Out of range
+    CHECK(!scheduler.isActive(SCHEDULER_TIMERS));
+    scheduler.start(1, 10, 0);
+    scheduler.stop(1);
+    CHECK(!scheduler.isActive(1));
+}
+
+/*! \fn static void testPeriodic()
+    \brief A periodic timer keeps its grid, the missed periods are skipped in one takeDue()
+*/
+static void testPeriodic(){
+    Scheduler scheduler;
+    restart();
+    scheduler.start(2, 60, 60);
+    at(61);
+    CHECK(scheduler.takeDue(2));
+    CHECK(scheduler.getNextDeadline() == epoch(120));
+    CHECK(!scheduler.takeDue(2));
+    at(350);//Deadlines 120 to 300 missed
+    CHECK(scheduler.takeDue(2));
+    CHECK(scheduler.getNextDeadline() == epoch(360));
+    CHECK(!scheduler.takeDue(2));
+    at(359);//Within the slack of 360, the next one is 420
+    CHECK(scheduler.takeDue(2));
+    CHECK(scheduler.getNextDeadline() == epoch(420));
+}
+
+/*! \fn static void testAligned()
+    \brief startAligned() restarts a timer on the grid origin + k * period
+*/
+static void testAligned(){
+    Scheduler scheduler;
+    restart();
+    at(1000);
+    scheduler.startAligned(3, epoch(100), 300);//Grid 100, 400, ..., 1000, 1300
+    CHECK(scheduler.getNextDeadline() == epoch(1300));
+    scheduler.startAligned(4, epoch(1000), 600);//A deadline now is the next one of the grid
+    scheduler.stop(3);
+    CHECK(scheduler.getNextDeadline() == epoch(1600));
+    scheduler.startAligned(5, epoch(1200), 60);//Origin in the future
+    CHECK(scheduler.getNextDeadline() == epoch(1200));
+    scheduler.startAligned(6, epoch(0), 0);//Not periodic
+    CHECK(!scheduler.isActive(6));
+}
+
+/*! \fn static void testAlarm()
+    \brief The alarm of programAlarm() for every kind of deadline
+*/
+static void testAlarm(){
+    Scheduler scheduler;
+    restart();
+    scheduler.start(0, 300, 0);
+    scheduler.start(1, 100, 100);
+    CHECK(scheduler.programAlarm() == 0);
+    CHECK(alarmSecond() == 100);//Nearest deadline
+
+    at(100);//Woken up by the alarm, the timer is taken
+    CHECK(scheduler.takeDue(1));
+    CHECK(scheduler.programAlarm() == 0);
+    CHECK(alarmSecond() == 200);
+
+    at(200);//Woken up by the alarm, the timer is not taken
+    CHECK(scheduler.programAlarm() == 0);
+    CHECK(alarmSecond() == 300);//Skipped as missed, not programmed one second ahead again
+    CHECK(scheduler.isActive(1));
+    CHECK(scheduler.getNextDeadline() == epoch(300));
+
+    at(250);//Awake until after a deadline that was never programmed
+    scheduler.start(2, 10, 0);
+    at(270);
+    CHECK(scheduler.programAlarm() == 0);
+    CHECK(alarmSecond() == 271);//Programmed one second ahead
+    CHECK(scheduler.isActive(2));
+
+    at(271);//Not taken either: the one-shot timer is stopped
+    CHECK(scheduler.programAlarm() == 0);
+    CHECK(!scheduler.isActive(2));
+    CHECK(alarmSecond() == 300);
+
+    scheduler.stop(0);
+    scheduler.stop(1);
+    scheduler.start(3, 3 * SCHEDULER_MAX_SLEEP, 0);
+    CHECK(scheduler.programAlarm() == 0);
+    CHECK(alarmSecond() == 271 + SCHEDULER_MAX_SLEEP);//Limited to SCHEDULER_MAX_SLEEP
+}
+
+/*! \fn int main()
+    \brief Run the checks
+    \retval 0 if all of them passed
+*/
+int main(){
+    testOneShot();
+    testPeriodic();
+    testAligned();
+    testAlarm();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,108 @@
+/*! \file SendOnDeltaTest.cpp
+    \brief Unit test of the send-on-delta filter: deadband, heartbeat and counters
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    Usage: SendOnDeltaTest
+
+    Values inside and outside the deadband of a type, the heartbeat after the maximum silence,
+    forget(), a threshold 0, and the counters stopping at 0xFFFF with a sane suppression rate.
+
+    Build: the SendOnDeltaTest target of the root CMakeLists.txt
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include <inttypes.h>
+#include "Check.h"
+#include "defines.h"
+#include "SendOnDelta.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define TEST_EPOCH 1792281600UL/*!< RTC epoch of the first value */
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+/*! \fn static void testDeadband()
+    \brief Only the changes of the threshold or more from the last value sent are sent
+*/
+static void testDeadband(){
+    SendOnDelta filter;
+    filter.setThreshold(TEMPERATURE_TYPE, 50, 0);
+    CHECK(filter.getThreshold(TEMPERATURE_TYPE) == 50);
+    CHECK(filter.getMaxSilence(TEMPERATURE_TYPE) == 0);
+    CHECK(filter.filter(TEMPERATURE_TYPE, 2000, TEST_EPOCH));//The first value is always sent
+    CHECK(!filter.filter(TEMPERATURE_TYPE, 2049, TEST_EPOCH + 60));
+    CHECK(!filter.filter(TEMPERATURE_TYPE, 1951, TEST_EPOCH + 120));
+    CHECK(filter.filter(TEMPERATURE_TYPE, 1950, TEST_EPOCH + 180));//Reference 1950 now
+    CHECK(!filter.filter(TEMPERATURE_TYPE, 1999, TEST_EPOCH + 240));
+    CHECK(filter.filter(TEMPERATURE_TYPE, 2000, TEST_EPOCH + 300));
+    CHECK(filter.filter(TEMPERATURE_TYPE, -2000, TEST_EPOCH + 360));//Negative values
+    CHECK(!filter.filter(TEMPERATURE_TYPE, -1951, TEST_EPOCH + 420));
+    CHECK(!filter.filter(TEMPERATURE_TYPE, -1990, TEST_EPOCH + 86400 * 30));//Never a heartbeat with silence 0
+    CHECK(filter.filter(HUMIDITY_TYPE, 5000, TEST_EPOCH));//Each type has its own reference
+    CHECK(filter.filter(SEND_ON_DELTA_TYPES, 0, TEST_EPOCH));//Types not filtered are sent, not counted
+
+    CHECK(filter.getCheckedCount() == 10);
+    CHECK(filter.getSuppressedCount() == 5);
+    CHECK(filter.getSuppressedCount(TEMPERATURE_TYPE) == 5);
+    CHECK(filter.getSuppressedCount(HUMIDITY_TYPE) == 0);
+    CHECK(filter.getSuppressionRate() == 50);
+
+    filter.forget(TEMPERATURE_TYPE);
+    CHECK(filter.filter(TEMPERATURE_TYPE, -2000, TEST_EPOCH + 480));//Sent as the new reference
+
+    filter.setThreshold(TEMPERATURE_TYPE, 0, 0);
+    CHECK(filter.filter(TEMPERATURE_TYPE, -2000, TEST_EPOCH + 540));//0 sends every value
+}
+
+/*! \fn static void testHeartbeat()
+    \brief A value inside the deadband is sent after the maximum silence of its type
+*/
+static void testHeartbeat(){
+    SendOnDelta filter;
+    filter.setThreshold(PRESSURE_TYPE, 100, 2);
+    CHECK(filter.filter(PRESSURE_TYPE, 101325, TEST_EPOCH));
+    CHECK(!filter.filter(PRESSURE_TYPE, 101325, TEST_EPOCH + 2 * 3600 - 1));
+    CHECK(filter.filter(PRESSURE_TYPE, 101325, TEST_EPOCH + 2 * 3600));
+    CHECK(!filter.filter(PRESSURE_TYPE, 101330, TEST_EPOCH + 3 * 3600));//The heartbeat restarts the silence
+    CHECK(filter.filter(PRESSURE_TYPE, 101330, TEST_EPOCH + 4 * 3600));
+}
+
+/*! \fn static void testCounters()
+    \brief The counters stop together at 0xFFFF and clearCounters() restarts them
+*/
+static void testCounters(){
+    SendOnDelta filter;
+    filter.setThreshold(UV_INDEX_TYPE, 10, 0);
+    CHECK(filter.getSuppressionRate() == 0);//Nothing filtered
+    CHECK(filter.filter(UV_INDEX_TYPE, 0, TEST_EPOCH));
+    for(uint32_t i = 1; i < 70000; i++){
+        CHECK(filter.filter(UV_INDEX_TYPE, 10 * (i / 2), TEST_EPOCH + i) == ((i % 2) == 0));//Every other value moves 10
+    }
+    CHECK(filter.getCheckedCount() == 0xFFFF);
+    CHECK(filter.getSuppressedCount() <= filter.getCheckedCount());
+    CHECK(filter.getSuppressedCount(UV_INDEX_TYPE) == filter.getSuppressedCount());
+    CHECK(filter.getSuppressionRate() == 49);
+    filter.clearCounters();
+    CHECK(filter.getCheckedCount() == 0);
+    CHECK(filter.getSuppressedCount() == 0);
+    CHECK(filter.getSuppressedCount(UV_INDEX_TYPE) == 0);
+    CHECK(filter.getSuppressionRate() == 0);
+}
+
+/*! \fn int main()
+    \brief Run the checks
+    \retval 0 if all of them passed
+*/
+int main(){
+    testDeadband();
+    testHeartbeat();
+    testCounters();
+    return CHECK_RESULT();
+}
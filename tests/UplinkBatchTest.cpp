@@ -0,0 +1,176 @@
+/*! \file UplinkBatchTest.cpp
+    \brief Unit test of the batch decoder of the uplink frames
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    Usage: UplinkBatchTest
+
+    Frames with every kind of element (raw, delta series, summary, timestamped, redundancy), an
+    empty frame and malformed ones are decoded with decodeUplinkBatch() by 1 to 8 threads. The
+    columns must hold the values expected and match decodeUplinkFrame() frame by frame, whatever
+    the number of threads.
+
+    Build: the UplinkBatchTest target of the root CMakeLists.txt
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include <inttypes.h>
+#include <vector>
+#include "Check.h"
+#include "defines.h"
+#include "DeltaCodec.h"
+#include "RunningStats.h"
+#include "UplinkDecoder.h"
+#include "UplinkBatch.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define TEST_EPOCH 1792281600UL/*!< Epoch of the timestamped frame */
+#define TEST_COPIES 50/*!< Times the frames are repeated in the batch */
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+/*! \fn static std::vector<std::vector<uint8_t> > buildFrames()
+    \brief Build one frame of each kind
+*/
+static std::vector<std::vector<uint8_t> > buildFrames(){
+    std::vector<std::vector<uint8_t> > frames;
+    std::vector<uint8_t> frame;
+    DeltaEncoder series;
+    RunningStats stats;
+    uint8_t summary[STATISTICS_SUMMARY_SIZE];
+    uint8_t length;
+
+    //0: raw elements, -2.50 ºC and 50.00 %, and a redundancy element that is skipped
+    const uint8_t raw[] = {TEMPERATURE_TYPE, 2, 0x06, 0xFF, HUMIDITY_TYPE, 2, 0x88, 0x13, REDUNDANCY_TYPE, 2, 0x05, 0x11};
+    frames.push_back(std::vector<uint8_t>(raw, raw + sizeof(raw)));
+
+    //1: delta series of the pressure and summary of the UV index
+    series.putValue(101325);
+    series.putValue(101320);
+    series.putValue(101330);
+    frame.push_back(PRESSURE_TYPE | DELTA_TYPE_FLAG);
+    frame.push_back(1 + series.getLength());
+    frame.push_back(series.getCount());
+    frame.insert(frame.end(), series.getStream(), series.getStream() + series.getLength());
+    stats.putValue(2);
+    stats.putValue(4);
+    stats.putValue(9);
+    length = stats.encode(summary);
+    frame.push_back(UV_INDEX_TYPE | STATISTICS_TYPE_FLAG);
+    frame.push_back(length);
+    frame.insert(frame.end(), summary, summary + length);
+    frames.push_back(frame);
+
+    //2: timestamped raw element, 30 s after the frame epoch
+    const uint8_t stamped[] = {FRAME_EPOCH_TYPE, 4, (uint8_t)TEST_EPOCH, (uint8_t)(TEST_EPOCH >> 8), (uint8_t)(TEST_EPOCH >> 16),
+                               (uint8_t)(TEST_EPOCH >> 24), TEMPERATURE_TYPE | TIMESTAMP_TYPE_FLAG, 3, 30, 0xD2, 0x04};
+    frames.push_back(std::vector<uint8_t>(stamped, stamped + sizeof(stamped)));
+
+    //3: empty
+    frames.push_back(std::vector<uint8_t>());
+
+    //4: malformed, the element is longer than the frame
+    const uint8_t truncated[] = {HUMIDITY_TYPE, 2, 0x88, 0x13, TEMPERATURE_TYPE, 4, 0x01};
+    frames.push_back(std::vector<uint8_t>(truncated, truncated + sizeof(truncated)));
+
+    //5: malformed, the series has less values than its count
+    const uint8_t broken[] = {PRESSURE_TYPE | DELTA_TYPE_FLAG, 3, 3, 0x02, 0x04};
+    frames.push_back(std::vector<uint8_t>(broken, broken + sizeof(broken)));
+    return frames;
+}
+
+/*! \fn static void checkValues(const uplinkColumns_t &columns)
+    \brief The values of the first copy of the frames
+*/
+static void checkValues(const uplinkColumns_t &columns){
+    uint32_t value;
+    CHECK(columns.elements[0] == 2);
+    CHECK(columns.elements[1] == 2);
+    CHECK(columns.elements[2] == 1);
+    CHECK(columns.elements[3] == 0);
+    CHECK(columns.elements[4] == -1);
+    CHECK(columns.elements[5] == -1);
+
+    value = columns.firstValue[0];
+    CHECK(columns.firstValue[1] - value == 2);
+    CHECK(columns.type[value] == TEMPERATURE_TYPE && columns.value[value] == -250 && columns.flags[value] == 0);
+    CHECK(columns.samples[value] == 1 && columns.timestamp[value] == 0);
+    CHECK(columns.type[value + 1] == HUMIDITY_TYPE && columns.value[value + 1] == 5000);
+
+    value = columns.firstValue[1];
+    CHECK(columns.firstValue[2] - value == 7);
+    CHECK(columns.type[value] == PRESSURE_TYPE && columns.flags[value] == UPLINK_VALUE_SERIES);
+    CHECK(columns.value[value] == 101325 && columns.value[value + 1] == 101320 && columns.value[value + 2] == 101330);
+    CHECK(columns.type[value + 3] == UV_INDEX_TYPE && columns.flags[value + 3] == UPLINK_VALUE_SUMMARY);
+    CHECK(columns.value[value + 3] == 2 && columns.value[value + 4] == 9 && columns.value[value + 5] == 5);//min, max, mean
+    CHECK(columns.value[value + 6] == 3);//stddev
+    CHECK(columns.samples[value + 3] == 3);
+
+    value = columns.firstValue[2];
+    CHECK(columns.firstValue[3] - value == 1);
+    CHECK(columns.value[value] == 1234 && columns.flags[value] == UPLINK_VALUE_TIMESTAMPED);
+    CHECK(columns.timestamp[value] == TEST_EPOCH + 30);
+
+    CHECK(columns.firstValue[4] == columns.firstValue[3]);//No values of the empty and malformed frames
+    CHECK(columns.firstValue[6] == columns.firstValue[3]);
+}
+
+/*! \fn static void checkReference(const uplinkBatch_t &batch, const uplinkColumns_t &columns)
+    \brief Every frame of the batch gives the values of decodeUplinkFrame()
+*/
+static void checkReference(const uplinkBatch_t &batch, const uplinkColumns_t &columns){
+    std::vector<uplinkElement_t> elements;
+    uint32_t value;
+    int decoded;
+    CHECK(columns.elements.size() == batch.lengths.size());
+    CHECK(columns.firstValue.size() == batch.lengths.size() + 1);
+    for(uint32_t frame = 0; frame < batch.lengths.size(); frame++){
+        elements.clear();
+        decoded = decodeUplinkFrame(&batch.bytes[batch.offsets[frame]], batch.lengths[frame], elements);
+        CHECK(columns.elements[frame] == decoded);
+        if(decoded < 0){
+            CHECK(columns.firstValue[frame + 1] == columns.firstValue[frame]);
+            continue;
+        }
+        value = columns.firstValue[frame];
+        for(size_t i = 0; i < elements.size(); i++){
+            for(size_t j = 0; j < elements[i].values.size(); j++, value++){
+                CHECK(columns.frame[value] == frame);
+                CHECK(columns.type[value] == elements[i].type);
+                CHECK(columns.value[value] == elements[i].values[j]);
+                CHECK(columns.timestamp[value] == (elements[i].timestamps.empty() ? 0 : elements[i].timestamps[j]));
+            }
+        }
+        CHECK(columns.firstValue[frame + 1] == value);
+    }
+}
+
+/*! \fn int main()
+    \brief Run the checks
+    \retval 0 if all of them passed
+*/
+int main(){
+    std::vector<std::vector<uint8_t> > frames = buildFrames();
+    uplinkBatch_t batch;
+    uplinkColumns_t columns;
+    uint32_t values;
+    for(uint8_t copy = 0; copy < TEST_COPIES; copy++){
+        for(size_t i = 0; i < frames.size(); i++){
+            addUplinkFrame(batch, frames[i].data(), frames[i].size());
+        }
+    }
+    for(unsigned int threads = 1; threads <= 8; threads++){
+        values = decodeUplinkBatch(batch, columns, threads);
+        CHECK(values == TEST_COPIES * 10);
+        CHECK(columns.value.size() == values);
+        checkValues(columns);
+        checkReference(batch, columns);
+    }
+    return CHECK_RESULT();
+}
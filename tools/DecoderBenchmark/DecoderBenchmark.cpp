@@ -0,0 +1,266 @@
+/*! \file DecoderBenchmark.cpp
+    \brief Throughput of the uplink frame decoders on a large batch of frames
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    Usage: DecoderBenchmark [-n frames] [-b max_payload] [-j threads] [-e malformed] [-r rounds] [-s seed]
+
+    A batch of frames in the format built by Buffer is generated with the encoders of the node
+    (DeltaEncoder, RunningStats): raw, delta series and summary elements of random types, half of
+    the frames timestamped (FRAME_EPOCH_TYPE first and TIMESTAMP_TYPE_FLAG elements), up to -b
+    bytes each (51 by default, the payload of DR0 to DR2). -e is the fraction of frames damaged,
+    truncated at a random byte or with a random byte set to 0xFF, many of them malformed.
+
+    The batch is decoded with decodeUplinkFrame() frame by frame, with decodeUplinkBatch() on one
+    thread and on -j threads (one per hardware thread by default), -r times each (3 by default)
+    into the same output, as a server decoding a stream batch after batch, and the fastest round is
+    kept. Every value, type and timestamp of the batch decoder is checked against
+    decodeUplinkFrame(). One row per decoder: wall time, frames, values and payload MB per second.
+
+    Build: the DecoderBenchmark target of the root CMakeLists.txt
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include "defines.h"
+#include "DeltaCodec.h"
+#include "RunningStats.h"
+#include "UplinkDecoder.h"
+#include "UplinkBatch.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+//Size in bytes of the characteristic value of each UplinkTypes_t in the Thunderboard Sense 2
+static const uint8_t valueSize[12] = {1, 1, 4, 2, 4, 2, 2, 1, 2, 2, 1, 4};
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+/*! \fn static uint8_t generateFrame(std::mt19937 &random, uint8_t maxPayload, uint8_t *frame)
+    \brief Build one random frame as Buffer does
+    \retval The frame length
+*/
+static uint8_t generateFrame(std::mt19937 &random, uint8_t maxPayload, uint8_t *frame){
+    uint8_t length = 0;
+    uint8_t element[2 + 2 * VARINT_MAX_SIZE + 1 + DELTA_STREAM_SIZE];
+    uint8_t elementLength;
+    uint8_t timestamped = random() & 1;
+    DeltaEncoder encoder;
+    RunningStats stats;
+    if(timestamped){
+        uint32_t epoch = 1790000000 + (random() % 10000000);
+        frame[length++] = FRAME_EPOCH_TYPE;
+        frame[length++] = 4;
+        for(uint8_t i = 0; i < 4; i++){
+            frame[length++] = epoch >> (8 * i);
+        }
+    }
+    while(1){
+        uint8_t type = UV_INDEX_TYPE + random() % (FIELD_STRENGHT_TYPE - UV_INDEX_TYPE + 1);
+        uint8_t kind = random() % 10;
+        elementLength = 2;
+        element[0] = type | (timestamped ? TIMESTAMP_TYPE_FLAG : 0);
+        if(kind < 6){
+            if(timestamped){
+                elementLength += varintEncode(random() % 600, element + elementLength);
+            }
+            for(uint8_t i = 0; i < valueSize[type]; i++){
+                element[elementLength++] = random();
+            }
+        }else if(kind < 8){
+            int32_t value = (int32_t)(random() % 100000) - 50000;
+            element[0] |= DELTA_TYPE_FLAG;
+            if(timestamped){
+                elementLength += varintEncode(zigzagEncode((int32_t)(random() % 600) - 60), element + elementLength);
+                elementLength += varintEncode(30 + random() % 300, element + elementLength);
+            }
+            encoder.clear();
+            for(uint8_t i = 2 + random() % 7; (i > 0) && encoder.putValue(value); i--){
+                value += (int32_t)(random() % 41) - 20;
+            }
+            element[elementLength++] = encoder.getCount();
+            memcpy(element + elementLength, encoder.getStream(), encoder.getLength());
+            elementLength += encoder.getLength();
+        }else{
+            int32_t value = (int32_t)(random() % 100000) - 50000;
+            element[0] |= STATISTICS_TYPE_FLAG;
+            if(timestamped){
+                elementLength += varintEncode(random() % 600, element + elementLength);
+            }
+            stats.clear();
+            for(uint8_t i = 2 + random() % 30; i > 0; i--){
+                stats.putValue(value + (int32_t)(random() % 201) - 100);
+            }
+            elementLength += stats.encode(element + elementLength);
+        }
+        element[1] = elementLength - 2;
+        if((length + elementLength) > maxPayload){
+            return length;
+        }
+        memcpy(frame + length, element, elementLength);
+        length += elementLength;
+    }
+}
+
+/*! \fn static uint32_t checkColumns(const uplinkBatch_t &batch, const uplinkColumns_t &columns)
+    \brief Compare the batch decoder with decodeUplinkFrame()
+    \retval The number of frames that differ
+*/
+static uint32_t checkColumns(const uplinkBatch_t &batch, const uplinkColumns_t &columns){
+    uint32_t errors = 0;
+    std::vector<uplinkElement_t> elements;
+    for(uint32_t index = 0; index < batch.lengths.size(); index++){
+        elements.clear();
+        int decoded = decodeUplinkFrame(batch.bytes.data() + batch.offsets[index], batch.lengths[index], elements);
+        uint32_t value = columns.firstValue[index];
+        uint8_t equal = (decoded == columns.elements[index]);
+        for(size_t i = 0; equal && (decoded >= 0) && (i < elements.size()); i++){
+            for(size_t j = 0; equal && (j < elements[i].values.size()); j++, value++){
+                equal = (value < columns.firstValue[index + 1]) && (columns.frame[value] == index)
+                        && (columns.type[value] == elements[i].type) && (columns.value[value] == elements[i].values[j])
+                        && (columns.timestamp[value] == (elements[i].timestamps.empty() ? 0
+                            : elements[i].timestamps[elements[i].isSeries ? j : 0]))
+                        && (elements[i].isSeries || (columns.samples[value] == (elements[i].isSummary ? elements[i].samples : 1)));
+            }
+        }
+        if(!equal || ((decoded >= 0) && (value != columns.firstValue[index + 1]))){
+            errors++;
+        }
+    }
+    return errors;
+}
+
+/*! \fn static void printRow(const char *label, double seconds, uint32_t frames, uint64_t values, uint64_t bytes)
+    \brief Print the throughput of one decoder
+*/
+static void printRow(const char *label, double seconds, uint32_t frames, uint64_t values, uint64_t bytes){
+    printf("%-20s %9.3f %12.0f %12.0f %9.1f\n", label, seconds, frames / seconds, values / seconds,
+           bytes / seconds / 1e6);
+}
+
+/*! \fn int main(int argc, char **argv)
+    \brief Benchmark entry point
+*/
+int main(int argc, char **argv){
+    uint32_t frames = 1000000;
+    unsigned int maxPayload = 51;
+    unsigned int threads = std::thread::hardware_concurrency();
+    double malformed = 0.01;
+    unsigned int rounds = 3;
+    double best;
+    unsigned long seed = 1;
+    uint8_t frame[255];
+    uplinkBatch_t batch;
+    uplinkColumns_t columns;
+    std::vector<uplinkElement_t> elements;
+    uint64_t values = 0;
+    uint32_t rejected = 0;
+    char label[32];
+    for(int arg = 1; arg < argc; arg++){
+        if((arg + 1) >= argc){
+            fprintf(stderr, "Missing value of %s\n", argv[arg]);
+            return 1;
+        }else if(strcmp(argv[arg], "-n") == 0){
+            frames = strtoul(argv[++arg], NULL, 10);
+        }else if(strcmp(argv[arg], "-b") == 0){
+            maxPayload = atoi(argv[++arg]);
+        }else if(strcmp(argv[arg], "-j") == 0){
+            threads = atoi(argv[++arg]);
+        }else if(strcmp(argv[arg], "-e") == 0){
+            malformed = atof(argv[++arg]);
+        }else if(strcmp(argv[arg], "-r") == 0){
+            rounds = atoi(argv[++arg]);
+        }else if(strcmp(argv[arg], "-s") == 0){
+            seed = strtoul(argv[++arg], NULL, 10);
+        }else{
+            fprintf(stderr, "Unknown option %s\n", argv[arg]);
+            return 1;
+        }
+    }
+    if((maxPayload < 16) || (maxPayload > 255)){
+        fprintf(stderr, "The payload must be 16 to 255 bytes\n");
+        return 1;
+    }
+    if(threads == 0){
+        threads = 1;
+    }
+    if(rounds == 0){
+        rounds = 1;
+    }
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    batch.offsets.reserve(frames);
+    batch.lengths.reserve(frames);
+    batch.bytes.reserve((size_t)frames * maxPayload);
+    for(uint32_t i = 0; i < frames; i++){
+        uint8_t length = generateFrame(random, maxPayload, frame);
+        if((length > 1) && (uniform(random) < malformed)){
+            if(random() & 1){
+                length = 1 + random() % (length - 1);
+            }else{
+                frame[random() % length] = 0xFF;
+            }
+        }
+        addUplinkFrame(batch, frame, length);
+    }
+
+    printf("Decoder benchmark: %u frames, %.1f MB, up to %u bytes, %.3f damaged, seed %lu\n", frames,
+           batch.bytes.size() / 1e6, maxPayload, malformed, seed);
+    printf("%-20s %9s %12s %12s %9s\n", "decoder", "wall_s", "frames/s", "values/s", "MB/s");
+    best = 0;
+    for(unsigned int round = 0; round < rounds; round++){
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        values = 0;
+        rejected = 0;
+        for(uint32_t i = 0; i < frames; i++){
+            elements.clear();
+            if(decodeUplinkFrame(batch.bytes.data() + batch.offsets[i], batch.lengths[i], elements) < 0){
+                rejected++;
+                continue;
+            }
+            for(size_t j = 0; j < elements.size(); j++){
+                values += elements[j].values.size();
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if((round == 0) || (seconds < best)){
+            best = seconds;
+        }
+    }
+    printRow("decodeUplinkFrame", best, frames, values, batch.bytes.size());
+    for(unsigned int run = 0; run < 2; run++){
+        unsigned int used = (run == 0) ? 1 : threads;
+        uint32_t decoded = 0;
+        if((run == 1) && (threads == 1)){
+            break;
+        }
+        for(unsigned int round = 0; round < rounds; round++){
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            decoded = decodeUplinkBatch(batch, columns, used);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if((round == 0) || (seconds < best)){
+                best = seconds;
+            }
+        }
+        snprintf(label, sizeof(label), "batch, %u thread%s", used, (used > 1) ? "s" : "");
+        printRow(label, best, frames, decoded, batch.bytes.size());
+        if(decoded != values){
+            printf("  %u values, %llu expected\n", decoded, (unsigned long long)values);
+        }
+    }
+    uint32_t errors = checkColumns(batch, columns);
+    printf("%llu values, %u malformed frames, %u frames decoded differently\n", (unsigned long long)values,
+           rejected, errors);
+    return (errors == 0) ? 0 : 2;
+}
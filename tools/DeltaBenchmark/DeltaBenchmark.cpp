@@ -0,0 +1,172 @@
+/*! \file DeltaBenchmark.cpp
+    \brief Compression ratio of the delta series against the raw uplink elements
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    Usage: DeltaBenchmark [-n samples_per_frame] [trace.csv ...]
+
+    A trace is a Thunderboard Sense 2 recording, one reading per line: "type,value"
+    (type as UplinkTypes_t, value as the decoded integer of the characteristic). Lines
+    starting with '#' are ignored. Without traces a synthetic random walk is used and
+    the report says so.
+
+    For every trace and sensor the readings are grouped in frames of n samples and the
+    size of n raw elements ([type][lenght][value]) is compared with one delta series
+    element. Every series is decoded back with UplinkDecoder to check the round trip.
+
+    Build: the DeltaBenchmark target of the root CMakeLists.txt
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <algorithm>
+#include <vector>
+#include "defines.h"
+#include "DeltaCodec.h"
+#include "UplinkDecoder.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+//Size in bytes of the characteristic value of each UplinkTypes_t in the Thunderboard Sense 2
+static const uint8_t valueSize[12] = {1, 1, 4, 2, 4, 2, 2, 1, 2, 2, 1, 4};
+
+typedef struct {
+  uint32_t rawBytes;/**< Bytes used by the raw elements */
+  uint32_t deltaBytes;/**< Bytes used by the delta series elements */
+  uint32_t samples;/**< Number of samples */
+  uint32_t errors;/**< Round trip errors */
+}result_t;
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+/*! \fn static int loadTrace(const char *path, std::vector<int32_t> series[12])
+    \brief Load a "type,value" trace
+    \retval 0 if OK, -1 if the file can not be read
+*/
+static int loadTrace(const char *path, std::vector<int32_t> series[12]){
+    char line[128];
+    int type;
+    long value;
+    FILE *file = fopen(path, "r");
+    if(file == NULL){
+        return -1;
+    }
+    while(fgets(line, sizeof(line), file) != NULL){
+        if((line[0] == '#') || (sscanf(line, "%d,%ld", &type, &value) != 2)){
+            continue;
+        }
+        if((type > BLE_DISCONNECT_TYPE) && (type <= FIELD_STRENGHT_TYPE)){
+            series[type].push_back((int32_t)value);
+        }
+    }
+    fclose(file);
+    return 0;
+}
+
+/*! \fn static void syntheticTrace(std::vector<int32_t> series[12], uint32_t samples)
+    \brief Random walk around typical indoor values, used when no trace is given
+*/
+static void syntheticTrace(std::vector<int32_t> series[12], uint32_t samples){
+    static const int32_t start[12] = {0, 1, 1013250, 2150, 4000, 35, 4500, 100, 400, 20, 1, 0};
+    static const int32_t step[12]  = {0, 1, 30, 5, 200, 4, 20, 1, 15, 5, 0, 10};
+    srand(1);
+    for(uint8_t type = UV_INDEX_TYPE; type <= FIELD_STRENGHT_TYPE; type++){
+        int32_t value = start[type];
+        for(uint32_t i = 0; i < samples; i++){
+            series[type].push_back(value);
+            if(step[type] > 0){
+                value += (rand() % (2 * step[type] + 1)) - step[type];
+            }
+        }
+    }
+}
+
+/*! \fn static void compress(uint8_t type, const std::vector<int32_t> &values, uint8_t perFrame, result_t *result)
+    \brief Encode the series of one sensor in frames of perFrame samples and accumulate the sizes
+*/
+static void compress(uint8_t type, const std::vector<int32_t> &values, uint8_t perFrame, result_t *result){
+    DeltaEncoder encoder;
+    uint8_t frame[3 + DELTA_STREAM_SIZE];
+    size_t i = 0;
+    while(i < values.size()){
+        encoder.clear();
+        size_t first = i;
+        while((i < values.size()) && (encoder.getCount() < perFrame) && encoder.putValue(values[i])){
+            i++;
+        }
+        result->samples += encoder.getCount();
+        result->rawBytes += encoder.getCount() * (2 + valueSize[type]);
+        result->deltaBytes += 3 + encoder.getLength();
+        frame[0] = type | DELTA_TYPE_FLAG;
+        frame[1] = encoder.getLength() + 1;
+        frame[2] = encoder.getCount();
+        memcpy(frame + 3, encoder.getStream(), encoder.getLength());
+        std::vector<uplinkElement_t> elements;
+        if((decodeUplinkFrame(frame, 3 + encoder.getLength(), elements) != 1) ||
+           (elements[0].values.size() != (i - first)) ||
+           !std::equal(elements[0].values.begin(), elements[0].values.end(), values.begin() + first)){
+            result->errors++;
+        }
+    }
+}
+
+/*! \fn static void report(const char *name, std::vector<int32_t> series[12], uint8_t perFrame)
+    \brief Print the compression ratio of every sensor of a trace
+*/
+static void report(const char *name, std::vector<int32_t> series[12], uint8_t perFrame){
+    result_t total = {0, 0, 0, 0};
+    printf("%s (%u samples per frame)\n", name, perFrame);
+    printf("  %-6s %10s %10s %10s %8s\n", "type", "samples", "raw B", "delta B", "ratio");
+    for(uint8_t type = UV_INDEX_TYPE; type <= FIELD_STRENGHT_TYPE; type++){
+        result_t result = {0, 0, 0, 0};
+        if(series[type].empty()){
+            continue;
+        }
+        compress(type, series[type], perFrame, &result);
+        printf("  %-6u %10u %10u %10u %8.2f%s\n", type, result.samples, result.rawBytes, result.deltaBytes,
+               (double)result.rawBytes / result.deltaBytes, result.errors ? "  ROUND TRIP ERROR" : "");
+        total.samples += result.samples;
+        total.rawBytes += result.rawBytes;
+        total.deltaBytes += result.deltaBytes;
+        total.errors += result.errors;
+    }
+    if(total.deltaBytes > 0){
+        printf("  %-6s %10u %10u %10u %8.2f\n", "all", total.samples, total.rawBytes, total.deltaBytes,
+               (double)total.rawBytes / total.deltaBytes);
+    }
+}
+
+/*! \fn int main(int argc, char **argv)
+    \brief Benchmark entry point
+*/
+int main(int argc, char **argv){
+    uint8_t perFrame = 4;
+    int traces = 0;
+    for(int arg = 1; arg < argc; arg++){
+        if((strcmp(argv[arg], "-n") == 0) && ((arg + 1) < argc)){
+            perFrame = (uint8_t)atoi(argv[++arg]);
+            continue;
+        }
+        std::vector<int32_t> series[12];
+        if(loadTrace(argv[arg], series) != 0){
+            fprintf(stderr, "Can not read %s\n", argv[arg]);
+            return 1;
+        }
+        report(argv[arg], series, perFrame);
+        traces++;
+    }
+    if(traces == 0){
+        std::vector<int32_t> series[12];
+        syntheticTrace(series, 1000);
+        report("synthetic random walk (no trace given)", series, perFrame);
+    }
+    return 0;
+}
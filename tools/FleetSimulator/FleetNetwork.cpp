@@ -0,0 +1,239 @@
+/*! \file FleetNetwork.cpp
+    \brief Single channel LoRa gateway and network server shared by the nodes of a fleet simulation
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include "FleetNetwork.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define MS_PER_DAY 86400000.0
+#define FLEET_RSSI_MIN -120.0/*!< dBm of the farthest node */
+#define FLEET_RSSI_MAX -70.0/*!< dBm of the nearest node */
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS                                                          *
+ ******************************************************************************/
+
+/*! \fn void setPublished(uint32_t node, uint64_t time)
+    \brief Raise the published time of a node, it never goes back
+*/
+void FleetNetwork::setPublished(uint32_t node, uint64_t time){
+    if(time <= published[node]){
+        return;
+    }
+    clocks.erase(clocks.find(published[node]));
+    published[node] = time;
+    clocks.insert(time);
+}
+
+/*! \fn uint8_t gatewayFree(uint64_t start, uint64_t end)
+    \brief 1 if the gateway does not transmit in [start, end)
+*/
+uint8_t FleetNetwork::gatewayFree(uint64_t start, uint64_t end){
+    for(size_t i = 0; i < gatewayTx.size(); i++){
+        if((gatewayTx[i].first < end) && (gatewayTx[i].second > start)){
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*! \fn void resolve(waiter_t *waiter)
+    \brief Outcome of a transmission, all the transmissions overlapping it are known
+
+    Only the transmissions starting less than maxAirtime before it can overlap it, so the cost does
+    not grow with the number of transmissions kept in the air.
+*/
+void FleetNetwork::resolve(waiter_t *waiter){
+    rn2483Reception_t *reception = waiter->reception;
+    uint8_t collided = 0;
+    uint8_t due;
+    uint16_t length;
+    uint32_t airtime;
+    uint64_t rx;
+    uint64_t first = (waiter->start > maxAirtime) ? waiter->start - maxAirtime : 0;
+    std::multimap<uint64_t, transmission_t>::iterator last = air.lower_bound(waiter->end);
+    for(std::multimap<uint64_t, transmission_t>::iterator i = air.lower_bound(first); i != last; i++){
+        transmission_t *other = &i->second;
+        if((other->node == waiter->node) && (other->start == waiter->start)){
+            other->resolved = 1;
+        }else if((other->end > waiter->start) && (rssi[waiter->node] < rssi[other->node] + captureDb)){
+            collided = 1;
+        }
+    }
+    stats.transmissions++;
+    reception->received = 0;
+    reception->window = 0;
+    reception->airtime = 0;
+    reception->hasData = 0;
+    if(collided){
+        stats.collisions++;
+        return;
+    }
+    if(!gatewayFree(waiter->start, waiter->end)){
+        stats.gatewayBusy++;
+        return;
+    }
+    reception->received = 1;
+    if((int64_t)waiter->counter > lastCounter[waiter->node]){
+        lastCounter[waiter->node] = waiter->counter;
+        stats.delivered++;
+    }
+    due = !downlinks[waiter->node].empty() && (downlinks[waiter->node].front() <= waiter->end);
+    if(!waiter->confirmed && !due){
+        return;
+    }
+    length = due ? (sizeof(FLEET_DOWNLINK_DATA) - 1) / 2 : 0;
+    rx = waiter->end + FLEET_RX1_DELAY;
+    airtime = Rn2483Emulator::timeOnAir(FLEET_RX1_DATA_RATE, length);
+    reception->window = 1;
+    if(!gatewayFree(rx, rx + airtime)){
+        rx = waiter->end + FLEET_RX2_DELAY;
+        airtime = Rn2483Emulator::timeOnAir(FLEET_RX2_DATA_RATE, length);
+        reception->window = 2;
+        if(!gatewayFree(rx, rx + airtime)){
+            reception->window = 0;
+            stats.answersLost++;
+            return;
+        }
+    }
+    gatewayTx.push_back(std::make_pair(rx, rx + airtime));
+    reception->airtime = airtime;
+    if(waiter->confirmed){
+        stats.acknowledgements++;
+    }
+    if(due){
+        reception->hasData = 1;
+        reception->downlink.port = FLEET_DOWNLINK_PORT;
+        reception->downlink.data = FLEET_DOWNLINK_DATA;
+        stats.latencies.push_back(rx - downlinks[waiter->node].front());
+        downlinks[waiter->node].pop_front();
+        stats.downlinksSent++;
+    }
+}
+
+/*! \fn void resolveReady()
+    \brief Resolve, earliest first, the transmissions ending before every published time
+*/
+void FleetNetwork::resolveReady(){
+    while(!waiters.empty() && (waiters.begin()->first <= *clocks.begin())){
+        waiter_t *waiter = waiters.begin()->second;
+        waiters.erase(waiters.begin());
+        resolve(waiter);
+        waiter->done = 1;
+        waiter->ready.notify_one();
+    }
+    forget();
+}
+
+/*! \fn void forget()
+    \brief Drop the transmissions that can not overlap a transmission not resolved yet
+
+    The earliest end of the waiters less maxAirtime bounds their starts, so the horizon does not
+    need a pass over every waiting node on each publish().
+*/
+void FleetNetwork::forget(){
+    uint64_t horizon = *clocks.begin();
+    if(!waiters.empty() && (waiters.begin()->first < horizon + maxAirtime)){
+        horizon = (waiters.begin()->first > maxAirtime) ? waiters.begin()->first - maxAirtime : 0;
+    }
+    while(!air.empty() && air.begin()->second.resolved && (air.begin()->second.end < horizon)){
+        air.erase(air.begin());
+    }
+    while(!gatewayTx.empty() && (gatewayTx.front().second < horizon)){
+        gatewayTx.pop_front();
+    }
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS                                                           *
+ ******************************************************************************/
+
+/*! class constructor
+  \param boot             Virtual time each node starts at
+  \param end              Virtual time the run ends at, the downlinks are queued before it
+  \param downlinksPerDay  Mean downlinks queued per node and day (Poisson process)
+  \param capture          Capture threshold in dB
+  \param seed             Seed of the node distances and of the downlink times
+*/
+FleetNetwork::FleetNetwork(const std::vector<uint64_t> &boot, uint64_t end, double downlinksPerDay, double capture, uint32_t seed){
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<double> power(FLEET_RSSI_MIN, FLEET_RSSI_MAX);
+    captureDb = capture;
+    maxAirtime = 0;
+    published = boot;
+    clocks.insert(boot.begin(), boot.end());
+    rssi.resize(boot.size());
+    downlinks.resize(boot.size());
+    lastCounter.assign(boot.size(), -1);
+    stats.transmissions = 0;
+    stats.collisions = 0;
+    stats.gatewayBusy = 0;
+    stats.delivered = 0;
+    stats.acknowledgements = 0;
+    stats.answersLost = 0;
+    stats.downlinksQueued = 0;
+    stats.downlinksSent = 0;
+    for(size_t node = 0; node < boot.size(); node++){
+        rssi[node] = power(random);
+        if(downlinksPerDay <= 0){
+            continue;
+        }
+        std::exponential_distribution<double> interval(downlinksPerDay / MS_PER_DAY);
+        for(double time = boot[node] + interval(random); time < end; time += interval(random)){
+            downlinks[node].push_back((uint64_t)time);
+            stats.downlinksQueued++;
+        }
+    }
+}
+
+/*! \fn void publish(uint32_t node, uint64_t time)
+    \brief The node will not start a transmission before time (HOST_NEVER when it has finished)
+*/
+void FleetNetwork::publish(uint32_t node, uint64_t time){
+    std::lock_guard<std::mutex> guard(lock);
+    if(time > published[node]){
+        setPublished(node, time);
+        resolveReady();
+    }
+}
+
+/*! \fn void uplink(uint32_t node, uint64_t start, uint32_t airtime, uint8_t confirmed, uint32_t counter, rn2483Reception_t *reception)
+    \brief Transmit an uplink and wait for its outcome
+*/
+void FleetNetwork::uplink(uint32_t node, uint64_t start, uint32_t airtime, uint8_t confirmed, uint32_t counter, rn2483Reception_t *reception){
+    std::unique_lock<std::mutex> guard(lock);
+    waiter_t waiter;
+    transmission_t transmission = {node, start, start + airtime, 0};
+    waiter.node = node;
+    waiter.start = start;
+    waiter.end = start + airtime;
+    waiter.confirmed = confirmed;
+    waiter.counter = counter;
+    waiter.reception = reception;
+    waiter.done = 0;
+    if(airtime > maxAirtime){
+        maxAirtime = airtime;
+    }
+    air.insert(std::make_pair(start, transmission));
+    waiters.insert(std::make_pair(waiter.end, &waiter));
+    setPublished(node, waiter.end);
+    resolveReady();
+    while(!waiter.done){
+        waiter.ready.wait(guard);
+    }
+}
+
+/*! \fn fleetStats_t getStats()
+    \brief The counters of the run
+*/
+fleetStats_t FleetNetwork::getStats(){
+    std::lock_guard<std::mutex> guard(lock);
+    return stats;
+}
@@ -0,0 +1,158 @@
+/*! \file FleetNetwork.h
+    \brief Single channel LoRa gateway and network server shared by the nodes of a fleet simulation
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    Every node runs in its own thread with its own virtual clock. A transmission is resolved when
+    every other node has published a virtual time after its end, so all the transmissions that
+    overlap it are known (conservative synchronisation). A node waiting for a transmission publishes
+    its end, as it does nothing else until then, so the earliest transmission can always be resolved.
+
+    Channel: one frequency and one spreading factor (the LoPy4 nano-gateway). Two overlapping
+    transmissions collide unless one is received captureDb stronger than each of the others. The
+    gateway is half duplex: an uplink overlapping one of its downlinks is lost.
+
+    Network server: it acknowledges the confirmed uplinks, deduplicates the retransmissions by
+    frame counter and sends the downlinks queued for a node after its next uplink, in RX1 or, if
+    the gateway is busy then, in RX2. The downlink latency is measured from the queueing time.
+*/
+
+/*! \def _FLEETNETWORK_H
+    \brief The library flag
+ */
+#ifndef _FLEETNETWORK_H
+#define _FLEETNETWORK_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <vector>
+#include "Rn2483Emulator.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define FLEET_RX1_DELAY 1000/*!< ms from the end of an uplink to RX1 */
+#define FLEET_RX2_DELAY 2000/*!< ms from the end of an uplink to RX2 */
+#define FLEET_RX1_DATA_RATE 5/*!< RX1 uses the data rate of the uplink, DR5 in this firmware */
+#define FLEET_RX2_DATA_RATE 0/*!< EU868 RX2 default, SF12 */
+#define FLEET_DOWNLINK_PORT 2/*!< FPort of the downlinks queued */
+#define FLEET_DOWNLINK_DATA "34303330303030"/*!< Type 4 downlink: temperature period 0, the default (Buffer.cpp) */
+
+/*! \struct fleetStats_t
+    \brief  Counters of the channel and of the network server
+ */
+typedef struct {
+  uint32_t transmissions;/**< Transmissions resolved, retransmissions included */
+  uint32_t collisions;/**< Transmissions lost by a collision */
+  uint32_t gatewayBusy;/**< Transmissions lost because the gateway was transmitting */
+  uint32_t delivered;/**< Uplinks received, without the retransmissions */
+  uint32_t acknowledgements;/**< Answers sent to confirmed uplinks */
+  uint32_t answersLost;/**< Answers not sent because the gateway was busy in RX1 and RX2 */
+  uint32_t downlinksQueued;/**< Downlinks queued up to the end of the run */
+  uint32_t downlinksSent;/**< Downlinks sent */
+  std::vector<uint64_t> latencies;/**< ms from queueing to sending of each downlink sent */
+}fleetStats_t;
+
+/******************************************************************************
+ * Class                                                                      *
+ ******************************************************************************/
+
+//! FleetNetwork Class
+/*!
+  Channel, gateway and network server of the fleet, shared by the node threads
+ */
+class FleetNetwork{
+
+/// private types //////////////
+private:
+
+    typedef struct {
+      uint32_t node;/**< Transmitting node */
+      uint64_t start;/**< Virtual time of the start */
+      uint64_t end;/**< Virtual time of the end */
+      uint8_t resolved;/**< The outcome is known */
+    }transmission_t;
+
+    typedef struct {
+      uint32_t node;/**< Waiting node */
+      uint64_t start;/**< The transmission */
+      uint64_t end;
+      uint8_t confirmed;
+      uint32_t counter;/**< Frame counter */
+      rn2483Reception_t *reception;/**< Where the outcome is written */
+      uint8_t done;/**< The outcome is written */
+      std::condition_variable ready;/**< Signalled when done */
+    }waiter_t;
+
+/// private attributes //////////////
+private:
+
+    std::mutex lock;/*!< Protects everything below */
+    std::vector<uint64_t> published;/*!< Lower bound of the virtual time of each node */
+    std::multiset<uint64_t> clocks;/*!< The published times, to find the minimum */
+    std::multimap<uint64_t, transmission_t> air;/*!< Transmissions not old enough to be forgotten, by start */
+    uint32_t maxAirtime;/*!< Longest transmission seen, bounds the starts that may overlap a transmission */
+    std::deque<std::pair<uint64_t, uint64_t> > gatewayTx;/*!< Downlink transmissions of the gateway */
+    std::multimap<uint64_t, waiter_t*> waiters;/*!< Transmissions waiting to be resolved, by end */
+    std::vector<double> rssi;/*!< Received power of each node at the gateway in dBm */
+    std::vector<std::deque<uint64_t> > downlinks;/*!< Queueing times of the downlinks of each node */
+    std::vector<int64_t> lastCounter;/*!< Last frame counter received from each node */
+    double captureDb;/*!< Capture threshold */
+    fleetStats_t stats;/*!< Counters */
+
+/// private methods //////////////////////////
+private:
+
+    void setPublished(uint32_t node, uint64_t time);
+
+    uint8_t gatewayFree(uint64_t start, uint64_t end);
+
+    void resolve(waiter_t *waiter);
+
+    void resolveReady();
+
+    void forget();
+
+/// public methods ////////////
+public:
+
+    FleetNetwork(const std::vector<uint64_t> &boot, uint64_t end, double downlinksPerDay, double capture, uint32_t seed);
+
+    void publish(uint32_t node, uint64_t time);
+
+    void uplink(uint32_t node, uint64_t start, uint32_t airtime, uint8_t confirmed, uint32_t counter, rn2483Reception_t *reception);
+
+    fleetStats_t getStats();
+};
+
+//! FleetNode Class
+/*!
+  The FleetNetwork seen by the RN2483 emulator of one node
+ */
+class FleetNode : public Rn2483Network{
+
+/// private attributes //////////////
+private:
+
+    FleetNetwork *network;/*!< The fleet */
+    uint32_t node;/*!< Index of the node */
+
+/// public methods ////////////
+public:
+
+    FleetNode(FleetNetwork *fleet, uint32_t index){ network = fleet; node = index; }
+
+    void uplink(uint64_t start, uint32_t airtime, uint8_t confirmed, uint32_t counter, rn2483Reception_t *reception){
+        network->uplink(node, start, airtime, confirmed, counter, reception);
+    }
+};
+
+#endif
@@ -0,0 +1,215 @@
+/*! \file FleetSimulator.cpp
+    \brief Fleet of nodes sharing a single channel gateway: delivery, collisions and downlink latency
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    Usage: FleetSimulator [-N nodes,...] [-p policy,...] [-d days] [-q downlinks_per_day]
+                          [-c capture_db] [-s seed]
+
+    Each node is main.pde on the host build, with its own Ble112Emulator and Rn2483Emulator, in
+    its own thread (the node globals are thread_local). The RN2483 emulators transmit through one
+    FleetNetwork: single channel and spreading factor, as the LoPy4 nano-gateway the firmware is
+    configured for (channels 1 and 2 disabled, DR5).
+
+    Cost: a node takes about 0.1 s of CPU per simulated day, mostly its own polling loops, and the
+    threads share the cores of the machine: 2000 nodes for 1 day and one policy take about 200 s on
+    one core, and the three policies three times that. A pool of workers stepping several nodes
+    each would need to swap every global of main.pde between the steps, so each node keeps its
+    thread and the node count is limited by the threads the system allows.
+
+    Schedule policies, the boot time of each node within the 2 minutes base period of the firmware:
+      sync     every node boots at the same time (e.g. after a power cut)
+      stagger  the boots are evenly spread over the period
+      random   the boots are uniformly random over the period
+
+    One row per node count and policy: uplinks, transmissions (retries included), delivery ratio
+    (uplinks received by the network server), collision and gateway busy rates per transmission,
+    downlinks sent out of the queued ones and their latency from queueing.
+
+    Build: the FleetSimulator target of the root CMakeLists.txt
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include "WaspClasses.h"
+#include "Ble112Emulator.h"
+#include "Rn2483Emulator.h"
+#include "FleetNetwork.h"
+#include "main.pde"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define MS_PER_DAY 86400000ULL
+#define BASE_PERIOD 120000ULL/*!< ms of the base sampling period of the firmware (hours = 0, minutes = 2) */
+
+/*! \struct nodeResult_t
+    \brief  Counters of the RN2483 of one node at the end of the run
+ */
+typedef struct {
+  uint32_t uplinks;/**< mac tx */
+  uint32_t transmissions;/**< Transmissions, retransmissions included */
+}nodeResult_t;
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+/*! \fn static void runNode(FleetNetwork *fleet, uint32_t index, uint64_t boot, uint64_t end, uint32_t seed, nodeResult_t *result)
+    \brief Thread of one node: setup() at boot, loop() until end
+*/
+static void runNode(FleetNetwork *fleet, uint32_t index, uint64_t boot, uint64_t end, uint32_t seed, nodeResult_t *result){
+    FleetNode network(fleet, index);
+    Ble112Emulator ble(seed);
+    Rn2483Emulator lora(seed + 1);
+    ble.setHallEventsPerDay(24);
+    lora.setNetwork(&network);
+    hostUart[SOCKET0].attach(&ble);
+    hostUart[SOCKET1].attach(&lora);
+    USB.setStream(NULL);
+    hostClock.setTime(boot);
+    setup();
+    fleet->publish(index, hostClock.getTime());
+    while(hostClock.getTime() < end){
+        loop();
+        fleet->publish(index, hostClock.getTime());
+    }
+    result->uplinks = lora.getUplinks();
+    result->transmissions = lora.getTransmissions();
+    fleet->publish(index, HOST_NEVER);
+}
+
+/*! \fn static uint64_t bootTime(const std::string &policy, uint32_t index, uint32_t nodes, std::mt19937 *random)
+    \brief Boot time of a node under a schedule policy
+*/
+static uint64_t bootTime(const std::string &policy, uint32_t index, uint32_t nodes, std::mt19937 *random){
+    if(policy == "stagger"){
+        return index * BASE_PERIOD / nodes;
+    }
+    if(policy == "random"){
+        return std::uniform_int_distribution<uint64_t>(0, BASE_PERIOD - 1)(*random);
+    }
+    return 0;
+}
+
+/*! \fn static void runFleet(uint32_t nodes, const std::string &policy, unsigned int days, double downlinksPerDay, double capture, uint32_t seed)
+    \brief Simulate a fleet and print its row
+*/
+static void runFleet(uint32_t nodes, const std::string &policy, unsigned int days, double downlinksPerDay, double capture, uint32_t seed){
+    std::mt19937 random(seed);
+    std::vector<uint64_t> boot(nodes);
+    std::vector<nodeResult_t> results(nodes);
+    std::vector<std::thread> threads;
+    uint64_t end = days * MS_PER_DAY;
+    uint32_t uplinks = 0;
+    uint32_t transmissions = 0;
+    double latency = 0;
+    uint64_t p95 = 0;
+    for(uint32_t node = 0; node < nodes; node++){
+        boot[node] = bootTime(policy, node, nodes, &random);
+    }
+    FleetNetwork fleet(boot, end, downlinksPerDay, capture, seed);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(uint32_t node = 0; node < nodes; node++){
+        threads.push_back(std::thread(runNode, &fleet, node, boot[node], end, seed * 7919 + node * 2, &results[node]));
+    }
+    for(uint32_t node = 0; node < nodes; node++){
+        threads[node].join();
+        uplinks += results[node].uplinks;
+        transmissions += results[node].transmissions;
+    }
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fleetStats_t stats = fleet.getStats();
+    if(!stats.latencies.empty()){
+        std::sort(stats.latencies.begin(), stats.latencies.end());
+        for(size_t i = 0; i < stats.latencies.size(); i++){
+            latency += stats.latencies[i];
+        }
+        latency /= stats.latencies.size();
+        p95 = stats.latencies[(stats.latencies.size() * 95) / 100];
+    }
+    printf("%6u %-8s %8u %8u %9.2f %9.2f %9.2f %5u/%-5u %9.1f %9.1f %8.1f\n", nodes, policy.c_str(), uplinks,
+           transmissions, uplinks ? 100.0 * stats.delivered / uplinks : 0.0,
+           transmissions ? 100.0 * stats.collisions / transmissions : 0.0,
+           transmissions ? 100.0 * stats.gatewayBusy / transmissions : 0.0,
+           stats.downlinksSent, stats.downlinksQueued, latency / 1000.0, p95 / 1000.0, wall);
+    fflush(stdout);
+}
+
+/*! \fn static std::vector<std::string> split(const char *list)
+    \brief Split a comma separated list
+*/
+static std::vector<std::string> split(const char *list){
+    std::vector<std::string> items;
+    std::string item;
+    for(const char *c = list; ; c++){
+        if((*c == ',') || (*c == '\0')){
+            if(!item.empty()){
+                items.push_back(item);
+            }
+            item.clear();
+            if(*c == '\0'){
+                break;
+            }
+        }else{
+            item.push_back(*c);
+        }
+    }
+    return items;
+}
+
+/*! \fn int main(int argc, char **argv)
+    \brief Simulator entry point
+*/
+int main(int argc, char **argv){
+    std::vector<std::string> counts = split("10,50,100");
+    std::vector<std::string> policies = split("sync,stagger,random");
+    unsigned int days = 1;
+    double downlinksPerDay = 4;
+    double capture = 6;
+    unsigned long seed = 1;
+    for(int arg = 1; arg < argc; arg++){
+        if((arg + 1) >= argc){
+            fprintf(stderr, "Missing value of %s\n", argv[arg]);
+            return 1;
+        }else if(strcmp(argv[arg], "-N") == 0){
+            counts = split(argv[++arg]);
+        }else if(strcmp(argv[arg], "-p") == 0){
+            policies = split(argv[++arg]);
+        }else if(strcmp(argv[arg], "-d") == 0){
+            days = atoi(argv[++arg]);
+        }else if(strcmp(argv[arg], "-q") == 0){
+            downlinksPerDay = atof(argv[++arg]);
+        }else if(strcmp(argv[arg], "-c") == 0){
+            capture = atof(argv[++arg]);
+        }else if(strcmp(argv[arg], "-s") == 0){
+            seed = strtoul(argv[++arg], NULL, 10);
+        }else{
+            fprintf(stderr, "Unknown option %s\n", argv[arg]);
+            return 1;
+        }
+    }
+    for(size_t i = 0; i < policies.size(); i++){
+        if((policies[i] != "sync") && (policies[i] != "stagger") && (policies[i] != "random")){
+            fprintf(stderr, "Unknown policy %s\n", policies[i].c_str());
+            return 1;
+        }
+    }
+    if(days == 0){
+        days = 1;
+    }
+    printf("Fleet: %u days, %.1f downlinks/node/day, capture %.1f dB, seed %lu\n", days, downlinksPerDay, capture, seed);
+    printf("%6s %-8s %8s %8s %9s %9s %9s %11s %9s %9s %8s\n", "nodes", "policy", "uplinks", "tx",
+           "deliv_%", "collis_%", "gwbusy_%", "downlinks", "dl_lat_s", "dl_p95_s", "wall_s");
+    for(size_t i = 0; i < counts.size(); i++){
+        for(size_t j = 0; j < policies.size(); j++){
+            runFleet(atoi(counts[i].c_str()), policies[j], days, downlinksPerDay, capture, seed);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,196 @@
+/*! \file GattBenchmark.cpp
+    \brief Deterministic benchmark of the BLECentral discovery and read procedures against the emulated BLE112
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    Usage: GattBenchmark [-g description_file] [-i interval_ms] [-l latency_ms] [-r read_rounds]
+                         [-m mac] [-n name] [-s seed] [-v]
+
+    BLECentral runs on the host build (host/) against a Ble112Emulator on SOCKET0 serving the
+    Thunderboard Sense 2 database of defines.h, or the database of a description file given with -g
+    (Thunderboard.gatt is the default database written as a description file). The run scans,
+    connects, discovers the services, the characteristics and the descriptors, enables the Hall
+    notifications, reads every sensor characteristic of sensorUuid -r times, reads the device name and
+    the Device Information strings -r times with the read long procedure and disconnects. A value
+    longer than 22 bytes (a text characteristic of a description file) is read in several chunks.
+
+    Options: -i ms between the events of a GATT procedure and -l ms from a command to its response
+    (they override the description file), -m and -n peripheral searched, -v node logs on stderr.
+
+    One row per phase: result, virtual ms, BGAPI commands, bytes written to the BLE112, bytes read
+    from it and wall time. The virtual timeline only depends on the options, so two discovery or
+    read strategies can be compared row by row.
+
+    Build: the GattBenchmark target of the root CMakeLists.txt
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include <chrono>
+#include "WaspClasses.h"
+#include "Ble112Emulator.h"
+#include "BLECentral.h"
+#include "defines.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+
+/*! \struct benchmarkCounters_t
+    \brief  Cumulated counters, a phase is the difference of two samples
+ */
+typedef struct {
+  uint64_t time;/**< Virtual ms */
+  uint32_t commands;/**< BGAPI commands */
+  uint64_t written;/**< Bytes written to the BLE112 */
+  uint64_t read;/**< Bytes read from the BLE112 */
+  std::chrono::steady_clock::time_point wall;/**< Wall time */
+}benchmarkCounters_t;
+
+/*! \var longValues
+    \brief Characteristics read with readLongAttributeValue(): the device name and the Device Information strings
+ */
+static uint8_t *longValues[] = {
+    Service0_Characrteristic0_Device_Name_uuid,
+    Service2_Characrteristic0_Manufacturer_Name_uuid,
+    Service2_Characrteristic1_Model_Number_uuid,
+    Service2_Characrteristic2_Serial_Number_uuid,
+    Service2_Characrteristic3_Hardware_Revision_uuid,
+    Service2_Characrteristic4_Firmware_Revision_uuid
+};
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+/*! \fn static benchmarkCounters_t sample(Ble112Emulator *ble)
+    \brief The cumulated counters at the current virtual time
+*/
+static benchmarkCounters_t sample(Ble112Emulator *ble){
+    benchmarkCounters_t counters;
+    counters.time = hostClock.getTime();
+    counters.commands = ble->getCommands();
+    counters.written = ble->getBytesReceived();
+    counters.read = ble->getBytesSent();
+    counters.wall = std::chrono::steady_clock::now();
+    return counters;
+}
+
+/*! \fn static void printRow(const char *label, uint8_t ok, const benchmarkCounters_t *from, const benchmarkCounters_t *to)
+    \brief Print the activity between two samples
+*/
+static void printRow(const char *label, uint8_t ok, const benchmarkCounters_t *from, const benchmarkCounters_t *to){
+    printf("%-16s %4s %10llu %9u %9llu %9llu %10.0f\n", label, ok ? "ok" : "FAIL",
+           (unsigned long long)(to->time - from->time), to->commands - from->commands,
+           (unsigned long long)(to->written - from->written), (unsigned long long)(to->read - from->read),
+           std::chrono::duration<double, std::micro>(to->wall - from->wall).count());
+}
+
+/*! \fn int main(int argc, char **argv)
+    \brief Benchmark entry point
+*/
+int main(int argc, char **argv){
+    const char *description = NULL;
+    long interval = -1;
+    long latency = -1;
+    unsigned int rounds = 10;
+    char mac[13] = "000b57a90aaf";
+    char name[32] = "Thunder Sense #02735";
+    unsigned long seed = 1;
+    uint8_t verbose = 0;
+    uint8_t value[SENSOR_VALUE_MAX_SIZE];
+    uint8_t longValue[ATT_MAX_VALUE_LENGTH];
+    uint8_t ok;
+    uint8_t all = 1;
+    for(int arg = 1; arg < argc; arg++){
+        if((strcmp(argv[arg], "-v") == 0)){
+            verbose = 1;
+        }else if((arg + 1) >= argc){
+            fprintf(stderr, "Missing value of %s\n", argv[arg]);
+            return 1;
+        }else if(strcmp(argv[arg], "-g") == 0){
+            description = argv[++arg];
+        }else if(strcmp(argv[arg], "-i") == 0){
+            interval = atol(argv[++arg]);
+        }else if(strcmp(argv[arg], "-l") == 0){
+            latency = atol(argv[++arg]);
+        }else if(strcmp(argv[arg], "-r") == 0){
+            rounds = atoi(argv[++arg]);
+        }else if(strcmp(argv[arg], "-m") == 0){
+            strncpy(mac, argv[++arg], sizeof(mac) - 1);
+        }else if(strcmp(argv[arg], "-n") == 0){
+            strncpy(name, argv[++arg], sizeof(name) - 1);
+        }else if(strcmp(argv[arg], "-s") == 0){
+            seed = strtoul(argv[++arg], NULL, 10);
+        }else{
+            fprintf(stderr, "Unknown option %s\n", argv[arg]);
+            return 1;
+        }
+    }
+    Ble112Emulator ble(seed);
+    if(description != NULL){
+        uint16_t error = ble.loadDatabase(description);
+        if(error == BLE112_FILE_ERROR){
+            fprintf(stderr, "Cannot open %s\n", description);
+            return 1;
+        }else if(error != 0){
+            fprintf(stderr, "%s:%u: invalid directive\n", description, error);
+            return 1;
+        }
+    }
+    if(interval >= 0){
+        ble.setConnectionInterval(interval);
+    }
+    if(latency >= 0){
+        ble.setResponseLatency(latency);
+    }
+    hostUart[SOCKET0].attach(&ble);
+    USB.setStream(verbose ? stderr : NULL);
+    BLECentral central;
+
+    printf("GATT benchmark: %s (%u attributes), %u read rounds, seed %lu\n",
+           (description != NULL) ? description : "default Thunderboard Sense 2", ble.getAttributes(), rounds, seed);
+    printf("%-16s %4s %10s %9s %9s %9s %10s\n", "phase", "", "virtual_ms", "commands", "bytes_out", "bytes_in", "wall_us");
+    central.turnOnModule(SOCKET0);
+    central.configureScanner(BLE_GAP_DISCOVER_OBSERVATION, TX_POWER, SCAN_INTERVAL, SCAN_WINDOW, BLE_PASSIVE_SCANNING);
+    benchmarkCounters_t first = sample(&ble);
+    benchmarkCounters_t previous = first;
+    benchmarkCounters_t current;
+    for(uint8_t phase = 0; phase < 9; phase++){
+        static const char *labels[9] = {"scan", "connect", "services", "characteristics", "descriptors",
+                                        "notify", "reads", "long reads", "disconnect"};
+        switch(phase){
+            case 0: ok = (central.startScanningDevice(mac) == 1) && central.scanReport(name); break;
+            case 1: ok = central.connect(mac) == 1; break;
+            case 2: ok = central.discoverServices(); break;
+            case 3: ok = central.discoverCharacteristics(); break;
+            case 4: ok = central.discoverDescriptors(); break;
+            case 5: ok = central.enableNotification(ServiceA_Characrteristic0_State_uuid) != 0; break;
+            case 6:
+                ok = 1;
+                for(unsigned int round = 0; round < rounds; round++){
+                    for(uint8_t type = UV_INDEX_TYPE; type <= FIELD_STRENGHT_TYPE; type++){
+                        ok &= central.readAttributeValue(sensorUuid[type], value, sizeof(value)) != 0;
+                    }
+                }
+                break;
+            case 7:
+                ok = 1;
+                for(unsigned int round = 0; round < rounds; round++){
+                    for(uint8_t i = 0; i < (sizeof(longValues) / sizeof(longValues[0])); i++){
+                        ok &= central.readLongAttributeValue(longValues[i], longValue, sizeof(longValue)) != 0;
+                    }
+                }
+                break;
+            default: ok = central.disconnect(central.getConnectionHandler()) == 0; break;
+        }
+        current = sample(&ble);
+        printRow(labels[phase], ok, &previous, &current);
+        previous = current;
+        all &= ok;
+    }
+    printRow("total", all, &first, &previous);
+    central.turnOffModule();
+    return all ? 0 : 2;
+}
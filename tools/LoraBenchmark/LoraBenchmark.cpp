@@ -0,0 +1,222 @@
+/*! \file LoraBenchmark.cpp
+    \brief Deterministic benchmark of the LoraWan uplink path against the emulated RN2483
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    Usage: LoraBenchmark [-n cycles] [-f frames_per_cycle] [-b payload_bytes] [-p period_s] [-c]
+                         [-l loss] [-q downlinks] [-D] [-O] [-s seed] [-v]
+
+    LoraWan runs on the host build (host/) against a Rn2483Emulator on SOCKET1. The setup phase
+    configures the module and joins as setup() of main.pde does. Each cycle then runs the sequence
+    of lorawanSendUplinkState(): module on, ADR off, automatic reply on, join ABP, channels 1 and 2
+    off, -f frames of -b bytes, channel report (verbose builds only) and module off, and the next cycle
+    starts -p seconds later. A frame not sent ends its cycle, as in the node.
+
+    Options: -c confirmed frames, -l probability of losing each transmission, -q downlinks queued
+    in the network server before the first cycle, -D duty cycle of the channels enforced, -O the
+    module is switched off with turnOffModule2() (UART closed, mux left on) instead of
+    turnOffModule() (mux off and UART closed), -v node logs on stderr.
+
+    One row per phase: virtual time, commands, bytes written to the RN2483 and read from it, time
+    the module has been powered, uplinks, uplinks delivered, frames not sent, no_free_ch answers,
+    time on air and delivered payload bytes per second powered. Then the commands by name.
+
+    Build: the LoraBenchmark target of the root CMakeLists.txt
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include "WaspClasses.h"
+#include "Rn2483Emulator.h"
+#include "LoraWan.h"
+#include "Log.h"
+#include "defines.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define BENCHMARK_PORT 3/*!< FPort of the frames */
+
+/*! \struct benchmarkCounters_t
+    \brief  Cumulated counters, a phase is the difference of two samples
+ */
+typedef struct {
+  uint64_t time;/**< Virtual ms */
+  uint32_t commands;/**< Commands */
+  uint64_t written;/**< Bytes written to the RN2483 */
+  uint64_t read;/**< Bytes read from the RN2483 */
+  uint64_t moduleOn;/**< ms the RN2483 has been powered */
+  uint32_t uplinks;/**< mac tx transmitted */
+  uint32_t delivered;/**< Uplinks received by the network */
+  uint32_t deliveredBytes;/**< Payload bytes received by the network */
+  uint32_t noFreeChannel;/**< no_free_ch answers */
+  uint64_t tx;/**< ms transmitting */
+}benchmarkCounters_t;
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+/*! \fn static benchmarkCounters_t sample(Rn2483Emulator *lora)
+    \brief The cumulated counters at the current virtual time
+*/
+static benchmarkCounters_t sample(Rn2483Emulator *lora){
+    benchmarkCounters_t counters;
+    counters.time = hostClock.getTime();
+    counters.commands = lora->getCommands();
+    counters.written = lora->getBytesReceived();
+    counters.read = lora->getBytesSent();
+    counters.moduleOn = hostUart[SOCKET1].getOpenedTime();
+    counters.uplinks = lora->getUplinks();
+    counters.delivered = lora->getDelivered();
+    counters.deliveredBytes = lora->getDeliveredBytes();
+    counters.noFreeChannel = lora->getNoFreeChannel();
+    counters.tx = lora->getTxTime();
+    return counters;
+}
+
+/*! \fn static void printRow(const char *label, uint32_t failed, const benchmarkCounters_t *from, const benchmarkCounters_t *to)
+    \brief Print the activity between two samples
+*/
+static void printRow(const char *label, uint32_t failed, const benchmarkCounters_t *from, const benchmarkCounters_t *to){
+    double moduleOn = (to->moduleOn - from->moduleOn) / 1000.0;
+    printf("%-8s %10.1f %8u %9llu %9llu %11.1f %7u %9u %6u %10u %9.2f %11.2f\n", label,
+           (to->time - from->time) / 1000.0, to->commands - from->commands,
+           (unsigned long long)(to->written - from->written), (unsigned long long)(to->read - from->read),
+           moduleOn, to->uplinks - from->uplinks, to->delivered - from->delivered, failed,
+           to->noFreeChannel - from->noFreeChannel, (to->tx - from->tx) / 1000.0,
+           (moduleOn > 0) ? (to->deliveredBytes - from->deliveredBytes) / moduleOn : 0.0);
+}
+
+/*! \fn int main(int argc, char **argv)
+    \brief Benchmark entry point
+*/
+int main(int argc, char **argv){
+    static char deviceEui[] = "00D994825A4CEA00";
+    static char appEui[] = "0000000000000000";
+    static char appKey[] = "170957426080C62A29819A7D656368E4";
+    unsigned int cycles = 100;
+    unsigned int frames = 4;
+    unsigned int payload = 20;
+    unsigned long period = 120;
+    uint8_t confirmed = 0;
+    double loss = 0;
+    unsigned int downlinks = 0;
+    uint8_t dutyCycle = 0;
+    uint8_t closeUart = 0;
+    unsigned long seed = 1;
+    uint8_t verbose = 0;
+    uint8_t data[LORAWAN_MAX_PAYLOAD];
+    uint32_t failed = 0;
+    for(int arg = 1; arg < argc; arg++){
+        if(strcmp(argv[arg], "-v") == 0){
+            verbose = 1;
+        }else if(strcmp(argv[arg], "-c") == 0){
+            confirmed = 1;
+        }else if(strcmp(argv[arg], "-D") == 0){
+            dutyCycle = 1;
+        }else if(strcmp(argv[arg], "-O") == 0){
+            closeUart = 1;
+        }else if((arg + 1) >= argc){
+            fprintf(stderr, "Missing value of %s\n", argv[arg]);
+            return 1;
+        }else if(strcmp(argv[arg], "-n") == 0){
+            cycles = atoi(argv[++arg]);
+        }else if(strcmp(argv[arg], "-f") == 0){
+            frames = atoi(argv[++arg]);
+        }else if(strcmp(argv[arg], "-b") == 0){
+            payload = atoi(argv[++arg]);
+        }else if(strcmp(argv[arg], "-p") == 0){
+            period = strtoul(argv[++arg], NULL, 10);
+        }else if(strcmp(argv[arg], "-l") == 0){
+            loss = atof(argv[++arg]);
+        }else if(strcmp(argv[arg], "-q") == 0){
+            downlinks = atoi(argv[++arg]);
+        }else if(strcmp(argv[arg], "-s") == 0){
+            seed = strtoul(argv[++arg], NULL, 10);
+        }else{
+            fprintf(stderr, "Unknown option %s\n", argv[arg]);
+            return 1;
+        }
+    }
+    if(payload > LORAWAN_MAX_PAYLOAD){
+        payload = LORAWAN_MAX_PAYLOAD;
+    }
+    for(unsigned int i = 0; i < payload; i++){
+        data[i] = i;
+    }
+    Rn2483Emulator lora(seed);
+    lora.setLossProbability(loss);
+    lora.setDutyCycle(dutyCycle);
+    for(unsigned int i = 0; i < downlinks; i++){
+        lora.queueDownlink(2, "00");
+    }
+    hostUart[SOCKET1].attach(&lora);
+    USB.setStream(verbose ? stderr : NULL);
+    LoraWan lorawan;
+
+    printf("LoRaWAN benchmark: %u cycles of %u %s frames of %u bytes every %lu s, loss %.3f, duty cycle %s, %s, seed %lu\n",
+           cycles, frames, confirmed ? "confirmed" : "unconfirmed", payload, period, loss, dutyCycle ? "on" : "off",
+           closeUart ? "turnOffModule2(), UART closed" : "turnOffModule(), mux off and UART closed", seed);
+    printf("%-8s %10s %8s %9s %9s %11s %7s %9s %6s %10s %9s %11s\n", "phase", "virtual_s", "commands", "bytes_out",
+           "bytes_in", "module_on_s", "uplinks", "delivered", "failed", "no_free_ch", "airtime_s", "goodput_Bps");
+    benchmarkCounters_t first = sample(&lora);
+    lorawan.turnOnModule(SOCKET1);
+    lorawan.enableOrDisableChannel(1, "off");
+    lorawan.enableOrDisableChannel(2, "off");
+    lorawan.setChannelDataRateRange(0, 5, 5);
+    lorawan.setRetries(2);
+    lorawan.getTxPower();
+    lorawan.setAdaptativeDataRate("off");
+    lorawan.configure2OTAA(deviceEui, appEui, appKey);
+    lorawan.saveModuleConfig();
+    lorawan.joinOTAA();
+    lorawan.saveModuleConfig();
+    if(closeUart){
+        lorawan.turnOffModule2(SOCKET1);
+    }else{
+        lorawan.turnOffModule();
+    }
+    benchmarkCounters_t setup = sample(&lora);
+    printRow("setup", 0, &first, &setup);
+    lora.resetCounters();
+    setup = sample(&lora);
+    for(unsigned int cycle = 0; cycle < cycles; cycle++){
+        hostClock.setTime(setup.time + (uint64_t)cycle * period * 1000);
+        lorawan.turnOnModule(SOCKET1);
+        lorawan.setAdaptativeDataRate("off");
+        lorawan.setAutomaticReply("on");
+        lorawan.joinABP();
+        lorawan.enableOrDisableChannel(1, "off");
+        lorawan.enableOrDisableChannel(2, "off");
+        for(unsigned int frame = 0; frame < frames; frame++){
+            if(confirmed){
+                lorawan.sendConfirmedData(BENCHMARK_PORT, data, payload);
+            }else{
+                lorawan.sendUnconfirmedData(BENCHMARK_PORT, data, payload);
+            }
+            if(lorawan.getSendResponse() != 0){
+                failed += frames - frame;
+                break;
+            }
+        }
+        #if DEBUG >= LOG_LEVEL_VERBOSE
+            lorawan.printChannelsStatus();//As lorawanSendUplinkState()
+        #endif
+        if(closeUart){
+            lorawan.turnOffModule2(SOCKET1);
+        }else{
+            lorawan.turnOffModule();
+        }
+    }
+    hostClock.setTime(setup.time + (uint64_t)cycles * period * 1000);
+    benchmarkCounters_t end = sample(&lora);
+    printRow("uplinks", failed, &setup, &end);
+    printf("\n%-24s %8s %10s\n", "command", "count", "per_cycle");
+    const std::map<std::string, uint32_t> &counts = lora.getCommandCounts();
+    for(std::map<std::string, uint32_t>::const_iterator entry = counts.begin(); entry != counts.end(); entry++){
+        printf("%-24s %8u %10.2f\n", entry->first.c_str(), entry->second, (cycles > 0) ? (double)entry->second / cycles : 0.0);
+    }
+    return 0;
+}
@@ -0,0 +1,502 @@
+/*! \file MicroBenchmark.cpp
+    \brief Microbenchmarks of the hot functions of the node: advertising decoding, profile storage,
+           handle lookup and frame building
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    Usage: MicroBenchmark [-t ms_per_case] [filter]
+
+    Each case runs the function on realistic inputs: the scan response of the Thunderboard Sense 2,
+    the GATT profile of defines.h (11 services, 33 characteristics) built from the BGAPI events of
+    the discovery, a lookup of every sensor characteristic, a sweep of the 11 sensors into a frame
+    and the five downlink types. Only the cases whose name contains the filter are run.
+
+    One row per case: host ns per operation and, counted on one run, allocations, frees, bytes
+    copied, set and compared per operation, and an estimate of the ATmega1281 cycles and µs
+    (14.7456 MHz). The library calls are counted by wrapping them at link time (the sources are
+    built with -fno-builtin so every call is seen), and the growth of the profile arrays, that are
+    copied element by element, is added to the bytes copied. The cycles are the avr-libc cost of
+    the counted work plus a hand counted cost of the function body: an estimate, not a simulation.
+
+    Build: the MicroBenchmark target of the root CMakeLists.txt
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include <chrono>
+#include "WaspClasses.h"
+#include "WaspBLE.h"
+#include "BLECentral.h"
+#include "Buffer.h"
+#include "defines.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define AVR_CLOCK_MHZ 14.7456/*!< Waspmote clock */
+#define AVR_CALL_CYCLES 20/*!< Call, return, arguments and the loop step of the caller */
+#define AVR_COPY_CYCLES 8/*!< Per byte of memcpy()/memmove() (ld, st, 16 bits counter, branch) */
+#define AVR_INLINE_COPY_CYCLES 4/*!< Per byte of a structure assignment (ld, st) */
+#define AVR_SET_CYCLES 6/*!< Per byte of memset() */
+#define AVR_COMPARE_CYCLES 10/*!< Per byte of memcmp() until the first difference */
+#define AVR_MALLOC_CYCLES 250/*!< malloc() walking a short free list */
+#define AVR_FREE_CYCLES 200/*!< free() merging with its neighbours */
+#define DEFAULT_CASE_TIME 200/*!< ms of measure of each case */
+
+/*! \struct libraryWork_t
+    \brief  Work counted while a case is measured
+ */
+typedef struct {
+  uint64_t calls;/**< Library calls */
+  uint64_t allocations;/**< malloc(), calloc() and realloc() */
+  uint64_t frees;/**< free() */
+  uint64_t copied;/**< Bytes copied by the library and by the array growth */
+  uint64_t inlineCopied;/**< Bytes of the array growth, copied element by element */
+  uint64_t set;/**< Bytes set */
+  uint64_t compared;/**< Bytes compared */
+}libraryWork_t;
+
+/*! \struct microBenchmark_t
+    \brief  A case: one run does opsPerRun operations between measureBegin() and measureEnd()
+ */
+typedef struct {
+  const char *name;/**< Function and input */
+  uint32_t opsPerRun;/**< Operations of one run */
+  uint32_t bodyCycles;/**< Hand counted AVR cycles of one operation outside the library calls */
+  void (*run)();/**< One run */
+}microBenchmark_t;
+
+static uint8_t counting = 0;/*!< The wrappers count while it is 1 */
+static libraryWork_t work;/*!< Work of the current case */
+static std::chrono::steady_clock::duration measured;/*!< Time between measureBegin() and measureEnd() */
+static std::chrono::steady_clock::time_point measureStart;/*!< Last measureBegin() */
+
+/******************************************************************************
+ * Library wrappers (-Wl,--wrap)                                              *
+ ******************************************************************************/
+extern "C" {
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *pointer, size_t size);
+void __real_free(void *pointer);
+void *__real_memcpy(void *destination, const void *source, size_t length);
+void *__real_memmove(void *destination, const void *source, size_t length);
+void *__real_memset(void *destination, int value, size_t length);
+int __real_memcmp(const void *first, const void *second, size_t length);
+
+void *__wrap_malloc(size_t size){
+    work.allocations += counting;
+    work.calls += counting;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size){
+    work.allocations += counting;
+    work.calls += counting;
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *pointer, size_t size){
+    work.allocations += counting;
+    work.calls += counting;
+    return __real_realloc(pointer, size);
+}
+
+void __wrap_free(void *pointer){
+    work.frees += counting && (pointer != NULL);
+    work.calls += counting;
+    __real_free(pointer);
+}
+
+void *__wrap_memcpy(void *destination, const void *source, size_t length){
+    work.copied += counting ? length : 0;
+    work.calls += counting;
+    return __real_memcpy(destination, source, length);
+}
+
+void *__wrap_memmove(void *destination, const void *source, size_t length){
+    work.copied += counting ? length : 0;
+    work.calls += counting;
+    return __real_memmove(destination, source, length);
+}
+
+void *__wrap_memset(void *destination, int value, size_t length){
+    work.set += counting ? length : 0;
+    work.calls += counting;
+    return __real_memset(destination, value, length);
+}
+
+int __wrap_memcmp(const void *first, const void *second, size_t length){
+    if(counting){
+        size_t same = 0;
+        while((same < length) && (((const uint8_t *)first)[same] == ((const uint8_t *)second)[same])){
+            same++;
+        }
+        work.compared += (same < length) ? same + 1 : length;
+        work.calls++;
+    }
+    return __real_memcmp(first, second, length);
+}
+}
+
+/******************************************************************************
+ * Class                                                                      *
+ ******************************************************************************/
+
+//! BLECentralBenchmark Class
+/*!
+  BLECentral with its protected profile storage made public
+ */
+class BLECentralBenchmark : public BLECentral{
+
+/// public methods ////////////
+public:
+
+    using BLECentral::newDevice;
+
+    using BLECentral::freeDevice;
+
+    using BLECentral::newService;
+
+    using BLECentral::newCharacteristic;
+
+    using BLECentral::uuid128ToHandle;
+
+    Device_t* getDevice(){ return device; }
+};
+
+/*! \var benchmarkCentral
+    \brief Central whose profile is built
+ */
+static BLECentralBenchmark benchmarkCentral;
+
+/******************************************************************************
+ * Inputs                                                                     *
+ ******************************************************************************/
+
+/*! \var scanResponse
+    \brief BLE.BLEDev.advData of the Thunderboard Sense 2: [length][flags][complete local name]
+ */
+static uint8_t scanResponse[] = {25, 2, 0x01, 0x06, 21, 0x09, 'T', 'h', 'u', 'n', 'd', 'e', 'r', ' ', 'S',
+                                 'e', 'n', 's', 'e', ' ', '#', '0', '2', '7', '3', '5'};
+
+/*! \struct profileEntry_t
+    \brief  A service (characteristic 0) or a characteristic of the Thunderboard Sense 2 profile
+ */
+typedef struct {
+  uint8_t characteristic;/**< 0 for a service */
+  uint16_t uuid16;/**< 16 bits UUID, 0 if uuid128 */
+  uint8_t *uuid128;/**< 128 bits UUID of defines.h, most significant byte first */
+  uint8_t properties;/**< GATT properties of a characteristic */
+}profileEntry_t;
+
+/*! \var profile
+    \brief Services 0 to A of defines.h in discovery order
+ */
+static const profileEntry_t profile[] = {
+    {0, 0x1800, 0, 0}, {1, 0x2A00, 0, 0x02}, {1, 0x2A01, 0, 0x02},
+    {0, 0x1801, 0, 0}, {1, 0x2A05, 0, 0x20},
+    {0, 0x180A, 0, 0}, {1, 0x2A29, 0, 0x02}, {1, 0x2A24, 0, 0x02}, {1, 0x2A25, 0, 0x02}, {1, 0x2A27, 0, 0x02},
+    {1, 0x2A26, 0, 0x02}, {1, 0x2A23, 0, 0x02},
+    {0, 0x180F, 0, 0}, {1, 0x2A19, 0, 0x12},
+    {0, 0x181A, 0, 0}, {1, 0x2A76, 0, 0x02}, {1, 0x2A6D, 0, 0x02}, {1, 0x2A6E, 0, 0x02}, {1, 0x2A6F, 0, 0x02},
+    {1, 0, Service4_Characrteristic4_Ambient_Light_uuid, 0x02}, {1, 0, Service4_Characrteristic5_Sound_Level_uuid, 0x02},
+    {1, 0, Service4_Characrteristic6_Control_Point_uuid, 0x28},
+    {0, 0, power_management_service_uuid, 0}, {1, 0, Service5_Characrteristic0_Power_Source_uuid, 0x02},
+    {0, 0, iaq_service_uuid, 0}, {1, 0, Service6_Characrteristic0_ECO2_uuid, 0x02},
+    {1, 0, Service6_Characrteristic1_TVOC_uuid, 0x02}, {1, 0, Service6_Characrteristic2_Control_Point_uuid, 0x28},
+    {0, 0, user_interface_service_uuid, 0}, {1, 0, Service7_Characrteristic0_Buttons_uuid, 0x12},
+    {1, 0, Service7_Characrteristic1_Leds_uuid, 0x0A}, {1, 0, Service7_Characrteristic2_RGB_Leds_uuid, 0x0A},
+    {1, 0, Service7_Characrteristic3_Control_Point_uuid, 0x28},
+    {0, 0x1815, 0, 0}, {1, 0x2A56, 0, 0x1A}, {1, 0x2A56, 0, 0x1A},
+    {0, 0, accleration_orientation_service_uuid, 0}, {1, 0, Service9_Characrteristic0_Acceleration_uuid, 0x10},
+    {1, 0, Service9_Characrteristic1_Orientation_uuid, 0x10}, {1, 0, Service9_Characrteristic2_Control_Point_uuid, 0x28},
+    {0, 0, hall_effect_service_uuid, 0}, {1, 0, ServiceA_Characrteristic0_State_uuid, 0x12},
+    {1, 0, ServiceA_Characrteristic1_Field_Strength_uuid, 0x12}, {1, 0, ServiceA_Characrteristic2_Control_Point_uuid, 0x28}
+};
+
+#define PROFILE_ENTRIES (sizeof(profile) / sizeof(profile[0]))
+#define PROFILE_SERVICES 11
+#define PROFILE_CHARACTERISTICS (PROFILE_ENTRIES - PROFILE_SERVICES)
+
+static uint8_t serviceEvents[PROFILE_SERVICES][26];/*!< attclient_group_found of each service */
+static uint8_t characteristicEvents[PROFILE_CHARACTERISTICS][28];/*!< attclient_attribute_value of each declaration */
+static uint8_t characteristicService[PROFILE_CHARACTERISTICS];/*!< Service of each characteristic */
+
+/*! \var downlinks
+    \brief One downlink of each type of putNetworkReceivedData(), ASCII hex as received from the RN2483
+ */
+static char downlinks[5][40] = {
+    "3130333030",/*1: 10:30*/
+    "3231313131313131313131",/*2: all the sensors*/
+    "33313033",/*3: redundancy mode 1, depth 3*/
+    "34303330303135",/*4: temperature every 15 min*/
+    "3530333030323030303036"/*5: temperature delta 20, 6 h*/
+};
+
+/*! \var sensorValues
+    \brief Characteristic values of a sensor sweep, [size][value], as read from the Thunderboard
+ */
+static uint8_t sensorValues[FIELD_STRENGHT_TYPE + 1][SENSOR_VALUE_MAX_SIZE + 1] = {
+    {0}, {1, 1}, {4, 0x02, 0x76, 0x0F, 0x00}, {2, 0x66, 0x08}, {4, 0x40, 0x9C, 0x00, 0x00}, {2, 0x94, 0x11},
+    {2, 0x94, 0x11}, {1, 100}, {2, 0x90, 0x01}, {2, 20, 0}, {1, 0}, {4, 0xF4, 0x01, 0x00, 0x00}
+};
+
+/*! \fn static void buildEvents()
+    \brief Write the BGAPI events of the discovery of the profile, with the handles of the BLE112 GATT compiler
+*/
+static void buildEvents(){
+    uint16_t handle = 1;
+    uint8_t service = 0;
+    uint8_t characteristic = 0;
+    for(uint8_t i = 0; i < PROFILE_ENTRIES; i++){
+        uint8_t length = profile[i].uuid16 ? 2 : 16;
+        uint8_t uuid[16];
+        for(uint8_t j = 0; j < length; j++){
+            uuid[j] = profile[i].uuid16 ? (uint8_t)(profile[i].uuid16 >> (8 * j)) : profile[i].uuid128[15 - j];
+        }
+        if(profile[i].characteristic == 0){
+            uint8_t *event = serviceEvents[service++];
+            uint16_t end = handle;
+            for(uint8_t j = i + 1; (j < PROFILE_ENTRIES) && profile[j].characteristic; j++){
+                end += 2 + ((profile[j].properties & 0x30) ? 1 : 0);
+            }
+            event[0] = 0x80; event[1] = 6 + length; event[2] = 4; event[3] = 2; event[4] = 0;
+            event[5] = handle; event[6] = handle >> 8; event[7] = end; event[8] = end >> 8; event[9] = length;
+            memcpy(event + 10, uuid, length);
+            handle++;
+        }else{
+            uint8_t *event = characteristicEvents[characteristic];
+            event[0] = 0x80; event[1] = 5 + 3 + length; event[2] = 4; event[3] = 5; event[4] = 0;
+            event[5] = handle; event[6] = handle >> 8; event[7] = 3; event[8] = 3 + length;
+            event[9] = profile[i].properties; event[10] = handle + 1; event[11] = (handle + 1) >> 8;
+            memcpy(event + 12, uuid, length);
+            characteristicService[characteristic++] = service - 1;
+            handle += 2 + ((profile[i].properties & 0x30) ? 1 : 0);
+        }
+    }
+}
+
+/******************************************************************************
+ * Cases                                                                      *
+ ******************************************************************************/
+
+/*! \fn static void measureBegin()
+    \brief Start counting and timing
+*/
+static void measureBegin(){
+    counting = 1;
+    measureStart = std::chrono::steady_clock::now();
+}
+
+/*! \fn static void measureEnd()
+    \brief Stop counting and timing
+*/
+static void measureEnd(){
+    measured += std::chrono::steady_clock::now() - measureStart;
+    counting = 0;
+}
+
+/*! \fn static void buildServices()
+    \brief newService() of the 11 services, the growth copies of the array are counted
+*/
+static void buildServices(){
+    for(uint8_t i = 0; i < PROFILE_SERVICES; i++){
+        uint32_t grown = benchmarkCentral.getDevice()->numberOfServices * sizeof(service_t);
+        work.copied += counting ? grown : 0;
+        work.inlineCopied += counting ? grown : 0;
+        benchmarkCentral.newService(serviceEvents[i]);
+    }
+}
+
+/*! \fn static void buildCharacteristics()
+    \brief newCharacteristic() of the 33 characteristics, the growth copies of the arrays are counted
+*/
+static void buildCharacteristics(){
+    for(uint8_t i = 0; i < PROFILE_CHARACTERISTICS; i++){
+        service_t *service = &benchmarkCentral.getDevice()->service[characteristicService[i]];
+        uint32_t grown = service->numberOfCharacteristics * sizeof(characteristic_t);
+        work.copied += counting ? grown : 0;
+        work.inlineCopied += counting ? grown : 0;
+        benchmarkCentral.newCharacteristic(service, characteristicEvents[i]);
+    }
+}
+
+static void runAdvdataName(){
+    uint8_t length;
+    uint8_t name[31];
+    BLECentral central;
+    measureBegin();
+    central.bleAdvdataDecode(0x09, scanResponse[0], scanResponse, &length, name);
+    measureEnd();
+}
+
+static void runAdvdataAbsent(){
+    uint8_t length;
+    uint8_t data[31];
+    BLECentral central;
+    measureBegin();
+    central.bleAdvdataDecode(0xFF, scanResponse[0], scanResponse, &length, data);
+    measureEnd();
+}
+
+static void runScanReport(){
+    measureBegin();
+    benchmarkCentral.scanReport("Thunder Sense #02735");
+    measureEnd();
+}
+
+static void runNewService(){
+    measureBegin();
+    buildServices();
+    measureEnd();
+    benchmarkCentral.freeDevice();
+}
+
+static void runNewCharacteristic(){
+    buildServices();
+    measureBegin();
+    buildCharacteristics();
+    measureEnd();
+    benchmarkCentral.freeDevice();
+}
+
+static void runUuid128ToHandle(){
+    if(benchmarkCentral.getDevice()->numberOfServices == 0){
+        buildServices();
+        buildCharacteristics();
+    }
+    measureBegin();
+    for(uint8_t type = UV_INDEX_TYPE; type <= FIELD_STRENGHT_TYPE; type++){
+        benchmarkCentral.uuid128ToHandle(sensorUuid[type]);
+    }
+    measureEnd();
+}
+
+static void runGetSensorHandle(){
+    if(benchmarkCentral.getSensorHandle(UV_INDEX_TYPE) == 0){
+        if(benchmarkCentral.getDevice()->numberOfServices == 0){
+            buildServices();
+            buildCharacteristics();
+        }
+        benchmarkCentral.resolveSensorHandles();
+    }
+    measureBegin();
+    for(uint8_t type = UV_INDEX_TYPE; type <= FIELD_STRENGHT_TYPE; type++){
+        benchmarkCentral.getSensorHandle(type);
+    }
+    measureEnd();
+}
+
+static void runPutDataToSend(){
+    static Buffer buffer;
+    buffer.openFrame(DATA_PORT, 0, FRAME_PRIORITY_PERIODIC);
+    measureBegin();
+    for(uint8_t type = UV_INDEX_TYPE; type <= FIELD_STRENGHT_TYPE; type++){
+        buffer.putDataToSend(sensorValues[type], type);
+    }
+    measureEnd();
+    buffer.closeFrame();
+    while(buffer.hasDataToSend()){
+        buffer.clearDataToSend();
+    }
+}
+
+static void runPutNetworkReceivedData(){
+    static Buffer buffer;
+    measureBegin();
+    for(uint8_t i = 0; i < 5; i++){
+        buffer.putNetworkReceivedData(downlinks[i]);
+    }
+    measureEnd();
+}
+
+/*! \var cases
+    \brief The cases, the body cycles are counted on the C code of each function
+ */
+static const microBenchmark_t cases[] = {
+    {"bleAdvdataDecode name", 1, 50, runAdvdataName},
+    {"bleAdvdataDecode absent", 1, 45, runAdvdataAbsent},
+    {"scanReport", 1, 900, runScanReport},
+    {"newService profile", PROFILE_SERVICES, 180, runNewService},
+    {"newCharacteristic profile", PROFILE_CHARACTERISTICS, 200, runNewCharacteristic},
+    {"uuid128ToHandle sweep", FIELD_STRENGHT_TYPE, 30, runUuid128ToHandle},
+    {"getSensorHandle sweep", FIELD_STRENGHT_TYPE, 8, runGetSensorHandle},
+    {"putDataToSend sweep", FIELD_STRENGHT_TYPE, 260, runPutDataToSend},
+    {"putNetworkReceivedData", 5, 120, runPutNetworkReceivedData}
+};
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+/*! \fn static double avrCycles(const libraryWork_t *counted, uint32_t bodyCycles, uint32_t ops)
+    \brief Estimated ATmega1281 cycles of one operation
+*/
+static double avrCycles(const libraryWork_t *counted, uint32_t bodyCycles, uint32_t ops){
+    double cycles = counted->calls * AVR_CALL_CYCLES
+                  + (counted->copied - counted->inlineCopied) * AVR_COPY_CYCLES
+                  + counted->inlineCopied * AVR_INLINE_COPY_CYCLES
+                  + counted->set * AVR_SET_CYCLES + counted->compared * AVR_COMPARE_CYCLES
+                  + counted->allocations * AVR_MALLOC_CYCLES + counted->frees * AVR_FREE_CYCLES;
+    return cycles / ops + bodyCycles;
+}
+
+/*! \fn static void runCase(const microBenchmark_t *benchmark, uint32_t caseTime)
+    \brief Count the work of one run, time runs for caseTime ms and print the row
+*/
+static void runCase(const microBenchmark_t *benchmark, uint32_t caseTime){
+    libraryWork_t counted;
+    uint64_t runs = 0;
+    std::chrono::steady_clock::time_point start;
+    benchmark->run();//Warm up: first allocations and caches
+    memset(&work, 0, sizeof(work));
+    benchmark->run();
+    counted = work;
+    measured = std::chrono::steady_clock::duration::zero();
+    start = std::chrono::steady_clock::now();
+    while(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(caseTime)){
+        benchmark->run();
+        runs++;
+    }
+    double ops = (double)runs * benchmark->opsPerRun;
+    double cycles = avrCycles(&counted, benchmark->bodyCycles, benchmark->opsPerRun);
+    printf("%-26s %10.1f %8.2f %8.2f %9.1f %7.1f %9.1f %10.0f %9.1f\n", benchmark->name,
+           std::chrono::duration<double, std::nano>(measured).count() / ops,
+           (double)counted.allocations / benchmark->opsPerRun, (double)counted.frees / benchmark->opsPerRun,
+           (double)counted.copied / benchmark->opsPerRun, (double)counted.set / benchmark->opsPerRun,
+           (double)counted.compared / benchmark->opsPerRun, cycles, cycles / AVR_CLOCK_MHZ);
+}
+
+/*! \fn int main(int argc, char **argv)
+    \brief Benchmark entry point
+*/
+int main(int argc, char **argv){
+    uint32_t caseTime = DEFAULT_CASE_TIME;
+    const char *filter = "";
+    for(int arg = 1; arg < argc; arg++){
+        if((strcmp(argv[arg], "-t") == 0) && ((arg + 1) < argc)){
+            caseTime = atoi(argv[++arg]);
+        }else if(argv[arg][0] == '-'){
+            fprintf(stderr, "Unknown option %s\n", argv[arg]);
+            return 1;
+        }else{
+            filter = argv[arg];
+        }
+    }
+    USB.setStream(NULL);
+    buildEvents();
+    benchmarkCentral.newDevice();
+    memcpy(BLE.BLEDev.mac, "\x00\x0b\x57\xa9\x0a\xaf", 6);
+    memcpy(BLE.BLEDev.advData, scanResponse, sizeof(scanResponse));
+    printf("Microbenchmarks: %u ms per case, AVR estimate at %.4f MHz\n", caseTime, AVR_CLOCK_MHZ);
+    printf("%-26s %10s %8s %8s %9s %7s %9s %10s %9s\n", "case", "ns/op", "allocs", "frees", "copied_B",
+           "set_B", "cmp_B", "avr_cycles", "avr_us");
+    for(uint8_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++){
+        if(strstr(cases[i].name, filter) != NULL){
+            runCase(&cases[i], caseTime);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,261 @@
+/*! \file NodeSimulator.cpp
+    \brief Virtual time simulation of the node against emulated BLE112, Thunderboard Sense 2 and RN2483
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    Usage: NodeSimulator [-d days] [-l loss] [-D disconnects_per_day] [-o outage_s]
+                         [-n hall_events_per_day] [-t trace_file] [-s seed]
+                         [-a max_airtime_s_per_day] [-m max_mAh_per_day] [-v]
+
+    setup() and loop() of main.pde run unchanged on the host build (host/): the BLE112 with the
+    Thunderboard is a Ble112Emulator on SOCKET0, the RN2483 and the network a Rn2483Emulator on
+    SOCKET1, and the sleeps of the node jump the virtual clock to the next RTC alarm or BLE event.
+    A simulated day takes milliseconds of wall time.
+
+    Options: -l probability of losing each LoRa transmission, -D mean link losses per day and
+    -o seconds the peripheral is not seen after each one, -n mean Hall state changes per day,
+    -t capture of the bytes exchanged on both UARTs (UartTrace.h, played back by TraceReplay),
+    -v node logs on stderr. The logs take their USB time (USB_BAUD_RATE) with or without -v, so
+    awake_s follows the log level (DEBUG in defines.h).
+
+    Checks: a day with more time on air than -a seconds (default DUTY_CYCLE_AIRTIME, the 1 % duty
+    cycle of the single channel used) or, if -m is given, more charge than -m mAh is flagged and
+    the exit status is 2. CTest runs the scenarios of the root CMakeLists.txt with these checks.
+
+    One row per simulated day: uplinks sent and received by the network, payload bytes, time on
+    air, RN2483 powered time, MCU awake time, wake ups, notifications, link losses and the charge
+    estimated with the currents below.
+
+    Build: the NodeSimulator target of the root CMakeLists.txt
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include <chrono>
+#include "WaspClasses.h"
+#include "HalHost.h"
+#include "Ble112Emulator.h"
+#include "Rn2483Emulator.h"
+#include "main.pde"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define MS_PER_DAY 86400000ULL
+#define MCU_AWAKE_CURRENT 15.0/*!< mA of the Waspmote awake */
+#define MCU_SLEEP_CURRENT 0.055/*!< mA of the Waspmote in power down */
+#define BLE_ACTIVE_CURRENT 8.0/*!< mA of the BLE112 while the MCU is awake (UART and GATT procedures) */
+#define BLE_IDLE_CURRENT 0.4/*!< mA of the BLE112 keeping the connection while the MCU sleeps */
+#define LORA_IDLE_CURRENT 2.8/*!< mA of the RN2483 powered */
+#define LORA_TX_CURRENT 38.9/*!< mA of the RN2483 transmitting at 14 dBm */
+#define LORA_RX_CURRENT 14.2/*!< mA of the RN2483 receiving */
+#define DUTY_CYCLE_AIRTIME 864.0/*!< s on air per day allowed by the 1 % duty cycle of the EU868 sub-band of channel 0 */
+
+/*! \struct simulationCounters_t
+    \brief  Cumulated counters, a day is the difference of two samples
+ */
+typedef struct {
+  uint64_t time;/**< Virtual ms */
+  uint64_t sleep;/**< ms in halSleep() */
+  uint64_t bleOn;/**< ms the BLE UART has been opened */
+  uint64_t loraOn;/**< ms the RN2483 has been powered */
+  uint64_t tx;/**< ms transmitting */
+  uint64_t rx;/**< ms receiving */
+  uint32_t uplinks;/**< mac tx */
+  uint32_t delivered;/**< Uplinks received by the network */
+  uint32_t bytes;/**< Payload bytes */
+  uint32_t wakeUps;/**< RTC and BLE wake ups */
+  uint32_t notifications;/**< Hall notifications */
+  uint32_t disconnects;/**< Link losses */
+}simulationCounters_t;
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+/*! \fn static simulationCounters_t sample(Ble112Emulator *ble, Rn2483Emulator *lora)
+    \brief The cumulated counters at the current virtual time
+*/
+static simulationCounters_t sample(Ble112Emulator *ble, Rn2483Emulator *lora){
+    simulationCounters_t counters;
+    counters.time = hostClock.getTime();
+    counters.sleep = halHostGetSleepTime();
+    counters.bleOn = hostUart[SOCKET0].getOpenedTime();
+    counters.loraOn = hostUart[SOCKET1].getOpenedTime();
+    counters.tx = lora->getTxTime();
+    counters.rx = lora->getRxTime();
+    counters.uplinks = lora->getUplinks();
+    counters.delivered = lora->getDelivered();
+    counters.bytes = lora->getPayloadBytes();
+    counters.wakeUps = halHostGetAlarmWakeUps() + halHostGetBleWakeUps();
+    counters.notifications = ble->getNotifications();
+    counters.disconnects = ble->getDisconnects();
+    return counters;
+}
+
+/*! \fn static double charge(const simulationCounters_t *from, const simulationCounters_t *to)
+    \brief Charge between two samples in mAh
+*/
+static double charge(const simulationCounters_t *from, const simulationCounters_t *to){
+    double elapsed = to->time - from->time;
+    double asleep = to->sleep - from->sleep;
+    double awake = elapsed - asleep;
+    double bleOn = to->bleOn - from->bleOn;
+    double bleActive = (bleOn < awake) ? bleOn : awake;
+    double mAms = awake * MCU_AWAKE_CURRENT + asleep * MCU_SLEEP_CURRENT
+                + bleActive * BLE_ACTIVE_CURRENT + (bleOn - bleActive) * BLE_IDLE_CURRENT
+                + (to->loraOn - from->loraOn) * LORA_IDLE_CURRENT
+                + (to->tx - from->tx) * (LORA_TX_CURRENT - LORA_IDLE_CURRENT)
+                + (to->rx - from->rx) * (LORA_RX_CURRENT - LORA_IDLE_CURRENT);
+    return mAms / 3600000.0;
+}
+
+/*! \fn static void printRow(const char *label, const simulationCounters_t *from, const simulationCounters_t *to)
+    \brief Print the activity between two samples
+*/
+static void printRow(const char *label, const simulationCounters_t *from, const simulationCounters_t *to){
+    printf("%-6s %8u %9u %8u %9.1f %9.1f %9.1f %7u %7u %7u %9.2f\n", label,
+           to->uplinks - from->uplinks, to->delivered - from->delivered, to->bytes - from->bytes,
+           (to->tx - from->tx) / 1000.0, (to->loraOn - from->loraOn) / 1000.0,
+           ((to->time - from->time) - (to->sleep - from->sleep)) / 1000.0,
+           to->wakeUps - from->wakeUps, to->notifications - from->notifications,
+           to->disconnects - from->disconnects, charge(from, to));
+}
+
+#if PROFILE_ENABLED
+/*! \fn static void printProfile()
+    \brief Print the statistics of the measured radio operations (Profile.h), in ms
+*/
+static void printProfile(){
+    printf("%-6s %8s %10s %9s %9s\n", "op", "count", "total_ms", "mean_ms", "max_ms");
+    for(uint8_t id = 0; id < PROFILE_OPERATIONS; id++){
+        profileStats_t *stats = profiler.getStats(id);
+        if(stats->count == 0){
+            continue;
+        }
+        printf("%-6u %8u %10.1f %9.3f %9.3f\n", id, stats->count, stats->totalTicks / (double)HAL_TICKS_PER_MS,
+               stats->totalTicks / (double)HAL_TICKS_PER_MS / stats->count, stats->maxTicks / (double)HAL_TICKS_PER_MS);
+    }
+}
+#endif
+
+/*! \fn static uint8_t checkDay(unsigned int day, const simulationCounters_t *from, const simulationCounters_t *to, double maxAirtime, double maxCharge)
+    \brief Check one day against the limits
+    \retval 1 if the day is flagged, 0 if not
+*/
+static uint8_t checkDay(unsigned int day, const simulationCounters_t *from, const simulationCounters_t *to, double maxAirtime, double maxCharge){
+    double airtime = (to->tx - from->tx) / 1000.0;
+    double mAh = charge(from, to);
+    uint8_t flagged = 0;
+    if(airtime > maxAirtime){
+        printf("FLAG day %u: %.1f s on air, limit %.1f s\n", day, airtime, maxAirtime);
+        flagged = 1;
+    }
+    if((maxCharge > 0) && (mAh > maxCharge)){
+        printf("FLAG day %u: %.2f mAh, limit %.2f mAh\n", day, mAh, maxCharge);
+        flagged = 1;
+    }
+    return flagged;
+}
+
+/*! \fn int main(int argc, char **argv)
+    \brief Simulator entry point
+    \retval 0 if OK, 1 if the arguments are wrong, 2 if a day has been flagged by the checks
+*/
+int main(int argc, char **argv){
+    unsigned int days = 7;
+    double loss = 0;
+    double disconnectsPerDay = 0;
+    unsigned int outage = 60;
+    double hallPerDay = 24;
+    unsigned long seed = 1;
+    uint8_t verbose = 0;
+    uint8_t flagged = 0;
+    double maxAirtime = DUTY_CYCLE_AIRTIME;
+    double maxCharge = 0;
+    const char *tracePath = NULL;
+    UartTrace capture;
+    char label[16];
+    for(int arg = 1; arg < argc; arg++){
+        if((strcmp(argv[arg], "-v") == 0)){
+            verbose = 1;
+        }else if((arg + 1) >= argc){
+            fprintf(stderr, "Missing value of %s\n", argv[arg]);
+            return 1;
+        }else if(strcmp(argv[arg], "-d") == 0){
+            days = atoi(argv[++arg]);
+        }else if(strcmp(argv[arg], "-l") == 0){
+            loss = atof(argv[++arg]);
+        }else if(strcmp(argv[arg], "-D") == 0){
+            disconnectsPerDay = atof(argv[++arg]);
+        }else if(strcmp(argv[arg], "-o") == 0){
+            outage = atoi(argv[++arg]);
+        }else if(strcmp(argv[arg], "-n") == 0){
+            hallPerDay = atof(argv[++arg]);
+        }else if(strcmp(argv[arg], "-t") == 0){
+            tracePath = argv[++arg];
+        }else if(strcmp(argv[arg], "-s") == 0){
+            seed = strtoul(argv[++arg], NULL, 10);
+        }else if(strcmp(argv[arg], "-a") == 0){
+            maxAirtime = atof(argv[++arg]);
+        }else if(strcmp(argv[arg], "-m") == 0){
+            maxCharge = atof(argv[++arg]);
+        }else{
+            fprintf(stderr, "Unknown option %s\n", argv[arg]);
+            return 1;
+        }
+    }
+    if(days == 0){
+        days = 1;
+    }
+    Ble112Emulator ble(seed);
+    Rn2483Emulator lora(seed + 1);
+    ble.setHallEventsPerDay(hallPerDay);
+    ble.setDisconnectsPerDay(disconnectsPerDay, outage);
+    lora.setLossProbability(loss);
+    hostUart[SOCKET0].attach(&ble);
+    hostUart[SOCKET1].attach(&lora);
+    if(tracePath != NULL){
+        if(!capture.open(tracePath)){
+            fprintf(stderr, "Cannot create %s\n", tracePath);
+            return 1;
+        }
+        hostUart[SOCKET0].capture(&capture, SOCKET0);
+        hostUart[SOCKET1].capture(&capture, SOCKET1);
+    }
+    USB.setStream(verbose ? stderr : NULL);
+
+    printf("Simulation: %u days, LoRa loss %.3f, %.1f link losses/day (%u s outage), %.1f Hall events/day, seed %lu\n",
+           days, loss, disconnectsPerDay, outage, hallPerDay, seed);
+    printf("%-6s %8s %9s %8s %9s %9s %9s %7s %7s %7s %9s\n", "day", "uplinks", "delivered", "bytes",
+           "airtime_s", "lora_on_s", "awake_s", "wakeups", "notifs", "discon", "mAh");
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    simulationCounters_t first = sample(&ble, &lora);
+    simulationCounters_t previous = first;
+    setup();
+    for(unsigned int day = 1; day <= days; day++){
+        while(hostClock.getTime() < day * MS_PER_DAY){
+            loop();
+        }
+        simulationCounters_t current = sample(&ble, &lora);
+        snprintf(label, sizeof(label), "%u", day);
+        printRow(label, &previous, &current);
+        flagged |= checkDay(day, &previous, &current, maxAirtime, maxCharge);
+        previous = current;
+    }
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printRow("total", &first, &previous);
+    printf("Mean per day: %.2f mAh, %.1f uplinks. Wall time %.3f s (%.4f s per simulated day)\n",
+           charge(&first, &previous) / days, (double)(previous.uplinks - first.uplinks) / days,
+           wall, wall / days);
+    #if PROFILE_ENABLED
+        printProfile();
+    #endif
+    if(tracePath != NULL){
+        capture.close();
+        printf("Trace %s: %u records, %llu bytes\n", tracePath, capture.getRecords(),
+               (unsigned long long)capture.getFileBytes());
+    }
+    return flagged ? 2 : 0;
+}
@@ -0,0 +1,123 @@
+/*! \file TraceReplay.cpp
+    \brief Replay of a UART capture against the node, to measure latency regressions
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    Usage: TraceReplay trace_file [-x extra_s] [-t trace_file] [-v]
+
+    setup() and loop() of main.pde run on the host build (host/) with a UartReplay on SOCKET0 and
+    another one on SOCKET1, both playing back the capture (NodeSimulator -t): BLECentral and
+    LoraWan receive the recorded BLE112 and RN2483 bytes at the recorded offsets from their own
+    commands. The run ends when both sockets have been played, or -x seconds (600 by default) after
+    the end of the capture if the node no longer follows it.
+
+    Options: -t capture of the replayed session, to compare it with the original, -v node logs on
+    stderr.
+
+    One row per socket: records, node writes matched, recorded writes the node skipped, node writes
+    not in the capture, the end of the capture and of the replay, and the mean and longest time from
+    the module bytes to the next node write, recorded and replayed. The exit status is 2 if the node
+    did not follow the capture, so the tool can gate a change of the node code.
+
+    Build: the TraceReplay target of the root CMakeLists.txt
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include "WaspClasses.h"
+#include "UartReplay.h"
+#include "main.pde"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define REPLAY_EXTRA_TIME 600/*!< Default s the replay goes on after the end of the capture */
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+/*! \fn static void printRow(const char *label, UartReplay *replay)
+    \brief Print the replay of one socket
+*/
+static void printRow(const char *label, UartReplay *replay){
+    uint32_t writes = replay->getMatched();
+    printf("%-8s %7u %7u %7u %10u %10.1f %10.1f %8.2f %8llu %8.2f %8llu\n", label, replay->getRecords(),
+           writes, replay->getSkipped(), replay->getUnexpected(), replay->getRecordedEnd() / 1000.0,
+           replay->getReplayedEnd() / 1000.0,
+           (writes > 0) ? (double)replay->getRecordedTurnaround() / writes : 0.0,
+           (unsigned long long)replay->getRecordedMaxTurnaround(),
+           (writes > 0) ? (double)replay->getReplayedTurnaround() / writes : 0.0,
+           (unsigned long long)replay->getReplayedMaxTurnaround());
+}
+
+/*! \fn int main(int argc, char **argv)
+    \brief Replay entry point
+*/
+int main(int argc, char **argv){
+    const char *path = NULL;
+    const char *tracePath = NULL;
+    unsigned long extra = REPLAY_EXTRA_TIME;
+    uint8_t verbose = 0;
+    std::vector<uartTraceRecord_t> trace;
+    UartTrace capture;
+    for(int arg = 1; arg < argc; arg++){
+        if(strcmp(argv[arg], "-v") == 0){
+            verbose = 1;
+        }else if(argv[arg][0] != '-'){
+            path = argv[arg];
+        }else if((arg + 1) >= argc){
+            fprintf(stderr, "Missing value of %s\n", argv[arg]);
+            return 1;
+        }else if(strcmp(argv[arg], "-x") == 0){
+            extra = strtoul(argv[++arg], NULL, 10);
+        }else if(strcmp(argv[arg], "-t") == 0){
+            tracePath = argv[++arg];
+        }else{
+            fprintf(stderr, "Unknown option %s\n", argv[arg]);
+            return 1;
+        }
+    }
+    if(path == NULL){
+        fprintf(stderr, "Usage: %s trace_file [-x extra_s] [-t trace_file] [-v]\n", argv[0]);
+        return 1;
+    }
+    if(!UartTrace::load(path, trace)){
+        fprintf(stderr, "Cannot read the trace %s\n", path);
+        return 1;
+    }
+    UartReplay ble(trace, SOCKET0);
+    UartReplay lora(trace, SOCKET1);
+    hostUart[SOCKET0].attach(&ble);
+    hostUart[SOCKET1].attach(&lora);
+    if(tracePath != NULL){
+        if(!capture.open(tracePath)){
+            fprintf(stderr, "Cannot create %s\n", tracePath);
+            return 1;
+        }
+        hostUart[SOCKET0].capture(&capture, SOCKET0);
+        hostUart[SOCKET1].capture(&capture, SOCKET1);
+    }
+    USB.setStream(verbose ? stderr : NULL);
+    uint64_t end = (trace.empty() ? 0 : trace.back().time) + (uint64_t)extra * 1000;
+
+    printf("Replay of %s: %u records, %.1f s\n", path, (unsigned int)trace.size(),
+           trace.empty() ? 0.0 : trace.back().time / 1000.0);
+    printf("%-8s %7s %7s %7s %10s %10s %10s %8s %8s %8s %8s\n", "socket", "records", "matched", "skipped",
+           "unexpected", "rec_end_s", "rep_end_s", "rec_ms", "rec_max", "rep_ms", "rep_max");
+    setup();
+    while(!(ble.isFinished() && lora.isFinished()) && (hostClock.getTime() < end)){
+        loop();
+    }
+    printRow("BLE", &ble);
+    printRow("LoRaWAN", &lora);
+    if(tracePath != NULL){
+        capture.close();
+        printf("Trace %s: %u records, %llu bytes\n", tracePath, capture.getRecords(),
+               (unsigned long long)capture.getFileBytes());
+    }
+    uint8_t followed = ble.isFinished() && lora.isFinished()
+                       && (ble.getSkipped() + ble.getUnexpected() + lora.getSkipped() + lora.getUnexpected() == 0);
+    return followed ? 0 : 2;
+}
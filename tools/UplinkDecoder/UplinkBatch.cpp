@@ -0,0 +1,348 @@
+/*! \file UplinkBatch.cpp
+    \brief Batch decoder of the uplink frames built by Buffer, into columns, for the network server side
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    Frame format: UplinkDecoder.cpp. decodeFrame() follows decodeUplinkFrame() element by element,
+    only the output differs, so both decoders accept and reject the same frames.
+
+    The batch is decoded in two passes over the frames, both split between the threads:
+    countFrame() walks the element headers to count the values of each frame, the counts give the
+    place of every frame in the columns, and decodeFrame() writes the values in place. The columns
+    are sized once and every value is written once, with no merge of per thread results. A frame
+    whose data is corrupted (a varint, a series or a summary) is only found by decodeFrame(): its
+    values are removed afterwards by a sequential compaction of the columns.
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include <stddef.h>
+#include <inttypes.h>
+#include <thread>
+#include "defines.h"
+#include "DeltaCodec.h"
+#include "RunningStats.h"
+#include "UplinkDecoder.h"
+#include "UplinkBatch.h"
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define UPLINK_BATCH_MIN_FRAMES 4096/*!< Frames per thread below which fewer threads are used */
+
+/*! \struct valueColumns_t
+    \brief  Start of the per value columns, where decodeFrame() writes
+ */
+typedef struct {
+  uint32_t *frame;/**< uplinkColumns_t::frame */
+  uint8_t *type;/**< uplinkColumns_t::type */
+  uint8_t *flags;/**< uplinkColumns_t::flags */
+  int32_t *value;/**< uplinkColumns_t::value */
+  uint32_t *timestamp;/**< uplinkColumns_t::timestamp */
+  uint32_t *samples;/**< uplinkColumns_t::samples */
+}valueColumns_t;
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+/*! \fn static void putValue(const valueColumns_t *columns, uint32_t position, uint32_t frame, uint8_t type, uint8_t flags, int32_t value, uint32_t timestamp, uint32_t samples)
+    \brief Write one value in the per value columns
+*/
+static inline void putValue(const valueColumns_t *columns, uint32_t position, uint32_t frame, uint8_t type, uint8_t flags,
+                            int32_t value, uint32_t timestamp, uint32_t samples){
+    columns->frame[position] = frame;
+    columns->type[position] = type;
+    columns->flags[position] = flags;
+    columns->value[position] = value;
+    columns->timestamp[position] = timestamp;
+    columns->samples[position] = samples;
+}
+
+/*! \fn static int countFrame(const uint8_t *frame, uint8_t length)
+    \brief Count the values of a frame from the element headers
+    \retval The number of values, -1 if the elements do not fit in the frame
+*/
+static int countFrame(const uint8_t *frame, uint8_t length){
+    uint8_t position = 0;
+    uint8_t header;
+    uint8_t elementLength;
+    uint8_t used;
+    uint32_t skipped;
+    int values = 0;
+    while(position < length){
+        if((position + 2) > length){
+            return -1;
+        }
+        header = frame[position];
+        elementLength = frame[position + 1];
+        position += 2;
+        if((position + elementLength) > length){
+            return -1;
+        }
+        if((header == REDUNDANCY_TYPE) || (header == FRAME_EPOCH_TYPE)){
+            position += elementLength;
+            continue;
+        }
+        if(header & DELTA_TYPE_FLAG){
+            used = 0;
+            if(header & TIMESTAMP_TYPE_FLAG){
+                used = varintDecode(frame + position, elementLength, &skipped);
+                if(used == 0){
+                    return -1;
+                }
+                used += varintDecode(frame + position + used, elementLength - used, &skipped);
+            }
+            if(used < elementLength){
+                values += frame[position + used];
+            }
+        }else if(header & STATISTICS_TYPE_FLAG){
+            values += 4;
+        }else{
+            values++;
+        }
+        position += elementLength;
+    }
+    return values;
+}
+
+/*! \fn static int decodeFrame(const uint8_t *frame, uint8_t length, uint32_t index, const valueColumns_t *columns, uint32_t position)
+    \brief Decode the sensor elements of one frame into the per value columns
+    \param[in]  *frame   The frame payload
+    \param[in]  length   The payload length
+    \param[in]  index    Index of the frame in the batch
+    \param[out] *columns The columns, room for the values counted by countFrame()
+    \param[in]  position Where the first value is written
+    \retval The number of elements decoded, -1 if the frame is malformed
+*/
+static int decodeFrame(const uint8_t *frame, uint8_t length, uint32_t index, const valueColumns_t *columns, uint32_t position){
+    uint8_t cursor = 0;
+    uint8_t header;
+    uint8_t type;
+    uint8_t flags;
+    uint8_t elementLength;
+    uint8_t timeLength;
+    uint8_t used;
+    uint8_t count;
+    int decoded = 0;
+    uint8_t raw[5];
+    uint32_t epoch = 0;
+    uint32_t offset = 0;
+    uint32_t interval = 0;
+    uint32_t samples;
+    int32_t summary[4];
+    if((length >= 6) && (frame[0] == FRAME_EPOCH_TYPE) && (frame[1] == 4)){
+        epoch = (uint32_t)frame[2] | ((uint32_t)frame[3] << 8) | ((uint32_t)frame[4] << 16) | ((uint32_t)frame[5] << 24);
+    }
+    while(cursor < length){
+        if((cursor + 2) > length){
+            return -1;
+        }
+        header = frame[cursor];
+        elementLength = frame[cursor + 1];
+        cursor += 2;
+        if((cursor + elementLength) > length){
+            return -1;
+        }
+        if((header == REDUNDANCY_TYPE) || (header == FRAME_EPOCH_TYPE)){
+            cursor += elementLength;
+            continue;
+        }
+        type = header & ~(DELTA_TYPE_FLAG | TIMESTAMP_TYPE_FLAG | STATISTICS_TYPE_FLAG);
+        flags = ((header & DELTA_TYPE_FLAG) ? UPLINK_VALUE_SERIES : 0) | ((header & STATISTICS_TYPE_FLAG) ? UPLINK_VALUE_SUMMARY : 0);
+        timeLength = 0;
+        if(header & TIMESTAMP_TYPE_FLAG){
+            timeLength = varintDecode(frame + cursor, elementLength, &offset);
+            if(timeLength == 0){
+                return -1;
+            }
+            if(header & DELTA_TYPE_FLAG){
+                used = varintDecode(frame + cursor + timeLength, elementLength - timeLength, &interval);
+                if(used == 0){
+                    return -1;
+                }
+                timeLength += used;
+            }
+            cursor += timeLength;
+            elementLength -= timeLength;
+            flags |= UPLINK_VALUE_TIMESTAMPED;
+        }
+        if(header & DELTA_TYPE_FLAG){
+            if(elementLength < 1){
+                return -1;
+            }
+            count = frame[cursor];
+            if(deltaDecodeSeries(frame + cursor + 1, elementLength - 1, count, columns->value + position) != count){
+                return -1;
+            }
+            for(uint16_t i = 0; i < count; i++){
+                putValue(columns, position, index, type, flags, columns->value[position],
+                         timeLength ? epoch + zigzagDecode(offset) - (uint32_t)(count - 1 - i) * interval : 0, 1);
+                position++;
+            }
+        }else if(header & STATISTICS_TYPE_FLAG){
+            if(statisticsDecode(frame + cursor, elementLength, &samples, summary) == 0){
+                return -1;
+            }
+            for(uint8_t i = 0; i < 4; i++){
+                putValue(columns, position++, index, type, flags, summary[i], timeLength ? epoch + offset : 0, samples);
+            }
+        }else{
+            raw[0] = elementLength > 4 ? 4 : elementLength;
+            for(uint8_t i = 0; i < raw[0]; i++){
+                raw[i + 1] = frame[cursor + i];
+            }
+            putValue(columns, position++, index, type, flags, rawToValue(raw, isSignedUplinkType(type)),
+                     timeLength ? epoch + offset : 0, 1);
+        }
+        cursor += elementLength;
+        decoded++;
+    }
+    return decoded;
+}
+
+/*! \fn static void countRange(const uplinkBatch_t *batch, uint32_t first, uint32_t last, uplinkColumns_t *columns)
+    \brief First pass over the frames [first, last): firstValue[index] is set to the values of each frame
+*/
+static void countRange(const uplinkBatch_t *batch, uint32_t first, uint32_t last, uplinkColumns_t *columns){
+    int values;
+    for(uint32_t index = first; index < last; index++){
+        values = countFrame(batch->bytes.data() + batch->offsets[index], batch->lengths[index]);
+        columns->elements[index] = (values < 0) ? -1 : 0;
+        columns->firstValue[index] = (values < 0) ? 0 : values;
+    }
+}
+
+/*! \fn static void decodeRange(const uplinkBatch_t *batch, uint32_t first, uint32_t last, uplinkColumns_t *columns, const valueColumns_t *values, uint32_t *corrupted)
+    \brief Second pass over the frames [first, last): the values are written in place
+    \param[out] *corrupted Frames of the range found malformed only by decodeFrame()
+*/
+static void decodeRange(const uplinkBatch_t *batch, uint32_t first, uint32_t last, uplinkColumns_t *columns,
+                        const valueColumns_t *values, uint32_t *corrupted){
+    for(uint32_t index = first; index < last; index++){
+        if(columns->elements[index] < 0){
+            continue;
+        }
+        columns->elements[index] = decodeFrame(batch->bytes.data() + batch->offsets[index], batch->lengths[index], index,
+                                               values, columns->firstValue[index]);
+        if(columns->elements[index] < 0){
+            (*corrupted)++;
+        }
+    }
+}
+
+/*! \fn static void compactValues(uplinkColumns_t &columns)
+    \brief Remove the values of the frames found malformed by decodeFrame()
+*/
+static void compactValues(uplinkColumns_t &columns){
+    uint32_t frames = columns.elements.size();
+    uint32_t write = 0;
+    uint32_t start;
+    uint32_t end = columns.firstValue[0];
+    for(uint32_t index = 0; index < frames; index++){
+        start = end;
+        end = columns.firstValue[index + 1];
+        columns.firstValue[index] = write;
+        if(columns.elements[index] < 0){
+            continue;
+        }
+        for(uint32_t value = start; value < end; value++, write++){
+            columns.frame[write] = columns.frame[value];
+            columns.type[write] = columns.type[value];
+            columns.flags[write] = columns.flags[value];
+            columns.value[write] = columns.value[value];
+            columns.timestamp[write] = columns.timestamp[value];
+            columns.samples[write] = columns.samples[value];
+        }
+    }
+    columns.firstValue[frames] = write;
+    columns.frame.resize(write);
+    columns.type.resize(write);
+    columns.flags.resize(write);
+    columns.value.resize(write);
+    columns.timestamp.resize(write);
+    columns.samples.resize(write);
+}
+
+/*! \fn void addUplinkFrame(uplinkBatch_t &batch, const uint8_t *frame, uint8_t length)
+    \brief Append a frame to a batch
+*/
+void addUplinkFrame(uplinkBatch_t &batch, const uint8_t *frame, uint8_t length){
+    batch.offsets.push_back(batch.bytes.size());
+    batch.lengths.push_back(length);
+    batch.bytes.insert(batch.bytes.end(), frame, frame + length);
+}
+
+/*! \fn uint32_t decodeUplinkBatch(const uplinkBatch_t &batch, uplinkColumns_t &columns, unsigned int threads)
+    \brief Decode every frame of a batch
+    \param[in]  batch   The frames
+    \param[out] columns The decoded values, replaced. Decoding the batches of a stream into the same
+                        columns reuses their memory
+    \param[in]  threads Threads used at most, 0 for one per hardware thread
+    \retval The number of values decoded
+*/
+uint32_t decodeUplinkBatch(const uplinkBatch_t &batch, uplinkColumns_t &columns, unsigned int threads){
+    uint32_t frames = batch.lengths.size();
+    uint32_t values = 0;
+    uint32_t count;
+    uint32_t corrupted = 0;
+    valueColumns_t pointers;
+    if(threads == 0){
+        threads = std::thread::hardware_concurrency();
+    }
+    if(threads > (frames / UPLINK_BATCH_MIN_FRAMES)){
+        threads = frames / UPLINK_BATCH_MIN_FRAMES;
+    }
+    if(threads == 0){
+        threads = 1;
+    }
+    std::vector<uint32_t> bounds(threads + 1);
+    std::vector<uint32_t> corruptedFrames(threads, 0);
+    std::vector<std::thread> workers;
+    for(unsigned int i = 0; i <= threads; i++){
+        bounds[i] = (uint32_t)(((uint64_t)frames * i) / threads);
+    }
+    columns.elements.resize(frames);
+    columns.firstValue.resize(frames + 1);
+    for(unsigned int i = 0; i + 1 < threads; i++){
+        workers.push_back(std::thread(countRange, &batch, bounds[i], bounds[i + 1], &columns));
+    }
+    countRange(&batch, bounds[threads - 1], bounds[threads], &columns);
+    for(size_t i = 0; i < workers.size(); i++){
+        workers[i].join();
+    }
+    workers.clear();
+    for(uint32_t index = 0; index < frames; index++){
+        count = columns.firstValue[index];
+        columns.firstValue[index] = values;
+        values += count;
+    }
+    columns.firstValue[frames] = values;
+    columns.frame.resize(values);
+    columns.type.resize(values);
+    columns.flags.resize(values);
+    columns.value.resize(values);
+    columns.timestamp.resize(values);
+    columns.samples.resize(values);
+    pointers.frame = columns.frame.data();
+    pointers.type = columns.type.data();
+    pointers.flags = columns.flags.data();
+    pointers.value = columns.value.data();
+    pointers.timestamp = columns.timestamp.data();
+    pointers.samples = columns.samples.data();
+    for(unsigned int i = 0; i + 1 < threads; i++){
+        workers.push_back(std::thread(decodeRange, &batch, bounds[i], bounds[i + 1], &columns, &pointers, &corruptedFrames[i]));
+    }
+    decodeRange(&batch, bounds[threads - 1], bounds[threads], &columns, &pointers, &corruptedFrames[threads - 1]);
+    for(size_t i = 0; i < workers.size(); i++){
+        workers[i].join();
+    }
+    for(unsigned int i = 0; i < threads; i++){
+        corrupted += corruptedFrames[i];
+    }
+    if(corrupted > 0){
+        compactValues(columns);
+    }
+    return columns.firstValue[frames];
+}
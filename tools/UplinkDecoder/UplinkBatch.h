@@ -0,0 +1,67 @@
+/*! \file UplinkBatch.h
+    \brief Batch decoder of the uplink frames built by Buffer, into columns, for the network server side
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    The frames of a batch are stored one after the other in a single array, and the decoded values
+    in columns (one array per field) instead of one uplinkElement_t with its own vectors per
+    element. The frames are decoded in parallel by several threads, each one on a contiguous range
+    of frames, and the columns of the threads are concatenated in frame order, so the result does
+    not depend on the number of threads.
+
+    The values are the ones of decodeUplinkFrame(): one per raw element, one per sample of a delta
+    series and min/max/mean/stddev for a summary. The values of a malformed frame are dropped and
+    its element count is -1.
+*/
+
+/*! \def _UPLINKBATCH_H
+    \brief The library flag
+ */
+#ifndef _UPLINKBATCH_H
+#define _UPLINKBATCH_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+#include <vector>
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+#define UPLINK_VALUE_SERIES 0x01/*!< Flag of a value decoded from a delta series */
+#define UPLINK_VALUE_SUMMARY 0x02/*!< Flag of a value of a statistics summary (min, max, mean and stddev in this order) */
+#define UPLINK_VALUE_TIMESTAMPED 0x04/*!< Flag of a value with a timestamp */
+
+/*! \struct uplinkBatch_t
+    \brief  Frames to decode
+ */
+typedef struct {
+  std::vector<uint8_t> bytes;/**< The payloads one after the other */
+  std::vector<uint32_t> offsets;/**< Start of each frame in bytes */
+  std::vector<uint8_t> lengths;/**< Length of each frame */
+}uplinkBatch_t;
+
+/*! \struct uplinkColumns_t
+    \brief  Decoded values of a batch, the vectors of a group have one entry per frame or per value
+ */
+typedef struct {
+  std::vector<int16_t> elements;/**< Per frame: elements decoded, -1 if the frame is malformed */
+  std::vector<uint32_t> firstValue;/**< Per frame: index of its first value, one more entry with the number of values */
+  std::vector<uint32_t> frame;/**< Per value: index of the frame */
+  std::vector<uint8_t> type;/**< Per value: UplinkTypes_t, without flags */
+  std::vector<uint8_t> flags;/**< Per value: UPLINK_VALUE_SERIES, UPLINK_VALUE_SUMMARY, UPLINK_VALUE_TIMESTAMPED */
+  std::vector<int32_t> value;/**< Per value: the value */
+  std::vector<uint32_t> timestamp;/**< Per value: RTC epoch, 0 if not timestamped */
+  std::vector<uint32_t> samples;/**< Per value: samples it stands for, the summarised samples for a summary, 1 otherwise */
+}uplinkColumns_t;
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+void addUplinkFrame(uplinkBatch_t &batch, const uint8_t *frame, uint8_t length);
+
+uint32_t decodeUplinkBatch(const uplinkBatch_t &batch, uplinkColumns_t &columns, unsigned int threads);
+
+#endif
@@ -0,0 +1,225 @@
+/*! \file UplinkDecoder.cpp
+    \brief Host side decoder of the uplink frames built by Buffer
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+
+    Uplink frame: a sequence of elements [type][lenght][data...]
+      - Raw element:   data is the BLE attribute value (little endian)
+      - Delta series:  type has DELTA_TYPE_FLAG set, data is [count][varints] (DeltaCodec.h)
+      - Summary:       type has STATISTICS_TYPE_FLAG set, data is the statistics of a window (RunningStats.h)
+      - Redundancy:    type REDUNDANCY_TYPE, always the last element (Redundancy.h)
+      - Frame epoch:   type FRAME_EPOCH_TYPE, first element, RTC epoch (4 bytes, little endian)
+    With TIMESTAMP_TYPE_FLAG in the type the data starts with the time of the values:
+      - Raw element:   varint seconds from the frame epoch
+      - Summary:       varint seconds from the frame epoch to the end of the window
+      - Delta series:  zig-zag varint seconds from the frame epoch to the last sample, varint seconds between samples
+*/
+
+/******************************************************************************
+ * Includes                                                                   *
+ ******************************************************************************/
+#include <stddef.h>
+#include <inttypes.h>
+#include "defines.h"
+#include "DeltaCodec.h"
+#include "RunningStats.h"
+#include "Redundancy.h"
+#include "UplinkDecoder.h"
+
+/******************************************************************************
+ * FUNCTIONS                                                                  *
+ ******************************************************************************/
+
+/*! \fn uint8_t isSignedUplinkType(uint8_t type)
+    \brief Same table as Buffer::isSignedType(), the values of these types are sign extended
+    \param  type The UplinkTypes_t
+    \retval 1 if signed
+*/
+uint8_t isSignedUplinkType(uint8_t type){
+    return (type == TEMPERATURE_TYPE) || (type == SOUND_LEVEL_TYPE) || (type == FIELD_STRENGHT_TYPE);
+}
+
+/*! \fn int decodeUplinkFrame(const uint8_t *frame, uint8_t length, std::vector<uplinkElement_t> &elements)
+    \brief Decode the sensor elements of an uplink frame, the redundancy element is skipped
+    \param[in]  *frame    The frame payload
+    \param[in]  length    The payload length
+    \param[out] elements  The decoded elements are appended here
+    \retval The number of elements decoded, -1 if the frame is malformed
+*/
+int decodeUplinkFrame(const uint8_t *frame, uint8_t length, std::vector<uplinkElement_t> &elements){
+    uint8_t index = 0;
+    uint8_t elementLength;
+    uint8_t timeLength;
+    uint8_t used;
+    int decoded = 0;
+    uint8_t raw[5];
+    uint32_t epoch = 0;
+    uint32_t offset;
+    uint32_t interval;
+    int32_t summary[4];
+    if((length >= 6) && (frame[0] == FRAME_EPOCH_TYPE) && (frame[1] == 4)){
+        epoch = (uint32_t)frame[2] | ((uint32_t)frame[3] << 8) | ((uint32_t)frame[4] << 16) | ((uint32_t)frame[5] << 24);
+    }
+    while(index < length){
+        if((index + 2) > length){
+            return -1;
+        }
+        uplinkElement_t element;
+        element.type = frame[index] & ~(DELTA_TYPE_FLAG | TIMESTAMP_TYPE_FLAG | STATISTICS_TYPE_FLAG);
+        element.isSeries = (frame[index] & DELTA_TYPE_FLAG) ? 1 : 0;
+        element.isSummary = (frame[index] & STATISTICS_TYPE_FLAG) ? 1 : 0;
+        element.samples = 0;
+        elementLength = frame[index + 1];
+        index += 2;
+        if((index + elementLength) > length){
+            return -1;
+        }
+        if((frame[index - 2] == REDUNDANCY_TYPE) || (frame[index - 2] == FRAME_EPOCH_TYPE)){
+            index += elementLength;
+            continue;
+        }
+        timeLength = 0;
+        if(frame[index - 2] & TIMESTAMP_TYPE_FLAG){
+            timeLength = varintDecode(frame + index, elementLength, &offset);
+            if(timeLength == 0){
+                return -1;
+            }
+            if(element.isSeries){
+                used = varintDecode(frame + index + timeLength, elementLength - timeLength, &interval);
+                if(used == 0){
+                    return -1;
+                }
+                timeLength += used;
+            }
+            index += timeLength;
+            elementLength -= timeLength;
+        }
+        if(element.isSeries){
+            if(elementLength < 1){
+                return -1;
+            }
+            element.values.resize(frame[index]);
+            if(deltaDecodeSeries(frame + index + 1, elementLength - 1, frame[index], &element.values[0]) != frame[index]){
+                return -1;
+            }
+        }else if(element.isSummary){
+            if(statisticsDecode(frame + index, elementLength, &element.samples, summary) == 0){
+                return -1;
+            }
+            element.values.assign(summary, summary + 4);
+        }else{
+            raw[0] = elementLength > 4 ? 4 : elementLength;
+            for(uint8_t i = 0; i < raw[0]; i++){
+                raw[i + 1] = frame[index + i];
+            }
+            element.values.push_back(rawToValue(raw, isSignedUplinkType(element.type)));
+        }
+        if(timeLength > 0){
+            if(element.isSeries){
+                for(size_t i = 0; i < element.values.size(); i++){
+                    element.timestamps.push_back(epoch + zigzagDecode(offset) - (uint32_t)(element.values.size() - 1 - i) * interval);
+                }
+            }else{
+                element.timestamps.push_back(epoch + offset);
+            }
+        }
+        index += elementLength;
+        elements.push_back(element);
+        decoded++;
+    }
+    return decoded;
+}
+
+/*! \fn int decodeRedundancy(const uint8_t *frame, uint8_t length, redundancy_t *redundancy)
+    \brief Decode the redundancy element of a DATA_PORT frame
+    \param[in]  *frame      The frame payload
+    \param[in]  length      The payload length
+    \param[out] *redundancy The redundancy, the copies are already recovered
+    \retval 1 if the frame has redundancy, 0 if not, -1 if the frame is malformed
+*/
+int decodeRedundancy(const uint8_t *frame, uint8_t length, redundancy_t *redundancy){
+    uint8_t index = 0;
+    uint8_t base;
+    uint8_t end;
+    uint8_t copyLength;
+    uint8_t blockLength;
+    while((index + 2) <= length){
+        if(frame[index] != REDUNDANCY_TYPE){
+            index += 2 + frame[index + 1];
+            continue;
+        }
+        base = index;
+        end = index + 2 + frame[index + 1];
+        if((end > length) || (frame[index + 1] < 2)){
+            return -1;
+        }
+        redundancy->sequence = frame[index + 2];
+        redundancy->mode = frame[index + 3] >> 4;
+        redundancy->depth = frame[index + 3] & 0x0F;
+        redundancy->copies.clear();
+        redundancy->lengths.clear();
+        redundancy->parity.clear();
+        index += 4;
+        if(redundancy->mode == REDUNDANCY_COPY){
+            for(uint8_t i = 0; i < redundancy->depth; i++){
+                if((index + 2) > end){
+                    return -1;
+                }
+                copyLength = frame[index];
+                blockLength = frame[index + 1];
+                index += 2;
+                if((index + blockLength) > end){
+                    return -1;
+                }
+                std::vector<uint8_t> copy(copyLength);
+                if((copyLength > 0) && !xorRunDecode(frame + index, blockLength, frame, base, &copy[0], copyLength)){
+                    return -1;
+                }
+                redundancy->copies.push_back(copy);
+                index += blockLength;
+            }
+        }else if(redundancy->mode == REDUNDANCY_PARITY){
+            if((index + redundancy->depth) > end){
+                return -1;
+            }
+            redundancy->lengths.assign(frame + index, frame + index + redundancy->depth);
+            index += redundancy->depth;
+            redundancy->parity.assign(frame + index, frame + end);
+        }else{
+            return -1;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+/*! \fn int recoverFromParity(const redundancy_t &redundancy, const std::vector<const std::vector<uint8_t>*> &received, std::vector<uint8_t> &lost)
+    \brief Recover one lost frame from the XOR parity
+    \param[in]  redundancy The REDUNDANCY_PARITY element
+    \param[in]  received   The covered frames, newest first, NULL for the lost one (without redundancy element)
+    \param[out] lost       The recovered frame
+    \retval The position of the recovered frame in received, -1 if not exactly one frame is lost
+*/
+int recoverFromParity(const redundancy_t &redundancy, const std::vector<const std::vector<uint8_t>*> &received, std::vector<uint8_t> &lost){
+    int position = -1;
+    if((redundancy.mode != REDUNDANCY_PARITY) || (received.size() != redundancy.depth)){
+        return -1;
+    }
+    lost = redundancy.parity;
+    for(size_t i = 0; i < received.size(); i++){
+        if(received[i] == NULL){
+            if(position >= 0){
+                return -1;
+            }
+            position = (int)i;
+            continue;
+        }
+        for(size_t j = 0; (j < received[i]->size()) && (j < lost.size()); j++){
+            lost[j] ^= (*received[i])[j];
+        }
+    }
+    if(position >= 0){
+        lost.resize(redundancy.lengths[position]);
+    }
+    return position;
+}
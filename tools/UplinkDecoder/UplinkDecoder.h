@@ -0,0 +1,59 @@
+/*! \file UplinkDecoder.h
+    \brief Host side decoder of the uplink frames built by Buffer
+    \date 18/10/2026
+    \author Alejandro Piñan Roescher
+*/
+
+/*! \def _UPLINKDECODER_H
+    \brief The library flag
+ */
+#ifndef _UPLINKDECODER_H
+#define _UPLINKDECODER_H
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <inttypes.h>
+#include <vector>
+
+/******************************************************************************
+ * Definitions & Declarations
+ ******************************************************************************/
+
+/*! \struct uplinkElement_t
+    \brief  One decoded element of an uplink frame
+ */
+typedef struct {
+  uint8_t type;/**< UplinkTypes_t of the element, without flags */
+  uint8_t isSeries;/**< 1 if the element was a delta series */
+  uint8_t isSummary;/**< 1 if the element was a statistics summary */
+  uint32_t samples;/**< Summary: number of samples summarised */
+  std::vector<int32_t> values;/**< The decoded values, one for a raw element, min/max/mean/stddev for a summary */
+  std::vector<uint32_t> timestamps;/**< RTC epoch of each value, empty if the element is not timestamped */
+}uplinkElement_t;
+
+/*! \struct redundancy_t
+    \brief  The redundancy element of a DATA_PORT frame
+ */
+typedef struct {
+  uint8_t sequence;/**< Sequence number of the frame */
+  uint8_t mode;/**< REDUNDANCY_COPY or REDUNDANCY_PARITY */
+  uint8_t depth;/**< Number of previous frames covered */
+  std::vector<std::vector<uint8_t> > copies;/**< REDUNDANCY_COPY: previous frames, newest first */
+  std::vector<uint8_t> lengths;/**< REDUNDANCY_PARITY: length of the covered frames, newest first */
+  std::vector<uint8_t> parity;/**< REDUNDANCY_PARITY: XOR of the covered frames */
+}redundancy_t;
+
+/******************************************************************************
+ * Functions                                                                  *
+ ******************************************************************************/
+
+uint8_t isSignedUplinkType(uint8_t type);
+
+int decodeUplinkFrame(const uint8_t *frame, uint8_t length, std::vector<uplinkElement_t> &elements);
+
+int decodeRedundancy(const uint8_t *frame, uint8_t length, redundancy_t *redundancy);
+
+int recoverFromParity(const redundancy_t &redundancy, const std::vector<const std::vector<uint8_t>*> &received, std::vector<uint8_t> &lost);
+
+#endif